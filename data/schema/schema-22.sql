@@ -0,0 +1,7 @@
+ALTER TABLE playlist_items ADD COLUMN position INTEGER NOT NULL DEFAULT 0;
+
+UPDATE playlist_items SET position = ROWID * 1024;
+
+CREATE INDEX IF NOT EXISTS idx_playlist_items_position ON playlist_items (playlist, position);
+
+UPDATE schema_version SET version=22;
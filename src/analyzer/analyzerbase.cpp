@@ -24,12 +24,9 @@
 
 #include "analyzerbase.h"
 
-#include <cstdint>
 #include <cmath>
-#include <algorithm>
 
 #include <QWidget>
-#include <QList>
 #include <QPainter>
 #include <QPalette>
 #include <QBasicTimer>
@@ -37,25 +34,29 @@
 #include <QHideEvent>
 #include <QTimerEvent>
 
+#include "includes/shared_ptr.h"
 #include "engine/enginebase.h"
+#include "analyzerspectrum.h"
 
 // INSTRUCTIONS Base2D
 // 1. do anything that depends on height() in init(), Base2D will call it before you are shown
 // 2. otherwise you can use the constructor to initialize things
 // 3. reimplement analyze(), and paint to canvas(), Base2D will update the widget when you return control to it
-// 4. if you want to manipulate the scope, reimplement transform()
+// 4. if you want a different transform of the scope, reimplement spectrumOptions()
 // 5. for convenience <vector> <qpixmap.h> <qwdiget.h> are pre-included
 //
 // TODO:
 // Make an INSTRUCTIONS file
-// can't mod scope in analyze you have to use transform for 2D use setErasePixmap Qt function insetead of m_background
+// can't mod scope in analyze you have to use spectrumOptions() for 2D use setErasePixmap Qt function insetead of m_background
 
 AnalyzerBase::AnalyzerBase(QWidget *parent, const uint scope_size)
     : QWidget(parent),
       fht_(new FHT(scope_size)),
       engine_(nullptr),
+      spectrum_(nullptr),
       lastscope_(512),
       new_frame_(false),
+      frame_requested_(false),
       is_playing_(false),
       timeout_(40) {
 
@@ -87,20 +88,42 @@ void AnalyzerBase::ChangeTimeout(const int timeout) {
 
 }
 
-void AnalyzerBase::transform(Scope &scope) {
+void AnalyzerBase::set_spectrum(SharedPtr<AnalyzerSpectrum> spectrum) {
 
-  QList<float> aux(fht_->size());
-  if (static_cast<quint64>(aux.size()) >= scope.size()) {
-    std::copy(scope.begin(), scope.end(), aux.begin());
+  if (spectrum_) {
+    QObject::disconnect(&*spectrum_, nullptr, this, nullptr);
   }
-  else {
-    std::copy(scope.begin(), scope.begin() + aux.size(), aux.begin());
+
+  spectrum_ = spectrum;
+  frame_requested_ = false;
+
+  if (spectrum_) {
+    QObject::connect(&*spectrum_, &AnalyzerSpectrum::FrameReady, this, &AnalyzerBase::SpectrumFrameReady);
   }
 
-  fht_->logSpectrum(scope.data(), aux.data());
-  fht_->scale(scope.data(), 1.0F / 20);
+}
+
+AnalyzerSpectrum::Options AnalyzerBase::spectrumOptions() const {
+
+  AnalyzerSpectrum::Options options;
+  options.size_exp = fht_->sizeExp();
+  options.transform = AnalyzerSpectrum::Transform::LogSpectrum;
+  options.scale = 1.0F / 20;
+  options.output_size = static_cast<size_t>(fht_->size() / 2);  // second half of values are rubbish
+
+  return options;
+
+}
+
+void AnalyzerBase::SpectrumFrameReady() {
 
-  scope.resize(static_cast<size_t>(fht_->size() / 2));  // second half of values are rubbish
+  // Ignore a frame that was requested by the previous analyzer.
+  if (!frame_requested_) return;
+  frame_requested_ = false;
+
+  lastscope_ = spectrum_->frame();
+  new_frame_ = true;
+  update();
 
 }
 
@@ -110,24 +133,12 @@ void AnalyzerBase::paintEvent(QPaintEvent *e) {
   p.fillRect(e->rect(), palette().color(QPalette::Window));
 
   switch (engine_->state()) {
-    case EngineBase::State::Playing:{
-      const EngineBase::Scope &thescope = engine_->scope(timeout_);
-      size_t i = 0;
-
-      // convert to mono here - our built in analyzers need mono, but the engines provide interleaved pcm
-      for (uint x = 0; static_cast<int>(x) < fht_->size(); ++x) {
-        lastscope_[x] = static_cast<float>(thescope[i] + thescope[i + 1]) / (2 * (1U << 15U));
-        i += 2;
-      }
-
+    case EngineBase::State::Playing:
+      // The spectrum stage has already transformed the scope, only paint it here.
       is_playing_ = true;
-      transform(lastscope_);
       analyze(p, lastscope_, new_frame_);
-
-      lastscope_.resize(static_cast<size_t>(fht_->size()));
-
       break;
-    }
+
     case EngineBase::State::Paused:
       is_playing_ = false;
       analyze(p, lastscope_, new_frame_);
@@ -213,27 +224,7 @@ void AnalyzerBase::demo(QPainter &p) {
 
 void AnalyzerBase::interpolate(const Scope &in_scope, Scope &out_scope) {
 
-  double pos = 0.0;
-  const double step = static_cast<double>(in_scope.size()) / static_cast<double>(out_scope.size());
-
-  for (uint i = 0; i < out_scope.size(); ++i, pos += step) {
-    const double error = pos - std::floor(pos);
-    const uint64_t offset = static_cast<uint64_t>(pos);
-
-    uint64_t indexLeft = offset + 0;
-
-    if (indexLeft >= in_scope.size()) {
-      indexLeft = in_scope.size() - 1;
-    }
-
-    uint64_t indexRight = offset + 1;
-
-    if (indexRight >= in_scope.size()) {
-      indexRight = in_scope.size() - 1;
-    }
-
-    out_scope[i] = in_scope[indexLeft] * (1.0F - static_cast<float>(error)) + in_scope[indexRight] * static_cast<float>(error);
-  }
+  AnalyzerSpectrum::Interpolate(in_scope, out_scope);
 
 }
 
@@ -256,6 +247,14 @@ void AnalyzerBase::timerEvent(QTimerEvent *e) {
     return;
   }
 
+  // While playing, the spectrum stage triggers the repaint when the transformed frame is ready.
+  if (spectrum_ && engine_ && engine_->state() == EngineBase::State::Playing) {
+    if (spectrum_->Process(spectrumOptions(), engine_->scope(timeout_))) {
+      frame_requested_ = true;
+    }
+    return;
+  }
+
   new_frame_ = true;
   update();
 
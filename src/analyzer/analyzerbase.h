@@ -38,6 +38,7 @@
 
 #include "includes/shared_ptr.h"
 #include "analyzer/fht.h"
+#include "analyzer/analyzerspectrum.h"
 #include "engine/enginebase.h"
 
 class QHideEvent;
@@ -54,6 +55,7 @@ class AnalyzerBase : public QWidget {
   int timeout() const { return timeout_; }
 
   void set_engine(SharedPtr<EngineBase> engine) { engine_ = engine; }
+  void set_spectrum(SharedPtr<AnalyzerSpectrum> spectrum);
 
   void ChangeTimeout(const int timeout);
 
@@ -71,20 +73,26 @@ class AnalyzerBase : public QWidget {
   int resizeExponent(int exp);
   int resizeForBands(const int bands);
   virtual void init() {}
-  virtual void transform(Scope &scope);
+  // Describes how the spectrum stage transforms the scope before it's passed to analyze().
+  virtual AnalyzerSpectrum::Options spectrumOptions() const;
   virtual void analyze(QPainter &p, const Scope &s, const bool new_frame) = 0;
   virtual void demo(QPainter &p);
 
   void interpolate(const Scope &in_scope, Scope &out_scope);
   void initSin(Scope &v, const uint size = 6000);
 
+ private Q_SLOTS:
+  void SpectrumFrameReady();
+
  protected:
   QBasicTimer timer_;
   FHT *fht_;
   SharedPtr<EngineBase> engine_;
+  SharedPtr<AnalyzerSpectrum> spectrum_;
   Scope lastscope_;
 
   bool new_frame_;
+  bool frame_requested_;
   bool is_playing_;
   int timeout_;
 };
@@ -37,6 +37,7 @@
 #include "analyzercontainer.h"
 
 #include "analyzerbase.h"
+#include "analyzerspectrum.h"
 #include "blockanalyzer.h"
 #include "boomanalyzer.h"
 #include "turbineanalyzer.h"
@@ -49,6 +50,7 @@
 #include "core/settings.h"
 #include "engine/enginebase.h"
 
+using std::make_shared;
 using namespace std::chrono_literals;
 using namespace Qt::Literals::StringLiterals;
 
@@ -74,7 +76,8 @@ AnalyzerContainer::AnalyzerContainer(QWidget *parent)
       double_click_timer_(new QTimer(this)),
       ignore_next_click_(false),
       current_analyzer_(nullptr),
-      engine_(nullptr) {
+      engine_(nullptr),
+      spectrum_(make_shared<AnalyzerSpectrum>()) {
 
   QHBoxLayout *layout = new QHBoxLayout(this);
   setLayout(layout);
@@ -156,6 +159,7 @@ void AnalyzerContainer::ChangeAnalyzer(const int id) {
   delete current_analyzer_;
   current_analyzer_ = qobject_cast<AnalyzerBase*>(instance);
   current_analyzer_->set_engine(engine_);
+  current_analyzer_->set_spectrum(spectrum_);
   // Even if it is not supposed to happen, I don't want to get a dbz error
   current_framerate_ = current_framerate_ == 0 ? kMediumFramerate : current_framerate_;
   current_analyzer_->ChangeTimeout(1000 / current_framerate_);
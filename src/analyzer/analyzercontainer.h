@@ -38,6 +38,7 @@ class QMouseEvent;
 class QWheelEvent;
 
 class AnalyzerBase;
+class AnalyzerSpectrum;
 
 class AnalyzerContainer : public QWidget {
   Q_OBJECT
@@ -89,6 +90,7 @@ class AnalyzerContainer : public QWidget {
 
   AnalyzerBase *current_analyzer_;
   SharedPtr<EngineBase> engine_;
+  SharedPtr<AnalyzerSpectrum> spectrum_;
 };
 
 template<typename T>
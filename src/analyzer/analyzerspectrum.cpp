@@ -0,0 +1,170 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#include <QObject>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
+#include <QMutexLocker>
+
+#include "engine/enginebase.h"
+#include "fht.h"
+#include "analyzerspectrum.h"
+
+using std::make_unique;
+
+AnalyzerSpectrum::AnalyzerSpectrum(QObject *parent)
+    : QObject(parent),
+      watcher_(new QFutureWatcher<Scope>(this)) {
+
+  QObject::connect(watcher_, &QFutureWatcher<Scope>::finished, this, &AnalyzerSpectrum::ProcessFinished);
+
+}
+
+AnalyzerSpectrum::~AnalyzerSpectrum() {
+
+  watcher_->waitForFinished();
+
+}
+
+bool AnalyzerSpectrum::Process(const Options &options, const EngineBase::Scope &scope) {
+
+  if (watcher_->isRunning()) return false;
+
+  QFuture<Scope> future = QtConcurrent::run(&AnalyzerSpectrum::ProcessScope, this, options, scope);
+  watcher_->setFuture(future);
+
+  return true;
+
+}
+
+void AnalyzerSpectrum::ProcessFinished() {
+
+  frame_ = watcher_->result();
+
+  Q_EMIT FrameReady();
+
+}
+
+AnalyzerSpectrum::Scope AnalyzerSpectrum::ProcessScope(const Options &options, const EngineBase::Scope &scope) {
+
+  QMutexLocker l(&mutex_);
+
+  if (!fht_ || fht_->sizeExp() != options.size_exp) {
+    fht_ = make_unique<FHT>(static_cast<uint>(options.size_exp));
+    window_.clear();
+  }
+
+  const size_t size = static_cast<size_t>(fht_->size());
+  Scope frame(size, 0.0F);
+
+  // Convert to mono, the engine provides interleaved stereo S16.
+  const size_t samples = std::min(size, scope.size() / 2);
+  for (size_t i = 0; i < samples; ++i) {
+    frame[i] = static_cast<float>(scope[i * 2] + scope[i * 2 + 1]) / static_cast<float>(2 * (1U << 15U));
+  }
+
+  if (options.transform != Transform::Waveform) {
+    if (window_.size() != size) {
+      UpdateWindow(static_cast<int>(size));
+    }
+    // Kept as a plain loop over contiguous arrays so the compiler vectorizes it.
+    const float gain = options.gain;
+    const float *window = window_.data();
+    float *data = frame.data();
+    for (size_t i = 0; i < size; ++i) {
+      data[i] *= window[i] * gain;
+    }
+  }
+
+  switch (options.transform) {
+    case Transform::Waveform:
+      break;
+    case Transform::Spectrum:
+      fht_->spectrum(frame.data());
+      break;
+    case Transform::LogSpectrum:{
+      Scope aux(frame);
+      fht_->logSpectrum(frame.data(), aux.data());
+      break;
+    }
+    case Transform::Power:
+      fht_->power2(frame.data());
+      break;
+  }
+
+  if (options.transform != Transform::Waveform && options.scale != 1.0F) {
+    fht_->scale(frame.data(), options.scale);
+  }
+
+  if (options.output_size > 0) {
+    frame.resize(options.output_size);
+  }
+
+  if (options.bands > 0 && options.bands != frame.size()) {
+    Scope bands(options.bands);
+    Interpolate(frame, bands);
+    return bands;
+  }
+
+  return frame;
+
+}
+
+void AnalyzerSpectrum::UpdateWindow(const int size) {
+
+  // Hann window, doubled to make up for its coherent gain of 0.5 so the levels stay comparable to the unwindowed transform.
+  window_.resize(static_cast<size_t>(size));
+  for (int i = 0; i < size; ++i) {
+    window_[static_cast<size_t>(i)] = static_cast<float>(1.0 - cos((2.0 * M_PI * i) / (size - 1)));
+  }
+
+}
+
+void AnalyzerSpectrum::Interpolate(const Scope &in_scope, Scope &out_scope) {
+
+  double pos = 0.0;
+  const double step = static_cast<double>(in_scope.size()) / static_cast<double>(out_scope.size());
+
+  for (uint i = 0; i < out_scope.size(); ++i, pos += step) {
+    const double error = pos - std::floor(pos);
+    const uint64_t offset = static_cast<uint64_t>(pos);
+
+    uint64_t indexLeft = offset + 0;
+
+    if (indexLeft >= in_scope.size()) {
+      indexLeft = in_scope.size() - 1;
+    }
+
+    uint64_t indexRight = offset + 1;
+
+    if (indexRight >= in_scope.size()) {
+      indexRight = in_scope.size() - 1;
+    }
+
+    out_scope[i] = in_scope[indexLeft] * (1.0F - static_cast<float>(error)) + in_scope[indexRight] * static_cast<float>(error);
+  }
+
+}
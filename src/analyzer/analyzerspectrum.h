@@ -0,0 +1,97 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ANALYZERSPECTRUM_H
+#define ANALYZERSPECTRUM_H
+
+#include "config.h"
+
+#include <vector>
+
+#include <QObject>
+#include <QMutex>
+
+#include "includes/scoped_ptr.h"
+#include "engine/enginebase.h"
+
+template<typename T> class QFutureWatcher;
+
+class FHT;
+
+// Turns the engine scope into the frame the analyzers paint.
+// The windowing, transform and band interpolation run on a worker thread once per frame, painting only renders the result.
+// AnalyzerContainer owns one instance and shares it with whichever analyzer is active.
+class AnalyzerSpectrum : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit AnalyzerSpectrum(QObject *parent = nullptr);
+  ~AnalyzerSpectrum() override;
+
+  using Scope = std::vector<float>;
+
+  enum class Transform {
+    Waveform,
+    Spectrum,
+    LogSpectrum,
+    Power
+  };
+
+  struct Options {
+    Options() : size_exp(7), transform(Transform::LogSpectrum), gain(1.0F), scale(1.0F), output_size(0), bands(0) {}
+    int size_exp;
+    Transform transform;
+    // Applied to the samples before the transform.
+    float gain;
+    // Applied to the first half of the transform.
+    float scale;
+    // Size of the frame, 0 keeps the size of the transform.
+    size_t output_size;
+    // Interpolates the frame to this number of bands, 0 disables.
+    size_t bands;
+  };
+
+  // Starts processing the scope, returns false if the previous frame is still being processed.
+  bool Process(const Options &options, const EngineBase::Scope &scope);
+
+  const Scope &frame() const { return frame_; }
+
+  static void Interpolate(const Scope &in_scope, Scope &out_scope);
+
+ Q_SIGNALS:
+  void FrameReady();
+
+ private:
+  Scope ProcessScope(const Options &options, const EngineBase::Scope &scope);
+  void UpdateWindow(const int size);
+
+ private Q_SLOTS:
+  void ProcessFinished();
+
+ private:
+  QFutureWatcher<Scope> *watcher_;
+  Scope frame_;
+
+  // Transform state used by the worker thread.
+  QMutex mutex_;
+  ScopedPtr<FHT> fht_;
+  Scope window_;
+};
+
+#endif  // ANALYZERSPECTRUM_H
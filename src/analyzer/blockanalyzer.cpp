@@ -127,15 +127,18 @@ void BlockAnalyzer::framerateChanged() {
   determineStep();
 }
 
-void BlockAnalyzer::transform(Scope &s) {
-
-  for (uint x = 0; x < s.size(); ++x) s[x] *= 2;
-
-  fht_->spectrum(s.data());
-  fht_->scale(s.data(), 1.0F / 20);
+AnalyzerSpectrum::Options BlockAnalyzer::spectrumOptions() const {
 
+  AnalyzerSpectrum::Options options;
+  options.size_exp = fht_->sizeExp();
+  options.transform = AnalyzerSpectrum::Transform::Spectrum;
+  options.gain = 2.0F;
+  options.scale = 1.0F / 20;
   // the second half is pretty dull, so only show it if the user has a large analyzer by setting to scope_.size() if large we prevent interpolation of large analyzers, this is good!
-  s.resize(scope_.size() <= kMaxColumns / 2 ? kMaxColumns / 2 : scope_.size());
+  options.output_size = scope_.size() <= kMaxColumns / 2 ? kMaxColumns / 2 : scope_.size();
+  options.bands = scope_.size();
+
+  return options;
 
 }
 
@@ -161,7 +164,13 @@ void BlockAnalyzer::analyze(QPainter &p, const Scope &s, const bool new_frame) {
 
   QPainter canvas_painter(&canvas_);
 
-  interpolate(s, scope_);
+  // The spectrum stage already reduces the frame to one value per band, it only differs in size until the stage picks up a resize.
+  if (s.size() == scope_.size()) {
+    scope_ = s;
+  }
+  else {
+    interpolate(s, scope_);
+  }
 
   // Paint the background
   canvas_painter.drawPixmap(0, 0, background_);
@@ -46,7 +46,7 @@ class BlockAnalyzer : public AnalyzerBase {
   static const char *kName;
 
  protected:
-  void transform(Scope &s) override;
+  AnalyzerSpectrum::Options spectrumOptions() const override;
   void analyze(QPainter &p, const Scope &s, const bool new_frame) override;
   void resizeEvent(QResizeEvent *e) override;
   virtual void paletteChange(const QPalette &_palette);
@@ -96,12 +96,16 @@ void BoomAnalyzer::resizeEvent(QResizeEvent *e) {
 
 }
 
-void BoomAnalyzer::transform(Scope &s) {
+AnalyzerSpectrum::Options BoomAnalyzer::spectrumOptions() const {
 
-  fht_->spectrum(s.data());
-  fht_->scale(s.data(), 1.0F / 50);
+  AnalyzerSpectrum::Options options;
+  options.size_exp = fht_->sizeExp();
+  options.transform = AnalyzerSpectrum::Transform::Spectrum;
+  options.scale = 1.0F / 50;
+  options.output_size = scope_.size() <= static_cast<quint64>(kMaxBandCount) / 2 ? kMaxBandCount / 2 : scope_.size();
+  options.bands = scope_.size();
 
-  s.resize(scope_.size() <= static_cast<quint64>(kMaxBandCount) / 2 ? kMaxBandCount / 2 : scope_.size());
+  return options;
 
 }
 
@@ -117,7 +121,13 @@ void BoomAnalyzer::analyze(QPainter &p, const Scope &scope, const bool new_frame
   QPainter canvas_painter(&canvas_);
   canvas_.fill(palette().color(QPalette::Window));
 
-  interpolate(scope, scope_);
+  // Only interpolate while the spectrum stage hasn't picked up a new band count yet.
+  if (scope.size() == scope_.size()) {
+    scope_ = scope;
+  }
+  else {
+    interpolate(scope, scope_);
+  }
 
   int x = 0;
   int y = 0;
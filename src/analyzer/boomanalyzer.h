@@ -44,7 +44,7 @@ class BoomAnalyzer : public AnalyzerBase {
 
   static const char *kName;
 
-  void transform(Scope &s) override;
+  AnalyzerSpectrum::Options spectrumOptions() const override;
   void analyze(QPainter &p, const Scope &scope, const bool new_frame) override;
 
  public Q_SLOTS:
@@ -91,7 +91,16 @@ RainbowAnalyzer::RainbowAnalyzer(const RainbowType rbtype, QWidget *parent)
   }
 }
 
-void RainbowAnalyzer::transform(Scope &s) { fht_->spectrum(s.data()); }
+AnalyzerSpectrum::Options RainbowAnalyzer::spectrumOptions() const {
+
+  AnalyzerSpectrum::Options options;
+  options.size_exp = fht_->sizeExp();
+  options.transform = AnalyzerSpectrum::Transform::Spectrum;
+  options.scale = 1.0F;
+
+  return options;
+
+}
 
 void RainbowAnalyzer::timerEvent(QTimerEvent *e) {
 
@@ -52,7 +52,7 @@ class RainbowAnalyzer : public AnalyzerBase {
   explicit RainbowAnalyzer(const RainbowType rbtype, QWidget *parent);
 
  protected:
-  void transform(Scope &s) override;
+  AnalyzerSpectrum::Options spectrumOptions() const override;
   void analyze(QPainter &p, const Scope &s, const bool new_frame) override;
 
   void timerEvent(QTimerEvent *e) override;
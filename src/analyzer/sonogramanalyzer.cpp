@@ -81,11 +81,15 @@ void SonogramAnalyzer::analyze(QPainter &p, const Scope &s, const bool new_frame
 
 }
 
-void SonogramAnalyzer::transform(Scope &scope) {
+AnalyzerSpectrum::Options SonogramAnalyzer::spectrumOptions() const {
 
-  fht_->power2(scope.data());
-  fht_->scale(scope.data(), 1.0 / 256);
-  scope.resize(static_cast<size_t>(fht_->size() / 2));
+  AnalyzerSpectrum::Options options;
+  options.size_exp = fht_->sizeExp();
+  options.transform = AnalyzerSpectrum::Transform::Power;
+  options.scale = 1.0F / 256;
+  options.output_size = static_cast<size_t>(fht_->size() / 2);
+
+  return options;
 
 }
 
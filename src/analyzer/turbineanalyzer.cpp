@@ -49,7 +49,13 @@ void TurbineAnalyzer::analyze(QPainter &p, const Scope &scope, const bool new_fr
   QPainter canvas_painter(&canvas_);
   canvas_.fill(palette().color(QPalette::Window));
 
-  AnalyzerBase::interpolate(scope, scope_);
+  // Same as BoomAnalyzer, the frame already has one value per band.
+  if (scope.size() == scope_.size()) {
+    scope_ = scope;
+  }
+  else {
+    AnalyzerBase::interpolate(scope, scope_);
+  }
 
   for (uint i = 0, x = 0, y = 0; i < static_cast<uint>(bands_); ++i, x += kColumnWidth + 1) {
     float h = static_cast<float>(std::min(log10(scope_[i] * 256.0) * F_ * 0.5, kMaxHeight * 1.0));
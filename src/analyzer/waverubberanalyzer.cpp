@@ -82,9 +82,15 @@ void WaveRubberAnalyzer::analyze(QPainter &p, const Scope &s, const bool new_fra
 
 }
 
-void WaveRubberAnalyzer::transform(Scope &scope) {
+AnalyzerSpectrum::Options WaveRubberAnalyzer::spectrumOptions() const {
+
   // No need transformation for waveform analyzer
-  Q_UNUSED(scope);
+  AnalyzerSpectrum::Options options;
+  options.size_exp = fht_->sizeExp();
+  options.transform = AnalyzerSpectrum::Transform::Waveform;
+
+  return options;
+
 }
 
 void WaveRubberAnalyzer::demo(QPainter &p) {
@@ -33,7 +33,7 @@ class WaveRubberAnalyzer : public AnalyzerBase {
  protected:
   void resizeEvent(QResizeEvent *e) override;
   void analyze(QPainter &p, const Scope &s, const bool new_frame) override;
-  void transform(Scope &scope) override;
+  AnalyzerSpectrum::Options spectrumOptions() const override;
   void demo(QPainter &p) override;
 
  private:
@@ -31,6 +31,7 @@
 #include <QMutex>
 #include <QSet>
 #include <QMap>
+#include <QHash>
 #include <QList>
 #include <QVariant>
 #include <QByteArray>
@@ -50,6 +51,7 @@
 #include "core/database.h"
 #include "core/scopedtransaction.h"
 #include "core/song.h"
+#include "core/playstatistics.h"
 
 #include "collectiondirectory.h"
 #include "collectionbackend.h"
@@ -59,6 +61,11 @@
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+constexpr qsizetype kMaxSongsForIncrementalUpdate = 1000;
+constexpr qsizetype kMaxSongIdsPerQuery = 1000;
+}  // namespace
+
 CollectionBackend::CollectionBackend(QObject *parent)
     : CollectionBackendInterface(parent),
       db_(nullptr),
@@ -637,39 +644,71 @@ void CollectionBackend::AddOrUpdateSongs(const SongList &songs) {
   SongList added_songs;
   SongList changed_songs;
 
+  // Look up songs with a unique id with one query for all songs instead of one per song.
+  QMap<QString, int> song_id_rows;
+  {
+    QStringList song_ids;
+    for (const Song &song : songs) {
+      if (song.id() == -1 && !song.song_id().isEmpty()) song_ids << song.song_id();
+    }
+    for (qsizetype i = 0; i < song_ids.count(); i += kMaxSongIdsPerQuery) {
+      const SongList old_songs = GetSongsBySongId(song_ids.mid(i, kMaxSongIdsPerQuery), db);
+      for (const Song &old_song : old_songs) {
+        if (old_song.is_valid() && old_song.id() != -1) song_id_rows.insert(old_song.song_id(), old_song.id());
+      }
+    }
+  }
+
+  SqlQuery check_dir(db);
+  if (!dirs_table_.isEmpty()) {
+    check_dir.prepare(QStringLiteral("SELECT ROWID FROM %1 WHERE ROWID = :id").arg(dirs_table_));
+  }
+  SqlQuery check_song(db);
+  check_song.prepare(QStringLiteral("SELECT ROWID FROM %1 WHERE ROWID = :id").arg(songs_table_));
+  SqlQuery update_query(db);
+  update_query.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
+  SqlQuery insert_query(db);
+  insert_query.prepare(QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)").arg(songs_table_, Song::kColumnSpec, Song::kBindSpec));
+
+  QMap<int, bool> directory_exists;
+
   for (const Song &song : songs) {
 
     // Do a sanity check first - make sure the song's directory still exists
     // This is to fix a possible race condition when a directory is removed while CollectionWatcher is scanning it.
     if (!dirs_table_.isEmpty()) {
-      SqlQuery check_dir(db);
-      check_dir.prepare(QStringLiteral("SELECT ROWID FROM %1 WHERE ROWID = :id").arg(dirs_table_));
-      check_dir.BindValue(u":id"_s, song.directory_id());
-      if (!check_dir.Exec()) {
-        db_->ReportErrors(check_dir);
-        return;
+      if (!directory_exists.contains(song.directory_id())) {
+        check_dir.BindValue(u":id"_s, song.directory_id());
+        if (!check_dir.Exec()) {
+          db_->ReportErrors(check_dir);
+          return;
+        }
+        directory_exists.insert(song.directory_id(), check_dir.next());
+        check_dir.finish();
       }
 
-      if (!check_dir.next()) continue;
+      if (!directory_exists.value(song.directory_id())) continue;
 
     }
 
     if (song.id() != -1) {  // This song exists in the DB.
 
-      // Get the previous song data first
-      Song old_song(GetSongById(song.id()));
-      if (!old_song.is_valid()) continue;
+      // Make sure the song wasn't deleted in the meantime.
+      check_song.BindValue(u":id"_s, song.id());
+      if (!check_song.Exec()) {
+        db_->ReportErrors(check_song);
+        return;
+      }
+      const bool song_exists = check_song.next();
+      check_song.finish();
+      if (!song_exists) continue;
 
       // Update
-      {
-        SqlQuery q(db);
-        q.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
-        song.BindToQuery(&q);
-        q.BindValue(u":id"_s, song.id());
-        if (!q.Exec()) {
-          db_->ReportErrors(q);
-          return;
-        }
+      song.BindToQuery(&update_query);
+      update_query.BindValue(u":id"_s, song.id());
+      if (!update_query.Exec()) {
+        db_->ReportErrors(update_query);
+        return;
       }
 
       changed_songs << song;
@@ -677,51 +716,38 @@ void CollectionBackend::AddOrUpdateSongs(const SongList &songs) {
       continue;
 
     }
-    else if (!song.song_id().isEmpty()) {  // Song has a unique id, check if the song exists.
-
-      // Get the previous song data first
-      Song old_song(GetSongBySongId(song.song_id()));
-
-      if (old_song.is_valid() && old_song.id() != -1) {
-
-        Song new_song = song;
-        new_song.set_id(old_song.id());
-
-        // Update
-        {
-          SqlQuery q(db);
-          q.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
-          new_song.BindToQuery(&q);
-          q.BindValue(u":id"_s, new_song.id());
-          if (!q.Exec()) {
-            db_->ReportErrors(q);
-            return;
-          }
-        }
+    else if (song_id_rows.contains(song.song_id())) {  // Song has a unique id and exists.
 
-        changed_songs << new_song;
+      Song new_song = song;
+      new_song.set_id(song_id_rows.value(song.song_id()));
 
-        continue;
+      // Update
+      new_song.BindToQuery(&update_query);
+      update_query.BindValue(u":id"_s, new_song.id());
+      if (!update_query.Exec()) {
+        db_->ReportErrors(update_query);
+        return;
       }
+
+      changed_songs << new_song;
+
+      continue;
     }
 
     // Create new song
 
-    int id = -1;
-    {  // Insert the row and create a new ID
-      SqlQuery q(db);
-      q.prepare(QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)").arg(songs_table_, Song::kColumnSpec, Song::kBindSpec));
-      song.BindToQuery(&q);
-      if (!q.Exec()) {
-        db_->ReportErrors(q);
-        return;
-      }
-      // Get the new ID
-      id = q.lastInsertId().toInt();
+    // Insert the row and create a new ID
+    song.BindToQuery(&insert_query);
+    if (!insert_query.Exec()) {
+      db_->ReportErrors(insert_query);
+      return;
     }
-
+    // Get the new ID
+    const int id = insert_query.lastInsertId().toInt();
     if (id == -1) return;
 
+    if (!song.song_id().isEmpty()) song_id_rows.insert(song.song_id(), id);
+
     Song song_copy(song);
     song_copy.set_id(id);
     added_songs << song_copy;
@@ -764,6 +790,14 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
     }
   }
 
+  // The queries are prepared once and reused for all songs, a full sync can contain tens of thousands of songs.
+  SqlQuery update_query(db);
+  update_query.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
+  SqlQuery insert_query(db);
+  insert_query.prepare(QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)").arg(songs_table_, Song::kColumnSpec, Song::kBindSpec));
+  SqlQuery delete_query(db);
+  delete_query.prepare(QStringLiteral("DELETE FROM %1 WHERE ROWID = :id").arg(songs_table_));
+
   // Add or update songs.
   const QList new_songs_list = new_songs.values();
   for (const Song &new_song : new_songs_list) {
@@ -773,15 +807,11 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
 
       if (!new_song.IsAllMetadataEqual(old_song) || !new_song.IsFingerprintEqual(old_song)) {  // Update existing song.
 
-        {
-          SqlQuery q(db);
-          q.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
-          new_song.BindToQuery(&q);
-          q.BindValue(u":id"_s, old_song.id());
-          if (!q.Exec()) {
-            db_->ReportErrors(q);
-            return;
-          }
+        new_song.BindToQuery(&update_query);
+        update_query.BindValue(u":id"_s, old_song.id());
+        if (!update_query.Exec()) {
+          db_->ReportErrors(update_query);
+          return;
         }
 
         Song new_song_copy(new_song);
@@ -792,19 +822,13 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
 
     }
     else {  // Add new song
-      int id = -1;
-      {
-        SqlQuery q(db);
-        q.prepare(QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)").arg(songs_table_, Song::kColumnSpec, Song::kBindSpec));
-        new_song.BindToQuery(&q);
-        if (!q.Exec()) {
-          db_->ReportErrors(q);
-          return;
-        }
-        // Get the new ID
-        id = q.lastInsertId().toInt();
+      new_song.BindToQuery(&insert_query);
+      if (!insert_query.Exec()) {
+        db_->ReportErrors(insert_query);
+        return;
       }
-
+      // Get the new ID
+      const int id = insert_query.lastInsertId().toInt();
       if (id == -1) return;
 
       Song new_song_copy(new_song);
@@ -817,29 +841,36 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
   const QList old_songs_list = old_songs.values();
   for (const Song &old_song : old_songs_list) {
     if (!new_songs.contains(old_song.song_id())) {
-      {
-        SqlQuery q(db);
-        q.prepare(QStringLiteral("DELETE FROM %1 WHERE ROWID = :id").arg(songs_table_));
-        q.BindValue(u":id"_s, old_song.id());
-        if (!q.Exec()) {
-          db_->ReportErrors(q);
-          return;
-        }
+      delete_query.BindValue(u":id"_s, old_song.id());
+      if (!delete_query.Exec()) {
+        db_->ReportErrors(delete_query);
+        return;
       }
       deleted_songs << old_song;
     }
   }
 
-  transaction.Commit();
+  if (!transaction.Commit()) {
+    qLog(Error) << "Failed to commit" << songs_table_ << "transaction:" << db.lastError().text();
+    return;
+  }
 
-  if (!deleted_songs.isEmpty()) Q_EMIT SongsDeleted(deleted_songs);
-  if (!added_songs.isEmpty()) Q_EMIT SongsAdded(added_songs);
-  if (!changed_songs.isEmpty()) Q_EMIT SongsChanged(changed_songs);
+  if (deleted_songs.count() + added_songs.count() + changed_songs.count() > kMaxSongsForIncrementalUpdate) {
+    // Reloading the models once is much faster than updating them song by song, like on the first sync of a large collection.
+    Q_EMIT DatabaseReset();
+  }
+  else {
+    if (!deleted_songs.isEmpty()) Q_EMIT SongsDeleted(deleted_songs);
+    if (!added_songs.isEmpty()) Q_EMIT SongsAdded(added_songs);
+    if (!changed_songs.isEmpty()) Q_EMIT SongsChanged(changed_songs);
+  }
 
   UpdateTotalSongCountAsync();
   UpdateTotalArtistCountAsync();
   UpdateTotalAlbumCountAsync();
 
+  Q_EMIT SongsBySongIDUpdated();
+
 }
 
 void CollectionBackend::UpdateMTimesOnly(const SongList &songs) {
@@ -963,6 +994,29 @@ QStringList CollectionBackend::GetAll(const QString &column, const CollectionFil
 
 }
 
+QHash<int, QString> CollectionBackend::GetAllBySongId(const QString &column) {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  CollectionQuery query(db, songs_table_);
+  query.SetColumnSpec(u"ROWID, "_s + column);
+  query.AddCompilationRequirement(false);
+  query.AddWhere(column, ""_L1, u"!="_s);
+
+  if (!query.Exec()) {
+    ReportErrors(query);
+    return QHash<int, QString>();
+  }
+
+  QHash<int, QString> ret;
+  while (query.Next()) {
+    ret.insert(query.Value(0).toInt(), query.Value(1).toString());
+  }
+  return ret;
+
+}
+
 QStringList CollectionBackend::GetAllArtists(const CollectionFilterOptions &opt) {
 
   return GetAll(u"artist"_s, opt);
@@ -2014,58 +2068,98 @@ SongList CollectionBackend::GetSongsBy(const QString &artist, const QString &alb
 
 }
 
-void CollectionBackend::UpdateLastPlayed(const QString &artist, const QString &album, const QString &title, const qint64 lastplayed) {
+void CollectionBackend::UpdatePlayStatistics(const PlayStatisticsList &statistics_list) {
 
-  const SongList songs = GetSongsBy(artist, album, title);
-  if (songs.isEmpty()) {
-    qLog(Debug) << "Could not find a matching song in the database for" << artist << album << title;
-    return;
-  }
+  if (statistics_list.isEmpty()) return;
 
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
-  for (const Song &song : songs) {
-    if (song.lastplayed() >= lastplayed) {
-      continue;
-    }
+  ScopedTransaction transaction(&db);
+
+  // Stage the statistics in a temporary table, so they can all be matched against the songs with one query.
+  // The key columns use the same case insensitive matching as GetSongsBy().
+  const QStringList setup_queries = QStringList() << u"CREATE TEMP TABLE IF NOT EXISTS play_statistics_import (artist TEXT NOT NULL COLLATE NOCASE, album TEXT NOT NULL COLLATE NOCASE, title TEXT NOT NULL COLLATE NOCASE, lastplayed INTEGER, playcount INTEGER)"_s
+                                                  << u"CREATE INDEX IF NOT EXISTS temp.idx_play_statistics_import ON play_statistics_import (artist, title)"_s
+                                                  << u"DELETE FROM temp.play_statistics_import"_s;
+  for (const QString &setup_query : setup_queries) {
     SqlQuery q(db);
-    q.prepare(QStringLiteral("UPDATE %1 SET lastplayed = :lastplayed WHERE ROWID = :id").arg(songs_table_));
-    q.BindValue(u":lastplayed"_s, lastplayed);
-    q.BindValue(u":id"_s, song.id());
+    q.prepare(setup_query);
     if (!q.Exec()) {
       db_->ReportErrors(q);
-      continue;
+      return;
     }
   }
 
-  Q_EMIT SongsStatisticsChanged(SongList() << songs);
-
-}
-
-void CollectionBackend::UpdatePlayCount(const QString &artist, const QString &title, const int playcount, const bool save_tags) {
+  SqlQuery insert(db);
+  insert.prepare(u"INSERT INTO temp.play_statistics_import (artist, album, title, lastplayed, playcount) VALUES (:artist, :album, :title, :lastplayed, :playcount)"_s);
+  for (const PlayStatistics &statistics : statistics_list) {
+    insert.BindStringValue(u":artist"_s, statistics.artist);
+    insert.BindStringValue(u":album"_s, statistics.album);
+    insert.BindStringValue(u":title"_s, statistics.title);
+    insert.BindValue(u":lastplayed"_s, statistics.lastplayed > 0 ? QVariant(statistics.lastplayed) : QVariant());
+    insert.BindValue(u":playcount"_s, statistics.playcount >= 0 ? QVariant(statistics.playcount) : QVariant());
+    if (!insert.Exec()) {
+      db_->ReportErrors(insert);
+      return;
+    }
+  }
 
-  const SongList songs = GetSongsBy(artist, QString(), title);
-  if (songs.isEmpty()) {
-    qLog(Debug) << "Could not find a matching song in the database for" << artist << title;
+  SqlQuery q(db);
+  q.prepare(QStringLiteral("SELECT s.ROWID, s.lastplayed, s.playcount, MAX(i.lastplayed), MAX(i.playcount) FROM %1 AS s JOIN temp.play_statistics_import AS i ON i.artist = s.artist AND i.title = s.title AND (i.album = '' OR i.album = s.album) GROUP BY s.ROWID").arg(songs_table_));
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
     return;
   }
 
-  QMutexLocker l(db_->Mutex());
-  QSqlDatabase db(db_->Connect());
+  SqlQuery update(db);
+  update.prepare(QStringLiteral("UPDATE %1 SET lastplayed = :lastplayed, playcount = :playcount WHERE ROWID = :id").arg(songs_table_));
 
-  for (const Song &song : songs) {
-    SqlQuery q(db);
-    q.prepare(QStringLiteral("UPDATE %1 SET playcount = :playcount WHERE ROWID = :id").arg(songs_table_));
-    q.BindValue(u":playcount"_s, playcount);
-    q.BindValue(u":id"_s, song.id());
-    if (!q.Exec()) {
-      db_->ReportErrors(q);
+  QStringList changed_ids;
+  while (q.next()) {
+    const int id = q.value(0).toInt();
+    qint64 lastplayed = q.value(1).toLongLong();
+    int playcount = q.value(2).toInt();
+    bool changed = false;
+    if (!q.value(3).isNull() && q.value(3).toLongLong() > lastplayed) {
+      lastplayed = q.value(3).toLongLong();
+      changed = true;
+    }
+    if (!q.value(4).isNull() && q.value(4).toInt() != playcount) {
+      playcount = q.value(4).toInt();
+      changed = true;
+    }
+    if (!changed) continue;
+    update.BindValue(u":lastplayed"_s, lastplayed);
+    update.BindValue(u":playcount"_s, playcount);
+    update.BindValue(u":id"_s, id);
+    if (!update.Exec()) {
+      db_->ReportErrors(update);
       return;
     }
+    changed_ids << QString::number(id);
+  }
+
+  {
+    SqlQuery cleanup(db);
+    cleanup.prepare(u"DELETE FROM temp.play_statistics_import"_s);
+    if (!cleanup.Exec()) {
+      db_->ReportErrors(cleanup);
+    }
+  }
+
+  transaction.Commit();
+
+  qLog(Debug) << "Updated play statistics for" << changed_ids.count() << "songs from" << statistics_list.count() << "imported entries";
+
+  if (changed_ids.isEmpty()) return;
+
+  SongList changed_songs;
+  for (qsizetype i = 0; i < changed_ids.count(); i += kMaxSongIdsPerQuery) {
+    changed_songs << GetSongsById(changed_ids.mid(i, kMaxSongIdsPerQuery), db);
   }
 
-  Q_EMIT SongsStatisticsChanged(SongList() << songs, save_tags);
+  Q_EMIT SongsStatisticsChanged(changed_songs);
 
 }
 
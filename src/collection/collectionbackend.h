@@ -31,6 +31,7 @@
 #include <QObject>
 #include <QFileInfo>
 #include <QList>
+#include <QHash>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -38,6 +39,7 @@
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "core/playstatistics.h"
 #include "collectionfilteroptions.h"
 #include "collectionquery.h"
 #include "collectiondirectory.h"
@@ -179,6 +181,8 @@ class CollectionBackend : public CollectionBackendInterface {
   SongList GetAllSongs() override;
 
   QStringList GetAll(const QString &column, const CollectionFilterOptions &filter_options = CollectionFilterOptions());
+  // Returns the non-empty values of the column keyed by song ID, excluding compilations like GetAll().
+  QHash<int, QString> GetAllBySongId(const QString &column);
   QStringList GetAllArtists(const CollectionFilterOptions &opt = CollectionFilterOptions()) override;
   QStringList GetAllArtistsWithAlbums(const CollectionFilterOptions &opt = CollectionFilterOptions()) override;
   SongList GetArtistSongs(const QString &effective_albumartist, const CollectionFilterOptions &opt = CollectionFilterOptions()) override;
@@ -268,8 +272,7 @@ class CollectionBackend : public CollectionBackendInterface {
   void SongPathChanged(const Song &song, const QFileInfo &new_file, const std::optional<int> new_collection_directory_id);
 
   SongList GetSongsBy(const QString &artist, const QString &album, const QString &title);
-  void UpdateLastPlayed(const QString &artist, const QString &album, const QString &title, const qint64 lastplayed);
-  void UpdatePlayCount(const QString &artist, const QString &title, const int playcount, const bool save_tags = false);
+  void UpdatePlayStatistics(const PlayStatisticsList &statistics_list);
 
   void UpdateSongRating(const int id, const float rating, const bool save_tags = false);
   void UpdateSongsRating(const QList<int> &id_list, const float rating, const bool save_tags = false);
@@ -286,6 +289,8 @@ class CollectionBackend : public CollectionBackendInterface {
   void SongsDeleted(const SongList &songs);
   void SongsChanged(const SongList &songs);
   void SongsStatisticsChanged(const SongList &songs, const bool save_tags = false);
+  // Emitted when the songs passed to UpdateSongsBySongID() are committed to the database.
+  void SongsBySongIDUpdated();
 
   void DatabaseReset();
 
@@ -42,6 +42,7 @@
 #include "collectionwatcher.h"
 #include "collectionbackend.h"
 #include "collectionmodel.h"
+#include "playlist/tagcompletionstore.h"
 #include "constants/collectionsettings.h"
 
 using std::make_shared;
@@ -60,6 +61,7 @@ CollectionLibrary::CollectionLibrary(const SharedPtr<Database> database,
       tagreader_client_(tagreader_client),
       backend_(nullptr),
       model_(nullptr),
+      tag_completion_store_(nullptr),
       watcher_(nullptr),
       watcher_thread_(nullptr),
       original_thread_(nullptr),
@@ -77,6 +79,7 @@ CollectionLibrary::CollectionLibrary(const SharedPtr<Database> database,
   backend_->Init(database, task_manager, Song::Source::Collection, QLatin1String(kSongsTable), QLatin1String(kDirsTable), QLatin1String(kSubdirsTable));
 
   model_ = new CollectionModel(backend_, albumcover_loader, this);
+  tag_completion_store_ = new TagCompletionStore(backend_, this);
 
   full_rescan_revisions_[21] = tr("Support for sort tags artist, album, album artist, title, composer, and performer");
 
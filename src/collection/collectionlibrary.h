@@ -42,6 +42,7 @@ class CollectionBackend;
 class CollectionModel;
 class CollectionWatcher;
 class AlbumCoverLoader;
+class TagCompletionStore;
 
 class CollectionLibrary : public QObject {
   Q_OBJECT
@@ -65,6 +66,7 @@ class CollectionLibrary : public QObject {
 
   SharedPtr<CollectionBackend> backend() const { return backend_; }
   CollectionModel *model() const { return model_; }
+  TagCompletionStore *tag_completion_store() const { return tag_completion_store_; }
 
   QString full_rescan_reason(int schema_version) const { return full_rescan_revisions_.value(schema_version, QString()); }
 
@@ -111,6 +113,7 @@ class CollectionLibrary : public QObject {
 
   SharedPtr<CollectionBackend> backend_;
   CollectionModel *model_;
+  TagCompletionStore *tag_completion_store_;
 
   CollectionWatcher *watcher_;
   Thread *watcher_thread_;
@@ -52,6 +52,13 @@ bool CollectionPlaylistItem::InitFromQuery(const SqlRow &query) {
 
 }
 
+void CollectionPlaylistItem::SetOriginalMetadata(const Song &song) {
+
+  song_ = song;
+  DatabaseValuesChanged();
+
+}
+
 void CollectionPlaylistItem::Reload() {
 
   if (song_.url().isLocalFile()) {
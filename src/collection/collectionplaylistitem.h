@@ -36,7 +36,7 @@ class CollectionPlaylistItem : public PlaylistItem {
   explicit CollectionPlaylistItem(const Song &song);
 
   Song OriginalMetadata() const override { return song_; }
-  void SetOriginalMetadata(const Song &song) override { song_ = song; }
+  void SetOriginalMetadata(const Song &song) override;
 
   QUrl OriginalUrl() const override { return song_.url(); }
   bool IsLocalCollectionItem() const override { return song_.source() == Song::Source::Collection; }
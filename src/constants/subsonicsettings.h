@@ -40,6 +40,8 @@ constexpr char kDownloadAlbumCovers[] = "downloadalbumcovers";
 constexpr char kUseAlbumIdForAlbumCovers[] = "usealbumidforalbumcovers";
 constexpr char kServerSideScrobbling[] = "serversidescrobbling";
 constexpr char kAuthMethod[] = "authmethod";
+constexpr char kLastModified[] = "lastmodified";
+constexpr char kLastModifiedServer[] = "lastmodifiedserver";
 
 }  // namespace SubsonicSettings
 
@@ -0,0 +1,231 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+
+#include <QObject>
+#include <QTimer>
+#include <QByteArray>
+#include <QString>
+#include <QVariant>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+#include "logging.h"
+#include "adaptiveconcurrencylimiter.h"
+
+namespace {
+constexpr int kInitialLimit = 3;
+constexpr int kMaximumLimit = 16;
+constexpr qint64 kDefaultRetryAfterMsec = 1000;
+constexpr qint64 kMaximumRetryAfterMsec = 60000;
+// Latencies below this are not considered a sign of load, so fast local servers are not limited by jitter.
+constexpr double kMinimumLatencyMsec = 50.0;
+constexpr double kLatencyTolerance = 2.0;
+constexpr double kLatencyWeight = 0.2;
+// Lets the lowest latency seen slowly follow the current latency, in case the service got permanently slower.
+constexpr double kMinLatencyWeight = 0.01;
+}  // namespace
+
+AdaptiveConcurrencyLimiter::AdaptiveConcurrencyLimiter(const QString &name, QObject *parent)
+    : QObject(parent),
+      name_(name),
+      timer_backoff_(new QTimer(this)),
+      limit_(kInitialLimit),
+      active_(0),
+      responses_since_change_(0),
+      responses_before_decrease_(0),
+      average_latency_(-1),
+      min_latency_(-1),
+      requests_(0),
+      throttled_(0),
+      total_latency_(0),
+      peak_limit_(kInitialLimit),
+      busy_msec_(0) {
+
+  timer_backoff_->setSingleShot(true);
+  QObject::connect(timer_backoff_, &QTimer::timeout, this, &AdaptiveConcurrencyLimiter::Ready);
+
+}
+
+AdaptiveConcurrencyLimiter::~AdaptiveConcurrencyLimiter() {
+
+  if (requests_ > 0) {
+    const Statistics stats = statistics();
+    qLog(Debug) << name_ << "requests:" << stats.requests << "throttled:" << stats.throttled << "average latency:" << stats.average_latency_msec << "ms" << "peak concurrency:" << stats.peak_limit << "requests per second:" << stats.requests_per_second;
+  }
+
+}
+
+void AdaptiveConcurrencyLimiter::set_limit(const int limit) {
+
+  limit_ = std::clamp(limit, 1, kMaximumLimit);
+  peak_limit_ = requests_ == 0 ? limit_ : std::max(peak_limit_, limit_);
+  responses_since_change_ = 0;
+
+}
+
+bool AdaptiveConcurrencyLimiter::CanStartRequest() const {
+
+  return active_ < limit_ && !timer_backoff_->isActive();
+
+}
+
+void AdaptiveConcurrencyLimiter::AddReply(QNetworkReply *reply) {
+
+  if (replies_.contains(reply)) return;
+
+  if (active_ == 0) busy_timer_.start();
+  ++active_;
+
+  QElapsedTimer timer;
+  timer.start();
+  replies_.insert(reply, timer);
+
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply]() { ReplyFinished(reply); });
+  QObject::connect(reply, &QObject::destroyed, this, [this, reply]() {
+    if (replies_.remove(reply) > 0) {
+      RequestStopped();
+      Q_EMIT Ready();
+    }
+  });
+
+}
+
+void AdaptiveConcurrencyLimiter::ReplyFinished(QNetworkReply *reply) {
+
+  if (!replies_.contains(reply)) return;
+
+  const qint64 latency = replies_.take(reply).elapsed();
+  RequestStopped();
+
+  // Aborted or failed requests without a HTTP status don't say anything about the load of the service.
+  const QVariant http_status_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+  if (!http_status_code.isValid()) {
+    Q_EMIT Ready();
+    return;
+  }
+
+  RequestFinished(latency, http_status_code.toInt(), RetryAfter(reply));
+
+}
+
+void AdaptiveConcurrencyLimiter::RequestStopped() {
+
+  --active_;
+  if (active_ == 0 && busy_timer_.isValid()) {
+    busy_msec_ += busy_timer_.elapsed();
+    busy_timer_.invalidate();
+  }
+
+}
+
+void AdaptiveConcurrencyLimiter::RequestFinished(const qint64 latency_msec, const int http_status_code, const qint64 retry_after_msec) {
+
+  ++requests_;
+  ++responses_since_change_;
+
+  if (http_status_code == 429 || http_status_code == 503) {
+    ++throttled_;
+    Decrease(2);
+    const qint64 backoff_msec = retry_after_msec > 0 ? std::min(retry_after_msec, kMaximumRetryAfterMsec) : kDefaultRetryAfterMsec;
+    if (!timer_backoff_->isActive() || timer_backoff_->remainingTime() < backoff_msec) {
+      timer_backoff_->start(static_cast<int>(backoff_msec));
+    }
+    qLog(Debug) << name_ << "throttled with HTTP" << http_status_code << "limiting to" << limit_ << "concurrent requests, retrying after" << backoff_msec << "ms";
+    return;
+  }
+
+  total_latency_ += latency_msec;
+
+  const double latency = static_cast<double>(latency_msec);
+  if (min_latency_ < 0 || latency < min_latency_) {
+    min_latency_ = latency;
+  }
+  else {
+    min_latency_ += (latency - min_latency_) * kMinLatencyWeight;
+  }
+  average_latency_ = average_latency_ < 0 ? latency : average_latency_ + (latency - average_latency_) * kLatencyWeight;
+
+  if (average_latency_ > kLatencyTolerance * std::max(min_latency_, kMinimumLatencyMsec)) {
+    // The service is queueing the requests, more of them won't make it faster.
+    Decrease(4);
+  }
+  else if (responses_since_change_ >= limit_ && limit_ < kMaximumLimit) {
+    ++limit_;
+    peak_limit_ = std::max(peak_limit_, limit_);
+    responses_since_change_ = 0;
+    responses_before_decrease_ = 0;
+  }
+
+  Q_EMIT Ready();
+
+}
+
+void AdaptiveConcurrencyLimiter::Decrease(const int divisor) {
+
+  // Replies to requests that were started before the last decrease don't reflect it yet.
+  if (responses_since_change_ < responses_before_decrease_) return;
+
+  limit_ = std::max(1, limit_ - std::max(1, limit_ / divisor));
+  responses_since_change_ = 0;
+  responses_before_decrease_ = active_;
+
+}
+
+qint64 AdaptiveConcurrencyLimiter::RetryAfter(QNetworkReply *reply) {
+
+  const QByteArray retry_after = reply->rawHeader("Retry-After").trimmed();
+  if (retry_after.isEmpty()) return 0;
+
+  bool ok = false;
+  const qint64 seconds = retry_after.toLongLong(&ok);
+  if (ok) return seconds * 1000;
+
+  const QDateTime date = QDateTime::fromString(QString::fromLatin1(retry_after), Qt::RFC2822Date);
+  if (date.isValid()) return std::max(0LL, QDateTime::currentDateTimeUtc().msecsTo(date));
+
+  return 0;
+
+}
+
+AdaptiveConcurrencyLimiter::Statistics AdaptiveConcurrencyLimiter::statistics() const {
+
+  Statistics stats;
+  stats.requests = requests_;
+  stats.throttled = throttled_;
+  stats.peak_limit = peak_limit_;
+
+  const qint64 latency_requests = requests_ - throttled_;
+  if (latency_requests > 0) {
+    stats.average_latency_msec = total_latency_ / latency_requests;
+  }
+
+  const qint64 busy_msec = busy_msec_ + (busy_timer_.isValid() ? busy_timer_.elapsed() : 0);
+  if (busy_msec > 0) {
+    stats.requests_per_second = static_cast<double>(requests_) * 1000.0 / static_cast<double>(busy_msec);
+  }
+
+  return stats;
+
+}
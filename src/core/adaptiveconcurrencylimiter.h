@@ -0,0 +1,95 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ADAPTIVECONCURRENCYLIMITER_H
+#define ADAPTIVECONCURRENCYLIMITER_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QElapsedTimer>
+
+class QTimer;
+class QNetworkReply;
+
+// Limits the number of concurrent requests to a web API, shared by all requests to the same service.
+// The limit is raised by one after each round of fast replies, and lowered when the latency grows,
+// or halved when the service throttles with HTTP 429 or 503, in which case no requests are started until Retry-After has passed.
+class AdaptiveConcurrencyLimiter : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit AdaptiveConcurrencyLimiter(const QString &name, QObject *parent = nullptr);
+  ~AdaptiveConcurrencyLimiter() override;
+
+  class Statistics {
+   public:
+    Statistics() : requests(0), throttled(0), average_latency_msec(0), peak_limit(0), requests_per_second(0) {}
+    qint64 requests;
+    qint64 throttled;
+    qint64 average_latency_msec;
+    int peak_limit;
+    double requests_per_second;
+  };
+
+  int limit() const { return limit_; }
+  void set_limit(const int limit);
+  int active() const { return active_; }
+  bool CanStartRequest() const;
+
+  // Counts the reply as active until it's finished or deleted.
+  void AddReply(QNetworkReply *reply);
+
+  void RequestFinished(const qint64 latency_msec, const int http_status_code, const qint64 retry_after_msec = 0);
+
+  Statistics statistics() const;
+
+ Q_SIGNALS:
+  // Emitted when requests can be started again, after a reply finished or after backing off.
+  void Ready();
+
+ private:
+  void ReplyFinished(QNetworkReply *reply);
+  void RequestStopped();
+  void Decrease(const int divisor);
+  static qint64 RetryAfter(QNetworkReply *reply);
+
+  QString name_;
+  QTimer *timer_backoff_;
+  QHash<QNetworkReply*, QElapsedTimer> replies_;
+
+  int limit_;
+  int active_;
+  int responses_since_change_;
+  int responses_before_decrease_;
+  double average_latency_;
+  double min_latency_;
+
+  qint64 requests_;
+  qint64 throttled_;
+  qint64 total_latency_;
+  int peak_limit_;
+  QElapsedTimer busy_timer_;
+  qint64 busy_msec_;
+};
+
+#endif  // ADAPTIVECONCURRENCYLIMITER_H
@@ -18,6 +18,7 @@
  */
 
 #include <QByteArray>
+#include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QJsonDocument>
 #include <QJsonValue>
@@ -33,6 +34,20 @@ using namespace Qt::Literals::StringLiterals;
 JsonBaseRequest::JsonBaseRequest(const SharedPtr<NetworkAccessManager> network, QObject *parent)
     : HttpBaseRequest(network, parent) {}
 
+JsonBaseRequest::ReplyData JsonBaseRequest::TakeReplyData(QNetworkReply *reply) {
+
+  ReplyData reply_data;
+  reply_data.network_error = reply->error();
+  reply_data.error_string = reply->errorString();
+  if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid()) {
+    reply_data.http_status_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  }
+  reply_data.data = reply->readAll();
+
+  return reply_data;
+
+}
+
 JsonBaseRequest::JsonObjectResult JsonBaseRequest::GetJsonObject(const QByteArray &data) {
 
   if (data.isEmpty()) {
@@ -20,7 +20,14 @@
 #ifndef JSONBASEREQUEST_H
 #define JSONBASEREQUEST_H
 
+#include <utility>
+
+#include <QObject>
 #include <QByteArray>
+#include <QString>
+#include <QNetworkReply>
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
 #include <QJsonObject>
 #include <QJsonArray>
 
@@ -59,10 +66,46 @@ class JsonBaseRequest : public HttpBaseRequest {
     QJsonArray json_array;
   };
 
+  class ReplyData {
+   public:
+    ReplyData() : network_error(QNetworkReply::NoError), http_status_code(200) {}
+    QNetworkReply::NetworkError network_error;
+    QString error_string;
+    int http_status_code;
+    QByteArray data;
+  };
+
+  // Drains the reply into the returned data, so the payload is held once and can be moved to a worker thread.
+  static ReplyData TakeReplyData(QNetworkReply *reply);
+
   static JsonObjectResult GetJsonObject(const QByteArray &data);
   static JsonValueResult GetJsonValue(const QJsonObject &json_object, const QString &name);
   static JsonObjectResult GetJsonObject(const QJsonObject &json_object, const QString &name);
   static JsonArrayResult GetJsonArray(const QJsonObject &json_object, const QString &name);
+
+ protected:
+  // Takes the reply and calls parser with its data on a worker thread, then handler with the result on the thread of this object.
+  // The parser must not touch this object, it can outlive it.
+  template<typename Result, typename Parser, typename Handler>
+  void ParseReplyAsync(QNetworkReply *reply, Parser &&parser, Handler &&handler);
 };
 
+template<typename Result, typename Parser, typename Handler>
+void JsonBaseRequest::ParseReplyAsync(QNetworkReply *reply, Parser &&parser, Handler &&handler) {
+
+  if (!replies_.contains(reply)) return;
+  replies_.removeAll(reply);
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
+
+  QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
+  QObject::connect(watcher, &QFutureWatcher<Result>::finished, this, [watcher, handler = std::forward<Handler>(handler)]() {
+    const Result result = watcher->result();
+    watcher->deleteLater();
+    handler(result);
+  });
+  watcher->setFuture(QtConcurrent::run([parser = std::forward<Parser>(parser), reply_data = TakeReplyData(reply)]() mutable { return parser(std::move(reply_data)); }));
+
+}
+
 #endif  // JSONBASEREQUEST_H
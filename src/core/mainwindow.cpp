@@ -107,6 +107,7 @@
 #include "dialogs/errordialog.h"
 #include "dialogs/about.h"
 #include "dialogs/console.h"
+#include "dialogs/playbackmetricsdialog.h"
 #include "dialogs/addstreamdialog.h"
 #include "dialogs/deleteconfirmationdialog.h"
 #include "dialogs/lastfmimportdialog.h"
@@ -303,6 +304,11 @@ MainWindow::MainWindow(Application *app,
         QObject::connect(console, &Console::Error, this, &MainWindow::ShowErrorDialog);
         return console;
       }),
+      playback_metrics_dialog_([app, this]() {
+        PlaybackMetricsDialog *playback_metrics_dialog = new PlaybackMetricsDialog(app->player());
+        QObject::connect(playback_metrics_dialog, &PlaybackMetricsDialog::Error, this, &MainWindow::ShowErrorDialog);
+        return playback_metrics_dialog;
+      }),
       edit_tag_dialog_(std::bind(&MainWindow::CreateEditTagDialog, this)),
       album_cover_choice_controller_(new AlbumCoverChoiceController(this)),
 #ifdef HAVE_GLOBALSHORTCUTS
@@ -342,6 +348,7 @@ MainWindow::MainWindow(Application *app,
       smartplaylists_view_(new SmartPlaylistsViewContainer(app->player(),
                                                            app->playlist_manager(),
                                                            app->collection_backend(),
+                                                           app->collection()->tag_completion_store(),
 #ifdef HAVE_MOODBAR
                                                            app->moodbar_loader(),
 #endif
@@ -351,13 +358,13 @@ MainWindow::MainWindow(Application *app,
       subsonic_view_(new StreamingSongsView(app->streaming_services()->ServiceBySource(Song::Source::Subsonic), QLatin1String(SubsonicSettings::kSettingsGroup), this)),
 #endif
 #ifdef HAVE_TIDAL
-      tidal_view_(new StreamingTabsView(app->streaming_services()->ServiceBySource(Song::Source::Tidal), app->albumcover_loader(), QLatin1String(TidalSettings::kSettingsGroup), this)),
+      tidal_view_(new StreamingTabsView(app->streaming_services()->ServiceBySource(Song::Source::Tidal), app->albumcover_loader(), app->database(), QLatin1String(TidalSettings::kSettingsGroup), this)),
 #endif
 #ifdef HAVE_SPOTIFY
-      spotify_view_(new StreamingTabsView(app->streaming_services()->ServiceBySource(Song::Source::Spotify), app->albumcover_loader(), QLatin1String(SpotifySettings::kSettingsGroup), this)),
+      spotify_view_(new StreamingTabsView(app->streaming_services()->ServiceBySource(Song::Source::Spotify), app->albumcover_loader(), app->database(), QLatin1String(SpotifySettings::kSettingsGroup), this)),
 #endif
 #ifdef HAVE_QOBUZ
-      qobuz_view_(new StreamingTabsView(app->streaming_services()->ServiceBySource(Song::Source::Qobuz), app->albumcover_loader(), QLatin1String(QobuzSettings::kSettingsGroup), this)),
+      qobuz_view_(new StreamingTabsView(app->streaming_services()->ServiceBySource(Song::Source::Qobuz), app->albumcover_loader(), app->database(), QLatin1String(QobuzSettings::kSettingsGroup), this)),
 #endif
       radio_view_(new RadioViewContainer(this)),
       lastfm_import_dialog_(new LastFMImportDialog(app_->lastfm_import(), this)),
@@ -477,7 +484,7 @@ MainWindow::MainWindow(Application *app,
 
   ui_->playlist->view()->Init(app_->player(),
                               app_->playlist_manager(),
-                              app_->collection_backend(),
+                              app_->collection()->tag_completion_store(),
 #ifdef HAVE_MOODBAR
                               app_->moodbar_loader(),
 #endif
@@ -947,6 +954,7 @@ MainWindow::MainWindow(Application *app,
   QObject::connect(this, &MainWindow::SearchCoverInProgress, ui_->widget_playing, &PlayingWidget::SearchCoverInProgress);
 
   QObject::connect(ui_->action_console, &QAction::triggered, this, &MainWindow::ShowConsole);
+  QObject::connect(ui_->action_playback_metrics, &QAction::triggered, this, &MainWindow::ShowPlaybackMetrics);
   PlayingWidgetPositionChanged(ui_->widget_playing->show_above_status_bar());
 
   StyleSheetLoader *css_loader = new StyleSheetLoader(this);
@@ -980,8 +988,7 @@ MainWindow::MainWindow(Application *app,
   QObject::connect(&*app_->lastfm_import(), &LastFMImport::FinishedWithError, lastfm_import_dialog_, &LastFMImportDialog::FinishedWithError);
   QObject::connect(&*app_->lastfm_import(), &LastFMImport::UpdateTotal, lastfm_import_dialog_, &LastFMImportDialog::UpdateTotal);
   QObject::connect(&*app_->lastfm_import(), &LastFMImport::UpdateProgress, lastfm_import_dialog_, &LastFMImportDialog::UpdateProgress);
-  QObject::connect(&*app_->lastfm_import(), &LastFMImport::UpdateLastPlayed, &*app_->collection_backend(), &CollectionBackend::UpdateLastPlayed);
-  QObject::connect(&*app_->lastfm_import(), &LastFMImport::UpdatePlayCount, &*app_->collection_backend(), &CollectionBackend::UpdatePlayCount);
+  QObject::connect(&*app_->lastfm_import(), &LastFMImport::UpdatePlayStatistics, &*app_->collection_backend(), &CollectionBackend::UpdatePlayStatistics);
 
 #if !defined(HAVE_AUDIOCD)
   ui_->action_open_cd->setEnabled(false);
@@ -3029,7 +3036,7 @@ void MainWindow::OpenSettingsDialogAtPage(const SettingsDialog::Page page) {
 
 EditTagDialog *MainWindow::CreateEditTagDialog() {
 
-  EditTagDialog *edit_tag_dialog = new EditTagDialog(app_->network(), app_->tagreader_client(), app_->collection_backend(), app_->albumcover_loader(), app_->current_albumcover_loader(), app_->cover_providers(), app_->lyrics_providers(), app_->streaming_services());
+  EditTagDialog *edit_tag_dialog = new EditTagDialog(app_->network(), app_->tagreader_client(), app_->collection_backend(), app_->collection()->tag_completion_store(), app_->albumcover_loader(), app_->current_albumcover_loader(), app_->cover_providers(), app_->lyrics_providers(), app_->streaming_services());
   QObject::connect(edit_tag_dialog, &EditTagDialog::accepted, this, &MainWindow::EditTagDialogAccepted);
   QObject::connect(edit_tag_dialog, &EditTagDialog::Error, this, &MainWindow::ShowErrorDialog);
   return edit_tag_dialog;
@@ -3215,6 +3222,13 @@ void MainWindow::ShowConsole() {
 
 }
 
+void MainWindow::ShowPlaybackMetrics() {
+
+  playback_metrics_dialog_->show();
+  playback_metrics_dialog_->raise();
+
+}
+
 void MainWindow::keyPressEvent(QKeyEvent *e) {
 
   if (e->key() == Qt::Key_Space) {
@@ -63,6 +63,7 @@
 
 class About;
 class Console;
+class PlaybackMetricsDialog;
 class AlbumCoverManager;
 class Application;
 class ContextView;
@@ -248,6 +249,7 @@ class MainWindow : public QMainWindow, public PlatformInterface {
   void HandleNotificationPreview(const OSDSettings::Type type, const QString &line1, const QString &line2);
 
   void ShowConsole();
+  void ShowPlaybackMetrics();
 
   void LoadCoverFromFile();
   void SaveCoverToFile();
@@ -313,6 +315,7 @@ class MainWindow : public QMainWindow, public PlatformInterface {
   Lazy<ErrorDialog> error_dialog_;
   Lazy<About> about_dialog_;
   Lazy<Console> console_;
+  Lazy<PlaybackMetricsDialog> playback_metrics_dialog_;
   Lazy<EditTagDialog> edit_tag_dialog_;
   AlbumCoverChoiceController *album_cover_choice_controller_;
 
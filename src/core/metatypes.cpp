@@ -44,6 +44,7 @@
 #endif
 
 #include "core/song.h"
+#include "core/playstatistics.h"
 #include "core/enginemetadata.h"
 #include "engine/enginebase.h"
 #include "engine/gstenginepipeline.h"
@@ -101,6 +102,8 @@ void RegisterMetaTypes() {
   qRegisterMetaType<SongList>("SongList");
   qRegisterMetaType<SongMap>("SongMap");
   qRegisterMetaType<Song::Source>("Song::Source");
+  qRegisterMetaType<PlayStatistics>("PlayStatistics");
+  qRegisterMetaType<PlayStatisticsList>("PlayStatisticsList");
   qRegisterMetaType<Song::FileType>("Song::FileType");
   qRegisterMetaType<EngineBase::State>("EngineBase::State");
   qRegisterMetaType<EngineBase::TrackChangeFlags>("EngineBase::TrackChangeFlags");
@@ -32,7 +32,7 @@
 #include <QNetworkInformation>
 
 #include "networkaccessmanager.h"
-#include "threadsafenetworkdiskcache.h"
+#include "shardednetworkdiskcache.h"
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -40,7 +40,7 @@ NetworkAccessManager::NetworkAccessManager(QObject *parent)
     : QNetworkAccessManager(parent) {
 
   setRedirectPolicy(QNetworkRequest::NoLessSafeRedirectPolicy);
-  setCache(new ThreadSafeNetworkDiskCache(this));
+  setCache(new ShardedNetworkDiskCache(this));
 
   // Handle network state changes after system suspend/resume
   // QNetworkInformation provides cross-platform network reachability monitoring in Qt 6
@@ -0,0 +1,45 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PLAYSTATISTICS_H
+#define PLAYSTATISTICS_H
+
+#include <QtGlobal>
+#include <QMetaType>
+#include <QList>
+#include <QString>
+
+// Play statistics for a song identified by artist, album and title, as imported from a scrobbling service.
+// An empty album matches the song on any album, a negative lastplayed or playcount leaves that value unchanged.
+class PlayStatistics {
+ public:
+  explicit PlayStatistics(const QString &_artist = QString(), const QString &_album = QString(), const QString &_title = QString(), const qint64 _lastplayed = -1, const int _playcount = -1)
+      : artist(_artist), album(_album), title(_title), lastplayed(_lastplayed), playcount(_playcount) {}
+  QString artist;
+  QString album;
+  QString title;
+  qint64 lastplayed;
+  int playcount;
+};
+using PlayStatisticsList = QList<PlayStatistics>;
+
+Q_DECLARE_METATYPE(PlayStatistics)
+Q_DECLARE_METATYPE(PlayStatisticsList)
+
+#endif  // PLAYSTATISTICS_H
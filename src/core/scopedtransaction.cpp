@@ -44,10 +44,11 @@ void ScopedTransaction::Commit() {
 
   if (!pending_) {
     qLog(Warning) << "Tried to commit a ScopedTransaction twice";
-    return;
+    return false;
   }
 
-  db_->commit();
   pending_ = false;
 
+  return db_->commit();
+
 }
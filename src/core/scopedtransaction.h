@@ -34,7 +34,7 @@ class ScopedTransaction {
   explicit ScopedTransaction(QSqlDatabase *db);
   ~ScopedTransaction();
 
-  void Commit();
+  bool Commit();
 
  private:
   QSqlDatabase *db_;
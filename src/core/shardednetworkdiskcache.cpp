@@ -0,0 +1,283 @@
+/*
+ * Strawberry Music Player
+ * This file was part of Clementine.
+ * Copyright 2010, David Sansome <me@davidsansome.com>
+ * Copyright 2018-2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <atomic>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QCoreApplication>
+#include <QIODevice>
+#include <QMutex>
+#include <QHash>
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QNetworkDiskCache>
+#include <QNetworkCacheMetaData>
+#include <QAbstractNetworkCache>
+#include <QUrl>
+
+#include "logging.h"
+#include "standardpaths.h"
+#include "shardednetworkdiskcache.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr int kShardCount = 16;
+// Same total size as a single QNetworkDiskCache by default, this is also the maximum size of each shard.
+constexpr qint64 kMaximumCacheSize = 50LL * 1024LL * 1024LL;
+}  // namespace
+
+QMutex ShardedNetworkDiskCache::sMutex;
+int ShardedNetworkDiskCache::sInstances = 0;
+ShardedNetworkDiskCache::Shard ShardedNetworkDiskCache::sShards[kShardCount];
+QHash<QIODevice*, int> ShardedNetworkDiskCache::sPreparedDevices;
+std::atomic<quint64> ShardedNetworkDiskCache::sHits = 0;
+std::atomic<quint64> ShardedNetworkDiskCache::sMisses = 0;
+std::atomic<quint64> ShardedNetworkDiskCache::sLookupNsec = 0;
+
+ShardedNetworkDiskCache::ShardedNetworkDiskCache(QObject *parent) : QAbstractNetworkCache(parent) {
+
+  QMutexLocker l(&sMutex);
+  ++sInstances;
+
+  if (!sShards[0].cache) {
+#ifdef Q_OS_WIN32
+    const QString cache_directory = StandardPaths::WritableLocation(StandardPaths::StandardLocation::TempLocation) + u"/strawberry/networkcache"_s;
+#else
+    const QString cache_directory = StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + u"/networkcache"_s;
+#endif
+    RemoveUnshardedCache(cache_directory);
+    for (int i = 0; i < kShardCount; ++i) {
+      QMutexLocker shard_locker(&sShards[i].mutex);
+      sShards[i].cache = new QNetworkDiskCache;
+      sShards[i].cache->setCacheDirectory(cache_directory + u'/' + QString::number(i, 16));
+      // A shard limited to its share of the total size would refuse or keep evicting large entries like big album covers.
+      sShards[i].cache->setMaximumCacheSize(kMaximumCacheSize);
+      sShards[i].size = sShards[i].cache->cacheSize();
+    }
+  }
+
+}
+
+ShardedNetworkDiskCache::~ShardedNetworkDiskCache() {
+
+  QMutexLocker l(&sMutex);
+  --sInstances;
+
+  if (sShards[0].cache && sInstances == 0) {
+    qLog(Debug) << "Network cache hits:" << sHits.load() << "misses:" << sMisses.load() << "lookup time:" << sLookupNsec.load() / 1000000 << "ms";
+    for (int i = 0; i < kShardCount; ++i) {
+      QMutexLocker shard_locker(&sShards[i].mutex);
+      sShards[i].cache->deleteLater();
+      sShards[i].cache = nullptr;
+      sShards[i].size = 0;
+    }
+  }
+
+}
+
+void ShardedNetworkDiskCache::RemoveUnshardedCache(const QString &cache_directory) {
+
+  // Earlier versions kept a single cache in the top directory, the shards use subdirectories named by their number.
+  const QFileInfoList entries = QDir(cache_directory).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+  for (const QFileInfo &entry : entries) {
+    if (entry.fileName().startsWith("data"_L1) || entry.fileName() == "prepared"_L1) {
+      QDir(entry.absoluteFilePath()).removeRecursively();
+    }
+  }
+
+}
+
+qint64 ShardedNetworkDiskCache::maximumCacheSize() {
+
+  return kMaximumCacheSize;
+
+}
+
+int ShardedNetworkDiskCache::ShardIndex(const QUrl &url) {
+
+  // The shard decides where an entry is stored on disk, so it can't depend on qHash, which can change between Qt versions.
+  const QByteArray digest = QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Md5);
+  return static_cast<quint8>(digest.at(0)) % kShardCount;
+
+}
+
+ShardedNetworkDiskCache::Shard &ShardedNetworkDiskCache::ShardForUrl(const QUrl &url) {
+
+  return sShards[ShardIndex(url)];
+
+}
+
+qint64 ShardedNetworkDiskCache::cacheSize() const {
+
+  qint64 size = 0;
+  for (int i = 0; i < kShardCount; ++i) {
+    QMutexLocker l(&sShards[i].mutex);
+    size += sShards[i].cache->cacheSize();
+  }
+
+  return size;
+
+}
+
+QIODevice *ShardedNetworkDiskCache::data(const QUrl &url) {
+
+  QElapsedTimer timer;
+  timer.start();
+
+  QIODevice *device = nullptr;
+  {
+    Shard &shard = ShardForUrl(url);
+    QMutexLocker l(&shard.mutex);
+    device = shard.cache->data(url);
+  }
+
+  if (device) ++sHits;
+  else ++sMisses;
+  sLookupNsec += static_cast<quint64>(timer.nsecsElapsed());
+
+  return device;
+
+}
+
+void ShardedNetworkDiskCache::insert(QIODevice *device) {
+
+  int shard_index = -1;
+  {
+    QMutexLocker l(&sMutex);
+    shard_index = sPreparedDevices.take(device);
+  }
+  if (shard_index < 0 || shard_index >= kShardCount) return;
+
+  {
+    Shard &shard = sShards[shard_index];
+    QMutexLocker l(&shard.mutex);
+    shard.cache->insert(device);
+    shard.size = shard.cache->cacheSize();
+  }
+
+  ExpireShards();
+
+}
+
+void ShardedNetworkDiskCache::ExpireShards() {
+
+  qint64 total_size = 0;
+  for (int i = 0; i < kShardCount; ++i) {
+    total_size += sShards[i].size;
+  }
+
+  while (total_size > kMaximumCacheSize) {
+    int largest_shard_index = 0;
+    for (int i = 1; i < kShardCount; ++i) {
+      if (sShards[i].size > sShards[largest_shard_index].size) largest_shard_index = i;
+    }
+    Shard &shard = sShards[largest_shard_index];
+    qint64 expired_size = 0;
+    {
+      QMutexLocker l(&shard.mutex);
+      if (!shard.cache) return;
+      const qint64 size = shard.cache->cacheSize();
+      // Lowering the maximum size makes QNetworkDiskCache expire its oldest entries right away.
+      shard.cache->setMaximumCacheSize(qMax(0LL, size - (total_size - kMaximumCacheSize)));
+      shard.cache->setMaximumCacheSize(kMaximumCacheSize);
+      shard.size = shard.cache->cacheSize();
+      expired_size = size - shard.size;
+    }
+    if (expired_size <= 0) break;
+    total_size -= expired_size;
+  }
+
+}
+
+QNetworkCacheMetaData ShardedNetworkDiskCache::metaData(const QUrl &url) {
+
+  Shard &shard = ShardForUrl(url);
+  QMutexLocker l(&shard.mutex);
+  return shard.cache->metaData(url);
+
+}
+
+QIODevice *ShardedNetworkDiskCache::prepare(const QNetworkCacheMetaData &metaData) {
+
+  const int shard_index = ShardIndex(metaData.url());
+
+  QIODevice *device = nullptr;
+  {
+    Shard &shard = sShards[shard_index];
+    QMutexLocker l(&shard.mutex);
+    device = shard.cache->prepare(metaData);
+  }
+
+  if (device) {
+    {
+      QMutexLocker l(&sMutex);
+      sPreparedDevices.insert(device, shard_index);
+    }
+    // The shard deletes the device without it being inserted when the reply is aborted and the entry is removed, or when the shard is deleted.
+    QObject::connect(device, &QObject::destroyed, device, [device]() { PreparedDeviceDestroyed(device); });
+  }
+
+  return device;
+
+}
+
+void ShardedNetworkDiskCache::PreparedDeviceDestroyed(QIODevice *device) {
+
+  QMutexLocker l(&sMutex);
+  sPreparedDevices.remove(device);
+
+}
+
+bool ShardedNetworkDiskCache::remove(const QUrl &url) {
+
+  Shard &shard = ShardForUrl(url);
+  QMutexLocker l(&shard.mutex);
+  const bool removed = shard.cache->remove(url);
+  shard.size = shard.cache->cacheSize();
+
+  return removed;
+
+}
+
+void ShardedNetworkDiskCache::updateMetaData(const QNetworkCacheMetaData &metaData) {
+
+  Shard &shard = ShardForUrl(metaData.url());
+  QMutexLocker l(&shard.mutex);
+  shard.cache->updateMetaData(metaData);
+
+}
+
+void ShardedNetworkDiskCache::clear() {
+
+  for (int i = 0; i < kShardCount; ++i) {
+    QMutexLocker l(&sShards[i].mutex);
+    sShards[i].cache->clear();
+    sShards[i].size = 0;
+  }
+
+}
@@ -0,0 +1,93 @@
+/*
+ * Strawberry Music Player
+ * This file was part of Clementine.
+ * Copyright 2010, David Sansome <me@davidsansome.com>
+ * Copyright 2018-2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SHARDEDNETWORKDISKCACHE_H
+#define SHARDEDNETWORKDISKCACHE_H
+
+#include "config.h"
+
+#include <atomic>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QAbstractNetworkCache>
+#include <QMutex>
+#include <QHash>
+#include <QUrl>
+#include <QNetworkCacheMetaData>
+
+class QIODevice;
+class QNetworkDiskCache;
+
+// HTTP cache shared by all network access managers in all threads.
+// Entries are spread over a number of QNetworkDiskCache shards by URL, each with its own lock and directory,
+// so requests from different threads only wait for each other when they hit the same shard.
+// Each shard may use the whole maximum size, so large entries can be cached, and when the shards together
+// grow past the maximum size the largest shard evicts its oldest entries.
+// Revalidation with Cache-Control, ETag and Last-Modified is done by QNetworkAccessManager from the stored metadata.
+class ShardedNetworkDiskCache : public QAbstractNetworkCache {
+  Q_OBJECT
+
+ public:
+  explicit ShardedNetworkDiskCache(QObject *parent);
+  ~ShardedNetworkDiskCache() override;
+
+  static qint64 maximumCacheSize();
+
+  qint64 cacheSize() const override;
+  QIODevice *data(const QUrl &url) override;
+  void insert(QIODevice *device) override;
+  QNetworkCacheMetaData metaData(const QUrl &url) override;
+  QIODevice *prepare(const QNetworkCacheMetaData &metaData) override;
+  bool remove(const QUrl &url) override;
+  void updateMetaData(const QNetworkCacheMetaData &metaData) override;
+
+ public Q_SLOTS:
+  void clear() override;
+
+ private:
+  class Shard {
+   public:
+    Shard() : cache(nullptr), size(0) {}
+    QMutex mutex;
+    QNetworkDiskCache *cache;
+    // Size of the cache, updated while the mutex is held, so the total size can be read without taking every lock.
+    std::atomic<qint64> size;
+  };
+
+  static int ShardIndex(const QUrl &url);
+  static Shard &ShardForUrl(const QUrl &url);
+  static void RemoveUnshardedCache(const QString &cache_directory);
+  static void PreparedDeviceDestroyed(QIODevice *device);
+  static void ExpireShards();
+
+  static QMutex sMutex;
+  static int sInstances;
+  static Shard sShards[];
+  // Devices returned by prepare() and the shard they belong to, until they are inserted.
+  static QHash<QIODevice*, int> sPreparedDevices;
+
+  static std::atomic<quint64> sHits;
+  static std::atomic<quint64> sMisses;
+  static std::atomic<quint64> sLookupNsec;
+};
+
+#endif  // SHARDEDNETWORKDISKCACHE_H
@@ -46,6 +46,7 @@
 #include "albumcoverfetchersearch.h"
 #include "coverprovider.h"
 #include "coverproviders.h"
+#include "coversearchcache.h"
 #include "albumcoverimageresult.h"
 
 using namespace Qt::Literals::StringLiterals;
@@ -55,15 +56,24 @@ constexpr int kSearchTimeoutMs = 20000;
 constexpr int kImageLoadTimeoutMs = 6000;
 constexpr int kTargetSize = 500;
 constexpr float kGoodScore = 4.0;
+constexpr float kGoodMatchScore = 1.0;
+constexpr float kGoodQualityScore = 1.5;
+constexpr int kBatchProvidersPerRound = 2;
 }  // namespace
 
 AlbumCoverFetcherSearch::AlbumCoverFetcherSearch(const CoverSearchRequest &request, SharedPtr<NetworkAccessManager> network, QObject *parent)
     : QObject(parent),
       request_(request),
+      search_cache_(nullptr),
+      using_cached_result_(false),
+      timed_out_(false),
+      exploring_providers_(false),
       image_load_timeout_(new NetworkTimeouts(kImageLoadTimeoutMs, this)),
       network_(network),
       cancel_requested_(false) {
 
+  elapsed_timer_.start();
+
   // We will terminate the search after kSearchTimeoutMs milliseconds if we are not able to find all of the results before that point in time
   QTimer::singleShot(kSearchTimeoutMs, this, &AlbumCoverFetcherSearch::TerminateSearch);
 
@@ -76,6 +86,28 @@ AlbumCoverFetcherSearch::~AlbumCoverFetcherSearch() {
 
 void AlbumCoverFetcherSearch::TerminateSearch() {
 
+  queued_providers_.clear();
+
+  const QList<int> ids = pending_requests_.keys();
+  if (!ids.isEmpty() && !cancel_requested_) {
+    timed_out_ = true;
+  }
+  for (const int id : ids) {
+    CoverProvider *provider = pending_requests_.take(id);
+    if (!cancel_requested_) {
+      AddProviderSearch(provider, id, false);
+    }
+    provider->CancelSearch(id);
+  }
+
+  AllProvidersFinished();
+
+}
+
+void AlbumCoverFetcherSearch::FinishEarly() {
+
+  queued_providers_.clear();
+
   const QList<int> ids = pending_requests_.keys();
   for (const int id : ids) {
     pending_requests_.take(id)->CancelSearch(id);
@@ -93,9 +125,47 @@ void AlbumCoverFetcherSearch::Start(SharedPtr<CoverProviders> cover_providers) {
     return;
   }
 
-  QList<CoverProvider*> cover_providers_sorted = cover_providers->List();
+  cover_providers_ = cover_providers;
+  search_cache_ = cover_providers->search_cache();
+  cache_key_ = CoverSearchCache::AlbumKey(request_);
+
+  // Use the outcome of an earlier search for the album, unless the user is searching manually.
+  CoverProviderSearchResult cached_result;
+  if (!request_.search && search_cache_->Result(cache_key_, &cached_result)) {
+    if (!cached_result.image_url.isEmpty()) {
+      qLog(Debug) << "Using cached cover search result" << cached_result.image_url << "from" << cached_result.provider;
+      ++statistics_.cached_results_;
+      using_cached_result_ = true;
+      results_ << cached_result;
+      AllProvidersFinished();
+      return;
+    }
+    // Only skip albums without covers for batches, a single request could be the user retrying with a newly enabled provider.
+    if (request_.batch) {
+      ++statistics_.cached_results_;
+      statistics_.missing_images_++;
+      Q_EMIT AlbumCoverFetched(request_.id, AlbumCoverImageResult());
+      return;
+    }
+  }
+
+  SearchProviders();
+
+}
+
+void AlbumCoverFetcherSearch::SearchProviders() {
+
+  QList<CoverProvider*> cover_providers_sorted = cover_providers_->List();
   std::stable_sort(cover_providers_sorted.begin(), cover_providers_sorted.end(), ProviderCompareOrder);
 
+  // Batches ask the providers that most often gave the chosen cover first, keeping the configured order for ties.
+  // Now and then a batch search asks all providers, so the ones ranked low still get a chance to give the chosen cover.
+  exploring_providers_ = request_.batch && search_cache_->ExploreProviders();
+  if (request_.batch && !exploring_providers_) {
+    std::stable_sort(cover_providers_sorted.begin(), cover_providers_sorted.end(), [this](CoverProvider *a, CoverProvider *b) { return ProviderCompareRank(a, b); });
+  }
+
+  queued_providers_.clear();
   for (CoverProvider *provider : std::as_const(cover_providers_sorted)) {
 
     if (!provider->enabled()) continue;
@@ -115,21 +185,64 @@ void AlbumCoverFetcherSearch::Start(SharedPtr<CoverProviders> cover_providers) {
       continue;
     }
 
-    QObject::connect(provider, &CoverProvider::SearchResults, this, QOverload<const int, const CoverProviderSearchResults&>::of(&AlbumCoverFetcherSearch::ProviderSearchResults));
-    QObject::connect(provider, &CoverProvider::SearchFinished, this, &AlbumCoverFetcherSearch::ProviderSearchFinished);
-    const int id = cover_providers->NextId();
+    queued_providers_ << provider;
+  }
+
+  StartProviderSearches();
+
+  // End this search before it even began if there are no providers...
+  if (pending_requests_.isEmpty()) {
+    TerminateSearch();
+  }
+
+}
+
+void AlbumCoverFetcherSearch::StartProviderSearches() {
+
+  // Batches only ask a few providers at a time, so the rest doesn't have to be asked if one of them has a good match.
+  int started = 0;
+  while (!queued_providers_.isEmpty() && (!request_.batch || exploring_providers_ || started < kBatchProvidersPerRound)) {
+    CoverProvider *provider = queued_providers_.takeFirst();
+
+    QObject::connect(provider, &CoverProvider::SearchResults, this, QOverload<const int, const CoverProviderSearchResults&>::of(&AlbumCoverFetcherSearch::ProviderSearchResults), Qt::UniqueConnection);
+    QObject::connect(provider, &CoverProvider::SearchFinished, this, &AlbumCoverFetcherSearch::ProviderSearchFinished, Qt::UniqueConnection);
+    const int id = cover_providers_->NextId();
     const bool success = provider->StartSearch(request_.artist, request_.album, request_.title, id);
 
     if (success) {
       pending_requests_[id] = provider;
+      search_start_times_[id] = elapsed_timer_.elapsed();
       statistics_.network_requests_made_++;
+      ++started;
     }
   }
 
-  // End this search before it even began if there are no providers...
-  if (pending_requests_.isEmpty()) {
-    TerminateSearch();
-  }
+}
+
+void AlbumCoverFetcherSearch::AddProviderSearch(CoverProvider *provider, const int id, const bool success) {
+
+  const qint64 latency = elapsed_timer_.elapsed() - search_start_times_.take(id);
+
+  statistics_.searches_by_provider_[provider->name()]++;
+  statistics_.search_time_by_provider_[provider->name()] += static_cast<quint64>(latency);
+
+  search_cache_->AddProviderSearch(provider->name(), latency, success);
+
+}
+
+bool AlbumCoverFetcherSearch::IsGoodMatch(const CoverProviderSearchResult &result) {
+
+  // Results without a size could be anything, only stop early for images that are known to be big enough.
+  return result.score_match >= kGoodMatchScore &&
+         result.image_size.width() >= kTargetSize &&
+         result.image_size.height() >= kTargetSize &&
+         result.score_quality >= kGoodQualityScore;
+
+}
+
+bool AlbumCoverFetcherSearch::HasGoodMatch() const {
+
+  return std::any_of(results_.begin(), results_.end(), IsGoodMatch);
 
 }
 
@@ -237,12 +350,25 @@ void AlbumCoverFetcherSearch::ProviderSearchFinished(const int id, const CoverPr
 
   CoverProvider *provider = pending_requests_.take(id);
   ProviderSearchResults(provider, results);
+  AddProviderSearch(provider, id, !results.isEmpty());
+
+  // When fetching covers in a batch, there's no need to wait for the other providers if the artist and album matched with a big enough image.
+  if (request_.batch && !exploring_providers_ && HasGoodMatch() && (!pending_requests_.isEmpty() || !queued_providers_.isEmpty())) {
+    qLog(Debug) << "Found a good match from" << provider->name() << "skipping" << pending_requests_.count() + queued_providers_.count() << "providers";
+    FinishEarly();
+    return;
+  }
 
   // Do we have more providers left?
   if (!pending_requests_.isEmpty()) {
     return;
   }
 
+  if (!queued_providers_.isEmpty()) {
+    StartProviderSearches();
+    if (!pending_requests_.isEmpty()) return;
+  }
+
   AllProvidersFinished();
 
 }
@@ -263,6 +389,9 @@ void AlbumCoverFetcherSearch::AllProvidersFinished() {
 
   // No results?
   if (results_.isEmpty()) {
+    if (!timed_out_ && search_cache_) {
+      search_cache_->AddMissing(cache_key_);
+    }
     statistics_.missing_images_++;
     Q_EMIT AlbumCoverFetched(request_.id, AlbumCoverImageResult());
     return;
@@ -401,6 +530,18 @@ void AlbumCoverFetcherSearch::SendBestImage() {
     statistics_.chosen_images_++;
     statistics_.chosen_width_ += result.image.width();
     statistics_.chosen_height_ += result.image.height();
+
+    if (!using_cached_result_) {
+      search_cache_->AddResult(cache_key_, best_image.result);
+    }
+  }
+  else if (using_cached_result_) {
+    // The cached image could not be loaded, search the providers again.
+    qLog(Debug) << "Cached cover for" << request_.artist << request_.album << "is gone, searching again";
+    using_cached_result_ = false;
+    search_cache_->RemoveResult(cache_key_);
+    SearchProviders();
+    return;
   }
   else {
     statistics_.missing_images_++;
@@ -433,6 +574,10 @@ bool AlbumCoverFetcherSearch::ProviderCompareOrder(CoverProvider *a, CoverProvid
   return a->order() < b->order();
 }
 
+bool AlbumCoverFetcherSearch::ProviderCompareRank(CoverProvider *a, CoverProvider *b) const {
+  return search_cache_->ProviderRank(a->name()) > search_cache_->ProviderRank(b->name());
+}
+
 bool AlbumCoverFetcherSearch::CoverProviderSearchResultCompareScore(const CoverProviderSearchResult &a, const CoverProviderSearchResult &b) {
   return a.score() > b.score();
 }
@@ -34,6 +34,7 @@
 #include <QString>
 #include <QUrl>
 #include <QImage>
+#include <QElapsedTimer>
 
 #include "includes/shared_ptr.h"
 #include "albumcoverfetcher.h"
@@ -43,6 +44,7 @@
 class QNetworkReply;
 class CoverProvider;
 class CoverProviders;
+class CoverSearchCache;
 class NetworkAccessManager;
 class NetworkTimeouts;
 
@@ -65,6 +67,9 @@ class AlbumCoverFetcherSearch : public QObject {
 
   static bool CoverProviderSearchResultCompareNumber(const CoverProviderSearchResult &a, const CoverProviderSearchResult &b);
 
+  // Returns true if the artist and album matched and the image is known to be big enough to stop asking other providers.
+  static bool IsGoodMatch(const CoverProviderSearchResult &result);
+
  Q_SIGNALS:
   // It's the end of search (when there was no fetch-me-a-cover request).
   void SearchFinished(quint64, const CoverProviderSearchResults &results);
@@ -80,6 +85,11 @@ class AlbumCoverFetcherSearch : public QObject {
 
  private:
   void ProviderSearchResults(CoverProvider *provider, const CoverProviderSearchResults &results);
+  void SearchProviders();
+  void StartProviderSearches();
+  void AddProviderSearch(CoverProvider *provider, const int id, const bool success);
+  bool HasGoodMatch() const;
+  void FinishEarly();
   void AllProvidersFinished();
 
   void FetchMoreImages();
@@ -87,6 +97,7 @@ class AlbumCoverFetcherSearch : public QObject {
   void SendBestImage();
 
   static bool ProviderCompareOrder(CoverProvider *a, CoverProvider *b);
+  bool ProviderCompareRank(CoverProvider *a, CoverProvider *b) const;
   static bool CoverProviderSearchResultCompareScore(const CoverProviderSearchResult &a, const CoverProviderSearchResult &b);
 
  private:
@@ -98,7 +109,19 @@ class AlbumCoverFetcherSearch : public QObject {
   // Complete results (from all of the available providers).
   CoverProviderSearchResults results_;
 
+  SharedPtr<CoverProviders> cover_providers_;
+  CoverSearchCache *search_cache_;
+  QString cache_key_;
+  bool using_cached_result_;
+  bool timed_out_;
+  bool exploring_providers_;
+
+  // Providers which are not asked yet, batch searches ask a few at a time.
+  QList<CoverProvider*> queued_providers_;
+
   QMap<int, CoverProvider*> pending_requests_;
+  QMap<int, qint64> search_start_times_;
+  QElapsedTimer elapsed_timer_;
   QHash<QNetworkReply*, CoverProviderSearchResult> pending_image_loads_;
   NetworkTimeouts *image_load_timeout_;
 
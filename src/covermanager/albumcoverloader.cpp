@@ -18,21 +18,27 @@
  */
 
 #include <memory>
-#include <chrono>
+#include <utility>
+#include <algorithm>
 
 #include <QtGlobal>
 #include <QObject>
 #include <QThread>
+#include <QThreadPool>
 #include <QMutex>
 #include <QSet>
+#include <QHash>
 #include <QQueue>
 #include <QVariant>
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
 #include <QFile>
+#include <QBuffer>
 #include <QImage>
-#include <QTimer>
+#include <QImageReader>
+#include <QSize>
 #include <QNetworkReply>
 #include <QNetworkRequest>
 
@@ -48,19 +54,21 @@
 #include "albumcoverloaderresult.h"
 #include "albumcoverimageresult.h"
 
-using namespace std::literals::chrono_literals;
 using std::make_shared;
 
 namespace {
 constexpr int kMaxRedirects = 3;
+constexpr int kMaxThreads = 8;
 }
 
 AlbumCoverLoader::AlbumCoverLoader(const SharedPtr<TagReaderClient> tagreader_client, QObject *parent)
     : QObject(parent),
       tagreader_client_(tagreader_client),
       network_(new NetworkAccessManager(this)),
-      timer_process_tasks_(new QTimer(this)),
+      thread_pool_(new QThreadPool(this)),
+      thumbnail_store_(new AlbumCoverThumbnailStore),
       stop_requested_(false),
+      running_tasks_(0),
       load_image_async_id_(1),
       original_thread_(nullptr) {
 
@@ -68,9 +76,10 @@ AlbumCoverLoader::AlbumCoverLoader(const SharedPtr<TagReaderClient> tagreader_cl
 
   original_thread_ = thread();
 
-  timer_process_tasks_->setSingleShot(false);
-  timer_process_tasks_->setInterval(10ms);
-  QObject::connect(timer_process_tasks_, &QTimer::timeout, this, &AlbumCoverLoader::ProcessTasks);
+  // Cached, since the network access manager can't be used from the thread pool.
+  supported_schemes_ = network_->supportedSchemes();
+
+  thread_pool_->setMaxThreadCount(std::max(2, std::min(kMaxThreads, QThread::idealThreadCount())));
 
 }
 
@@ -84,6 +93,8 @@ void AlbumCoverLoader::ExitAsync() {
 void AlbumCoverLoader::Exit() {
 
   Q_ASSERT(QThread::currentThread() == thread());
+  thread_pool_->clear();
+  thread_pool_->waitForDone();
   moveToThread(original_thread_);
   Q_EMIT ExitFinished();
 
@@ -91,23 +102,25 @@ void AlbumCoverLoader::Exit() {
 
 void AlbumCoverLoader::CancelTask(const quint64 id) {
 
-  QMutexLocker l(&mutex_load_image_async_);
-  for (QQueue<TaskPtr>::iterator it = tasks_.begin(); it != tasks_.end(); ++it) {
-    TaskPtr task = *it;
-    if (task->id == id) {
-      tasks_.erase(it);
-      break;
-    }
-  }
+  CancelTasks(QSet<quint64>() << id);
 
 }
 
 void AlbumCoverLoader::CancelTasks(const QSet<quint64> &ids) {
 
   QMutexLocker l(&mutex_load_image_async_);
+
+  // Tasks already taken from the queue keep running, but no result is emitted for the cancelled requests.
+  for (const TaskPtr &task : std::as_const(active_tasks_)) {
+    task->ids.removeIf([&ids](const quint64 id) { return ids.contains(id); });
+  }
+
   for (QQueue<TaskPtr>::iterator it = tasks_.begin(); it != tasks_.end();) {
     TaskPtr task = *it;
-    if (ids.contains(task->id)) {
+    task->ids.removeIf([&ids](const quint64 id) { return ids.contains(id); });
+    // Only drop the task when nobody else is waiting for the same cover.
+    if (task->ids.isEmpty()) {
+      if (!task->key.isEmpty()) tasks_by_key_.remove(task->key);
       it = tasks_.erase(it);
     }
     else {
@@ -168,50 +181,101 @@ quint64 AlbumCoverLoader::LoadImageAsync(const AlbumCoverLoaderOptions &options,
 
 }
 
+QString AlbumCoverLoader::TaskKey(TaskPtr task) {
+
+  // Tasks for a given image are not coalesced, there is nothing to load for them.
+  if (task->album_cover.is_valid()) return QString();
+
+  QStringList types;
+  for (const AlbumCoverLoaderOptions::Type type : std::as_const(task->options.types)) {
+    types << QString::number(static_cast<int>(type));
+  }
+
+  const QStringList key = QStringList() << QString::number(task->options.options.toInt())
+                                        << QString::number(task->options.desired_scaled_size.width())
+                                        << QString::number(task->options.desired_scaled_size.height())
+                                        << QString::number(task->options.device_pixel_ratio)
+                                        << types.join(u',')
+                                        << task->options.default_cover
+                                        << QString::number(task->art_embedded)
+                                        << task->art_automatic.toString()
+                                        << task->art_manual.toString()
+                                        << QString::number(task->art_unset)
+                                        << task->song_url.toString()
+                                        << QString::number(static_cast<int>(task->song_source))
+                                        << QString::number(task->song.is_valid())
+                                        << QString::number(static_cast<int>(task->song.source()))
+                                        << QString::number(task->song.is_radio());
+
+  return key.join(u'\n');
+
+}
+
 quint64 AlbumCoverLoader::EnqueueTask(TaskPtr task) {
 
+  const QString key = TaskKey(task);
+
+  quint64 id = 0;
   {
     QMutexLocker l(&mutex_load_image_async_);
-    task->id = load_image_async_id_++;
+    id = load_image_async_id_++;
+    if (!key.isEmpty() && tasks_by_key_.contains(key)) {
+      // The same cover is already being loaded, the result is emitted for this request too.
+      tasks_by_key_.value(key)->ids << id;
+      return id;
+    }
+    task->id = id;
+    task->ids << id;
+    task->key = key;
     tasks_.enqueue(task);
+    if (!key.isEmpty()) tasks_by_key_.insert(key, task);
   }
 
-  QMetaObject::invokeMethod(this, &AlbumCoverLoader::StartProcessTasks, Qt::QueuedConnection);
+  QMetaObject::invokeMethod(this, &AlbumCoverLoader::ProcessTasks, Qt::QueuedConnection);
 
-  return task->id;
+  return id;
 
 }
 
-void AlbumCoverLoader::StartProcessTasks() {
+void AlbumCoverLoader::ProcessTasks() {
 
-  if (!timer_process_tasks_->isActive()) {
-    timer_process_tasks_->start();
+  while (!stop_requested_ && running_tasks_ < thread_pool_->maxThreadCount()) {
+    TaskPtr task;
+    {
+      QMutexLocker l(&mutex_load_image_async_);
+      if (tasks_.isEmpty()) return;
+      task = tasks_.dequeue();
+      active_tasks_.insert(task->id, task);
+    }
+    StartTask(task);
   }
 
 }
 
-void AlbumCoverLoader::ProcessTasks() {
+void AlbumCoverLoader::StartTask(TaskPtr task) {
 
-  TaskPtr task;
-  {
-    QMutexLocker l(&mutex_load_image_async_);
-    if (tasks_.isEmpty()) {
-      if (timer_process_tasks_->isActive()) {
-        timer_process_tasks_->stop();
-      }
-      return;
-    }
-    task = tasks_.dequeue();
-  }
-
-  ProcessTask(task);
+  // Reading, decoding and scaling images is done in the thread pool, only remote requests and results are handled in this thread.
+  ++running_tasks_;
+  thread_pool_->start([this, task]() { ProcessTask(task); });
 
 }
 
 void AlbumCoverLoader::ProcessTask(TaskPtr task) {
 
+  // Image data downloaded in the loader thread is decoded here, so the loader thread only handles the network requests.
+  if (!task->downloaded_cover_url.isEmpty()) {
+    if (DecodeImage(task)) {
+      task->success = true;
+    }
+    else {
+      qLog(Error) << "Unable to load album cover image from URL" << task->downloaded_cover_url;
+      task->album_cover = AlbumCoverImageResult();
+      task->result_type = AlbumCoverLoaderResult::Type::None;
+    }
+    task->downloaded_cover_url.clear();
+  }
   // If we have album cover already, only do scale and pad.
-  if (task->album_cover.is_valid()) {
+  else if (task->album_cover.is_valid()) {
     task->success = true;
   }
   else {
@@ -257,7 +321,30 @@ void AlbumCoverLoader::FinishTask(TaskPtr task, const AlbumCoverLoaderResult::Ty
     }
   }
 
-  Q_EMIT AlbumCoverLoaded(task->id, AlbumCoverLoaderResult(task->success, task->result_type, task->album_cover, image_scaled, task->art_manual_updated, task->art_automatic_updated));
+  const AlbumCoverLoaderResult result(task->success, task->result_type, task->album_cover, image_scaled, task->art_manual_updated, task->art_automatic_updated);
+  QMetaObject::invokeMethod(this, [this, task, result]() { TaskFinished(task, result); }, Qt::QueuedConnection);
+
+}
+
+void AlbumCoverLoader::TaskFinished(TaskPtr task, const AlbumCoverLoaderResult &result) {
+
+  --running_tasks_;
+
+  QList<quint64> ids;
+  {
+    QMutexLocker l(&mutex_load_image_async_);
+    ids = task->ids;
+    active_tasks_.remove(task->id);
+    if (!task->key.isEmpty() && tasks_by_key_.value(task->key) == task) {
+      tasks_by_key_.remove(task->key);
+    }
+  }
+
+  for (const quint64 id : std::as_const(ids)) {
+    Q_EMIT AlbumCoverLoaded(id, result);
+  }
+
+  ProcessTasks();
 
 }
 
@@ -317,11 +404,49 @@ AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadImage(TaskPtr task, cons
 
 }
 
+bool AlbumCoverLoader::DecodeImage(TaskPtr task) {
+
+  // When only a scaled image is wanted, decode it at the thumbnail size right away, or take the thumbnail from the store.
+  // For JPEG this lets the decoder skip most of the work, and large images never have to be held in memory at full size.
+  if (task->scaled_image() && !task->original_image() && task->options.desired_scaled_size.isValid()) {
+    const QSize scale_size(static_cast<int>(task->options.desired_scaled_size.width() * task->options.device_pixel_ratio), static_cast<int>(task->options.desired_scaled_size.height() * task->options.device_pixel_ratio));
+    const int thumbnail_size = AlbumCoverThumbnailStore::ThumbnailSize(scale_size);
+    QByteArray hash;
+    if (thumbnail_size > 0) {
+      hash = AlbumCoverThumbnailStore::ImageDataHash(task->album_cover.image_data);
+      const QImage thumbnail = thumbnail_store_->Thumbnail(hash, thumbnail_size);
+      if (!thumbnail.isNull()) {
+        task->album_cover.image = thumbnail;
+        return true;
+      }
+    }
+    QBuffer buffer;
+    buffer.setData(task->album_cover.image_data);
+    if (buffer.open(QIODevice::ReadOnly)) {
+      QImageReader reader(&buffer);
+      const QSize image_size = reader.size();
+      const QSize decode_size = thumbnail_size > 0 ? QSize(thumbnail_size, thumbnail_size) : scale_size;
+      if (image_size.isValid() && (image_size.width() > decode_size.width() || image_size.height() > decode_size.height())) {
+        reader.setScaledSize(image_size.scaled(decode_size, Qt::KeepAspectRatio));
+      }
+      if (reader.read(&task->album_cover.image)) {
+        if (thumbnail_size > 0) {
+          thumbnail_store_->AddThumbnail(hash, thumbnail_size, task->album_cover.image);
+        }
+        return true;
+      }
+    }
+  }
+
+  return task->album_cover.image.loadFromData(task->album_cover.image_data);
+
+}
+
 AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadEmbeddedImage(TaskPtr task) {
 
   if (task->art_embedded && task->song_url.isValid() && task->song_url.isLocalFile()) {
     const TagReaderResult result = tagreader_client_->LoadCoverDataBlocking(task->song_url.toLocalFile(), task->album_cover.image_data);
-    if (result.success() && !task->album_cover.image_data.isEmpty() && task->album_cover.image.loadFromData(task->album_cover.image_data)) {
+    if (result.success() && !task->album_cover.image_data.isEmpty() && DecodeImage(task)) {
       return LoadImageResult(AlbumCoverLoaderResult::Type::Embedded, LoadImageResult::Status::Success);
     }
   }
@@ -336,7 +461,7 @@ AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadUrlImage(TaskPtr task, c
     if (cover_url.isLocalFile()) {
       return LoadLocalUrlImage(task, result_type, cover_url);
     }
-    if (network_->supportedSchemes().contains(cover_url.scheme())) {
+    if (supported_schemes_.contains(cover_url.scheme())) {
       return LoadRemoteUrlImage(task, result_type, cover_url);
     }
   }
@@ -384,7 +509,7 @@ AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadLocalFileImage(TaskPtr t
     return LoadImageResult(result_type, LoadImageResult::Status::Failure);
   }
 
-  if (!task->album_cover.image.loadFromData(task->album_cover.image_data)) {
+  if (!DecodeImage(task)) {
     qLog(Error) << "Failed to load image from cover file" << cover_file << ":" << file.errorString();
     return LoadImageResult(result_type, LoadImageResult::Status::Failure);
   }
@@ -395,6 +520,19 @@ AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadLocalFileImage(TaskPtr t
 
 AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadRemoteUrlImage(TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url) {
 
+  // The network access manager lives in the loader thread, so the request is started there.
+  QMetaObject::invokeMethod(this, [this, task, result_type, cover_url]() { LoadRemoteImage(task, result_type, cover_url); }, Qt::QueuedConnection);
+
+  return LoadImageResult(result_type, LoadImageResult::Status::Async);
+
+}
+
+void AlbumCoverLoader::LoadRemoteImage(TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url) {
+
+  // The task doesn't use a thread while waiting for the reply.
+  --running_tasks_;
+  ProcessTasks();
+
   qLog(Debug) << "Loading remote cover from URL" << cover_url;
 
   QNetworkRequest network_request(cover_url);
@@ -402,8 +540,6 @@ AlbumCoverLoader::LoadImageResult AlbumCoverLoader::LoadRemoteUrlImage(TaskPtr t
   QNetworkReply *reply = network_->get(network_request);
   QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, task, result_type, cover_url]() { LoadRemoteImageFinished(reply, task, result_type, cover_url); });
 
-  return LoadImageResult(result_type, LoadImageResult::Status::Async);
-
 }
 
 void AlbumCoverLoader::LoadRemoteImageFinished(QNetworkReply *reply, TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url) {
@@ -413,7 +549,7 @@ void AlbumCoverLoader::LoadRemoteImageFinished(QNetworkReply *reply, TaskPtr tas
   QVariant redirect = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
   if (redirect.isValid() && redirect.metaType().id() == QMetaType::QUrl) {
     if (task->redirects++ >= kMaxRedirects) {
-      ProcessTask(task);
+      StartTask(task);
       return;
     }
     const QUrl redirect_url = redirect.toUrl();
@@ -422,25 +558,25 @@ void AlbumCoverLoader::LoadRemoteImageFinished(QNetworkReply *reply, TaskPtr tas
     network_request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
     network_request.setUrl(redirect_url);
     QNetworkReply *redirected_reply = network_->get(network_request);
-    QObject::connect(redirected_reply, &QNetworkReply::finished, this, [this, reply, task, result_type, redirect_url]() { LoadRemoteImageFinished(reply, task, result_type, redirect_url); });
+    QObject::connect(redirected_reply, &QNetworkReply::finished, this, [this, redirected_reply, task, result_type, redirect_url]() { LoadRemoteImageFinished(redirected_reply, task, result_type, redirect_url); });
     return;
   }
 
   if (reply->error() == QNetworkReply::NoError) {
     task->album_cover.image_data = reply->readAll();
-    if (!task->album_cover.image_data.isEmpty() && task->album_cover.image.loadFromData(task->album_cover.image_data)) {
-      task->success = true;
-      FinishTask(task, result_type);
+    if (!task->album_cover.image_data.isEmpty()) {
+      // Decoding is left to the thread pool.
+      task->result_type = result_type;
+      task->downloaded_cover_url = cover_url;
+      StartTask(task);
       return;
     }
-    else {
-      qLog(Error) << "Unable to load album cover image from URL" << cover_url;
-    }
+    qLog(Error) << "Unable to load album cover image from URL" << cover_url;
   }
   else {
     qLog(Error) << "Unable to get album cover from URL" << cover_url << reply->error() << reply->errorString();
   }
 
-  ProcessTask(task);
+  StartTask(task);
 
 }
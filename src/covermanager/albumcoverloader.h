@@ -27,19 +27,23 @@
 #include <QMutex>
 #include <QSet>
 #include <QHash>
+#include <QList>
 #include <QQueue>
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
 #include <QImage>
 
 #include "includes/shared_ptr.h"
+#include "includes/scoped_ptr.h"
 #include "core/song.h"
 #include "albumcoverloaderoptions.h"
 #include "albumcoverloaderresult.h"
 #include "albumcoverimageresult.h"
+#include "albumcoverthumbnailstore.h"
 
 class QThread;
-class QTimer;
+class QThreadPool;
 class QNetworkReply;
 class NetworkAccessManager;
 class TagReaderClient;
@@ -71,6 +75,9 @@ class AlbumCoverLoader : public QObject {
     explicit Task() : id(0), success(false), art_embedded(false), art_unset(false), song_source(Song::Source::Unknown), result_type(AlbumCoverLoaderResult::Type::None), redirects(0) {}
 
     quint64 id;
+    // IDs of all identical requests that were coalesced into this task, the result is emitted for each of them.
+    QList<quint64> ids;
+    QString key;
     bool success;
 
     AlbumCoverLoaderOptions options;
@@ -92,6 +99,8 @@ class AlbumCoverLoader : public QObject {
     QUrl art_manual_updated;
     QUrl art_automatic_updated;
     int redirects;
+    // Set when the image data was downloaded from this URL and still has to be decoded in the thread pool.
+    QUrl downloaded_cover_url;
   };
   using TaskPtr = SharedPtr<Task>;
 
@@ -108,30 +117,41 @@ class AlbumCoverLoader : public QObject {
   };
 
  private:
+  static QString TaskKey(TaskPtr task);
   quint64 EnqueueTask(TaskPtr task);
+  void StartTask(TaskPtr task);
   void ProcessTask(TaskPtr task);
   void InitArt(TaskPtr task);
   LoadImageResult LoadImage(TaskPtr task, const AlbumCoverLoaderOptions::Type type);
+  bool DecodeImage(TaskPtr task);
   LoadImageResult LoadEmbeddedImage(TaskPtr task);
   LoadImageResult LoadUrlImage(TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url);
   LoadImageResult LoadLocalUrlImage(TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url);
   LoadImageResult LoadLocalFileImage(TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QString &cover_file);
   LoadImageResult LoadRemoteUrlImage(TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url);
   void FinishTask(TaskPtr task, const AlbumCoverLoaderResult::Type result_type);
+  void TaskFinished(TaskPtr task, const AlbumCoverLoaderResult &result);
+  void LoadRemoteImage(TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url);
 
  private Q_SLOTS:
   void Exit();
-  void StartProcessTasks();
   void ProcessTasks();
   void LoadRemoteImageFinished(QNetworkReply *reply, AlbumCoverLoader::TaskPtr task, const AlbumCoverLoaderResult::Type result_type, const QUrl &cover_url);
 
  private:
   const SharedPtr<TagReaderClient> tagreader_client_;
   const SharedPtr<NetworkAccessManager> network_;
-  QTimer *timer_process_tasks_;
+  QStringList supported_schemes_;
+  QThreadPool *thread_pool_;
+  ScopedPtr<AlbumCoverThumbnailStore> thumbnail_store_;
   bool stop_requested_;
   QMutex mutex_load_image_async_;
   QQueue<TaskPtr> tasks_;
+  // Queued and running tasks that new identical requests can be added to.
+  QHash<QString, TaskPtr> tasks_by_key_;
+  // Tasks taken from the queue that haven't finished yet, so they can still be cancelled.
+  QHash<quint64, TaskPtr> active_tasks_;
+  int running_tasks_;
   quint64 load_image_async_id_;
   QThread *original_thread_;
 };
@@ -0,0 +1,153 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QCache>
+#include <QIODevice>
+#include <QBuffer>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QImage>
+#include <QSize>
+#include <QCryptographicHash>
+#include <QNetworkDiskCache>
+#include <QNetworkCacheMetaData>
+
+#include "includes/scoped_ptr.h"
+#include "core/standardpaths.h"
+#include "albumcoverthumbnailstore.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+constexpr char kDiskCacheDir[] = "coverthumbnails";
+constexpr qint64 kDiskCacheSize = 256LL * 1024LL * 1024LL;
+// The memory cache cost is in kilobytes.
+constexpr int kMemoryCacheSize = 32 * 1024;
+constexpr int kThumbnailSizes[] = { 32, 64, 128, 256, 512 };
+
+}  // namespace
+
+AlbumCoverThumbnailStore::AlbumCoverThumbnailStore()
+    : disk_cache_(new QNetworkDiskCache) {
+
+  memory_cache_.setMaxCost(kMemoryCacheSize);
+  disk_cache_->setCacheDirectory(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + u'/' + QLatin1String(kDiskCacheDir));
+  disk_cache_->setMaximumCacheSize(kDiskCacheSize);
+
+}
+
+AlbumCoverThumbnailStore::~AlbumCoverThumbnailStore() = default;
+
+int AlbumCoverThumbnailStore::ThumbnailSize(const QSize size) {
+
+  const int max_side = qMax(size.width(), size.height());
+  for (const int thumbnail_size : kThumbnailSizes) {
+    if (max_side <= thumbnail_size) return thumbnail_size;
+  }
+
+  return 0;
+
+}
+
+QByteArray AlbumCoverThumbnailStore::ImageDataHash(const QByteArray &image_data) {
+
+  return QCryptographicHash::hash(image_data, QCryptographicHash::Sha1).toHex();
+
+}
+
+QString AlbumCoverThumbnailStore::MemoryCacheKey(const QByteArray &hash, const int size) {
+
+  return QString::fromLatin1(hash) + u'-' + QString::number(size);
+
+}
+
+QUrl AlbumCoverThumbnailStore::DiskCacheKey(const QByteArray &hash, const int size) {
+
+  return QUrl(u"thumbnail://"_s + QString::fromLatin1(hash) + u'/' + QString::number(size));
+
+}
+
+QImage AlbumCoverThumbnailStore::Thumbnail(const QByteArray &hash, const int size) {
+
+  const QString memory_cache_key = MemoryCacheKey(hash, size);
+  QByteArray image_data;
+
+  {
+    QMutexLocker l(&mutex_);
+    if (const QImage *image = memory_cache_.object(memory_cache_key)) {
+      return *image;
+    }
+    ScopedPtr<QIODevice> disk_cache_image(disk_cache_->data(DiskCacheKey(hash, size)));
+    if (!disk_cache_image) return QImage();
+    image_data = disk_cache_image->readAll();
+  }
+
+  // Decode without holding the lock, so the other loader threads aren't held up by it.
+  QImage image;
+  if (!image.loadFromData(image_data, "PNG")) return QImage();
+
+  QMutexLocker l(&mutex_);
+  memory_cache_.insert(memory_cache_key, new QImage(image), static_cast<int>(image.sizeInBytes() / 1024));
+
+  return image;
+
+}
+
+void AlbumCoverThumbnailStore::AddThumbnail(const QByteArray &hash, const int size, const QImage &image) {
+
+  if (image.isNull()) return;
+
+  // Encode without holding the lock, only the cache bookkeeping is serialized.
+  QByteArray image_data;
+  {
+    QBuffer buffer(&image_data);
+    if (!buffer.open(QIODevice::WriteOnly) || !image.save(&buffer, "PNG")) {
+      image_data.clear();
+    }
+  }
+
+  QMutexLocker l(&mutex_);
+
+  memory_cache_.insert(MemoryCacheKey(hash, size), new QImage(image), static_cast<int>(image.sizeInBytes() / 1024));
+
+  if (image_data.isEmpty()) return;
+
+  const QUrl disk_cache_key = DiskCacheKey(hash, size);
+  QNetworkCacheMetaData disk_cache_metadata;
+  disk_cache_metadata.setSaveToDisk(true);
+  disk_cache_metadata.setUrl(disk_cache_key);
+  // Qt 6 ignores any entry without headers, so add a fake header.
+  disk_cache_metadata.setRawHeaders(QNetworkCacheMetaData::RawHeaderList() << qMakePair(QByteArray("cover-thumbnail"), hash));
+  QIODevice *device = disk_cache_->prepare(disk_cache_metadata);
+  if (device) {
+    if (device->write(image_data) == image_data.size()) {
+      disk_cache_->insert(device);
+    }
+    else {
+      disk_cache_->remove(disk_cache_key);
+    }
+  }
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ALBUMCOVERTHUMBNAILSTORE_H
+#define ALBUMCOVERTHUMBNAILSTORE_H
+
+#include "config.h"
+
+#include <QMutex>
+#include <QCache>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QImage>
+#include <QSize>
+
+#include "includes/scoped_ptr.h"
+
+class QNetworkDiskCache;
+
+// Cover thumbnails in a few fixed sizes, keyed by a hash of the cover image data.
+// Thumbnails are kept in memory and on disk, so each cover is decoded and scaled at most once per size, also across sessions.
+// Since the key is the content of the cover, changed covers simply get new entries and old ones expire from the cache.
+// All functions are thread-safe.
+class AlbumCoverThumbnailStore {
+ public:
+  explicit AlbumCoverThumbnailStore();
+  ~AlbumCoverThumbnailStore();
+
+  // Returns the size of the smallest thumbnail that covers the given size, or 0 if the size is larger than all thumbnails.
+  static int ThumbnailSize(const QSize size);
+
+  static QByteArray ImageDataHash(const QByteArray &image_data);
+
+  QImage Thumbnail(const QByteArray &hash, const int size);
+  void AddThumbnail(const QByteArray &hash, const int size, const QImage &image);
+
+ private:
+  static QString MemoryCacheKey(const QByteArray &hash, const int size);
+  static QUrl DiskCacheKey(const QByteArray &hash, const int size);
+
+  QMutex mutex_;
+  QCache<QString, QImage> memory_cache_;
+  ScopedPtr<QNetworkDiskCache> disk_cache_;
+};
+
+#endif  // ALBUMCOVERTHUMBNAILSTORE_H
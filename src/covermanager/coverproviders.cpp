@@ -35,12 +35,13 @@
 #include "core/settings.h"
 #include "coverprovider.h"
 #include "coverproviders.h"
+#include "coversearchcache.h"
 
 #include "constants/coverssettings.h"
 
 int CoverProviders::NextOrderId = 0;
 
-CoverProviders::CoverProviders(QObject *parent) : QObject(parent) {}
+CoverProviders::CoverProviders(QObject *parent) : QObject(parent), search_cache_(new CoverSearchCache(this)) {}
 
 CoverProviders::~CoverProviders() {
 
@@ -33,6 +33,7 @@
 #include <QAtomicInt>
 
 class CoverProvider;
+class CoverSearchCache;
 
 // This is a repository for cover providers.
 // Providers are automatically unregistered from the repository when they are deleted.  The class is thread safe.
@@ -59,6 +60,9 @@ class CoverProviders : public QObject {
 
   int NextId();
 
+  // Outcome of previous searches and statistics for the providers, only to be used from the GUI thread.
+  CoverSearchCache *search_cache() const { return search_cache_; }
+
  private Q_SLOTS:
   void ProviderDestroyed();
 
@@ -71,6 +75,8 @@ class CoverProviders : public QObject {
   QMutex mutex_;
 
   QAtomicInt next_id_;
+
+  CoverSearchCache *search_cache_;
 };
 
 #endif  // COVERPROVIDERS_H
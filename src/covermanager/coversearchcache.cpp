@@ -0,0 +1,273 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <chrono>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QTimer>
+#include <QFile>
+#include <QIODevice>
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <QUrl>
+#include <QSize>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QJsonValue>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "core/logging.h"
+#include "core/standardpaths.h"
+#include "albumcoverfetcher.h"
+#include "coversearchcache.h"
+
+using namespace std::chrono_literals;
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr char kCacheFilename[] = "coversearch.cache";
+constexpr qint64 kFoundTtlSec = 180LL * 24LL * 60LL * 60LL;
+constexpr qint64 kMissingTtlSec = 30LL * 24LL * 60LL * 60LL;
+constexpr double kLatencyWeight = 0.1;
+constexpr quint64 kExploreInterval = 10;
+}  // namespace
+
+CoverSearchCache::CoverSearchCache(QObject *parent)
+    : QObject(parent),
+      timer_write_(new QTimer(this)),
+      filename_(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + QLatin1Char('/') + QLatin1String(kCacheFilename)),
+      dirty_(false),
+      batch_searches_(0) {
+
+  ReadCache();
+
+  timer_write_->setSingleShot(true);
+  timer_write_->setInterval(30s);
+  QObject::connect(timer_write_, &QTimer::timeout, this, &CoverSearchCache::WriteCache);
+
+}
+
+CoverSearchCache::~CoverSearchCache() {
+
+  if (timer_write_->isActive()) {
+    timer_write_->stop();
+    WriteCache();
+  }
+
+}
+
+QString CoverSearchCache::AlbumKey(const CoverSearchRequest &request) {
+
+  // Searches without an album use the song title, keep those apart from albums with the same name.
+  if (request.album.isEmpty()) {
+    return request.artist.toLower() + "\n\n"_L1 + request.title.toLower();
+  }
+
+  return request.artist.toLower() + QLatin1Char('\n') + request.album.toLower();
+
+}
+
+bool CoverSearchCache::Result(const QString &key, CoverProviderSearchResult *result) const {
+
+  if (!entries_.contains(key)) return false;
+
+  const Entry entry = entries_.value(key);
+  const qint64 ttl = entry.result.image_url.isEmpty() ? kMissingTtlSec : kFoundTtlSec;
+  if (entry.time < QDateTime::currentSecsSinceEpoch() - ttl) return false;
+
+  *result = entry.result;
+
+  return true;
+
+}
+
+void CoverSearchCache::AddResult(const QString &key, const CoverProviderSearchResult &result) {
+
+  Entry entry;
+  entry.time = QDateTime::currentSecsSinceEpoch();
+  entry.result = result;
+  entries_.insert(key, entry);
+
+  if (!result.provider.isEmpty()) {
+    ++provider_statistics_[result.provider].chosen_images;
+  }
+
+  ScheduleWrite();
+
+}
+
+void CoverSearchCache::AddMissing(const QString &key) {
+
+  AddResult(key, CoverProviderSearchResult());
+
+}
+
+void CoverSearchCache::RemoveResult(const QString &key) {
+
+  if (entries_.remove(key) > 0) {
+    ScheduleWrite();
+  }
+
+}
+
+void CoverSearchCache::AddProviderSearch(const QString &provider, const qint64 latency_msec, const bool success) {
+
+  ProviderStatistics &statistics = provider_statistics_[provider];
+  if (statistics.searches == 0) {
+    statistics.average_latency_msec = static_cast<double>(latency_msec);
+  }
+  else {
+    statistics.average_latency_msec += kLatencyWeight * (static_cast<double>(latency_msec) - statistics.average_latency_msec);
+  }
+  ++statistics.searches;
+  if (success) ++statistics.successful_searches;
+
+  ScheduleWrite();
+
+}
+
+bool CoverSearchCache::ExploreProviders() {
+
+  return batch_searches_++ % kExploreInterval == kExploreInterval - 1;
+
+}
+
+double CoverSearchCache::ProviderRank(const QString &provider) const {
+
+  // Providers without statistics start in the middle, so they are tried before the ones which rarely give the chosen cover.
+  const ProviderStatistics statistics = provider_statistics_.value(provider);
+  return static_cast<double>(statistics.chosen_images + 1) / static_cast<double>(statistics.searches + 2);
+
+}
+
+void CoverSearchCache::ScheduleWrite() {
+
+  dirty_ = true;
+  if (!timer_write_->isActive()) timer_write_->start();
+
+}
+
+void CoverSearchCache::ReadCache() {
+
+  QFile file(filename_);
+  if (!file.open(QIODevice::ReadOnly)) return;
+  const QByteArray data = file.readAll();
+  file.close();
+
+  if (data.isEmpty()) return;
+
+  QJsonParseError error;
+  const QJsonDocument json_doc = QJsonDocument::fromJson(data, &error);
+  if (error.error != QJsonParseError::NoError || !json_doc.isObject()) {
+    qLog(Error) << "Cover search cache" << filename_ << "is not a JSON object.";
+    return;
+  }
+  const QJsonObject json_obj = json_doc.object();
+
+  const qint64 now = QDateTime::currentSecsSinceEpoch();
+  const QJsonArray json_albums = json_obj["albums"_L1].toArray();
+  for (const QJsonValue &value : json_albums) {
+    const QJsonObject json_album = value.toObject();
+    const QString key = json_album["key"_L1].toString();
+    if (key.isEmpty()) continue;
+    Entry entry;
+    entry.time = json_album["time"_L1].toInteger();
+    entry.result.provider = json_album["provider"_L1].toString();
+    entry.result.artist = json_album["artist"_L1].toString();
+    entry.result.album = json_album["album"_L1].toString();
+    entry.result.image_url = QUrl(json_album["image_url"_L1].toString());
+    entry.result.image_size = QSize(json_album["width"_L1].toInt(), json_album["height"_L1].toInt());
+    entry.result.score_provider = static_cast<float>(json_album["score_provider"_L1].toDouble());
+    entry.result.score_match = static_cast<float>(json_album["score_match"_L1].toDouble());
+    const qint64 ttl = entry.result.image_url.isEmpty() ? kMissingTtlSec : kFoundTtlSec;
+    if (entry.time < now - ttl) continue;
+    entries_.insert(key, entry);
+  }
+
+  const QJsonArray json_providers = json_obj["providers"_L1].toArray();
+  for (const QJsonValue &value : json_providers) {
+    const QJsonObject json_provider = value.toObject();
+    const QString name = json_provider["name"_L1].toString();
+    if (name.isEmpty()) continue;
+    ProviderStatistics statistics;
+    statistics.searches = static_cast<quint64>(json_provider["searches"_L1].toInteger());
+    statistics.successful_searches = static_cast<quint64>(json_provider["successful_searches"_L1].toInteger());
+    statistics.chosen_images = static_cast<quint64>(json_provider["chosen_images"_L1].toInteger());
+    statistics.average_latency_msec = json_provider["average_latency_msec"_L1].toDouble();
+    provider_statistics_.insert(name, statistics);
+  }
+
+  qLog(Debug) << "Loaded" << entries_.count() << "cover search results and statistics for" << provider_statistics_.count() << "cover providers";
+
+}
+
+void CoverSearchCache::WriteCache() {
+
+  if (!dirty_) return;
+
+  QJsonArray json_albums;
+  for (QHash<QString, Entry>::const_iterator it = entries_.constBegin(); it != entries_.constEnd(); ++it) {
+    const Entry &entry = it.value();
+    QJsonObject json_album;
+    json_album.insert("key"_L1, it.key());
+    json_album.insert("time"_L1, entry.time);
+    if (!entry.result.image_url.isEmpty()) {
+      json_album.insert("provider"_L1, entry.result.provider);
+      json_album.insert("artist"_L1, entry.result.artist);
+      json_album.insert("album"_L1, entry.result.album);
+      json_album.insert("image_url"_L1, entry.result.image_url.toString());
+      json_album.insert("width"_L1, entry.result.image_size.width());
+      json_album.insert("height"_L1, entry.result.image_size.height());
+      json_album.insert("score_provider"_L1, entry.result.score_provider);
+      json_album.insert("score_match"_L1, entry.result.score_match);
+    }
+    json_albums.append(json_album);
+  }
+
+  QJsonArray json_providers;
+  for (QMap<QString, ProviderStatistics>::const_iterator it = provider_statistics_.constBegin(); it != provider_statistics_.constEnd(); ++it) {
+    QJsonObject json_provider;
+    json_provider.insert("name"_L1, it.key());
+    json_provider.insert("searches"_L1, static_cast<qint64>(it.value().searches));
+    json_provider.insert("successful_searches"_L1, static_cast<qint64>(it.value().successful_searches));
+    json_provider.insert("chosen_images"_L1, static_cast<qint64>(it.value().chosen_images));
+    json_provider.insert("average_latency_msec"_L1, it.value().average_latency_msec);
+    json_providers.append(json_provider);
+  }
+
+  QJsonObject json_obj;
+  json_obj.insert("albums"_L1, json_albums);
+  json_obj.insert("providers"_L1, json_providers);
+
+  QFile file(filename_);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qLog(Error) << "Unable to open cover search cache file" << filename_ << file.errorString();
+    return;
+  }
+  file.write(QJsonDocument(json_obj).toJson(QJsonDocument::Compact));
+  file.close();
+
+  dirty_ = false;
+
+}
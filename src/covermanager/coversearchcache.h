@@ -0,0 +1,92 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COVERSEARCHCACHE_H
+#define COVERSEARCHCACHE_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QString>
+
+#include "albumcoverfetcher.h"
+
+class QTimer;
+
+// Remembers the outcome of cover searches per album, and rolling statistics per cover provider.
+// Both are written to a file in the cache directory, so a later "Fetch Missing Covers" can skip albums that were already searched,
+// and ask the providers in the order they have been useful.
+class CoverSearchCache : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit CoverSearchCache(QObject *parent = nullptr);
+  ~CoverSearchCache() override;
+
+  struct ProviderStatistics {
+    ProviderStatistics() : searches(0), successful_searches(0), chosen_images(0), average_latency_msec(0.0) {}
+    quint64 searches;
+    quint64 successful_searches;
+    quint64 chosen_images;
+    double average_latency_msec;
+  };
+
+  static QString AlbumKey(const CoverSearchRequest &request);
+
+  // Returns true if the album was searched before and the result hasn't expired, an empty image URL means that no cover was found.
+  bool Result(const QString &key, CoverProviderSearchResult *result) const;
+  void AddResult(const QString &key, const CoverProviderSearchResult &result);
+  void AddMissing(const QString &key);
+  void RemoveResult(const QString &key);
+
+  void AddProviderSearch(const QString &provider, const qint64 latency_msec, const bool success);
+  ProviderStatistics provider_statistics(const QString &provider) const { return provider_statistics_.value(provider); }
+
+  // Estimated chance that a search with the provider gives the chosen cover, used to order the providers for batch searches.
+  double ProviderRank(const QString &provider) const;
+
+  // Returns true every few batch searches, those ask all providers instead of the best ranked ones first.
+  bool ExploreProviders();
+
+ public Q_SLOTS:
+  void WriteCache();
+
+ private:
+  struct Entry {
+    Entry() : time(0) {}
+    qint64 time;
+    CoverProviderSearchResult result;
+  };
+
+  void ReadCache();
+  void ScheduleWrite();
+
+ private:
+  QTimer *timer_write_;
+  QString filename_;
+  bool dirty_;
+  quint64 batch_searches_;
+  QHash<QString, Entry> entries_;
+  QMap<QString, ProviderStatistics> provider_statistics_;
+};
+
+#endif  // COVERSEARCHCACHE_H
@@ -32,6 +32,7 @@ using namespace Qt::Literals::StringLiterals;
 CoverSearchStatistics::CoverSearchStatistics()
     : network_requests_made_(0),
       bytes_transferred_(0),
+      cached_results_(0),
       chosen_images_(0),
       missing_images_(0),
       chosen_width_(0),
@@ -50,6 +51,13 @@ CoverSearchStatistics &CoverSearchStatistics::operator+=(const CoverSearchStatis
   for (const QString &key : std::as_const(keys)) {
     total_images_by_provider_[key] += other.total_images_by_provider_[key];
   }
+  keys = other.searches_by_provider_.keys();
+  for (const QString &key : std::as_const(keys)) {
+    searches_by_provider_[key] += other.searches_by_provider_[key];
+    search_time_by_provider_[key] += other.search_time_by_provider_[key];
+  }
+
+  cached_results_ += other.cached_results_;
 
   chosen_images_ += other.chosen_images_;
   missing_images_ += other.missing_images_;
@@ -70,3 +78,14 @@ QString CoverSearchStatistics::AverageDimensions() const {
   return QString::number(chosen_width_ / chosen_images_) + QLatin1Char('x') + QString::number(chosen_height_ / chosen_images_);
 
 }
+
+QString CoverSearchStatistics::AverageSearchTime(const QString &provider) const {
+
+  const quint64 searches = searches_by_provider_.value(provider);
+  if (searches == 0) {
+    return u"0 ms"_s;
+  }
+
+  return QString::number(search_time_by_provider_.value(provider) / searches) + " ms"_L1;
+
+}
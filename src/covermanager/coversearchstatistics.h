@@ -38,6 +38,10 @@ struct CoverSearchStatistics {
   quint64 bytes_transferred_;
   QMap<QString, quint64> total_images_by_provider_;
   QMap<QString, quint64> chosen_images_by_provider_;
+  QMap<QString, quint64> searches_by_provider_;
+  QMap<QString, quint64> search_time_by_provider_;
+
+  quint64 cached_results_;
 
   quint64 chosen_images_;
   quint64 missing_images_;
@@ -46,6 +50,7 @@ struct CoverSearchStatistics {
   quint64 chosen_height_;
 
   QString AverageDimensions() const;
+  QString AverageSearchTime(const QString &provider) const;
 };
 
 #endif  // COVERSEARCHSTATISTICS_H
@@ -76,6 +76,19 @@ void CoverSearchStatisticsDialog::Show(const CoverSearchStatistics &statistics)
     AddSpacer();
   }
 
+  QStringList searched_providers(statistics.searches_by_provider_.keys());
+  std::sort(searched_providers.begin(), searched_providers.end());
+
+  for (const QString &provider : std::as_const(searched_providers)) {
+    AddLine(tr("Average search time for %1").arg(provider), statistics.AverageSearchTime(provider));
+  }
+
+  if (!searched_providers.isEmpty()) {
+    AddSpacer();
+  }
+
+  AddLine(tr("Albums answered from earlier searches"), QString::number(statistics.cached_results_));
+
   AddLine(tr("Total network requests made"), QString::number(statistics.network_requests_made_));
   AddLine(tr("Average image size"), statistics.AverageDimensions());
   AddLine(tr("Total bytes transferred"), statistics.bytes_transferred_ > 0 ? Utilities::PrettySize(statistics.bytes_transferred_) : u"0 bytes"_s);
@@ -131,6 +131,7 @@ const char EditTagDialog::kArtDifferentHintText[] = QT_TR_NOOP("Different art ac
 EditTagDialog::EditTagDialog(const SharedPtr<NetworkAccessManager> network,
                              const SharedPtr<TagReaderClient> tagreader_client,
                              const SharedPtr<CollectionBackend> collection_backend,
+                             TagCompletionStore *tag_completion_store,
                              const SharedPtr<AlbumCoverLoader> albumcover_loader,
                              const SharedPtr<CurrentAlbumCoverLoader> current_albumcover_loader,
                              const SharedPtr<CoverProviders> cover_providers,
@@ -290,19 +291,19 @@ EditTagDialog::EditTagDialog(const SharedPtr<NetworkAccessManager> network,
       QKeySequence(QKeySequence::Forward).toString(QKeySequence::NativeText),
       QKeySequence(QKeySequence::MoveToNextPage).toString(QKeySequence::NativeText)));
 
-  new TagCompleter(collection_backend, Playlist::Column::Artist, ui_->artist);
-  new TagCompleter(collection_backend, Playlist::Column::ArtistSort, ui_->artistsort);
-  new TagCompleter(collection_backend, Playlist::Column::Album, ui_->album);
-  new TagCompleter(collection_backend, Playlist::Column::AlbumSort, ui_->albumsort);
-  new TagCompleter(collection_backend, Playlist::Column::AlbumArtist, ui_->albumartist);
-  new TagCompleter(collection_backend, Playlist::Column::AlbumArtistSort, ui_->albumartistsort);
-  new TagCompleter(collection_backend, Playlist::Column::Genre, ui_->genre);
-  new TagCompleter(collection_backend, Playlist::Column::Composer, ui_->composer);
-  new TagCompleter(collection_backend, Playlist::Column::ComposerSort, ui_->composersort);
-  new TagCompleter(collection_backend, Playlist::Column::Performer, ui_->performer);
-  new TagCompleter(collection_backend, Playlist::Column::PerformerSort, ui_->performersort);
-  new TagCompleter(collection_backend, Playlist::Column::Grouping, ui_->grouping);
-  new TagCompleter(collection_backend, Playlist::Column::TitleSort, ui_->titlesort);
+  new TagCompleter(tag_completion_store, Playlist::Column::Artist, ui_->artist);
+  new TagCompleter(tag_completion_store, Playlist::Column::ArtistSort, ui_->artistsort);
+  new TagCompleter(tag_completion_store, Playlist::Column::Album, ui_->album);
+  new TagCompleter(tag_completion_store, Playlist::Column::AlbumSort, ui_->albumsort);
+  new TagCompleter(tag_completion_store, Playlist::Column::AlbumArtist, ui_->albumartist);
+  new TagCompleter(tag_completion_store, Playlist::Column::AlbumArtistSort, ui_->albumartistsort);
+  new TagCompleter(tag_completion_store, Playlist::Column::Genre, ui_->genre);
+  new TagCompleter(tag_completion_store, Playlist::Column::Composer, ui_->composer);
+  new TagCompleter(tag_completion_store, Playlist::Column::ComposerSort, ui_->composersort);
+  new TagCompleter(tag_completion_store, Playlist::Column::Performer, ui_->performer);
+  new TagCompleter(tag_completion_store, Playlist::Column::PerformerSort, ui_->performersort);
+  new TagCompleter(tag_completion_store, Playlist::Column::Grouping, ui_->grouping);
+  new TagCompleter(tag_completion_store, Playlist::Column::TitleSort, ui_->titlesort);
 
 }
 
@@ -65,6 +65,7 @@ class TrackSelectionDialog;
 class TagFetcher;
 #endif
 class LyricsFetcher;
+class TagCompletionStore;
 
 class EditTagDialog : public QDialog {
   Q_OBJECT
@@ -73,6 +74,7 @@ class EditTagDialog : public QDialog {
   explicit EditTagDialog(const SharedPtr<NetworkAccessManager> network,
                          const SharedPtr<TagReaderClient> tagreader_client,
                          const SharedPtr<CollectionBackend> collection_backend,
+                         TagCompletionStore *tag_completion_store,
                          const SharedPtr<AlbumCoverLoader> albumcover_loader,
                          const SharedPtr<CurrentAlbumCoverLoader> current_albumcover_loader,
                          const SharedPtr<CoverProviders> cover_providers,
@@ -0,0 +1,115 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <chrono>
+
+#include <QWidget>
+#include <QDialog>
+#include <QTimer>
+#include <QFile>
+#include <QIODevice>
+#include <QString>
+#include <QFont>
+#include <QJsonDocument>
+#include <QFileDialog>
+#include <QPushButton>
+#include <QShowEvent>
+#include <QHideEvent>
+
+#include "playbackmetricsdialog.h"
+
+#include "includes/shared_ptr.h"
+#include "core/player.h"
+#include "engine/enginebase.h"
+
+using namespace std::chrono_literals;
+using namespace Qt::Literals::StringLiterals;
+
+PlaybackMetricsDialog::PlaybackMetricsDialog(const SharedPtr<Player> player, QWidget *parent)
+    : QDialog(parent),
+      ui_{},
+      player_(player),
+      timer_refresh_(new QTimer(this)) {
+
+  ui_.setupUi(this);
+
+  setWindowFlags(windowFlags() | Qt::WindowMaximizeButtonHint);
+
+  QFont font(u"Monospace"_s);
+  font.setStyleHint(QFont::TypeWriter);
+  ui_.output->setFont(font);
+
+  timer_refresh_->setInterval(1s);
+  QObject::connect(timer_refresh_, &QTimer::timeout, this, &PlaybackMetricsDialog::Refresh);
+
+  QObject::connect(ui_.reset, &QPushButton::clicked, this, &PlaybackMetricsDialog::Reset);
+  QObject::connect(ui_.save, &QPushButton::clicked, this, &PlaybackMetricsDialog::Save);
+  QObject::connect(ui_.close, &QPushButton::clicked, this, &PlaybackMetricsDialog::close);
+
+}
+
+void PlaybackMetricsDialog::showEvent(QShowEvent *e) {
+
+  Refresh();
+  timer_refresh_->start();
+
+  QDialog::showEvent(e);
+
+}
+
+void PlaybackMetricsDialog::hideEvent(QHideEvent *e) {
+
+  timer_refresh_->stop();
+
+  QDialog::hideEvent(e);
+
+}
+
+void PlaybackMetricsDialog::Refresh() {
+
+  const QString text = QString::fromUtf8(QJsonDocument(player_->engine()->playback_metrics()).toJson(QJsonDocument::Indented));
+  if (text != ui_.output->toPlainText()) {
+    ui_.output->setPlainText(text);
+  }
+
+}
+
+void PlaybackMetricsDialog::Reset() {
+
+  player_->engine()->ResetPlaybackMetrics();
+  Refresh();
+
+}
+
+void PlaybackMetricsDialog::Save() {
+
+  const QString filename = QFileDialog::getSaveFileName(this, tr("Save playback metrics"), u"playback-metrics.json"_s, tr("JSON files (*.json)"));
+  if (filename.isEmpty()) return;
+
+  QFile file(filename);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    Q_EMIT Error(tr("Could not open file %1 for writing: %2").arg(filename, file.errorString()));
+    return;
+  }
+  file.write(QJsonDocument(player_->engine()->playback_metrics()).toJson(QJsonDocument::Indented));
+  file.close();
+
+}
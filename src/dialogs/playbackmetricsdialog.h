@@ -0,0 +1,64 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PLAYBACKMETRICSDIALOG_H
+#define PLAYBACKMETRICSDIALOG_H
+
+#include "config.h"
+
+#include <QObject>
+#include <QWidget>
+#include <QDialog>
+#include <QString>
+
+#include "ui_playbackmetricsdialog.h"
+
+#include "includes/shared_ptr.h"
+
+class QTimer;
+class QShowEvent;
+class QHideEvent;
+class Player;
+
+// Shows the playback metrics of the engine as JSON, and saves them to a file.
+class PlaybackMetricsDialog : public QDialog {
+  Q_OBJECT
+
+ public:
+  explicit PlaybackMetricsDialog(const SharedPtr<Player> player, QWidget *parent = nullptr);
+
+ protected:
+  void showEvent(QShowEvent *e) override;
+  void hideEvent(QHideEvent *e) override;
+
+ private Q_SLOTS:
+  void Refresh();
+  void Reset();
+  void Save();
+
+ Q_SIGNALS:
+  void Error(const QString &error);
+
+ private:
+  Ui::PlaybackMetricsDialog ui_;
+  const SharedPtr<Player> player_;
+  QTimer *timer_refresh_;
+};
+
+#endif  // PLAYBACKMETRICSDIALOG_H
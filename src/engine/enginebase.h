@@ -37,6 +37,7 @@
 #include <QVariant>
 #include <QString>
 #include <QUrl>
+#include <QJsonObject>
 
 #include "core/enginemetadata.h"
 #include "core/song.h"
@@ -118,6 +119,10 @@ class EngineBase : public QObject {
   virtual bool ALSADeviceSupport(const QString &output) const = 0;
   virtual bool ExclusiveModeSupport(const QString &output) const = 0;
 
+  // Aggregated playback latency and dropout measurements since the engine was created or the metrics were reset.
+  virtual QJsonObject playback_metrics() const { return QJsonObject(); }
+  virtual void ResetPlaybackMetrics() {}
+
   // Plays a media stream represented with the URL 'u' from the given 'beginning' to the given 'end' (usually from 0 to a song's length).
   // Both markers should be passed in nanoseconds. 'end' can be negative, indicating that the real length of 'u' stream is unknown.
   bool Play(const QUrl &media_url, const QUrl &stream_url, const bool pause, const TrackChangeFlags flags, const bool force_stop_at_end, const quint64 beginning_offset_nanosec, const qint64 end_offset_nanosec, const quint64 offset_nanosec, const std::optional<double> ebur128_integrated_loudness_lufs);
@@ -61,7 +61,9 @@
 #include "gstengine.h"
 #include "gstenginepipeline.h"
 #include "gstbufferconsumer.h"
+#include "playbackmetrics.h"
 
+using std::make_shared;
 using namespace Qt::Literals::StringLiterals;
 
 #ifdef __clang__
@@ -89,6 +91,7 @@ constexpr int kDiscoveryTimeoutS = 10;
 constexpr qint64 kTimerIntervalNanosec = 1000 * kNsecPerMsec;  // 1s
 constexpr qint64 kPreloadGapNanosec = 8000 * kNsecPerMsec;     // 8s
 constexpr qint64 kSeekDelayNanosec = 100 * kNsecPerMsec;       // 100msec
+constexpr int kSparePipelineDelayMsec = 2000;
 }  // namespace
 
 #ifdef __clang_
@@ -100,6 +103,10 @@ GstEngine::GstEngine(SharedPtr<TaskManager> task_manager, QObject *parent)
       task_manager_(task_manager),
       discoverer_(nullptr),
       buffering_task_id_(-1),
+      timer_spare_pipeline_(new QTimer(this)),
+      playback_metrics_(make_shared<PlaybackMetrics>()),
+      first_sample_pipeline_id_(-1),
+      first_sample_spare_pipeline_(false),
       latest_buffer_(nullptr),
       stereo_balancer_enabled_(false),
       stereo_balance_(0.0F),
@@ -123,6 +130,10 @@ GstEngine::GstEngine(SharedPtr<TaskManager> task_manager, QObject *parent)
   seek_timer_->setInterval(kSeekDelayNanosec / kNsecPerMsec);
   QObject::connect(seek_timer_, &QTimer::timeout, this, &GstEngine::SeekNow);
 
+  timer_spare_pipeline_->setSingleShot(true);
+  timer_spare_pipeline_->setInterval(kSparePipelineDelayMsec);
+  QObject::connect(timer_spare_pipeline_, &QTimer::timeout, this, &GstEngine::PrepareSparePipeline);
+
   GstEngine::ReloadSettings();
 
 }
@@ -130,6 +141,8 @@ GstEngine::GstEngine(SharedPtr<TaskManager> task_manager, QObject *parent)
 GstEngine::~GstEngine() {
 
   current_pipeline_.reset();
+  spare_pipeline_.reset();
+  old_spare_pipelines_.clear();
 
   if (latest_buffer_) {
     gst_buffer_unref(latest_buffer_);
@@ -155,6 +168,8 @@ GstEngine::~GstEngine() {
 
 bool GstEngine::Init() {
 
+  ScheduleSparePipeline();
+
   return true;
 
 }
@@ -219,9 +234,14 @@ bool GstEngine::Load(const QUrl &media_url, const QUrl &stream_url, const Engine
     }
   }
 
+  first_sample_timer_.start();
+  first_sample_spare_pipeline_ = false;
+
   GstEnginePipelinePtr pipeline = CreatePipeline(media_url, stream_url, gst_url.url, static_cast<qint64>(beginning_offset_nanosec), force_stop_at_end ? end_offset_nanosec : 0, ebur128_loudness_normalizing_gain_db_);
   if (!pipeline) return false;
 
+  first_sample_pipeline_id_ = pipeline->id();
+
   // Set the source device if one was extracted from the URL
   if (!gst_url.source_device.isEmpty()) {
     pipeline->SetSourceDevice(gst_url.source_device);
@@ -267,6 +287,8 @@ bool GstEngine::Load(const QUrl &media_url, const QUrl &stream_url, const Engine
     }
   }
 
+  ScheduleSparePipeline();
+
   return true;
 
 }
@@ -535,6 +557,12 @@ void GstEngine::ReloadSettings() {
 
   if (output_.isEmpty()) output_ = QLatin1String(kAutoSink);
 
+  // The output, device and most other settings are applied when the pipeline is built.
+  if (spare_pipeline_) {
+    ReleaseSparePipeline();
+    ScheduleSparePipeline();
+  }
+
 #ifdef HAVE_SPOTIFY
   if (current_pipeline_ && old_spotify_access_token != spotify_access_token_) {
     current_pipeline_->set_spotify_access_token(spotify_access_token_);
@@ -553,10 +581,23 @@ void GstEngine::ConsumeBuffer(GstBuffer *buffer, const int pipeline_id, const QS
 
 }
 
+QJsonObject GstEngine::playback_metrics() const {
+
+  return playback_metrics_->ToJson();
+
+}
+
+void GstEngine::ResetPlaybackMetrics() {
+
+  playback_metrics_->Reset();
+
+}
+
 void GstEngine::SetStereoBalancerEnabled(const bool enabled) {
 
   stereo_balancer_enabled_ = enabled;
   if (current_pipeline_) current_pipeline_->set_stereo_balancer_enabled(enabled);
+  if (spare_pipeline_) spare_pipeline_->set_stereo_balancer_enabled(enabled);
 
 }
 
@@ -571,6 +612,7 @@ void GstEngine::SetEqualizerEnabled(const bool enabled) {
 
   equalizer_enabled_ = enabled;
   if (current_pipeline_) current_pipeline_->set_equalizer_enabled(enabled);
+  if (spare_pipeline_) spare_pipeline_->set_equalizer_enabled(enabled);
 
 }
 
@@ -587,6 +629,7 @@ void GstEngine::AddBufferConsumer(GstBufferConsumer *consumer) {
 
   buffer_consumers_ << consumer;
   if (current_pipeline_) current_pipeline_->AddBufferConsumer(consumer);
+  if (spare_pipeline_) spare_pipeline_->AddBufferConsumer(consumer);
 
 }
 
@@ -594,6 +637,7 @@ void GstEngine::RemoveBufferConsumer(GstBufferConsumer *consumer) {
 
   buffer_consumers_.removeAll(consumer);
   if (current_pipeline_) current_pipeline_->RemoveBufferConsumer(consumer);
+  if (spare_pipeline_) spare_pipeline_->RemoveBufferConsumer(consumer);
 
 }
 
@@ -638,6 +682,13 @@ void GstEngine::EndOfStreamReached(const int pipeline_id, const bool has_next_tr
 
 void GstEngine::HandlePipelineError(const int pipeline_id, const int domain, const int error_code, const QString &message, const QString &debugstr) {
 
+  if (spare_pipeline_ && spare_pipeline_->id() == pipeline_id) {
+    // Nothing is played by the spare pipeline, the error will be reported again if a pipeline for a track fails the same way.
+    qLog(Warning) << "Spare pipeline failed:" << domain << error_code << message;
+    ReleaseSparePipeline();
+    return;
+  }
+
   qLog(Error) << "GStreamer error:" << domain << error_code << message;
 
   Q_EMIT Error(message);
@@ -695,6 +746,13 @@ void GstEngine::AddBufferToScope(GstBuffer *buf, const int pipeline_id, const QS
     return;
   }
 
+  if (pipeline_id == first_sample_pipeline_id_) {
+    const qint64 time_to_first_sample = first_sample_timer_.elapsed();
+    qLog(Debug) << "Time to first sample for pipeline" << pipeline_id << "was" << time_to_first_sample << "msec," << (first_sample_spare_pipeline_ ? "with" : "without") << "spare pipeline";
+    playback_metrics_->AddTimeToFirstAudio(time_to_first_sample, first_sample_spare_pipeline_);
+    first_sample_pipeline_id_ = -1;
+  }
+
   if (latest_buffer_) {
     gst_buffer_unref(latest_buffer_);
   }
@@ -936,6 +994,7 @@ GstEnginePipelinePtr GstEngine::CreatePipeline() {
   pipeline->set_bs2b_enabled(bs2b_enabled_);
   pipeline->set_strict_ssl_enabled(strict_ssl_enabled_);
   pipeline->set_fading_enabled(fadeout_enabled_ || autocrossfade_enabled_ || fadeout_pause_enabled_);
+  pipeline->set_playback_metrics(playback_metrics_);
 
 #ifdef HAVE_SPOTIFY
   pipeline->set_spotify_access_token(spotify_access_token_);
@@ -961,7 +1020,8 @@ GstEnginePipelinePtr GstEngine::CreatePipeline() {
 
 GstEnginePipelinePtr GstEngine::CreatePipeline(const QUrl &media_url, const QUrl &stream_url, const QByteArray &gst_url, const qint64 beginning_offset_nanosec, const qint64 end_offset_nanosec, const double ebur128_loudness_normalizing_gain_db) {
 
-  GstEnginePipelinePtr ret = CreatePipeline();
+  GstEnginePipelinePtr ret = TakeSparePipeline();
+  if (!ret) ret = CreatePipeline();
   QString error;
   if (!ret->InitFromUrl(media_url, stream_url, gst_url, beginning_offset_nanosec, end_offset_nanosec, ebur128_loudness_normalizing_gain_db, error)) {
     ret.reset();
@@ -974,6 +1034,82 @@ GstEnginePipelinePtr GstEngine::CreatePipeline(const QUrl &media_url, const QUrl
 
 }
 
+GstEnginePipelinePtr GstEngine::TakeSparePipeline() {
+
+  if (!spare_pipeline_) return GstEnginePipelinePtr();
+
+  // The change to READY runs on the state thread pool, don't let it race with the change to PAUSED.
+  if (!spare_pipeline_->exclusive_mode() && !spare_pipeline_->direct_device() && spare_pipeline_->state() != GST_STATE_READY) {
+    ReleaseSparePipeline();
+    return GstEnginePipelinePtr();
+  }
+
+  GstEnginePipelinePtr pipeline = spare_pipeline_;
+  spare_pipeline_.reset();
+  first_sample_spare_pipeline_ = true;
+
+  return pipeline;
+
+}
+
+void GstEngine::ScheduleSparePipeline() {
+
+  if (!spare_pipeline_ && !timer_spare_pipeline_->isActive()) {
+    timer_spare_pipeline_->start();
+  }
+
+}
+
+void GstEngine::PrepareSparePipeline() {
+
+  if (spare_pipeline_) return;
+
+  // Don't compete with a track which is still starting.
+  if (current_pipeline_ && current_pipeline_->is_buffering()) {
+    ScheduleSparePipeline();
+    return;
+  }
+
+  GstEnginePipelinePtr pipeline = CreatePipeline();
+  QString error;
+  if (!pipeline->InitPipeline(error)) {
+    qLog(Warning) << "Could not create spare pipeline:" << error;
+    pipeline->Finish();
+    return;
+  }
+
+  // Bringing the pipeline to READY opens the audio sink, which is not possible while another pipeline has the device for itself.
+  // A hardware device would also be held by the spare until it plays, so leave those in NULL and open the device when playback starts.
+  if (!pipeline->exclusive_mode() && !pipeline->direct_device()) {
+    pipeline->SetState(GST_STATE_READY);
+  }
+
+  qLog(Debug) << "Prepared spare pipeline" << pipeline->id();
+
+  spare_pipeline_ = pipeline;
+
+}
+
+void GstEngine::ReleaseSparePipeline() {
+
+  timer_spare_pipeline_->stop();
+
+  if (!spare_pipeline_) return;
+
+  GstEnginePipelinePtr pipeline = spare_pipeline_;
+  spare_pipeline_.reset();
+
+  const int pipeline_id = pipeline->id();
+  QObject::disconnect(&*pipeline, nullptr, this, nullptr);
+  if (!pipeline->Finish()) {
+    old_spare_pipelines_.insert(pipeline_id, pipeline);
+    QObject::connect(&*pipeline, &GstEnginePipeline::Finished, this, [this, pipeline_id]() {
+      old_spare_pipelines_.remove(pipeline_id);
+    });
+  }
+
+}
+
 void GstEngine::FinishPipeline(GstEnginePipelinePtr pipeline) {
 
   const int pipeline_id = pipeline->id();
@@ -1227,6 +1363,9 @@ void GstEngine::SetSpotifyAccessToken() {
   if (current_pipeline_) {
     current_pipeline_->set_spotify_access_token(spotify_access_token_);
   }
+  if (spare_pipeline_) {
+    spare_pipeline_->set_spotify_access_token(spotify_access_token_);
+  }
 
 }
 #endif  // HAVE_SPOTIFY
@@ -38,6 +38,8 @@
 #include <QMap>
 #include <QString>
 #include <QUrl>
+#include <QElapsedTimer>
+#include <QJsonObject>
 
 #include "includes/shared_ptr.h"
 #include "enginebase.h"
@@ -48,6 +50,7 @@
 class QTimer;
 class QTimerEvent;
 class TaskManager;
+class PlaybackMetrics;
 
 class GstEngine : public EngineBase, public GstBufferConsumer {
   Q_OBJECT
@@ -86,6 +89,9 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
 
   void ConsumeBuffer(GstBuffer *buffer, const int pipeline_id, const QString &format) override;
 
+  QJsonObject playback_metrics() const override;
+  void ResetPlaybackMetrics() override;
+
  public Q_SLOTS:
   void ReloadSettings() override;
 
@@ -123,6 +129,8 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
 
   void PipelineFinished(const int pipeline_id);
 
+  void PrepareSparePipeline();
+
  private:
   GstUrl FixupUrl(const QUrl &url);
 
@@ -138,6 +146,11 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
 
   void FinishPipeline(GstEnginePipelinePtr pipeline);
 
+  // The spare pipeline has its playbin and audiobin built ahead of time, so a track change only needs to set the URL.
+  GstEnginePipelinePtr TakeSparePipeline();
+  void ScheduleSparePipeline();
+  void ReleaseSparePipeline();
+
   void UpdateScope(int chunk_length);
 
   static void StreamDiscovered(GstDiscoverer *discoverer, GstDiscovererInfo *info, GError *error, gpointer self);
@@ -161,6 +174,16 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
   QMap<int, GstEnginePipelinePtr> fadeout_pipelines_;
   GstEnginePipelinePtr fadeout_pause_pipeline_;
   QMap<int, GstEnginePipelinePtr> old_pipelines_;
+  GstEnginePipelinePtr spare_pipeline_;
+  QMap<int, GstEnginePipelinePtr> old_spare_pipelines_;
+  QTimer *timer_spare_pipeline_;
+
+  SharedPtr<PlaybackMetrics> playback_metrics_;
+
+  // Time from Load() to the first buffer of the new pipeline
+  QElapsedTimer first_sample_timer_;
+  int first_sample_pipeline_id_;
+  bool first_sample_spare_pipeline_;
 
   QList<GstBufferConsumer*> buffer_consumers_;
 
@@ -25,13 +25,16 @@
 
 #include <cstdint>
 #include <cstring>
+#include <ctime>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 
 #include <glib.h>
 #include <glib-object.h>
 #include <gst/gst.h>
 #include <gst/audio/audio.h>
+#include <gst/app/gstappsink.h>
 
 #ifdef Q_OS_UNIX
 #  include <pthread.h>
@@ -68,6 +71,9 @@
 #include "gstengine.h"
 #include "gstenginepipeline.h"
 #include "gstbufferconsumer.h"
+#include "gstvolumefader.h"
+#include "playbackmetrics.h"
+#include "sampleconversion.h"
 
 using namespace std::chrono_literals;
 using namespace Qt::Literals::StringLiterals;
@@ -95,6 +101,35 @@ constexpr int kEqBandFrequencies[] = { 60, 170, 310, 600, 1000, 3000, 6000, 1200
 // When within this many seconds of track end during gapless playback, ignore buffering messages
 constexpr int kIgnoreBufferingNearEndSeconds = 5;
 
+// Decoder CPU time is added to the playback metrics for about this much audio at a time
+constexpr qint64 kDecoderTimeIntervalNanosec = 1000 * kNsecPerMsec;
+
+qint64 MonotonicMsec() {
+
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+}
+
+qint64 ThreadCpuTimeNanosec() {
+
+#ifdef Q_OS_UNIX
+  timespec ts{};
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+    return static_cast<qint64>(ts.tv_sec) * kNsecPerSec + static_cast<qint64>(ts.tv_nsec);
+  }
+#endif
+
+  return -1;
+
+}
+
+// ALSA hw: and plughw: devices are opened by the sink itself, bypassing any sound server.
+bool IsALSAHardwareDevice(const QString &output, const QString &device) {
+
+  return output == QLatin1String(GstEngine::kALSASink) && (device.startsWith("hw:"_L1) || device.startsWith("plughw:"_L1));
+
+}
+
 }  // namespace
 
 #ifdef __clang_
@@ -127,8 +162,10 @@ GstEnginePipeline::GstEnginePipeline(QObject *parent)
       volume_full_range_support_(false),
       playbin3_enabled_(true),
       exclusive_mode_(false),
+      direct_device_(false),
       volume_enabled_(true),
       fading_enabled_(false),
+      offline_render_(false),
       strict_ssl_enabled_(false),
       buffer_duration_nanosec_(BackendSettings::kDefaultBufferDuration * kNsecPerMsec),
       buffer_low_watermark_(BackendSettings::kDefaultBufferLowWatermark),
@@ -174,6 +211,19 @@ GstEnginePipeline::GstEnginePipeline(QObject *parent)
       fader_use_fudge_timer_(false),
       timer_fader_fudge_(new QTimer(this)),
       timer_fader_timeout_(new QTimer(this)),
+      fader_curve_pending_(false),
+      fader_curve_duration_nanosec_(0),
+      fader_curve_progress_from_(0.0),
+      fader_curve_progress_to_(0.0),
+      seek_start_msec_(-1),
+      seek_flushed_(false),
+      buffering_start_msec_(-1),
+      decoder_thread_(nullptr),
+      decoder_thread_cpu_nanosec_(-1),
+      decoder_cpu_nanosec_pending_(0),
+      decoder_audio_nanosec_pending_(0),
+      offline_rendered_nanosec_(0),
+      offline_render_finished_(false),
       pipeline_(nullptr),
       audiobin_(nullptr),
       audiosink_(nullptr),
@@ -261,6 +311,30 @@ void GstEnginePipeline::set_output_device(const QString &output, const QVariant
 
 }
 
+void GstEnginePipeline::set_offline_render(const bool offline_render) {
+
+  offline_render_ = offline_render;
+  if (offline_render_) {
+    output_ = u"appsink"_s;
+    device_ = QVariant();
+  }
+
+}
+
+QByteArray GstEnginePipeline::offline_render_data() const {
+
+  QMutexLocker l(&mutex_offline_render_);
+  return offline_render_data_;
+
+}
+
+qint64 GstEnginePipeline::offline_rendered_nanosec() const {
+
+  QMutexLocker l(&mutex_offline_render_);
+  return offline_rendered_nanosec_;
+
+}
+
 void GstEnginePipeline::set_playbin3_enabled(const bool playbin3_enabled) {
   playbin3_enabled_ = playbin3_enabled;
 }
@@ -444,6 +518,20 @@ void GstEnginePipeline::Disconnect() {
       buffer_probe_cb_id_.reset();
     }
 
+    if (fader_probe_cb_id_.has_value()) {
+      GstPad *pad = gst_element_get_static_pad(volume_fading_, "sink");
+      if (pad) {
+        gst_pad_remove_probe(pad, fader_probe_cb_id_.value());
+        gst_object_unref(pad);
+      }
+      fader_probe_cb_id_.reset();
+    }
+
+    {
+      QMutexLocker l(&mutex_fader_curve_);
+      fader_curve_pending_ = false;
+    }
+
     {
       GstBus *bus = gst_pipeline_get_bus(GST_PIPELINE(pipeline_));
       if (bus) {
@@ -494,6 +582,28 @@ bool GstEnginePipeline::InitFromUrl(const QUrl &media_url, const QUrl &stream_ur
   end_offset_nanosec_ = end_offset_nanosec;
   ebur128_loudness_normalizing_gain_db_ = ebur128_loudness_normalizing_gain_db;
 
+  // The playbin and audiobin may already have been built by InitPipeline() while the pipeline was kept as a spare,
+  // in that case InitAudioBin() ran before the track was known and the per-track settings have to be applied here.
+  if (pipeline_) {
+    UpdateEBUR128LoudnessNormalizingGaindB();
+  }
+  else if (!InitPipeline(error)) {
+    return false;
+  }
+
+  {
+    QMutexLocker l(&mutex_url_);
+    g_object_set(G_OBJECT(pipeline_), "uri", gst_url.constData(), nullptr);
+  }
+
+  pipeline_connected_ = true;
+
+  return true;
+
+}
+
+bool GstEnginePipeline::InitPipeline(QString &error) {
+
   const QString playbin_name = playbin3_support_ && playbin3_enabled_ ? u"playbin3"_s : u"playbin"_s;
   qLog(Debug) << "Using" << playbin_name << "for pipeline";
   pipeline_ = CreateElement(playbin_name, u"pipeline"_s, nullptr, error);
@@ -532,13 +642,6 @@ bool GstEnginePipeline::InitFromUrl(const QUrl &media_url, const QUrl &stream_ur
   flags &= ~GST_PLAY_FLAG_SOFT_VOLUME;
   g_object_set(G_OBJECT(pipeline_), "flags", flags, nullptr);
 
-  {
-    QMutexLocker l(&mutex_url_);
-    g_object_set(G_OBJECT(pipeline_), "uri", gst_url.constData(), nullptr);
-  }
-
-  pipeline_connected_ = true;
-
   return true;
 
 }
@@ -557,6 +660,16 @@ bool GstEnginePipeline::InitAudioBin(QString &error) {
     return false;
   }
 
+  if (offline_render_) {
+    GstCaps *caps = gst_caps_new_simple("audio/x-raw", "format", G_TYPE_STRING, "F32LE", "layout", G_TYPE_STRING, "interleaved", nullptr);
+    g_object_set(G_OBJECT(audiosink_), "sync", FALSE, "caps", caps, nullptr);
+    gst_caps_unref(caps);
+    GstAppSinkCallbacks callbacks{};
+    callbacks.eos = &OfflineRenderEosCallback;
+    callbacks.new_sample = &OfflineRenderNewSampleCallback;
+    gst_app_sink_set_callbacks(GST_APP_SINK(audiosink_), &callbacks, this, nullptr);
+  }
+
   if (device_.isValid()) {
     if (g_object_class_find_property(G_OBJECT_GET_CLASS(audiosink_), "device")) {
       switch (device_.metaType().id()) {
@@ -565,7 +678,8 @@ bool GstEnginePipeline::InitAudioBin(QString &error) {
           if (!device.isEmpty()) {
             qLog(Debug) << "Setting device" << device << "for" << output_;
             g_object_set(G_OBJECT(audiosink_), "device", device.toUtf8().constData(), nullptr);
-            if (output_ == QLatin1String(GstEngine::kALSASink) && (device.startsWith("hw:"_L1) || device.startsWith("plughw:"_L1))) {
+            if (IsALSAHardwareDevice(output_, device)) {
+              direct_device_ = true;
               exclusive_mode_ = true;
             }
           }
@@ -576,6 +690,10 @@ bool GstEnginePipeline::InitAudioBin(QString &error) {
           if (!device.isEmpty()) {
             qLog(Debug) << "Setting device" << device_ << "for" << output_;
             g_object_set(G_OBJECT(audiosink_), "device", device.constData(), nullptr);
+            if (IsALSAHardwareDevice(output_, QString::fromUtf8(device))) {
+              direct_device_ = true;
+              exclusive_mode_ = true;
+            }
           }
           break;
         }
@@ -707,6 +825,7 @@ bool GstEnginePipeline::InitAudioBin(QString &error) {
     if (!volume_fading_) {
       return false;
     }
+    volume_fader_.reset(new GstVolumeFader(volume_fading_));
     if (fader_) {
       SetFaderVolume(fader_->currentValue());
     }
@@ -975,6 +1094,14 @@ bool GstEnginePipeline::InitAudioBin(QString &error) {
     }
   }
 
+  if (volume_fading_) {
+    GstPad *pad = gst_element_get_static_pad(volume_fading_, "sink");
+    if (pad) {
+      fader_probe_cb_id_ = gst_pad_add_probe(pad, static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM), FaderProbeCallback, this, nullptr);
+      gst_object_unref(pad);
+    }
+  }
+
   {
     GstBus *bus = gst_pipeline_get_bus(GST_PIPELINE(pipeline_));
     if (bus) {
@@ -1234,6 +1361,10 @@ GstPadProbeReturn GstEnginePipeline::PadProbeCallback(GstPad *pad, GstPadProbeIn
     }
 
     instance->last_playbin_segment_.position = timestamp;
+
+    if (instance->playback_metrics_ && duration != GST_CLOCK_TIME_NONE) {
+      instance->UpdateDecoderTime(static_cast<qint64>(duration));
+    }
   }
   else if (info_type & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
     GstEvent *event = GST_PAD_PROBE_INFO_EVENT(info);
@@ -1246,6 +1377,9 @@ GstPadProbeReturn GstEnginePipeline::PadProbeCallback(GstPad *pad, GstPadProbeIn
     else if (event_type == GST_EVENT_FLUSH_START) {
       // A flushing seek resets the running time to 0, so remove any offset we set on this pad before.
       gst_pad_set_offset(pad, 0);
+      if (instance->seek_start_msec_.value() != -1) {
+        instance->seek_flushed_ = true;
+      }
     }
   }
 
@@ -1253,10 +1387,115 @@ GstPadProbeReturn GstEnginePipeline::PadProbeCallback(GstPad *pad, GstPadProbeIn
 
 }
 
+void GstEnginePipeline::UpdateDecoderTime(const qint64 audio_nanosec) {
+
+  // The playbin pushes decoded audio into the audiobin from the thread that decodes it, so its CPU time is the decoder time.
+  const qint64 cpu_nanosec = ThreadCpuTimeNanosec();
+  if (cpu_nanosec == -1) return;
+
+  GThread *thread = g_thread_self();
+  if (thread != decoder_thread_ || decoder_thread_cpu_nanosec_ == -1) {
+    decoder_thread_ = thread;
+    decoder_thread_cpu_nanosec_ = cpu_nanosec;
+    return;
+  }
+
+  decoder_cpu_nanosec_pending_ += cpu_nanosec - decoder_thread_cpu_nanosec_;
+  decoder_audio_nanosec_pending_ += audio_nanosec;
+  decoder_thread_cpu_nanosec_ = cpu_nanosec;
+
+  if (decoder_audio_nanosec_pending_ >= kDecoderTimeIntervalNanosec) {
+    playback_metrics_->AddDecoderTime(decoder_cpu_nanosec_pending_, decoder_audio_nanosec_pending_);
+    decoder_cpu_nanosec_pending_ = 0;
+    decoder_audio_nanosec_pending_ = 0;
+  }
+
+}
+
+GstFlowReturn GstEnginePipeline::OfflineRenderNewSampleCallback(GstAppSink *appsink, gpointer self) {
+
+  GstEnginePipeline *instance = reinterpret_cast<GstEnginePipeline*>(self);
+
+  GstSample *sample = gst_app_sink_pull_sample(appsink);
+  if (!sample) return GST_FLOW_ERROR;
+
+  GstBuffer *buffer = gst_sample_get_buffer(sample);
+  if (buffer) {
+    GstMapInfo map_info;
+    if (gst_buffer_map(buffer, &map_info, GST_MAP_READ)) {
+      QMutexLocker l(&instance->mutex_offline_render_);
+      instance->offline_render_data_.append(reinterpret_cast<const char*>(map_info.data), static_cast<qsizetype>(map_info.size));
+      if (GST_BUFFER_DURATION_IS_VALID(buffer)) {
+        instance->offline_rendered_nanosec_ += static_cast<qint64>(GST_BUFFER_DURATION(buffer));
+      }
+      gst_buffer_unmap(buffer, &map_info);
+    }
+  }
+
+  gst_sample_unref(sample);
+
+  return GST_FLOW_OK;
+
+}
+
+void GstEnginePipeline::OfflineRenderEosCallback(GstAppSink *appsink, gpointer self) {
+
+  Q_UNUSED(appsink)
+
+  GstEnginePipeline *instance = reinterpret_cast<GstEnginePipeline*>(self);
+  instance->offline_render_finished_ = true;
+
+}
+
+GstPadProbeReturn GstEnginePipeline::FaderProbeCallback(GstPad *pad, GstPadProbeInfo *info, gpointer self) {
+
+  Q_UNUSED(pad)
+
+  GstEnginePipeline *instance = reinterpret_cast<GstEnginePipeline*>(self);
+
+  QMutexLocker l(&instance->mutex_fader_curve_);
+
+  if (info->type & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
+    GstEvent *event = gst_pad_probe_info_get_event(info);
+    if (GST_EVENT_TYPE(event) == GST_EVENT_SEGMENT) {
+      const GstSegment *segment = nullptr;
+      gst_event_parse_segment(event, &segment);
+      gst_segment_copy_into(segment, &instance->fader_segment_);
+    }
+    return GST_PAD_PROBE_OK;
+  }
+
+  if (!instance->fader_curve_pending_ || !instance->volume_fader_ || instance->fader_segment_.format != GST_FORMAT_TIME) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstBuffer *buffer = gst_pad_probe_info_get_buffer(info);
+  if (!GST_BUFFER_PTS_IS_VALID(buffer)) return GST_PAD_PROBE_OK;
+
+  // The volume element controls the gain by stream time, start the curve at the first sample of this buffer.
+  const GstClockTime stream_time = gst_segment_to_stream_time(&instance->fader_segment_, GST_FORMAT_TIME, GST_BUFFER_PTS(buffer));
+  if (!GST_CLOCK_TIME_IS_VALID(stream_time)) return GST_PAD_PROBE_OK;
+
+  instance->volume_fader_->SetCurve(stream_time, instance->fader_curve_duration_nanosec_, instance->fader_curve_progress_from_, instance->fader_curve_progress_to_, instance->fader_curve_easing_);
+  instance->fader_curve_pending_ = false;
+
+  return GST_PAD_PROBE_OK;
+
+}
+
 GstPadProbeReturn GstEnginePipeline::BufferProbeCallback(GstPad *pad, GstPadProbeInfo *info, gpointer self) {
 
   GstEnginePipeline *instance = reinterpret_cast<GstEnginePipeline*>(self);
 
+  if (instance->seek_flushed_.value()) {
+    const qint64 seek_start_msec = instance->seek_start_msec_.value();
+    if (instance->playback_metrics_ && seek_start_msec != -1) {
+      instance->playback_metrics_->AddSeekLatency(MonotonicMsec() - seek_start_msec);
+    }
+    instance->seek_flushed_ = false;
+    instance->seek_start_msec_ = -1;
+  }
+
   QString format;
   int channels = 1;
   int rate = 0;
@@ -1292,9 +1531,7 @@ GstPadProbeReturn GstEnginePipeline::BufferProbeCallback(GstPad *pad, GstPadProb
     int buf16_size = samples * static_cast<int>(sizeof(int16_t)) * channels;
     int16_t *d = static_cast<int16_t*>(g_malloc(static_cast<gsize>(buf16_size)));
     memset(d, 0, static_cast<size_t>(buf16_size));
-    for (int i = 0; i < (samples * channels); ++i) {
-      d[i] = static_cast<int16_t>((s[i] >> 16));
-    }
+    SampleConversion::S32LEToS16(s, d, samples * channels);
     gst_buffer_unmap(buf, &map_info);
     buf16 = gst_buffer_new_wrapped(d, static_cast<gsize>(buf16_size));
     GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(static_cast<guint64>(samples * sizeof(int16_t) / channels), static_cast<guint64>(rate));
@@ -1313,10 +1550,7 @@ GstPadProbeReturn GstEnginePipeline::BufferProbeCallback(GstPad *pad, GstPadProb
     int buf16_size = samples * static_cast<int>(sizeof(int16_t)) * channels;
     int16_t *d = static_cast<int16_t*>(g_malloc(static_cast<gsize>(buf16_size)));
     memset(d, 0, static_cast<size_t>(buf16_size));
-    for (int i = 0; i < (samples * channels); ++i) {
-      float sample_float = (s[i] * static_cast<float>(32768.0));
-      d[i] = static_cast<int16_t>(sample_float);
-    }
+    SampleConversion::F32LEToS16(s, d, samples * channels);
     gst_buffer_unmap(buf, &map_info);
     buf16 = gst_buffer_new_wrapped(d, static_cast<gsize>(buf16_size));
     GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(static_cast<guint64>(samples * sizeof(int16_t) / channels), static_cast<guint64>(rate));
@@ -1330,16 +1564,11 @@ GstPadProbeReturn GstEnginePipeline::BufferProbeCallback(GstPad *pad, GstPadProb
     gst_buffer_map(buf, &map_info, GST_MAP_READ);
 
     int8_t *s24 = reinterpret_cast<int8_t*>(map_info.data);
-    int8_t *s24e = s24 + map_info.size;
     int samples = static_cast<int>((map_info.size / sizeof(int8_t)) / channels);
     int buf16_size = samples * static_cast<int>(sizeof(int16_t)) * channels;
     int16_t *s16 = static_cast<int16_t*>(g_malloc(static_cast<gsize>(buf16_size)));
     memset(s16, 0, static_cast<size_t>(buf16_size));
-    for (int i = 0; i < (samples * channels); ++i) {
-      s16[i] = *(reinterpret_cast<int16_t*>(s24 + 1));
-      s24 += 3;
-      if (s24 >= s24e) break;
-    }
+    SampleConversion::S24LEToS16(s24, map_info.size, s16, samples * channels);
     gst_buffer_unmap(buf, &map_info);
     buf16 = gst_buffer_new_wrapped(s16, static_cast<gsize>(buf16_size));
     GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(static_cast<guint64>(samples * sizeof(int16_t) / channels), static_cast<guint64>(rate));
@@ -1353,18 +1582,11 @@ GstPadProbeReturn GstEnginePipeline::BufferProbeCallback(GstPad *pad, GstPadProb
     gst_buffer_map(buf, &map_info, GST_MAP_READ);
 
     int32_t *s32 = reinterpret_cast<int32_t*>(map_info.data);
-    int32_t *s32e = s32 + map_info.size;
-    int32_t *s32p = s32;
     int samples = static_cast<int>((map_info.size / sizeof(int32_t)) / channels);
     int buf16_size = samples * static_cast<int>(sizeof(int16_t)) * channels;
     int16_t *s16 = static_cast<int16_t*>(g_malloc(static_cast<gsize>(buf16_size)));
     memset(s16, 0, static_cast<size_t>(buf16_size));
-    for (int i = 0; i < (samples * channels); ++i) {
-      int8_t *s24 = reinterpret_cast<int8_t*>(s32p);
-      s16[i] = *(reinterpret_cast<int16_t*>(s24 + 1));
-      ++s32p;
-      if (s32p > s32e) break;
-    }
+    SampleConversion::S24_32LEToS16(s32, s16, samples * channels);
     gst_buffer_unmap(buf, &map_info);
     buf16 = gst_buffer_new_wrapped(s16, static_cast<gsize>(buf16_size));
     GST_BUFFER_DURATION(buf16) = GST_FRAMES_TO_CLOCK_TIME(static_cast<guint64>(samples * sizeof(int16_t) / channels), static_cast<guint64>(rate));
@@ -1491,6 +1713,10 @@ GstBusSyncReply GstEnginePipeline::BusSyncCallback(GstBus *bus, GstMessage *msg,
       instance->StreamStartMessageReceived();
       break;
 
+    case GST_MESSAGE_QOS:
+      instance->QosMessageReceived(msg);
+      break;
+
     default:
       break;
   }
@@ -1804,6 +2030,10 @@ void GstEnginePipeline::BufferingMessageReceived(GstMessage *msg) {
   int percent = 0;
   gst_message_parse_buffering(msg, &percent);
 
+  if (playback_metrics_) {
+    playback_metrics_->AddBufferFillLevel(percent, buffer_low_watermark_, buffer_high_watermark_);
+  }
+
   const GstState current_state = state();
 
   if (percent < 100 && !buffering_.value()) {
@@ -1821,6 +2051,8 @@ void GstEnginePipeline::BufferingMessageReceived(GstMessage *msg) {
 
     qLog(Debug) << "Buffering started";
     buffering_ = true;
+    buffering_start_msec_ = MonotonicMsec();
+    if (playback_metrics_) playback_metrics_->AddBufferingStarted();
     Q_EMIT BufferingStarted();
     if (current_state == GST_STATE_PLAYING) {
       SetStateAsync(GST_STATE_PAUSED);
@@ -1832,6 +2064,10 @@ void GstEnginePipeline::BufferingMessageReceived(GstMessage *msg) {
   else if (percent == 100 && buffering_.value()) {
     qLog(Debug) << "Buffering finished";
     buffering_ = false;
+    if (playback_metrics_ && buffering_start_msec_.value() != -1) {
+      playback_metrics_->AddBufferingFinished(MonotonicMsec() - buffering_start_msec_.value());
+    }
+    buffering_start_msec_ = -1;
     Q_EMIT BufferingFinished();
     if (pending_seek_nanosec_.value() != -1 && !next_uri_need_reset_.value()) {
       ProcessPendingSeek(state());
@@ -1847,6 +2083,37 @@ void GstEnginePipeline::BufferingMessageReceived(GstMessage *msg) {
 
 }
 
+void GstEnginePipeline::QosMessageReceived(GstMessage *msg) {
+
+  // Only the audio sink drops samples when it can't keep up, the sink of the autoaudiosink is a child element.
+  if (!playback_metrics_ || !audiosink_ || (GST_MESSAGE_SRC(msg) != GST_OBJECT(audiosink_) && !gst_object_has_as_ancestor(GST_MESSAGE_SRC(msg), GST_OBJECT(audiosink_)))) {
+    return;
+  }
+
+  GstFormat format = GST_FORMAT_UNDEFINED;
+  guint64 processed = 0;
+  guint64 dropped = 0;
+  gst_message_parse_qos_stats(msg, &format, &processed, &dropped);
+
+  qLog(Debug) << "Audio sink QoS, processed" << processed << "dropped" << dropped;
+
+  if (dropped == static_cast<guint64>(-1)) dropped = 0;
+
+  guint64 dropped_new = dropped;
+  {
+    QMutexLocker l(&mutex_qos_);
+    const guint64 dropped_last = qos_dropped_.value(GST_MESSAGE_SRC(msg), 0);
+    // The sink resets the total when it is flushed.
+    if (dropped >= dropped_last) dropped_new = dropped - dropped_last;
+    qos_dropped_.insert(GST_MESSAGE_SRC(msg), dropped);
+  }
+
+  if (dropped_new > 0) {
+    playback_metrics_->AddSinkXrun(dropped_new);
+  }
+
+}
+
 GstState GstEnginePipeline::state() const {
 
   GstState s = GST_STATE_NULL, sp = GST_STATE_NULL;
@@ -2005,8 +2272,15 @@ bool GstEnginePipeline::Seek(const qint64 nanosec) {
 
   qLog(Debug) << "Seeking to" << nanosec;
 
+  seek_flushed_ = false;
+  seek_start_msec_ = MonotonicMsec();
+
   const bool success = gst_element_seek_simple(pipeline_, GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH, nanosec);
 
+  if (!success) {
+    seek_start_msec_ = -1;
+  }
+
   if (success) {
     qLog(Debug) << "Seek succeeded";
     if (pending_state_.value() != GST_STATE_NULL) {
@@ -2172,7 +2446,6 @@ void GstEnginePipeline::StartFader(const qint64 duration_nanosec, const QTimeLin
     }
     timeline->deleteLater();
   });
-  QObject::connect(&*fader_, &QTimeLine::valueChanged, this, &GstEnginePipeline::SetFaderVolume);
   QObject::connect(&*fader_, &QTimeLine::stateChanged, this, &GstEnginePipeline::FaderTimelineStateChanged);
   QObject::connect(&*fader_, &QTimeLine::finished, this, &GstEnginePipeline::FaderTimelineFinished);
   fader_->setDirection(direction);
@@ -2187,6 +2460,15 @@ void GstEnginePipeline::StartFader(const qint64 duration_nanosec, const QTimeLin
 
   SetFaderVolume(fader_->currentValue());
 
+  if (volume_fader_) {
+    QMutexLocker l(&mutex_fader_curve_);
+    fader_curve_pending_ = true;
+    fader_curve_duration_nanosec_ = duration_nanosec;
+    fader_curve_progress_from_ = duration_msec > 0 ? static_cast<qreal>(start_time) / static_cast<qreal>(duration_msec) : 1.0;
+    fader_curve_progress_to_ = direction == QTimeLine::Direction::Forward ? 1.0 : 0.0;
+    fader_curve_easing_ = QEasingCurve(shape);
+  }
+
   qLog(Debug) << "Pipeline" << id() << "with state" << GstStateText(state()) << "set to fade from" << fader_->currentValue() << "time" << start_time << "direction" << (direction == QTimeLine::Direction::Forward ? "forward" : "backward");
 
   if (pipeline_active_.value()) {
@@ -2197,8 +2479,10 @@ void GstEnginePipeline::StartFader(const qint64 duration_nanosec, const QTimeLin
 
 void GstEnginePipeline::SetFaderVolume(const qreal volume) {
 
-  if (volume_fading_) {
-    g_object_set(G_OBJECT(volume_fading_), "volume", volume, nullptr);
+  if (volume_fader_) {
+    QMutexLocker l(&mutex_fader_curve_);
+    fader_curve_pending_ = false;
+    volume_fader_->SetVolume(volume);
   }
 
 }
@@ -2238,9 +2522,9 @@ void GstEnginePipeline::FaderTimelineTimeout() {
 
   qLog(Debug) << "Pipeline" << id() << "fading timed out";
 
-  if (volume_fading_) {
+  if (volume_fader_) {
     qLog(Debug) << "Pipeline" << id() << "setting volume" << (fader_->direction() == QTimeLine::Direction::Forward ? 1.0 : 0.0);
-    g_object_set(G_OBJECT(volume_fading_), "volume", fader_->direction() == QTimeLine::Direction::Forward ? 1.0 : 0.0, nullptr);
+    SetFaderVolume(fader_->direction() == QTimeLine::Direction::Forward ? 1.0 : 0.0);
   }
 
   FaderTimelineFinished();
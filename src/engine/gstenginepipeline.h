@@ -30,6 +30,7 @@
 #include <glib-object.h>
 #include <glib/gtypes.h>
 #include <gst/gst.h>
+#include <gst/app/gstappsink.h>
 
 #include <QtGlobal>
 #include <QObject>
@@ -39,6 +40,7 @@
 #include <QTimeLine>
 #include <QEasingCurve>
 #include <QList>
+#include <QHash>
 #include <QByteArray>
 #include <QVariant>
 #include <QString>
@@ -46,11 +48,14 @@
 #include <QSharedPointer>
 
 #include "includes/shared_ptr.h"
+#include "includes/scoped_ptr.h"
 #include "includes/mutex_protected.h"
 #include "core/enginemetadata.h"
 
 class QTimer;
 class GstBufferConsumer;
+class GstVolumeFader;
+class PlaybackMetrics;
 struct GstPlayBin;
 
 class GstEnginePipeline : public QObject {
@@ -80,13 +85,25 @@ class GstEnginePipeline : public QObject {
   void set_bs2b_enabled(const bool enabled);
   void set_strict_ssl_enabled(const bool enabled);
   void set_fading_enabled(const bool enabled);
+  void set_playback_metrics(SharedPtr<PlaybackMetrics> playback_metrics) { playback_metrics_ = playback_metrics; }
+
+  // Renders to an appsink as fast as possible instead of playing on the output, for tests and benchmarks.
+  // The rendered audio is kept in memory as interleaved 32-bit float samples.
+  void set_offline_render(const bool offline_render);
+  bool offline_render_finished() const { return offline_render_finished_.value(); }
+  QByteArray offline_render_data() const;
+  qint64 offline_rendered_nanosec() const;
 #ifdef HAVE_SPOTIFY
   void set_spotify_access_token(const QString &spotify_access_token);
 #endif
 
   bool Finish();
 
-  // Creates the pipeline, returns false on error
+  // Creates the playbin and audiobin without a URL, returns false on error
+  bool InitPipeline(QString &error);
+  bool is_initialized() const { return pipeline_ != nullptr; }
+
+  // Creates the pipeline unless InitPipeline() already did, and sets the URL, returns false on error
   bool InitFromUrl(const QUrl &media_url, const QUrl &stream_url, const QByteArray &gst_url, const qint64 beginning_offset_nanosec, const qint64 end_offset_nanosec, const double ebur128_loudness_normalizing_gain_db, QString &error);
 
   // GstBufferConsumers get fed audio data.  Thread-safe.
@@ -139,6 +156,8 @@ class GstEnginePipeline : public QObject {
   bool is_buffering() const { return buffering_.value(); }
 
   bool exclusive_mode() const { return exclusive_mode_; }
+  // The sink opens a hardware device directly, so the device is held from READY until the pipeline goes back to NULL.
+  bool direct_device() const { return direct_device_; }
 
   QByteArray redirect_url() const { return redirect_url_; }
   QMutex *mutex_redirect_url() { return &mutex_redirect_url_; }
@@ -170,6 +189,8 @@ class GstEnginePipeline : public QObject {
   static GstPadProbeReturn UpstreamEventsProbeCallback(GstPad *pad, GstPadProbeInfo *info, gpointer self);
   static GstPadProbeReturn BufferProbeCallback(GstPad *pad, GstPadProbeInfo *info, gpointer self);
   static GstPadProbeReturn PadProbeCallback(GstPad *pad, GstPadProbeInfo *info, gpointer self);
+  void UpdateDecoderTime(const qint64 audio_nanosec);
+  static GstPadProbeReturn FaderProbeCallback(GstPad *pad, GstPadProbeInfo *info, gpointer self);
   static void ElementAddedCallback(GstBin *bin, GstBin *sub_bin, GstElement *element, gpointer self);
   static void ElementRemovedCallback(GstBin *bin, GstBin *sub_bin, GstElement *element, gpointer self);
   static void PadAddedCallback(GstElement *element, GstPad *pad, gpointer self);
@@ -179,12 +200,15 @@ class GstEnginePipeline : public QObject {
   static GstBusSyncReply BusSyncCallback(GstBus *bus, GstMessage *msg, gpointer self);
   static gboolean BusWatchCallback(GstBus *bus, GstMessage *msg, gpointer self);
   static void TaskEnterCallback(GstTask *task, GThread *thread, gpointer self);
+  static GstFlowReturn OfflineRenderNewSampleCallback(GstAppSink *appsink, gpointer self);
+  static void OfflineRenderEosCallback(GstAppSink *appsink, gpointer self);
 
   void TagMessageReceived(GstMessage *msg);
   void ErrorMessageReceived(GstMessage *msg);
   void ElementMessageReceived(GstMessage *msg);
   void StateChangedMessageReceived(GstMessage *msg);
   void BufferingMessageReceived(GstMessage *msg);
+  void QosMessageReceived(GstMessage *msg);
   void StreamStatusMessageReceived(GstMessage *msg);
   void StreamStartMessageReceived();
 
@@ -227,8 +251,10 @@ class GstEnginePipeline : public QObject {
   QString output_;
   QVariant device_;
   bool exclusive_mode_;
+  bool direct_device_;
   bool volume_enabled_;
   bool fading_enabled_;
+  bool offline_render_;
   mutex_protected<bool> strict_ssl_enabled_;
 
   // Buffering
@@ -351,6 +377,35 @@ class GstEnginePipeline : public QObject {
   QTimer *timer_fader_fudge_;
   QTimer *timer_fader_timeout_;
 
+  // The timeline keeps track of the fader progress, the volume is ramped by a control curve on the fading volume element.
+  // The curve is started at the stream time of the next buffer that reaches the element.
+  ScopedPtr<GstVolumeFader> volume_fader_;
+  QMutex mutex_fader_curve_;
+  GstSegment fader_segment_{};
+  bool fader_curve_pending_;
+  qint64 fader_curve_duration_nanosec_;
+  qreal fader_curve_progress_from_;
+  qreal fader_curve_progress_to_;
+  QEasingCurve fader_curve_easing_;
+
+  // Measurements for the playback metrics, the decoder thread members are only used from the playbin's streaming thread.
+  SharedPtr<PlaybackMetrics> playback_metrics_;
+  mutex_protected<qint64> seek_start_msec_;
+  mutex_protected<bool> seek_flushed_;
+  mutex_protected<qint64> buffering_start_msec_;
+  GThread *decoder_thread_;
+  qint64 decoder_thread_cpu_nanosec_;
+  qint64 decoder_cpu_nanosec_pending_;
+  qint64 decoder_audio_nanosec_pending_;
+  // The dropped count in QoS messages is a running total per element, keep the last one to add only what's new.
+  QMutex mutex_qos_;
+  QHash<GstObject*, guint64> qos_dropped_;
+
+  mutable QMutex mutex_offline_render_;
+  QByteArray offline_render_data_;
+  qint64 offline_rendered_nanosec_;
+  mutex_protected<bool> offline_render_finished_;
+
   GstElement *pipeline_;
   GstElement *audiobin_;
   GstElement *audiosink_;
@@ -367,6 +422,7 @@ class GstEnginePipeline : public QObject {
 
   std::optional<gulong> upstream_events_probe_cb_id_;
   std::optional<gulong> buffer_probe_cb_id_;
+  std::optional<gulong> fader_probe_cb_id_;
   std::optional<gulong> pad_probe_cb_id_;
   std::optional<gulong> element_added_cb_id_;
   std::optional<gulong> element_removed_cb_id_;
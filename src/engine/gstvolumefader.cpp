@@ -0,0 +1,97 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <cmath>
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gst/gst.h>
+#include <gst/controller/gstinterpolationcontrolsource.h>
+#include <gst/controller/gstdirectcontrolbinding.h>
+
+#include <QtGlobal>
+#include <QEasingCurve>
+
+#include "gstvolumefader.h"
+
+namespace {
+// Non-linear curves are approximated with linear segments of this length.
+constexpr qint64 kCurveSegmentNanosec = 10'000'000;
+}  // namespace
+
+GstVolumeFader::GstVolumeFader(GstElement *volume)
+    : volume_(GST_ELEMENT(gst_object_ref(volume))),
+      control_source_(gst_interpolation_control_source_new()),
+      active_(false) {
+
+  g_object_set(control_source_, "mode", GST_INTERPOLATION_MODE_LINEAR, nullptr);
+
+}
+
+GstVolumeFader::~GstVolumeFader() {
+
+  gst_object_unref(control_source_);
+  gst_object_unref(volume_);
+
+}
+
+void GstVolumeFader::SetCurve(const GstClockTime stream_time, const qint64 duration_nanosec, const qreal progress_from, const qreal progress_to, const QEasingCurve &easing_curve) {
+
+  GstTimedValueControlSource *timed_value_control_source = GST_TIMED_VALUE_CONTROL_SOURCE(control_source_);
+  gst_timed_value_control_source_unset_all(timed_value_control_source);
+
+  const qreal progress_range = std::abs(progress_to - progress_from);
+  const qint64 curve_duration_nanosec = static_cast<qint64>(static_cast<qreal>(duration_nanosec) * progress_range);
+  int segments = 1;
+  if (easing_curve.type() != QEasingCurve::Linear && curve_duration_nanosec > kCurveSegmentNanosec) {
+    segments = static_cast<int>(curve_duration_nanosec / kCurveSegmentNanosec);
+  }
+
+  for (int i = 0; i <= segments; ++i) {
+    const qreal fraction = static_cast<qreal>(i) / static_cast<qreal>(segments);
+    const qreal progress = progress_from + ((progress_to - progress_from) * fraction);
+    const GstClockTime time = stream_time + static_cast<GstClockTime>(static_cast<qreal>(curve_duration_nanosec) * fraction);
+    gst_timed_value_control_source_set(timed_value_control_source, time, easing_curve.valueForProgress(progress));
+  }
+
+  if (!active_) {
+    // Absolute binding, so the control values are volumes and not a fraction of the property range.
+    gst_object_add_control_binding(GST_OBJECT(volume_), gst_direct_control_binding_new_absolute(GST_OBJECT(volume_), "volume", control_source_));
+    active_ = true;
+  }
+
+}
+
+void GstVolumeFader::SetVolume(const qreal volume) {
+
+  if (active_) {
+    GstControlBinding *control_binding = gst_object_get_control_binding(GST_OBJECT(volume_), "volume");
+    if (control_binding) {
+      gst_object_remove_control_binding(GST_OBJECT(volume_), control_binding);
+      gst_object_unref(control_binding);
+    }
+    gst_timed_value_control_source_unset_all(GST_TIMED_VALUE_CONTROL_SOURCE(control_source_));
+    active_ = false;
+  }
+
+  g_object_set(G_OBJECT(volume_), "volume", volume, nullptr);
+
+}
@@ -0,0 +1,55 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GSTVOLUMEFADER_H
+#define GSTVOLUMEFADER_H
+
+#include "config.h"
+
+#include <glib.h>
+#include <gst/gst.h>
+
+#include <QtGlobal>
+#include <QEasingCurve>
+
+// Fades the "volume" property of a GStreamer volume element with an interpolation control source.
+// The volume element looks up the gain for each sample on the streaming thread, so the fade doesn't depend on the Qt event loop.
+class GstVolumeFader {
+ public:
+  explicit GstVolumeFader(GstElement *volume);
+  ~GstVolumeFader();
+
+  // Fades along the easing curve from progress_from to progress_to, where a progress of 1.0 takes duration_nanosec.
+  // The fade starts at the given stream time, and the volume stays at the last value after it.
+  void SetCurve(const GstClockTime stream_time, const qint64 duration_nanosec, const qreal progress_from, const qreal progress_to, const QEasingCurve &easing_curve);
+
+  // Removes the curve, and sets the volume to a fixed value.
+  void SetVolume(const qreal volume);
+
+  bool active() const { return active_; }
+
+ private:
+  Q_DISABLE_COPY(GstVolumeFader)
+
+  GstElement *volume_;
+  GstControlSource *control_source_;
+  bool active_;
+};
+
+#endif  // GSTVOLUMEFADER_H
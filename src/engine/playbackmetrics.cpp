@@ -0,0 +1,172 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QMutexLocker>
+#include <QDateTime>
+#include <QJsonObject>
+
+#include "constants/timeconstants.h"
+#include "playbackmetrics.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+PlaybackMetrics::Distribution::Distribution() : count(0), total(0), min(0), max(0), last(0) {}
+
+void PlaybackMetrics::Distribution::Add(const qint64 value) {
+
+  min = count == 0 ? value : qMin(min, value);
+  max = count == 0 ? value : qMax(max, value);
+  last = value;
+  total += value;
+  ++count;
+
+}
+
+QJsonObject PlaybackMetrics::Distribution::ToJson() const {
+
+  QJsonObject json_obj;
+  json_obj.insert("count"_L1, count);
+  json_obj.insert("min"_L1, min);
+  json_obj.insert("max"_L1, max);
+  json_obj.insert("last"_L1, last);
+  json_obj.insert("average"_L1, count == 0 ? 0.0 : static_cast<double>(total) / static_cast<double>(count));
+
+  return json_obj;
+
+}
+
+PlaybackMetrics::PlaybackMetrics()
+    : start_time_(QDateTime::currentSecsSinceEpoch()),
+      buffering_started_(0),
+      buffer_fill_below_low_watermark_(0),
+      buffer_fill_above_high_watermark_(0),
+      sink_xruns_(0),
+      sink_dropped_(0),
+      decoder_cpu_nanosec_(0),
+      decoder_audio_nanosec_(0) {}
+
+void PlaybackMetrics::AddTimeToFirstAudio(const qint64 msec, const bool spare_pipeline) {
+
+  QMutexLocker l(&mutex_);
+  time_to_first_audio_.Add(msec);
+  if (spare_pipeline) time_to_first_audio_spare_pipeline_.Add(msec);
+
+}
+
+void PlaybackMetrics::AddSeekLatency(const qint64 msec) {
+
+  QMutexLocker l(&mutex_);
+  seek_latency_.Add(msec);
+
+}
+
+void PlaybackMetrics::AddBufferingStarted() {
+
+  QMutexLocker l(&mutex_);
+  ++buffering_started_;
+
+}
+
+void PlaybackMetrics::AddBufferingFinished(const qint64 msec) {
+
+  QMutexLocker l(&mutex_);
+  buffering_.Add(msec);
+
+}
+
+void PlaybackMetrics::AddBufferFillLevel(const int percent, const double low_watermark, const double high_watermark) {
+
+  QMutexLocker l(&mutex_);
+  buffer_fill_level_.Add(percent);
+  if (percent < qRound(low_watermark * 100.0)) ++buffer_fill_below_low_watermark_;
+  if (percent > qRound(high_watermark * 100.0)) ++buffer_fill_above_high_watermark_;
+
+}
+
+void PlaybackMetrics::AddSinkXrun(const quint64 dropped) {
+
+  QMutexLocker l(&mutex_);
+  ++sink_xruns_;
+  sink_dropped_ += dropped;
+
+}
+
+void PlaybackMetrics::AddDecoderTime(const qint64 cpu_nanosec, const qint64 audio_nanosec) {
+
+  QMutexLocker l(&mutex_);
+  decoder_cpu_nanosec_ += cpu_nanosec;
+  decoder_audio_nanosec_ += audio_nanosec;
+
+}
+
+void PlaybackMetrics::Reset() {
+
+  QMutexLocker l(&mutex_);
+  start_time_ = QDateTime::currentSecsSinceEpoch();
+  time_to_first_audio_ = Distribution();
+  time_to_first_audio_spare_pipeline_ = Distribution();
+  seek_latency_ = Distribution();
+  buffering_started_ = 0;
+  buffering_ = Distribution();
+  buffer_fill_level_ = Distribution();
+  buffer_fill_below_low_watermark_ = 0;
+  buffer_fill_above_high_watermark_ = 0;
+  sink_xruns_ = 0;
+  sink_dropped_ = 0;
+  decoder_cpu_nanosec_ = 0;
+  decoder_audio_nanosec_ = 0;
+
+}
+
+QJsonObject PlaybackMetrics::ToJson() const {
+
+  QMutexLocker l(&mutex_);
+
+  QJsonObject json_buffering = buffering_.ToJson();
+  json_buffering.insert("started"_L1, buffering_started_);
+
+  QJsonObject json_buffer_fill_level = buffer_fill_level_.ToJson();
+  json_buffer_fill_level.insert("below_low_watermark"_L1, buffer_fill_below_low_watermark_);
+  json_buffer_fill_level.insert("above_high_watermark"_L1, buffer_fill_above_high_watermark_);
+
+  QJsonObject json_sink;
+  json_sink.insert("xruns"_L1, sink_xruns_);
+  json_sink.insert("dropped"_L1, static_cast<qint64>(sink_dropped_));
+
+  QJsonObject json_decoder;
+  json_decoder.insert("cpu_msec"_L1, decoder_cpu_nanosec_ / kNsecPerMsec);
+  json_decoder.insert("audio_msec"_L1, decoder_audio_nanosec_ / kNsecPerMsec);
+  json_decoder.insert("cpu_load"_L1, decoder_audio_nanosec_ == 0 ? 0.0 : static_cast<double>(decoder_cpu_nanosec_) / static_cast<double>(decoder_audio_nanosec_));
+
+  QJsonObject json_obj;
+  json_obj.insert("since"_L1, start_time_);
+  json_obj.insert("time_to_first_audio_msec"_L1, time_to_first_audio_.ToJson());
+  json_obj.insert("time_to_first_audio_spare_pipeline_msec"_L1, time_to_first_audio_spare_pipeline_.ToJson());
+  json_obj.insert("seek_latency_msec"_L1, seek_latency_.ToJson());
+  json_obj.insert("buffering_msec"_L1, json_buffering);
+  json_obj.insert("buffer_fill_level_percent"_L1, json_buffer_fill_level);
+  json_obj.insert("sink"_L1, json_sink);
+  json_obj.insert("decoder"_L1, json_decoder);
+
+  return json_obj;
+
+}
@@ -0,0 +1,90 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PLAYBACKMETRICS_H
+#define PLAYBACKMETRICS_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QJsonObject>
+
+// Aggregates playback latency and dropout measurements from the engine and its pipelines.
+// All methods are thread-safe, most measurements are added from GStreamer streaming threads.
+class PlaybackMetrics {
+ public:
+  PlaybackMetrics();
+
+  class Distribution {
+   public:
+    Distribution();
+    void Add(const qint64 value);
+    QJsonObject ToJson() const;
+
+    qint64 count;
+    qint64 total;
+    qint64 min;
+    qint64 max;
+    qint64 last;
+  };
+
+  // From loading a track until the first buffer of it reaches the analyzer.
+  // Tracks started on a spare pipeline are also added to a separate distribution to compare the two paths.
+  void AddTimeToFirstAudio(const qint64 msec, const bool spare_pipeline);
+
+  // From a flushing seek until the first buffer after it leaves the buffer queue.
+  void AddSeekLatency(const qint64 msec);
+
+  void AddBufferingStarted();
+  void AddBufferingFinished(const qint64 msec);
+
+  // Fill level of the buffer queue reported by a buffering message, the watermarks are fractions of the buffer.
+  void AddBufferFillLevel(const int percent, const double low_watermark, const double high_watermark);
+
+  // QoS message from the audio sink, posted when it had to drop or resync samples.
+  void AddSinkXrun(const quint64 dropped);
+
+  // CPU time spent by the thread pushing decoded audio into the audiobin, for the given duration of audio.
+  void AddDecoderTime(const qint64 cpu_nanosec, const qint64 audio_nanosec);
+
+  void Reset();
+
+  QJsonObject ToJson() const;
+
+ private:
+  Q_DISABLE_COPY(PlaybackMetrics)
+
+  mutable QMutex mutex_;
+  qint64 start_time_;
+  Distribution time_to_first_audio_;
+  Distribution time_to_first_audio_spare_pipeline_;
+  Distribution seek_latency_;
+  qint64 buffering_started_;
+  Distribution buffering_;
+  Distribution buffer_fill_level_;
+  qint64 buffer_fill_below_low_watermark_;
+  qint64 buffer_fill_above_high_watermark_;
+  qint64 sink_xruns_;
+  quint64 sink_dropped_;
+  qint64 decoder_cpu_nanosec_;
+  qint64 decoder_audio_nanosec_;
+};
+
+#endif  // PLAYBACKMETRICS_H
@@ -0,0 +1,68 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "sampleconversion.h"
+
+namespace SampleConversion {
+
+void S32LEToS16(const int32_t *source, int16_t *dest, const int count) {
+
+  for (int i = 0; i < count; ++i) {
+    dest[i] = static_cast<int16_t>(source[i] >> 16);
+  }
+
+}
+
+void F32LEToS16(const float *source, int16_t *dest, const int count) {
+
+  for (int i = 0; i < count; ++i) {
+    const float sample_float = source[i] * static_cast<float>(32768.0);
+    dest[i] = static_cast<int16_t>(sample_float);
+  }
+
+}
+
+void S24LEToS16(const int8_t *source, const size_t source_size, int16_t *dest, const int count) {
+
+  // Take the two most significant bytes of each packed 3 byte sample.
+  const int8_t *source_end = source + source_size;
+  for (int i = 0; i < count; ++i) {
+    memcpy(&dest[i], source + 1, sizeof(int16_t));
+    source += 3;
+    if (source >= source_end) break;
+  }
+
+}
+
+void S24_32LEToS16(const int32_t *source, int16_t *dest, const int count) {
+
+  // The 24 bit sample is stored in the lower three bytes of each 32 bit word.
+  for (int i = 0; i < count; ++i) {
+    memcpy(&dest[i], reinterpret_cast<const int8_t*>(&source[i]) + 1, sizeof(int16_t));
+  }
+
+}
+
+}  // namespace SampleConversion
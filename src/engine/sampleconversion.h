@@ -0,0 +1,35 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SAMPLECONVERSION_H
+#define SAMPLECONVERSION_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Converts interleaved samples to S16 for the analyzers and other buffer consumers.
+// count is the number of samples (frames * channels) to write to dest.
+namespace SampleConversion {
+void S32LEToS16(const int32_t *source, int16_t *dest, const int count);
+void F32LEToS16(const float *source, int16_t *dest, const int count);
+void S24LEToS16(const int8_t *source, const size_t source_size, int16_t *dest, const int count);
+void S24_32LEToS16(const int32_t *source, int16_t *dest, const int count);
+}  // namespace SampleConversion
+
+#endif  // SAMPLECONVERSION_H
@@ -40,6 +40,7 @@
 #include <QDBusMessage>
 #include <QDBusArgument>
 #include <QDBusObjectPath>
+#include <QJsonDocument>
 
 #include "core/logging.h"
 
@@ -66,6 +67,7 @@
 #include "mpris2_playlists.h"
 #include "mpris2_root.h"
 #include "mpris2_tracklist.h"
+#include "mpris2_playbackmetrics.h"
 
 #ifdef __GNUC__
 #  pragma GCC diagnostic pop
@@ -121,6 +123,7 @@ Mpris2::Mpris2(const SharedPtr<Player> player,
   new Mpris2TrackList(this);
   new Mpris2Player(this);
   new Mpris2Playlists(this);
+  new Mpris2PlaybackMetrics(this);
 
   if (!QDBusConnection::sessionBus().registerService(QLatin1String(kServiceName))) {
     qLog(Warning) << "Failed to register" << kServiceName << "on the session bus";
@@ -319,6 +322,12 @@ void Mpris2::Raise() { Q_EMIT RaiseMainWindow(); }
 
 void Mpris2::Quit() { QCoreApplication::quit(); }
 
+QString Mpris2::GetPlaybackMetrics() const {
+  return QString::fromUtf8(QJsonDocument(player_->engine()->playback_metrics()).toJson(QJsonDocument::Compact));
+}
+
+void Mpris2::ResetPlaybackMetrics() { player_->engine()->ResetPlaybackMetrics(); }
+
 QString Mpris2::PlaybackStatus() const {
   return PlaybackStatus(player_->GetState());
 }
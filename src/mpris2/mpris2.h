@@ -205,6 +205,10 @@ class Mpris2 : public QObject {
   void ActivatePlaylist(const QDBusObjectPath &playlist_id);
   MprisPlaylistList GetPlaylists(quint32 index, quint32 max_count, const QString &order, bool reverse_order);
 
+  // Strawberry extension, the playback metrics of the engine as a JSON object
+  QString GetPlaybackMetrics() const;
+  void ResetPlaybackMetrics();
+
  Q_SIGNALS:
   // Player
   void Seeked(const qint64 position);
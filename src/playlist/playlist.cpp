@@ -78,6 +78,8 @@
 #include "playlistsequence.h"
 #include "playlistbackend.h"
 #include "playlistfilter.h"
+#include "playlistfilechecker.h"
+#include "playlistsorter.h"
 #include "playlistitemmimedata.h"
 #include "songloaderinserter.h"
 #include "songplaylistitem.h"
@@ -122,6 +124,10 @@ constexpr qint64 kMaxScrobblePointNsecs = 240LL * kNsecPerSec;
 
 constexpr int kMaxPlayedIndexes = 100;
 
+// The first page is small so the top of the playlist shows up right away, the rest is loaded in larger pages.
+constexpr int kRestoreFirstPageSize = 500;
+constexpr int kRestorePageSize = 5000;
+
 }  // namespace
 
 Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
@@ -138,6 +144,7 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
       filter_(new PlaylistFilter(this)),
       queue_(new Queue(this, this)),
       timer_save_(new QTimer(this)),
+      file_checker_(new PlaylistFileChecker(this)),
       task_manager_(task_manager),
       url_handlers_(url_handlers),
       playlist_backend_(playlist_backend),
@@ -145,6 +152,9 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
       tagreader_client_(tagreader_client),
       id_(id),
       favorite_(favorite),
+      playable_rows_valid_(false),
+      playable_index_valid_(false),
+      shuffle_generator_(std::random_device{}()),
       current_is_paused_(false),
       current_virtual_index_(-1),
       playlist_sequence_(nullptr),
@@ -152,6 +162,10 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
       undo_stack_(new QUndoStack(this)),
       special_type_(special_type),
       cancel_restore_(false),
+      is_restoring_(false),
+      save_after_restore_(false),
+      restore_row_(0),
+      restore_generation_(0),
       scrobbled_(false),
       scrobble_point_(-1),
       auto_sort_(false),
@@ -177,6 +191,15 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
 
   QObject::connect(timer_save_, &QTimer::timeout, this, &Playlist::Save);
 
+  QObject::connect(file_checker_, &PlaylistFileChecker::FilesChecked, this, &Playlist::FilesChecked);
+  QObject::connect(file_checker_, &PlaylistFileChecker::Finished, this, &Playlist::FileCheckFinished);
+
+  // Rows entering or leaving the filter when the filter string changes are patched, the layout changes are our own moves.
+  QObject::connect(filter_, &PlaylistFilter::modelReset, this, &Playlist::InvalidatePlayableIndex);
+  QObject::connect(filter_, &PlaylistFilter::rowsInserted, this, &Playlist::PlayableFilterRowsChanged);
+  QObject::connect(filter_, &PlaylistFilter::rowsAboutToBeRemoved, this, &Playlist::PlayableFilterRowsChanged);
+  QObject::connect(this, &Playlist::dataChanged, this, &Playlist::PlayableRowsChanged);
+
   column_alignments_ = PlaylistView::DefaultColumnAlignment();
 
   timer_save_->setSingleShot(true);
@@ -340,7 +363,7 @@ QVariant Playlist::data(const QModelIndex &idx, const int role) const {
       const PlaylistItemPtr item = items_[idx.row()];
       const Song song = item->EffectiveMetadata();
 
-      // Don't forget to change Playlist::CompareItems when adding new columns
+      // Don't forget to change PlaylistSorter when adding new columns
       switch (static_cast<Column>(idx.column())) {
         case Column::Title:              return song.PrettyTitle();
         case Column::TitleSort:          return song.titlesort();
@@ -566,6 +589,112 @@ bool Playlist::FilterContainsVirtualIndex(const int i) const {
   return filter_->filterAcceptsRow(virtual_items_[i], QModelIndex());
 }
 
+bool Playlist::IsPlayableRow(const int row) const {
+
+  return filter_->filterAcceptsRow(row, QModelIndex()) && !items_[row]->GetShouldSkip();
+
+}
+
+const PlaylistPlayableIndex &Playlist::PlayableIndex() const {
+
+  if (!playable_rows_valid_) {
+    // The filter only reports rows entering or leaving it once it has mapped the rows.
+    filter_->rowCount();
+    playable_rows_.Reset(static_cast<int>(items_.count()));
+    for (int row = 0; row < items_.count(); ++row) {
+      playable_rows_.Set(row, IsPlayableRow(row));
+    }
+    playable_rows_valid_ = true;
+    playable_index_valid_ = false;
+  }
+
+  // Without shuffle the virtual indexes are the rows.
+  if (ShuffleMode() == PlaylistSequence::ShuffleMode::Off) {
+    return playable_rows_;
+  }
+
+  if (!playable_index_valid_) {
+    const int count = static_cast<int>(virtual_items_.count());
+    playable_index_.Reset(count);
+    virtual_index_of_row_.fill(-1, items_.count());
+    for (int i = 0; i < count; ++i) {
+      const int row = virtual_items_[i];
+      if (row < 0 || row >= items_.count()) continue;
+      virtual_index_of_row_[row] = i;
+      playable_index_.Set(i, playable_rows_.Contains(row));
+    }
+    playable_index_valid_ = true;
+  }
+
+  return playable_index_;
+
+}
+
+void Playlist::InvalidatePlayableIndex() {
+
+  playable_rows_valid_ = false;
+  playable_index_valid_ = false;
+
+}
+
+void Playlist::UpdatePlayableRow(const int row) {
+
+  if (!playable_rows_valid_ || row < 0 || row >= playable_rows_.count()) return;
+
+  const bool playable = IsPlayableRow(row);
+  playable_rows_.Set(row, playable);
+
+  if (playable_index_valid_) {
+    const int virtual_index = virtual_index_of_row_.value(row, -1);
+    if (virtual_index == -1) {
+      playable_index_valid_ = false;
+    }
+    else {
+      playable_index_.Set(virtual_index, playable);
+    }
+  }
+
+}
+
+void Playlist::MovePlayableRows(const PlaylistItemPtrList &old_items, const int first_row, const int last_row) {
+
+  // The virtual indexes follow the items, but the virtual index of each row changed.
+  playable_index_valid_ = false;
+
+  if (!playable_rows_valid_) return;
+
+  // Only the rows between the first and last moved row changed, copy their bits from the old rows of their items.
+  QHash<const PlaylistItem*, bool> playable;
+  for (int row = first_row; row <= last_row; ++row) {
+    playable.insert(&*old_items[row], playable_rows_.Contains(row));
+  }
+  for (int row = first_row; row <= last_row; ++row) {
+    playable_rows_.Set(row, playable.value(&*items_[row], false));
+  }
+
+}
+
+void Playlist::PlayableRowsChanged(const QModelIndex &top_left, const QModelIndex &bottom_right) {
+
+  if (!playable_rows_valid_) return;
+
+  for (int row = top_left.row(); row <= bottom_right.row(); ++row) {
+    UpdatePlayableRow(row);
+  }
+
+}
+
+void Playlist::PlayableFilterRowsChanged(const QModelIndex &parent, const int first, const int last) {
+
+  if (!playable_rows_valid_ || parent.isValid()) return;
+
+  // Rows about to be removed from the filter are still mapped, the filter already rejects them when the filter string changed.
+  for (int row = first; row <= last; ++row) {
+    UpdatePlayableRow(filter_->mapToSource(filter_->index(row, 0)).row());
+  }
+
+}
+
 int Playlist::NextVirtualIndex(int i, const bool ignore_repeat_track) const {
 
   const PlaylistSequence::RepeatMode repeat_mode = RepeatMode();
@@ -579,28 +708,21 @@ int Playlist::NextVirtualIndex(int i, const bool ignore_repeat_track) const {
     return i;
   }
 
+  const PlaylistPlayableIndex &playable_index = PlayableIndex();
+
   // If we're not bothered about whether a song is on the same album then return the next virtual index, whatever it is.
+  // The playable index only contains tracks that are in the filter and not selected to be skipped.
   if (!album_only) {
-    ++i;
-
-    // Advance i until we find any track that is in the filter, skipping the selected to be skipped
-    while (i < virtual_items_.count() && (!FilterContainsVirtualIndex(i) || item_at(virtual_items_[i])->GetShouldSkip())) {
-      ++i;
-    }
-    return i;
+    return playable_index.Next(i);
   }
 
   // We need to advance i until we get something else on the same album
   const Song last_song = current_item_metadata();
-  for (int j = i + 1; j < virtual_items_.count(); ++j) {
-    if (item_at(virtual_items_[j])->GetShouldSkip()) {
-      continue;
-    }
+  for (int j = playable_index.Next(i); j < virtual_items_.count(); j = playable_index.Next(j)) {
     const Song this_song = item_at(virtual_items_[j])->EffectiveMetadata();
     if (((last_song.is_compilation() && this_song.is_compilation()) ||
          last_song.effective_albumartist() == this_song.effective_albumartist()) &&
-        last_song.album() == this_song.album() &&
-        FilterContainsVirtualIndex(j)) {
+        last_song.album() == this_song.album()) {
       return j;  // Found one
     }
   }
@@ -621,23 +743,18 @@ int Playlist::PreviousVirtualIndex(int i, const bool ignore_repeat_track) const
     return i;
   }
 
+  const PlaylistPlayableIndex &playable_index = PlayableIndex();
+
   // If we're not bothered about whether a song is on the same album then return the previous virtual index, whatever it is.
   if (!album_only) {
-    --i;
-
-    // Decrement i until we find any track that is in the filter
-    while (i >= 0 && (!FilterContainsVirtualIndex(i) || item_at(virtual_items_[i])->GetShouldSkip())) --i;
-    return i;
+    return playable_index.Previous(i);
   }
 
   // We need to decrement i until we get something else on the same album
   Song last_song = current_item_metadata();
-  for (int j = i - 1; j >= 0; --j) {
-    if (item_at(virtual_items_[j])->GetShouldSkip()) {
-      continue;
-    }
+  for (int j = playable_index.Previous(i); j >= 0; j = playable_index.Previous(j)) {
     Song this_song = item_at(virtual_items_[j])->EffectiveMetadata();
-    if (((last_song.is_compilation() && this_song.is_compilation()) || last_song.artist() == this_song.artist()) && last_song.album() == this_song.album() && FilterContainsVirtualIndex(j)) {
+    if (((last_song.is_compilation() && this_song.is_compilation()) || last_song.artist() == this_song.artist()) && last_song.album() == this_song.album()) {
       return j;  // Found one
     }
   }
@@ -763,6 +880,7 @@ void Playlist::set_current_row(const int i, const AutoScroll autoscroll, const b
       if (idx != -1) {
         virtual_items_.takeAt(idx);
         virtual_items_.prepend(i);
+        playable_index_valid_ = false;
       }
       current_virtual_index_ = 0;
     }
@@ -1053,6 +1171,12 @@ void Playlist::MoveItemsWithoutUndo(const QList<int> &source_rows, int pos) {
     }
   }
 
+  if (!source_rows.isEmpty()) {
+    const int first_row = std::min(*std::min_element(source_rows.begin(), source_rows.end()), start);
+    const int last_row = std::max(*std::max_element(source_rows.begin(), source_rows.end()), start + static_cast<int>(moved_items.count()) - 1);
+    MovePlayableRows(old_items, first_row, last_row);
+  }
+
   // Update current virtual index
   if (current_item_index_.isValid()) {
     current_virtual_index_ = static_cast<int>(virtual_items_.indexOf(current_item_index_.row()));
@@ -1126,6 +1250,12 @@ void Playlist::MoveItemsWithoutUndo(int start, const QList<int> &dest_rows) {
     }
   }
 
+  if (!dest_rows.isEmpty()) {
+    const int first_row = std::min(*std::min_element(dest_rows.begin(), dest_rows.end()), start);
+    const int last_row = std::max(*std::max_element(dest_rows.begin(), dest_rows.end()), start + static_cast<int>(dest_rows.count()) - 1);
+    MovePlayableRows(old_items, first_row, last_row);
+  }
+
   // Update current virtual index
   if (current_item_index_.isValid()) {
     current_virtual_index_ = static_cast<int>(virtual_items_.indexOf(current_item_index_.row()));
@@ -1189,6 +1319,16 @@ void Playlist::InsertItemsWithoutUndo(const PlaylistItemPtrList &items, const in
       last_played_item_index_ = current_item_index_;
     }
   }
+
+  // Patched before the filter is told about the new rows.
+  playable_index_valid_ = false;
+  if (playable_rows_valid_) {
+    playable_rows_.Insert(start, static_cast<int>(items.count()));
+    for (int i = start; i <= end; ++i) {
+      UpdatePlayableRow(i);
+    }
+  }
+
   endInsertRows();
 
   if (enqueue) {
@@ -1301,6 +1441,8 @@ void Playlist::UpdateItems(SongList songs) {
             }
           }
         }
+        // The new item takes over the row of the old one in the playlist_items table.
+        new_item->set_database_rowid(item->database_rowid());
         items_[i] = new_item;
         Q_EMIT dataChanged(index(i, 0), index(i, ColumnCount - 1));
         // Also update undo actions
@@ -1362,84 +1504,6 @@ QMimeData *Playlist::mimeData(const QModelIndexList &indexes) const {
 
 }
 
-namespace {
-
-inline bool CompareStr(const QString &a, const QString &b) {
-  return QString::localeAwareCompare(a.toLower(), b.toLower()) < 0;
-}
-
-template<typename T>
-inline bool CompareVal(const T &a, const T &b) {
-  return a < b;
-}
-
-}  // namespace
-
-bool Playlist::CompareItems(const Column column, const Qt::SortOrder order, PlaylistItemPtr _a, PlaylistItemPtr _b) {
-
-  PlaylistItemPtr a = (order == Qt::AscendingOrder) ? _a : _b;
-  PlaylistItemPtr b = (order == Qt::AscendingOrder) ? _b : _a;
-
-  const auto &ma = a->EffectiveMetadata();
-  const auto &mb = b->EffectiveMetadata();
-
-  switch (column) {
-    case Column::Title:                     return CompareStr(ma.effective_titlesort(), mb.effective_titlesort());
-    case Column::TitleSort:                 return CompareStr(ma.titlesort(), mb.titlesort());
-    case Column::Artist:                    return CompareStr(ma.effective_artistsort(), mb.effective_artistsort());
-    case Column::ArtistSort:                return CompareStr(ma.artistsort(), mb.artistsort());
-    case Column::Album:                     return CompareStr(ma.effective_albumsort(), mb.effective_albumsort());
-    case Column::AlbumSort:                 return CompareStr(ma.albumsort(), mb.albumsort());
-    case Column::Length:                    return CompareVal(ma.length_nanosec(), mb.length_nanosec());
-    case Column::Track:                     return CompareVal(ma.track(), mb.track());
-    case Column::Disc:                      return CompareVal(ma.disc(), mb.disc());
-    case Column::Year:                      return CompareVal(ma.year(), mb.year());
-    case Column::OriginalYear:              return CompareVal(ma.effective_originalyear(), mb.effective_originalyear());
-    case Column::Genre:                     return CompareStr(ma.genre(), mb.genre());
-    case Column::AlbumArtist:               return CompareStr(ma.playlist_effective_albumartistsort(), mb.playlist_effective_albumartistsort());
-    case Column::AlbumArtistSort:           return CompareStr(ma.albumartistsort(), mb.albumartistsort());
-    case Column::Composer:                  return CompareStr(ma.effective_composersort(), mb.effective_composersort());
-    case Column::ComposerSort:              return CompareStr(ma.composersort(), mb.composersort());
-    case Column::Performer:                 return CompareStr(ma.effective_performersort(), mb.effective_performersort());
-    case Column::PerformerSort:             return CompareStr(ma.performersort(), mb.performersort());
-    case Column::Grouping:                  return CompareStr(ma.grouping(), mb.grouping());
-
-    case Column::PlayCount:                 return CompareVal(ma.playcount(), mb.playcount());
-    case Column::SkipCount:                 return CompareVal(ma.skipcount(), mb.skipcount());
-    case Column::LastPlayed:                return CompareVal(ma.lastplayed(), mb.lastplayed());
-
-    case Column::Bitrate:                   return CompareVal(ma.bitrate(), mb.bitrate());
-    case Column::Samplerate:                return CompareVal(ma.samplerate(), mb.samplerate());
-    case Column::Bitdepth:                  return CompareVal(ma.bitdepth(), mb.bitdepth());
-    case Column::URL:                       return CompareStr(a->OriginalUrl().path(), b->OriginalUrl().path());
-    case Column::BaseFilename:              return CompareVal(ma.basefilename(), mb.basefilename());
-    case Column::Filesize:                  return CompareVal(ma.filesize(), mb.filesize());
-    case Column::Filetype:                  return CompareVal(ma.filetype(), mb.filetype());
-    case Column::DateModified:              return CompareVal(ma.mtime(), mb.mtime());
-    case Column::DateCreated:               return CompareVal(ma.ctime(), mb.ctime());
-
-    case Column::Comment:                   return CompareStr(ma.comment(), mb.comment());
-    case Column::Source:                    return CompareVal(ma.source(), mb.source());
-
-    case Column::Rating:                    return CompareVal(ma.rating(), mb.rating());
-
-    case Column::HasCUE:                    return CompareVal(ma.has_cue(), mb.has_cue());
-
-    case Column::EBUR128IntegratedLoudness: return CompareVal(ma.ebur128_integrated_loudness_lufs(), mb.ebur128_integrated_loudness_lufs());
-    case Column::EBUR128LoudnessRange:      return CompareVal(ma.ebur128_loudness_range_lu(), mb.ebur128_loudness_range_lu());
-
-    case Column::BPM:                       return CompareVal(ma.bpm(), mb.bpm());
-    case Column::Mood:                      return CompareStr(ma.mood(), mb.mood());
-    case Column::InitialKey:                return CompareStr(ma.initial_key(), mb.initial_key());
-
-    case Column::Moodbar:
-    case Column::ColumnCount:
-      break;
-  }
-
-  return false;
-}
-
 QString Playlist::column_name(const Column column) {
 
   switch (column) {
@@ -1519,28 +1583,33 @@ void Playlist::sort(const int column_number, const Qt::SortOrder order) {
 
   const Column column = static_cast<Column>(column_number);
 
-  sort_column_ = static_cast<Column>(column);
-  sort_order_ = order;
+  SortColumns sort_columns = SortColumns() << qMakePair(column, order);
+  if (column == Column::Album) {
+    // When sorting by album, also take into account discs and tracks.
+    sort_columns << qMakePair(Column::Disc, order) << qMakePair(Column::Track, order);
+  }
 
-  if (ignore_sorting_) return;
+  SortByColumns(sort_columns);
 
-  PlaylistItemPtrList new_items(items_);
-  PlaylistItemPtrList::iterator begin = new_items.begin();
+}
 
-  if (dynamic_playlist_ && current_item_index_.isValid())
-    begin += current_item_index_.row() + 1;
+void Playlist::SortByColumns(const SortColumns &sort_columns) {
 
-  if (column == Column::Album) {
-    // When sorting by album, also take into account discs and tracks.
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column::Track, order, std::placeholders::_1, std::placeholders::_2));
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column::Disc, order, std::placeholders::_1, std::placeholders::_2));
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, Column::Album, order, std::placeholders::_1, std::placeholders::_2));
-  }
-  else {
-    std::stable_sort(begin, new_items.end(), std::bind(&Playlist::CompareItems, column, order, std::placeholders::_1, std::placeholders::_2));
+  if (sort_columns.isEmpty()) return;
+
+  sort_column_ = sort_columns.first().first;
+  sort_order_ = sort_columns.first().second;
+
+  if (ignore_sorting_) return;
+
+  int begin = 0;
+  if (dynamic_playlist_ && current_item_index_.isValid()) {
+    begin += current_item_index_.row() + 1;
   }
 
-  undo_stack_->push(new PlaylistUndoCommandSortItems(this, column, order, new_items));
+  const PlaylistItemPtrList new_items = PlaylistSorter::Sort(items_, sort_columns, begin);
+
+  undo_stack_->push(new PlaylistUndoCommandSortItems(this, sort_column_, sort_order_, new_items));
 
 }
 
@@ -1570,6 +1639,10 @@ void Playlist::ReOrderWithoutUndo(const PlaylistItemPtrList &new_items) {
     }
   }
 
+  if (!items_.isEmpty()) {
+    MovePlayableRows(old_items, 0, static_cast<int>(items_.count()) - 1);
+  }
+
   // Update current virtual index
   if (current_item_index_.isValid()) {
     current_virtual_index_ = static_cast<int>(virtual_items_.indexOf(current_item_index_.row()));
@@ -1627,6 +1700,12 @@ void Playlist::Save() {
 
   if (!playlist_backend_ || is_loading_) return;
 
+  // Saving before all pages are restored would drop the rows that are not loaded yet.
+  if (is_restoring_) {
+    save_after_restore_ = true;
+    return;
+  }
+
   playlist_backend_->SavePlaylistAsync(id_, items_, last_played_row(), dynamic_playlist_);
 
 }
@@ -1637,12 +1716,32 @@ void Playlist::Restore() {
 
   items_.clear();
   virtual_items_.clear();
+  InvalidatePlayableIndex();
   ClearCollectionItems();
 
   cancel_restore_ = false;
-  QFuture<PlaylistItemPtrList> future = QtConcurrent::run(&PlaylistBackend::GetPlaylistItems, playlist_backend_, id_);
-  QFutureWatcher<PlaylistItemPtrList> *watcher = new QFutureWatcher<PlaylistItemPtrList>();
-  QObject::connect(watcher, &QFutureWatcher<PlaylistItemPtrList>::finished, this, &Playlist::ItemsLoaded);
+  is_restoring_ = true;
+  save_after_restore_ = false;
+  restore_row_ = 0;
+  // A restore that is still loading pages is replaced by this one, its remaining pages are ignored.
+  ++restore_generation_;
+  RestorePage(0, -1, kRestoreFirstPageSize);
+
+}
+
+void Playlist::RestorePage(const qint64 after_position, const qint64 after_rowid, const int limit) {
+
+  QFuture<PlaylistBackend::PlaylistItemsPage> future = QtConcurrent::run(&PlaylistBackend::GetPlaylistItemsPage, playlist_backend_, id_, after_position, after_rowid, limit);
+  QFutureWatcher<PlaylistBackend::PlaylistItemsPage> *watcher = new QFutureWatcher<PlaylistBackend::PlaylistItemsPage>();
+  QObject::connect(watcher, &QFutureWatcher<PlaylistBackend::PlaylistItemsPage>::finished, this, [this, watcher, generation = restore_generation_]() {
+    const PlaylistBackend::PlaylistItemsPage page = watcher->result();
+    watcher->deleteLater();
+    if (generation != restore_generation_) return;
+    ItemsLoaded(page.items, page.finished);
+    if (is_restoring_) {
+      RestorePage(page.last_position, page.last_rowid, kRestorePageSize);
+    }
+  });
   watcher->setFuture(future);
 
 }
@@ -1656,13 +1755,12 @@ void Playlist::ClearCollectionItems() {
 
 }
 
-void Playlist::ItemsLoaded() {
+void Playlist::ItemsLoaded(PlaylistItemPtrList items, const bool finished) {
 
-  QFutureWatcher<PlaylistItemPtrList> *watcher = static_cast<QFutureWatcher<PlaylistItemPtrList>*>(sender());
-  PlaylistItemPtrList items = watcher->result();
-  watcher->deleteLater();
-
-  if (cancel_restore_) return;
+  if (cancel_restore_) {
+    FinishRestore();
+    return;
+  }
 
   // Backend returns empty elements for collection items which it couldn't match (because they got deleted); we don't need those
   QMutableListIterator<PlaylistItemPtr> it(items);
@@ -1674,9 +1772,21 @@ void Playlist::ItemsLoaded() {
     }
   }
 
+  // Each page goes after the rows restored so far, items added while restoring stay below them.
+  // Restoring is not an undoable change, and the pages are usually bigger than what the undo stack can keep anyway.
+  const int row = std::min(restore_row_, rowCount());
   is_loading_ = true;
-  InsertItems(items, 0);
+  InsertItemsWithoutUndo(items, row);
   is_loading_ = false;
+  // Undo commands for items added while restoring refer to rows that just moved.
+  if (row < rowCount() - static_cast<int>(items.count())) {
+    undo_stack_->clear();
+  }
+  restore_row_ = row + static_cast<int>(items.count());
+
+  if (!finished) return;
+
+  FinishRestore();
 
   const PlaylistBackend::Playlist playlist = playlist_backend_->GetPlaylist(id_);
 
@@ -1715,6 +1825,17 @@ void Playlist::ItemsLoaded() {
 
 }
 
+void Playlist::FinishRestore() {
+
+  is_restoring_ = false;
+
+  if (save_after_restore_) {
+    save_after_restore_ = false;
+    ScheduleSave();
+  }
+
+}
+
 static bool DescendingIntLessThan(const int a, const int b) { return a > b; }
 
 void Playlist::RemoveItemsWithoutUndo(const QList<int> &indicesIn) {
@@ -1819,6 +1940,11 @@ PlaylistItemPtrList Playlist::RemoveItemsWithoutUndo(const int row, const int co
     }
   }
 
+  playable_index_valid_ = false;
+  if (playable_rows_valid_) {
+    playable_rows_.Remove(row, count);
+  }
+
   endRemoveRows();
 
   Q_ASSERT(items_.count() == virtual_items_.count());
@@ -2006,11 +2132,8 @@ void Playlist::Shuffle() {
     begin += current_item_index_.row() + 1;
   }
 
-  const int count = static_cast<int>(items_.count());
-  for (int i = begin; i < count; ++i) {
-    const int new_pos = i + (rand() % (count - i));
-
-    std::swap(new_items[i], new_items[new_pos]);
+  if (begin < new_items.count()) {
+    std::shuffle(new_items.begin() + begin, new_items.end(), shuffle_generator_);
   }
 
   undo_stack_->push(new PlaylistUndoCommandShuffleItems(this, new_items));
@@ -2043,8 +2166,7 @@ void Playlist::ReshuffleIndices() {
 
     case PlaylistSequence::ShuffleMode::All:
     case PlaylistSequence::ShuffleMode::InsideAlbum:{
-      std::random_device rd;
-      std::shuffle(virtual_items_.begin(), virtual_items_.end(), std::mt19937(rd()));
+      std::shuffle(virtual_items_.begin(), virtual_items_.end(), shuffle_generator_);
       break;
     }
 
@@ -2061,9 +2183,10 @@ void Playlist::ReshuffleIndices() {
       }
 
       // Shuffle them
-      static std::mt19937 rng{std::random_device{}()};
+      // Sort the keys first, so the order only depends on the shuffle seed
       QStringList shuffled_album_keys = album_key_set.values();
-      std::shuffle(shuffled_album_keys.begin(), shuffled_album_keys.end(), rng);
+      std::sort(shuffled_album_keys.begin(), shuffled_album_keys.end());
+      std::shuffle(shuffled_album_keys.begin(), shuffled_album_keys.end(), shuffle_generator_);
 
       // If the user is currently playing a song, force its album to be first
       // Also check last_played_row() for cases where current_row() hasn't been set yet (e.g., on app startup)
@@ -2105,9 +2228,10 @@ void Playlist::ReshuffleIndices() {
       }
 
       // Shuffle them
-      static std::mt19937 rng{std::random_device{}()};
+      // Sort the keys first, so the order only depends on the shuffle seed
       QStringList shuffled_grouping_keys = grouping_key_set.values();
-      std::shuffle(shuffled_grouping_keys.begin(), shuffled_grouping_keys.end(), rng);
+      std::sort(shuffled_grouping_keys.begin(), shuffled_grouping_keys.end());
+      std::shuffle(shuffled_grouping_keys.begin(), shuffled_grouping_keys.end(), shuffle_generator_);
 
       // If the user is currently playing a song, force its grouping list to be first
       // Also check last_played_row() for cases where current_row() hasn't been set yet (e.g., on app startup)
@@ -2137,6 +2261,8 @@ void Playlist::ReshuffleIndices() {
     }
   }
 
+  playable_index_valid_ = false;
+
   // Update current virtual index
   if (current_item_index_.isValid()) {
     current_virtual_index_ = static_cast<int>(virtual_items_.indexOf(current_item_index_.row()));
@@ -2147,6 +2273,12 @@ void Playlist::ReshuffleIndices() {
 
 }
 
+void Playlist::SetShuffleSeed(const quint32 seed) {
+
+  shuffle_generator_.seed(seed);
+
+}
+
 void Playlist::set_sequence(PlaylistSequence *v) {
 
   playlist_sequence_ = v;
@@ -2443,47 +2575,95 @@ void Playlist::InformOfCurrentSongChange(const bool minor) {
 
 void Playlist::InvalidateDeletedSongs() {
 
-  QList<int> invalidated_rows;
+  CheckLocalFiles(false);
 
-  for (int row = 0; row < items_.count(); ++row) {
-    PlaylistItemPtr item = items_.value(row);
-    const Song song = item->EffectiveMetadata();
+}
 
-    if (song.url().isValid() && song.url().isLocalFile()) {
-      const bool exists = QFile::exists(song.url().toLocalFile());
+void Playlist::RemoveDeletedSongs() {
 
-      if (!exists && !item->HasForegroundColor(kInvalidSongPriority)) {
-        // Gray out the song if it's not there
-        item->SetForegroundColor(kInvalidSongPriority, kInvalidSongColor);
-        invalidated_rows.append(row);  // clazy:exclude=reserve-candidates
-      }
-      else if (exists && item->HasForegroundColor(kInvalidSongPriority)) {
-        item->RemoveForegroundColor(kInvalidSongPriority);
-        invalidated_rows.append(row);  // clazy:exclude=reserve-candidates
-      }
+  CheckLocalFiles(true);
+
+}
+
+void Playlist::CheckLocalFiles(const bool remove_missing) {
+
+  FileCheckJob job;
+  job.remove_missing = remove_missing;
+  QStringList filenames;
+
+  for (int row = 0; row < items_.count(); ++row) {
+    const PlaylistItemPtr item = items_.value(row);
+    const QUrl url = item->EffectiveMetadata().url();
+    if (url.isValid() && url.isLocalFile()) {
+      job.items << item;  // clazy:exclude=reserve-candidates
+      filenames << url.toLocalFile();  // clazy:exclude=reserve-candidates
     }
   }
 
-  if (!invalidated_rows.isEmpty()) {
-    ReloadItems(invalidated_rows);
-  }
+  if (filenames.isEmpty()) return;
+
+  file_check_jobs_.insert(file_checker_->CheckFiles(filenames), job);
 
 }
 
-void Playlist::RemoveDeletedSongs() {
+void Playlist::FilesChecked(const int job_id, const QList<int> &existing, const QList<int> &missing) {
 
-  QList<int> rows_to_remove;
+  if (!file_check_jobs_.contains(job_id)) return;
 
+  const FileCheckJob &job = file_check_jobs_[job_id];
+
+  // Rows might have moved or been removed since the check was started, so the items are looked up again.
+  // The job holds a reference to the items, so their addresses can't be reused by new items in the meantime.
+  QHash<const PlaylistItem*, int> rows;
+  rows.reserve(items_.count());
   for (int row = 0; row < items_.count(); ++row) {
-    const PlaylistItemPtr item = items_.value(row);
-    const Song song = item->EffectiveMetadata();
+    rows.insert(items_[row].get(), row);
+  }
 
-    if (song.url().isLocalFile() && !QFile::exists(song.url().toLocalFile())) {
-      rows_to_remove.append(row);  // clazy:exclude=reserve-candidates
+  if (job.remove_missing) {
+    QList<int> rows_to_remove;
+    for (const int position : missing) {
+      const int row = rows.value(job.items.value(position).get(), -1);
+      if (row != -1) {
+        rows_to_remove.append(row);  // clazy:exclude=reserve-candidates
+      }
     }
+    removeRows(rows_to_remove);
+    return;
   }
 
-  removeRows(rows_to_remove);
+  QList<int> invalidated_rows;
+
+  for (const int position : missing) {
+    const int row = rows.value(job.items.value(position).get(), -1);
+    if (row == -1) continue;
+    PlaylistItemPtr item = items_.value(row);
+    if (!item->HasForegroundColor(kInvalidSongPriority)) {
+      // Gray out the song if it's not there
+      item->SetForegroundColor(kInvalidSongPriority, kInvalidSongColor);
+      invalidated_rows.append(row);  // clazy:exclude=reserve-candidates
+    }
+  }
+
+  for (const int position : existing) {
+    const int row = rows.value(job.items.value(position).get(), -1);
+    if (row == -1) continue;
+    PlaylistItemPtr item = items_.value(row);
+    if (item->HasForegroundColor(kInvalidSongPriority)) {
+      item->RemoveForegroundColor(kInvalidSongPriority);
+      invalidated_rows.append(row);  // clazy:exclude=reserve-candidates
+    }
+  }
+
+  if (!invalidated_rows.isEmpty()) {
+    ReloadItems(invalidated_rows);
+  }
+
+}
+
+void Playlist::FileCheckFinished(const int job_id) {
+
+  file_check_jobs_.remove(job_id);
 
 }
 
@@ -2540,18 +2720,7 @@ void Playlist::RemoveDuplicateSongs() {
 
 void Playlist::RemoveUnavailableSongs() {
 
-  QList<int> rows_to_remove;
-  for (int row = 0; row < items_.count(); ++row) {
-    const PlaylistItemPtr item = items_.value(row);
-    const Song &song = item->EffectiveMetadata();
-
-    // Check only local files
-    if (song.url().isLocalFile() && !QFile::exists(song.url().toLocalFile())) {
-      rows_to_remove.append(row);  // clazy:exclude=reserve-candidates
-    }
-  }
-
-  removeRows(rows_to_remove);
+  CheckLocalFiles(true);
 
 }
 
@@ -24,6 +24,8 @@
 
 #include "config.h"
 
+#include <random>
+
 #include <QtGlobal>
 #include <QObject>
 #include <QAbstractItemModel>
@@ -33,6 +35,7 @@
 #include <QList>
 #include <QMap>
 #include <QMultiMap>
+#include <QPair>
 #include <QMetaType>
 #include <QVariant>
 #include <QString>
@@ -47,6 +50,7 @@
 #include "covermanager/albumcoverloaderresult.h"
 #include "playlistitem.h"
 #include "playlistsequence.h"
+#include "playlistplayableindex.h"
 #include "smartplaylists/playlistgenerator_fwd.h"
 #include <streaming/streamingservice.h>
 
@@ -59,6 +63,7 @@ class UrlHandlers;
 class CollectionBackend;
 class PlaylistBackend;
 class PlaylistFilter;
+class PlaylistFileChecker;
 class Queue;
 class RadioService;
 
@@ -144,6 +149,8 @@ class Playlist : public QAbstractListModel {
     ColumnCount
   };
   using Columns = QList<Column>;
+  using SortColumn = QPair<Column, Qt::SortOrder>;
+  using SortColumns = QList<SortColumn>;
   static constexpr int ColumnCount = static_cast<int>(Column::ColumnCount);
 
   enum Role {
@@ -166,8 +173,6 @@ class Playlist : public QAbstractListModel {
   static const int kUndoStackSize;
   static const int kUndoItemLimit;
 
-  static bool CompareItems(const Column column, const Qt::SortOrder order, PlaylistItemPtr a, PlaylistItemPtr b);
-
   static QString column_name(const Column column);
   static QString abbreviated_column_name(const Column column);
 
@@ -175,6 +180,8 @@ class Playlist : public QAbstractListModel {
   static bool set_column_value(Song &song, Column column, const QVariant &value);
 
   // Persistence
+  // Loads the items in pages so the top of the playlist shows up right away.
+  // This is a paged restore only, every item is still in memory once it finishes since the model isn't virtualized.
   void Restore();
   void ScheduleSaveAsync();
 
@@ -242,6 +249,9 @@ class Playlist : public QAbstractListModel {
 
   void ReshuffleIndices();
 
+  // Seeds the random generator used for shuffling, so the shuffled order can be reproduced.
+  void SetShuffleSeed(const quint32 seed);
+
   // If this playlist contains the current item, this method will apply the "valid" flag on it.
   // If the "valid" flag is false, the song will be greyed out. Otherwise, the grey color will be undone.
   // If the song is a local file, and it's valid but non-existent or invalid but exists, the
@@ -250,6 +260,7 @@ class Playlist : public QAbstractListModel {
   bool ApplyValidityOnCurrentSong(const QUrl &url, bool valid);
 
   // Removes from the playlist all local files that don't exist anymore.
+  // The files are checked in the background, and the rows are removed as the results come in.
   void RemoveDeletedSongs();
 
   void StopAfter(const int row);
@@ -273,6 +284,9 @@ class Playlist : public QAbstractListModel {
   QMimeData *mimeData(const QModelIndexList &indexes) const override;
   bool dropMimeData(const QMimeData *data, Qt::DropAction action, const int row, const int column, const QModelIndex &parent_index) override;
   void sort(const int column_number, const Qt::SortOrder order) override;
+
+  // Sorts by several columns in one pass, the first column being the primary sort key.
+  void SortByColumns(const SortColumns &sort_columns);
   bool removeRows(const int row, const int count, const QModelIndex &parent = QModelIndex()) override;
 
   static Columns ChangedColumns(const Song &metadata1, const Song &metadata2);
@@ -343,6 +357,10 @@ class Playlist : public QAbstractListModel {
   int NextVirtualIndex(int i, const bool ignore_repeat_track) const;
   int PreviousVirtualIndex(int i, const bool ignore_repeat_track) const;
   bool FilterContainsVirtualIndex(const int i) const;
+  bool IsPlayableRow(const int row) const;
+  void UpdatePlayableRow(const int row);
+  void MovePlayableRows(const PlaylistItemPtrList &old_items, const int first_row, const int last_row);
+  const PlaylistPlayableIndex &PlayableIndex() const;
 
   template<typename T>
   void InsertSongItems(const SongList &songs, const int pos, const bool play_now, const bool enqueue, const bool enqueue_next = false);
@@ -364,8 +382,12 @@ class Playlist : public QAbstractListModel {
   void InsertDynamicItems(const int count);
 
   // Grays out and reloads all deleted songs in all playlists. Also, "ungreys" those songs which were once deleted but now got restored somehow.
+  // The files are checked in the background, so this returns immediately.
   void InvalidateDeletedSongs();
 
+  // Queues the local files of all items in the playlist for a background existence check.
+  void CheckLocalFiles(const bool remove_missing);
+
   void ClearCollectionItems();
 
  private Q_SLOTS:
@@ -375,15 +397,30 @@ class Playlist : public QAbstractListModel {
   void QueueLayoutChanged();
   void SongSaveComplete(TagReaderReplyPtr reply, const QPersistentModelIndex &idx, const Song &old_metadata);
   void ItemReloadComplete(const QPersistentModelIndex &idx, const Song &old_metadata, const bool metadata_edit);
-  void ItemsLoaded();
   void ScheduleSave();
   void Save();
+  void FilesChecked(const int job_id, const QList<int> &existing, const QList<int> &missing);
+  void FileCheckFinished(const int job_id);
+  void InvalidatePlayableIndex();
+  void PlayableRowsChanged(const QModelIndex &top_left, const QModelIndex &bottom_right);
+  void PlayableFilterRowsChanged(const QModelIndex &parent, const int first, const int last);
 
  private:
+  struct FileCheckJob {
+    bool remove_missing;
+    PlaylistItemPtrList items;
+  };
+
+  void RestorePage(const qint64 after_position, const qint64 after_rowid, const int limit);
+  void ItemsLoaded(PlaylistItemPtrList items, const bool finished);
+  void FinishRestore();
+
   bool is_loading_;
   PlaylistFilter *filter_;
   Queue *queue_;
   QTimer *timer_save_;
+  PlaylistFileChecker *file_checker_;
+  QMap<int, FileCheckJob> file_check_jobs_;
 
   QList<QModelIndex> temp_dequeue_change_indexes_;
 
@@ -402,6 +439,19 @@ class Playlist : public QAbstractListModel {
   // Contains the indices into items_ in the order that they will be played.
   QList<int> virtual_items_;
 
+  // The rows that are in the filter and not skipped, patched as rows are inserted, removed, moved or changed.
+  // Only rebuilt on the next lookup after the playlist was restored or the filter was reset.
+  mutable PlaylistPlayableIndex playable_rows_;
+  mutable bool playable_rows_valid_;
+
+  // The same set by virtual index and the virtual index of each row, for the shuffle modes.
+  // Copied from playable_rows_ on the next lookup after the play order changed, without testing the filter again.
+  mutable PlaylistPlayableIndex playable_index_;
+  mutable QList<int> virtual_index_of_row_;
+  mutable bool playable_index_valid_;
+
+  std::mt19937 shuffle_generator_;
+
   QList<QPersistentModelIndex> played_indexes_;
 
   QMultiMap<int, PlaylistItemPtr> collection_items_[Song::kSourceCount];
@@ -426,6 +476,12 @@ class Playlist : public QAbstractListModel {
   // Cancel async restore if songs are already replaced
   bool cancel_restore_;
 
+  // Playlists are restored in pages, saves are held back until the last page is loaded.
+  bool is_restoring_;
+  bool save_after_restore_;
+  int restore_row_;
+  int restore_generation_;
+
   bool scrobbled_;
   qint64 scrobble_point_;
 
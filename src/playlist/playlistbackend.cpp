@@ -23,6 +23,8 @@
 
 #include <utility>
 #include <memory>
+#include <algorithm>
+#include <limits>
 
 #include <QObject>
 #include <QApplication>
@@ -33,6 +35,10 @@
 #include <QFile>
 #include <QByteArray>
 #include <QList>
+#include <QHash>
+#include <QMultiHash>
+#include <QSet>
+#include <QVariant>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -56,8 +62,17 @@ using namespace Qt::Literals::StringLiterals;
 using std::make_shared;
 
 namespace {
+
 constexpr int kSongTableJoins = 2;
-}
+
+// Distance between the positions of neighbouring items after compaction, leaving room for items inserted or moved in between.
+constexpr qint64 kPositionGap = 1024;
+
+// Positions are compacted after this many saves if some neighbouring items got too close.
+constexpr int kSavesBetweenCompactions = 100;
+constexpr qint64 kMinPositionGap = 16;
+
+}  // namespace
 
 PlaylistBackend::PlaylistBackend(const SharedPtr<Database> database,
                                  const SharedPtr<TagReaderClient> tagreader_client,
@@ -184,19 +199,22 @@ PlaylistBackend::Playlist PlaylistBackend::GetPlaylist(const int id) {
 
 }
 
-QString PlaylistBackend::PlaylistItemsQuery() {
+QString PlaylistBackend::PlaylistItemsQuery(const bool paged) {
 
-  return QStringLiteral("SELECT %1, %2, p.type FROM playlist_items AS p "
+  // Pages are selected by the position and row ID of the last row of the previous page, so each page is an index range scan.
+  return QStringLiteral("SELECT %1, %2, p.type, p.position FROM playlist_items AS p "
                         "LEFT JOIN songs ON p.type = songs.source AND p.collection_id = songs.ROWID "
-                        "WHERE p.playlist = :playlist"
+                        "WHERE p.playlist = :playlist %3ORDER BY p.position, p.ROWID%4"
                         ).arg(Song::JoinSpec(u"songs"_s),
-                              Song::JoinSpec(u"p"_s));
+                              Song::JoinSpec(u"p"_s),
+                              paged ? u"AND (p.position > :after_position OR (p.position = :same_position AND p.ROWID > :after_rowid)) "_s : QString(),
+                              paged ? u" LIMIT :limit"_s : QString());
 
 }
 
-PlaylistItemPtrList PlaylistBackend::GetPlaylistItems(const int playlist) {
+PlaylistBackend::PlaylistItemsPage PlaylistBackend::GetPlaylistItemsPage(const int playlist, const qint64 after_position, const qint64 after_rowid, const int limit) {
 
-  PlaylistItemPtrList playlist_items;
+  PlaylistItemsPage page;
 
   {
 
@@ -205,17 +223,46 @@ PlaylistItemPtrList PlaylistBackend::GetPlaylistItems(const int playlist) {
     SqlQuery q(db);
     // Forward iterations only may be faster
     q.setForwardOnly(true);
-    q.prepare(PlaylistItemsQuery());
+    q.prepare(PlaylistItemsQuery(true));
     q.BindValue(u":playlist"_s, playlist);
+    q.BindValue(u":after_position"_s, after_rowid == -1 ? std::numeric_limits<qint64>::min() : after_position);
+    q.BindValue(u":same_position"_s, after_rowid == -1 ? std::numeric_limits<qint64>::min() : after_position);
+    q.BindValue(u":after_rowid"_s, after_rowid);
+    q.BindValue(u":limit"_s, limit);
     if (!q.Exec()) {
       database_->ReportErrors(q);
-      return PlaylistItemPtrList();
+      return page;
     }
 
     // It's probable that we'll have a few songs associated with the same CUE, so we're caching results of parsing CUEs
     SharedPtr<NewSongFromQueryState> state_ptr = make_shared<NewSongFromQueryState>();
+    const int rowid_column = static_cast<int>(Song::kRowIdColumns.count());
+    const int position_column = static_cast<int>(Song::kRowIdColumns.count()) * kSongTableJoins + 1;
+    // The snapshot of the saved rows is only used once all pages are loaded, until then saves rewrite the whole playlist.
+    // A save in between discards the partial snapshot, since the rows it refers to are gone.
+    if (after_rowid == -1) {
+      saved_items_.remove(playlist);
+      loading_saved_items_[playlist].clear();
+    }
+    // A page from a restore that was replaced by a new one doesn't follow the snapshot, so it can't be trusted anymore.
+    else if (loading_saved_items_.contains(playlist) && (loading_saved_items_[playlist].isEmpty() || loading_saved_items_[playlist].last().rowid != after_rowid)) {
+      loading_saved_items_.remove(playlist);
+    }
+    SavedItemList *saved_items = loading_saved_items_.contains(playlist) ? &loading_saved_items_[playlist] : nullptr;
+    int rows = 0;
     while (q.next()) {
-      playlist_items << NewPlaylistItemFromQuery(SqlRow(q), state_ptr);
+      const SqlRow row(q);
+      PlaylistItemPtr item = NewPlaylistItemFromQuery(row, state_ptr);
+      page.items << item;
+      page.last_rowid = row.value(rowid_column).toLongLong();
+      page.last_position = row.value(position_column).toLongLong();
+      item->set_database_rowid(page.last_rowid);
+      if (saved_items) *saved_items << NewSavedItem(item, page.last_rowid, page.last_position);
+      ++rows;
+    }
+    page.finished = rows < limit;
+    if (page.finished && saved_items) {
+      saved_items_[playlist] = loading_saved_items_.take(playlist);
     }
 
   }
@@ -224,7 +271,7 @@ PlaylistItemPtrList PlaylistBackend::GetPlaylistItems(const int playlist) {
     Close();
   }
 
-  return playlist_items;
+  return page;
 
 }
 
@@ -343,28 +390,9 @@ void PlaylistBackend::SavePlaylist(int playlist, const PlaylistItemPtrList &item
 
   ScopedTransaction transaction(&db);
 
-  // Clear the existing items in the playlist
-  {
-    SqlQuery q(db);
-    q.prepare(u"DELETE FROM playlist_items WHERE playlist = :playlist"_s);
-    q.BindValue(u":playlist"_s, playlist);
-    if (!q.Exec()) {
-      database_->ReportErrors(q);
-      return;
-    }
-  }
-
-  // Save the new ones
-  for (PlaylistItemPtr item : items) {  // clazy:exclude=range-loop-reference
-    SqlQuery q(db);
-    q.prepare(u"INSERT INTO playlist_items (playlist, type, collection_id, "_s + Song::kColumnSpec + u") VALUES (:playlist, :type, :collection_id, "_s + Song::kBindSpec + u")"_s);
-    q.BindValue(u":playlist"_s, playlist);
-    item->BindToQuery(&q);
-
-    if (!q.Exec()) {
-      database_->ReportErrors(q);
-      return;
-    }
+  SavedItemList saved_items;
+  if (!SavePlaylistItems(db, playlist, items, saved_items)) {
+    return;
   }
 
   // Update the last played track number
@@ -391,6 +419,266 @@ void PlaylistBackend::SavePlaylist(int playlist, const PlaylistItemPtrList &item
 
   transaction.Commit();
 
+  saved_items_[playlist] = saved_items;
+  loading_saved_items_.remove(playlist);
+
+}
+
+PlaylistBackend::SavedItem PlaylistBackend::NewSavedItem(PlaylistItemPtr item, const qint64 rowid, const qint64 position) {
+
+  SavedItem saved_item;
+  saved_item.item = item;
+  saved_item.rowid = rowid;
+  saved_item.position = position;
+  saved_item.generation = item->database_generation();
+
+  return saved_item;
+
+}
+
+QList<qint64> PlaylistBackend::ItemPositions(const SavedItemList &saved_items, const PlaylistItemPtrList &items, const QList<int> &saved_indexes, const bool compact) {
+
+  QList<qint64> positions(items.count(), 0);
+
+  if (compact) {
+    for (int i = 0; i < items.count(); ++i) {
+      positions[i] = (i + 1) * kPositionGap;
+    }
+    return positions;
+  }
+
+  // Find the longest run of saved items that are still in the same relative order, those keep their positions.
+  // This is a longest increasing subsequence over the saved indexes, in O(n log n).
+  QList<bool> keep(items.count(), false);
+  {
+    QList<int> tails;  // Item index of the smallest tail of each subsequence length
+    QList<int> previous(items.count(), -1);
+    for (int i = 0; i < items.count(); ++i) {
+      if (saved_indexes[i] == -1) continue;
+      const QList<int>::iterator it = std::lower_bound(tails.begin(), tails.end(), saved_indexes[i], [&saved_indexes](const int tail, const int saved_index) { return saved_indexes[tail] < saved_index; });
+      const int length = static_cast<int>(it - tails.begin());
+      previous[i] = length > 0 ? tails[length - 1] : -1;
+      if (it == tails.end()) {
+        tails << i;
+      }
+      else {
+        *it = i;
+      }
+    }
+    for (int i = tails.isEmpty() ? -1 : tails.last(); i != -1; i = previous[i]) {
+      keep[i] = true;
+    }
+  }
+
+  // Spread the other items evenly between the kept ones.
+  int left = -1;
+  while (left < items.count()) {
+    int right = left + 1;
+    while (right < items.count() && !keep[right]) ++right;
+    const int count = right - left - 1;
+    if (count > 0) {
+      qint64 left_position = 0;
+      qint64 right_position = 0;
+      if (left == -1 && right == items.count()) {
+        left_position = 0;
+        right_position = (count + 1) * kPositionGap;
+      }
+      else if (left == -1) {
+        right_position = saved_items[saved_indexes[right]].position;
+        left_position = right_position - (count + 1) * kPositionGap;
+      }
+      else if (right == items.count()) {
+        left_position = saved_items[saved_indexes[left]].position;
+        right_position = left_position + (count + 1) * kPositionGap;
+      }
+      else {
+        left_position = saved_items[saved_indexes[left]].position;
+        right_position = saved_items[saved_indexes[right]].position;
+      }
+      const qint64 step = (right_position - left_position) / (count + 1);
+      if (step < 1) {
+        // No room left between the neighbours.
+        return QList<qint64>();
+      }
+      for (int i = 0; i < count; ++i) {
+        positions[left + 1 + i] = left_position + step * (i + 1);
+      }
+    }
+    if (right < items.count()) {
+      positions[right] = saved_items[saved_indexes[right]].position;
+    }
+    left = right;
+  }
+
+  return positions;
+
+}
+
+bool PlaylistBackend::SavePlaylistItems(QSqlDatabase &db, const int playlist, const PlaylistItemPtrList &items, SavedItemList &saved_items) {
+
+  const bool has_saved_items = saved_items_.contains(playlist);
+  const SavedItemList old_saved_items = saved_items_.value(playlist);
+
+  // Without knowing what is in the table, clear the existing items in the playlist and save everything.
+  if (!has_saved_items) {
+    SqlQuery q(db);
+    q.prepare(u"DELETE FROM playlist_items WHERE playlist = :playlist"_s);
+    q.BindValue(u":playlist"_s, playlist);
+    if (!q.Exec()) {
+      database_->ReportErrors(q);
+      return false;
+    }
+  }
+
+  // Match the items to the saved rows by the row ID they were last saved to, this also works for items that were replaced by a new one.
+  // Items which are in the playlist more than once only keep the row ID of the first one, the others are matched by the item itself.
+  QHash<qint64, int> rowid_indexes;
+  rowid_indexes.reserve(old_saved_items.count());
+  for (int i = 0; i < old_saved_items.count(); ++i) {
+    rowid_indexes.insert(old_saved_items[i].rowid, i);
+  }
+  QList<int> saved_indexes(items.count(), -1);
+  QList<bool> matched(old_saved_items.count(), false);
+  QList<int> unmatched_items;
+  for (int i = 0; i < items.count(); ++i) {
+    const int saved_index = rowid_indexes.value(items[i]->database_rowid(), -1);
+    if (saved_index != -1 && !matched[saved_index]) {
+      saved_indexes[i] = saved_index;
+      matched[saved_index] = true;
+    }
+    else {
+      unmatched_items << i;
+    }
+  }
+  if (!unmatched_items.isEmpty()) {
+    QMultiHash<const PlaylistItem*, int> item_indexes;
+    for (int i = 0; i < old_saved_items.count(); ++i) {
+      if (matched[i]) continue;
+      const PlaylistItemPtr item = old_saved_items[i].item.lock();
+      if (item) {
+        item_indexes.insert(&*item, i);
+      }
+    }
+    for (const int i : std::as_const(unmatched_items)) {
+      QMultiHash<const PlaylistItem*, int>::iterator it = item_indexes.find(&*items[i]);
+      if (it != item_indexes.end()) {
+        saved_indexes[i] = it.value();
+        matched[it.value()] = true;
+        item_indexes.erase(it);
+      }
+    }
+  }
+
+  // Whatever is left was removed from the playlist, or deleted altogether.
+  QList<qint64> removed_rowids;
+  for (int i = 0; i < old_saved_items.count(); ++i) {
+    if (!matched[i]) {
+      removed_rowids << old_saved_items[i].rowid;
+    }
+  }
+  if (!removed_rowids.isEmpty()) {
+    SqlQuery q(db);
+    q.prepare(u"DELETE FROM playlist_items WHERE ROWID = :rowid"_s);
+    for (const qint64 rowid : std::as_const(removed_rowids)) {
+      q.BindValue(u":rowid"_s, rowid);
+      if (!q.Exec()) {
+        database_->ReportErrors(q);
+        return false;
+      }
+    }
+  }
+
+  int &saves_since_compaction = saves_since_compaction_[playlist];
+  bool compact = !has_saved_items;
+  if (!compact && ++saves_since_compaction >= kSavesBetweenCompactions) {
+    for (int i = 1; i < old_saved_items.count(); ++i) {
+      if (old_saved_items[i].position - old_saved_items[i - 1].position < kMinPositionGap) {
+        compact = true;
+        break;
+      }
+    }
+  }
+
+  QList<qint64> positions = ItemPositions(old_saved_items, items, saved_indexes, compact);
+  if (positions.isEmpty() && !items.isEmpty()) {
+    compact = true;
+    positions = ItemPositions(old_saved_items, items, saved_indexes, compact);
+  }
+  if (compact) {
+    qLog(Debug) << "Compacting positions of playlist" << playlist;
+    saves_since_compaction = 0;
+  }
+
+  SqlQuery insert_query(db);
+  insert_query.prepare(u"INSERT INTO playlist_items (playlist, type, collection_id, position, "_s + Song::kColumnSpec + u") VALUES (:playlist, :type, :collection_id, :position, "_s + Song::kBindSpec + u")"_s);
+  SqlQuery update_query(db);
+  update_query.prepare(u"UPDATE playlist_items SET type=:type, collection_id=:collection_id, position=:position, "_s + Song::kUpdateSpec + u" WHERE ROWID = :rowid"_s);
+  SqlQuery move_query(db);
+  move_query.prepare(u"UPDATE playlist_items SET position=:position WHERE ROWID = :rowid"_s);
+
+  int inserted = 0, updated = 0, moved = 0;
+
+  saved_items.clear();
+  saved_items.reserve(items.count());
+  QSet<const PlaylistItem*> saved_rowid_items;
+  for (int i = 0; i < items.count(); ++i) {
+    PlaylistItemPtr item = items[i];
+    const qint64 position = positions[i];
+
+    if (saved_indexes[i] == -1) {
+      // Take the generation before binding the values, a change in between is saved the next time.
+      SavedItem new_saved_item = NewSavedItem(item, -1, position);
+      insert_query.BindValue(u":playlist"_s, playlist);
+      insert_query.BindValue(u":position"_s, position);
+      item->BindToQuery(&insert_query);
+      if (!insert_query.Exec()) {
+        database_->ReportErrors(insert_query);
+        return false;
+      }
+      new_saved_item.rowid = insert_query.lastInsertId().toLongLong();
+      saved_items << new_saved_item;
+      if (!saved_rowid_items.contains(&*item)) {
+        saved_rowid_items.insert(&*item);
+        item->set_database_rowid(new_saved_item.rowid);
+      }
+      ++inserted;
+      continue;
+    }
+
+    const SavedItem &saved_item = old_saved_items[saved_indexes[i]];
+    SavedItem new_saved_item = NewSavedItem(item, saved_item.rowid, position);
+    if (!saved_rowid_items.contains(&*item)) {
+      saved_rowid_items.insert(&*item);
+      item->set_database_rowid(saved_item.rowid);
+    }
+    // Only items that were replaced or changed since the last save are written again.
+    const bool same_item = !saved_item.item.owner_before(item) && !item.owner_before(saved_item.item);
+    if (!same_item || new_saved_item.generation != saved_item.generation) {
+      update_query.BindValue(u":position"_s, position);
+      update_query.BindValue(u":rowid"_s, saved_item.rowid);
+      item->BindToQuery(&update_query);
+      if (!update_query.Exec()) {
+        database_->ReportErrors(update_query);
+        return false;
+      }
+      ++updated;
+    }
+    else if (position != saved_item.position) {
+      move_query.BindValue(u":position"_s, position);
+      move_query.BindValue(u":rowid"_s, saved_item.rowid);
+      if (!move_query.Exec()) {
+        database_->ReportErrors(move_query);
+        return false;
+      }
+      ++moved;
+    }
+    saved_items << new_saved_item;
+  }
+
+  qLog(Debug) << "Playlist" << playlist << "saved:" << inserted << "inserted," << updated << "updated," << moved << "moved," << removed_rowids.count() << "removed";
+
+  return true;
+
 }
 
 int PlaylistBackend::CreatePlaylist(const QString &name, const QString &special_type) {
@@ -440,6 +728,10 @@ void PlaylistBackend::RemovePlaylist(int id) {
 
   transaction.Commit();
 
+  saved_items_.remove(id);
+  loading_saved_items_.remove(id);
+  saves_since_compaction_.remove(id);
+
 }
 
 void PlaylistBackend::RenamePlaylist(const int id, const QString &new_name) {
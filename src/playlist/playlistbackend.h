@@ -24,6 +24,8 @@
 
 #include "config.h"
 
+#include <memory>
+
 #include <QObject>
 #include <QMutex>
 #include <QHash>
@@ -38,6 +40,7 @@
 #include "smartplaylists/playlistgenerator.h"
 
 class QThread;
+class QSqlDatabase;
 class Database;
 class TagReaderClient;
 
@@ -65,6 +68,16 @@ class PlaylistBackend : public QObject {
   };
   using PlaylistList = QList<Playlist>;
 
+  // A page of playlist items, the position and row ID of the last row are used to request the next page.
+  struct PlaylistItemsPage {
+    PlaylistItemsPage() : last_position(0), last_rowid(-1), finished(true) {}
+
+    PlaylistItemPtrList items;
+    qint64 last_position;
+    qint64 last_rowid;
+    bool finished;
+  };
+
   void Close();
   void ExitAsync();
 
@@ -73,7 +86,8 @@ class PlaylistBackend : public QObject {
   PlaylistList GetAllFavoritePlaylists();
   PlaylistBackend::Playlist GetPlaylist(const int id);
 
-  PlaylistItemPtrList GetPlaylistItems(const int playlist);
+  // Returns up to limit items following after_position and after_rowid, start with a row ID of -1 to get the first page.
+  PlaylistItemsPage GetPlaylistItemsPage(const int playlist, const qint64 after_position, const qint64 after_rowid, const int limit);
   SongList GetPlaylistSongs(const int playlist);
 
   void SetPlaylistOrder(const QList<int> &ids);
@@ -93,16 +107,29 @@ class PlaylistBackend : public QObject {
   void ExitFinished();
 
  private:
+  // What was last written to the playlist_items table for an item, used to save only the changes.
+  struct SavedItem {
+    std::weak_ptr<PlaylistItem> item;
+    qint64 rowid;
+    qint64 position;
+    quint64 generation;
+  };
+  using SavedItemList = QList<SavedItem>;
+
   struct NewSongFromQueryState {
     QHash<QString, SongList> cached_cues_;
     QMutex mutex_;
   };
 
-  static QString PlaylistItemsQuery();
+  static QString PlaylistItemsQuery(const bool paged = false);
   Song NewSongFromQuery(const SqlRow &row, SharedPtr<NewSongFromQueryState> state);
   PlaylistItemPtr NewPlaylistItemFromQuery(const SqlRow &row, SharedPtr<NewSongFromQueryState> state);
   PlaylistItemPtr RestoreCueData(PlaylistItemPtr item, SharedPtr<NewSongFromQueryState> state);
 
+  static SavedItem NewSavedItem(PlaylistItemPtr item, const qint64 rowid, const qint64 position);
+  static QList<qint64> ItemPositions(const SavedItemList &saved_items, const PlaylistItemPtrList &items, const QList<int> &saved_indexes, const bool compact);
+  bool SavePlaylistItems(QSqlDatabase &db, const int playlist, const PlaylistItemPtrList &items, SavedItemList &saved_items);
+
   enum GetPlaylistsFlags {
     GetPlaylists_OpenInUi = 1,
     GetPlaylists_Favorite = 2,
@@ -114,6 +141,12 @@ class PlaylistBackend : public QObject {
   const SharedPtr<TagReaderClient> tagreader_client_;
   const SharedPtr<CollectionBackend> collection_backend_;
   QThread *original_thread_;
+
+  // The rows currently in playlist_items for each loaded playlist, and the number of saves since the positions were last compacted.
+  // Both are only accessed while holding the database mutex, so they always match the table.
+  QHash<int, SavedItemList> saved_items_;
+  QHash<int, SavedItemList> loading_saved_items_;
+  QHash<int, int> saves_since_compaction_;
 };
 
 #endif  // PLAYLISTBACKEND_H
@@ -27,10 +27,6 @@
 #include <QApplication>
 #include <QObject>
 #include <QWidget>
-#include <QThread>
-#include <QtConcurrentRun>
-#include <QFuture>
-#include <QFutureWatcher>
 #include <QAbstractItemModel>
 #include <QAbstractItemView>
 #include <QCompleter>
@@ -48,6 +44,10 @@
 #include <QPixmap>
 #include <QPixmapCache>
 #include <QPainter>
+#include <QPalette>
+#include <QStaticText>
+#include <QStyle>
+#include <QTransform>
 #include <QColor>
 #include <QPen>
 #include <QPoint>
@@ -67,9 +67,9 @@
 #include "core/song.h"
 #include "utilities/strutils.h"
 #include "utilities/timeutils.h"
-#include "collection/collectionbackend.h"
 #include "playlist/playlist.h"
 #include "playlistdelegates.h"
+#include "tagcompletionstore.h"
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -81,6 +81,8 @@ constexpr QRgb kQueueBoxGradientColor1 = qRgb(102, 150, 227);
 constexpr QRgb kQueueBoxGradientColor2 = qRgb(77, 121, 200);
 constexpr int kQueueOpacitySteps = 10;
 constexpr float kQueueOpacityLowerBound = 0.4F;
+constexpr int kDisplayTextCacheSize = 4096;
+constexpr int kStaticTextCacheSize = 2048;
 }  // namespace
 
 const int PlaylistDelegateBase::kMinHeight = 19;
@@ -92,6 +94,11 @@ QueuedItemDelegate::QueuedItemDelegate(QObject *parent, const int indicator_colu
 void QueuedItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &idx) const {
 
   QStyledItemDelegate::paint(painter, option, idx);
+  DrawQueueIndicator(painter, option, idx);
+
+}
+
+void QueuedItemDelegate::DrawQueueIndicator(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &idx) const {
 
   if (idx.column() == indicator_column_) {
     bool ok = false;
@@ -166,8 +173,18 @@ int QueuedItemDelegate::queue_indicator_size(const QModelIndex &idx) const {
 
 
 PlaylistDelegateBase::PlaylistDelegateBase(QObject *parent, const QString &suffix)
-    : QueuedItemDelegate(parent), view_(qobject_cast<QTreeView*>(parent)), suffix_(suffix)
-{
+    : QueuedItemDelegate(parent), view_(qobject_cast<QTreeView*>(parent)), suffix_(suffix) {
+
+  display_text_cache_.setMaxCost(kDisplayTextCacheSize);
+  static_text_cache_.setMaxCost(kStaticTextCacheSize);
+
+}
+
+void PlaylistDelegateBase::ClearCaches() {
+
+  display_text_cache_.clear();
+  static_text_cache_.clear();
+
 }
 
 QString PlaylistDelegateBase::displayText(const QVariant &value, const QLocale &locale) const {
@@ -214,7 +231,9 @@ QSize PlaylistDelegateBase::sizeHint(const QStyleOptionViewItem &option, const Q
 
 void PlaylistDelegateBase::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &idx) const {
 
-  QueuedItemDelegate::paint(painter, Adjusted(option, idx), idx);
+  const QStyleOptionViewItem adjusted_option = Adjusted(option, idx);
+  DrawItem(painter, adjusted_option, idx);
+  DrawQueueIndicator(painter, adjusted_option, idx);
 
   // Stop after indicator
   if (idx.column() == static_cast<int>(Playlist::Column::Title)) {
@@ -228,6 +247,63 @@ void PlaylistDelegateBase::paint(QPainter *painter, const QStyleOptionViewItem &
 
 }
 
+void PlaylistDelegateBase::DrawItem(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &idx) const {
+
+  QStyleOptionViewItem option_copy(option);
+  initStyleOption(&option_copy, idx);
+
+  const QWidget *widget = option_copy.widget;
+  QStyle *style = widget ? widget->style() : QApplication::style();
+
+  // Wrapped and multiline texts are left to the style.
+  if (option_copy.text.isEmpty() || option_copy.features.testFlag(QStyleOptionViewItem::WrapText) || option_copy.text.contains(QLatin1Char('\n'))) {
+    style->drawControl(QStyle::CE_ItemViewItem, &option_copy, painter, widget);
+    return;
+  }
+
+  // Let the style draw everything but the text, the text is drawn from a cached static text, so scrolling doesn't elide and lay out the same texts again.
+  const QString text = option_copy.text;
+  QRect text_rect = style->subElementRect(QStyle::SE_ItemViewItemText, &option_copy, widget);
+  option_copy.text.clear();
+  style->drawControl(QStyle::CE_ItemViewItem, &option_copy, painter, widget);
+
+  const int text_margin = style->pixelMetric(QStyle::PM_FocusFrameHMargin, nullptr, widget) + 1;
+  text_rect.adjust(text_margin, 0, -text_margin, 0);
+  if (text_rect.width() <= 0) return;
+
+  const QStaticText *static_text = CachedStaticText(option_copy, text, text_rect);
+  if (!static_text) return;
+
+  QPalette::ColorGroup color_group = option_copy.state.testFlag(QStyle::State_Enabled) ? QPalette::Normal : QPalette::Disabled;
+  if (color_group == QPalette::Normal && !option_copy.state.testFlag(QStyle::State_Active)) {
+    color_group = QPalette::Inactive;
+  }
+
+  painter->save();
+  painter->setPen(option_copy.palette.color(color_group, option_copy.state.testFlag(QStyle::State_Selected) ? QPalette::HighlightedText : QPalette::Text));
+  painter->setFont(option_copy.font);
+  painter->setClipRect(text_rect, Qt::IntersectClip);
+  const QRect static_text_rect = QStyle::alignedRect(option_copy.direction, option_copy.displayAlignment, static_text->size().toSize(), text_rect);
+  painter->drawStaticText(static_text_rect.topLeft(), *static_text);
+  painter->restore();
+
+}
+
+const QStaticText *PlaylistDelegateBase::CachedStaticText(const QStyleOptionViewItem &option, const QString &text, const QRect text_rect) const {
+
+  const StaticTextKey key { text, text_rect.width(), static_cast<int>(option.displayAlignment), option.font };
+  if (const QStaticText *static_text = static_text_cache_.object(key)) return static_text;
+
+  QStaticText *static_text = new QStaticText(option.fontMetrics.elidedText(text, option.textElideMode, text_rect.width()));
+  static_text->setTextFormat(Qt::PlainText);
+  static_text->setPerformanceHint(QStaticText::AggressiveCaching);
+  static_text->prepare(QTransform(), option.font);
+  if (!static_text_cache_.insert(key, static_text)) return nullptr;
+
+  return static_text;
+
+}
+
 QStyleOptionViewItem PlaylistDelegateBase::Adjusted(const QStyleOptionViewItem &option, const QModelIndex &idx) const {
 
   if (!view_) return option;
@@ -306,7 +382,7 @@ QString LengthItemDelegate::displayText(const QVariant &value, const QLocale &lo
   bool ok = false;
   qint64 nanoseconds = value.toLongLong(&ok);
 
-  if (ok && nanoseconds > 0) return Utilities::PrettyTimeNanosec(nanoseconds);
+  if (ok && nanoseconds > 0) return CachedDisplayText(nanoseconds, [nanoseconds]() { return Utilities::PrettyTimeNanosec(nanoseconds); });
   return QString();
 
 }
@@ -319,7 +395,7 @@ QString SizeItemDelegate::displayText(const QVariant &value, const QLocale &loca
   bool ok = false;
   qint64 bytes = value.toLongLong(&ok);
 
-  if (ok && bytes > 0) return Utilities::PrettySize(static_cast<quint64>(bytes));
+  if (ok && bytes > 0) return CachedDisplayText(bytes, [bytes]() { return Utilities::PrettySize(static_cast<quint64>(bytes)); });
   return QString();
 
 }
@@ -335,7 +411,7 @@ QString DateItemDelegate::displayText(const QVariant &value, const QLocale &loca
     return QString();
   }
 
-  return QDateTime::fromSecsSinceEpoch(time).toString(QLocale::system().dateTimeFormat(QLocale::ShortFormat));
+  return CachedDisplayText(time, [time]() { return QDateTime::fromSecsSinceEpoch(time).toString(QLocale::system().dateTimeFormat(QLocale::ShortFormat)); });
 
 }
 
@@ -371,69 +447,14 @@ QWidget *TextItemDelegate::createEditor(QWidget *parent, const QStyleOptionViewI
   return new QLineEdit(parent);
 }
 
-TagCompletionModel::TagCompletionModel(SharedPtr<CollectionBackend> backend, const Playlist::Column column, QObject *parent) : QStringListModel(parent) {
-
-  QString col = database_column(column);
-  if (!col.isEmpty()) {
-    setStringList(backend->GetAll(col));
-  }
+TagCompleter::TagCompleter(TagCompletionStore *store, const Playlist::Column column, QLineEdit *editor) : QCompleter(editor) {
 
-  if (QThread::currentThread() != backend->thread() && QThread::currentThread() != qApp->thread()) {
-    backend->Close();
+  if (store) {
+    setModel(store->model(column));
   }
-
-}
-
-QString TagCompletionModel::database_column(const Playlist::Column column) {
-
-  switch (column) {
-    case Playlist::Column::Artist:          return u"artist"_s;
-    case Playlist::Column::ArtistSort:      return u"artistsort"_s;
-    case Playlist::Column::Album:           return u"album"_s;
-    case Playlist::Column::AlbumSort:       return u"albumsort"_s;
-    case Playlist::Column::AlbumArtist:     return u"albumartist"_s;
-    case Playlist::Column::AlbumArtistSort: return u"albumartistsort"_s;
-    case Playlist::Column::Composer:        return u"composer"_s;
-    case Playlist::Column::ComposerSort:    return u"composersort"_s;
-    case Playlist::Column::Performer:       return u"performer"_s;
-    case Playlist::Column::PerformerSort:   return u"performersort"_s;
-    case Playlist::Column::Grouping:        return u"grouping"_s;
-    case Playlist::Column::Genre:           return u"genre"_s;
-    case Playlist::Column::TitleSort:       return u"titlesort"_s;
-    default:
-      qLog(Warning) << "Unknown column" << static_cast<int>(column);
-      return QString();
-  }
-
-}
-
-static TagCompletionModel *InitCompletionModel(SharedPtr<CollectionBackend> backend, Playlist::Column column) {
-
-  return new TagCompletionModel(backend, column);
-
-}
-
-TagCompleter::TagCompleter(SharedPtr<CollectionBackend> backend, const Playlist::Column column, QLineEdit *editor) : QCompleter(editor), editor_(editor) {
-
-  QFuture<TagCompletionModel*> future = QtConcurrent::run(&InitCompletionModel, backend, column);
-  QFutureWatcher<TagCompletionModel*> *watcher = new QFutureWatcher<TagCompletionModel*>();
-  QObject::connect(watcher, &QFutureWatcher<TagCompletionModel*>::finished, this, &TagCompleter::ModelReady);
-  watcher->setFuture(future);
-
-}
-
-TagCompleter::~TagCompleter() {
-  delete model();
-}
-
-void TagCompleter::ModelReady() {
-
-  QFutureWatcher<TagCompletionModel*> *watcher = static_cast<QFutureWatcher<TagCompletionModel*>*>(sender());
-  TagCompletionModel *model = watcher->result();
-  watcher->deleteLater();
-  setModel(model);
+  setModelSorting(QCompleter::CaseInsensitivelySortedModel);
   setCaseSensitivity(Qt::CaseInsensitive);
-  editor_->setCompleter(this);
+  editor->setCompleter(this);
 
 }
 
@@ -443,7 +464,7 @@ QWidget *TagCompletionItemDelegate::createEditor(QWidget *parent, const QStyleOp
   Q_UNUSED(idx)
 
   QLineEdit *editor = new QLineEdit(parent);
-  new TagCompleter(backend_, column_, editor);
+  new TagCompleter(store_, column_, editor);
 
   return editor;
 
@@ -31,6 +31,9 @@
 #include <QStyleOptionViewItem>
 #include <QTreeView>
 #include <QCompleter>
+#include <QCache>
+#include <QHashFunctions>
+#include <QStaticText>
 #include <QLocale>
 #include <QVariant>
 #include <QUrl>
@@ -42,7 +45,6 @@
 #include <QSize>
 #include <QFont>
 #include <QString>
-#include <QStringListModel>
 #include <QStyleOption>
 #include <QHelpEvent>
 #include <QLineEdit>
@@ -51,8 +53,8 @@
 #include "core/song.h"
 #include "widgets/ratingwidget.h"
 
-class CollectionBackend;
 class Player;
+class TagCompletionStore;
 
 class QueuedItemDelegate : public QStyledItemDelegate {
   Q_OBJECT
@@ -65,6 +67,9 @@ class QueuedItemDelegate : public QStyledItemDelegate {
 
   int queue_indicator_size(const QModelIndex &idx) const;
 
+ protected:
+  void DrawQueueIndicator(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &idx) const;
+
  private:
   int indicator_column_;
 };
@@ -81,14 +86,44 @@ class PlaylistDelegateBase : public QueuedItemDelegate {
 
   QStyleOptionViewItem Adjusted(const QStyleOptionViewItem &option, const QModelIndex &idx) const;
 
+  // Drops the cached texts, for when the locale, the fonts or the settings changed.
+  void ClearCaches();
+
   static const int kMinHeight;
 
  public Q_SLOTS:
   bool helpEvent(QHelpEvent *event, QAbstractItemView *view, const QStyleOptionViewItem &option, const QModelIndex &idx) override;
 
  protected:
+  // Returns the text previously formatted for the same value, so scrolling doesn't format the same values over and over again.
+  // The cache is keyed by the value itself, so it doesn't have to be invalidated when the playlist changes, only when the locale does.
+  template<typename FormatFunc>
+  QString CachedDisplayText(const qint64 value, FormatFunc format) const {
+    if (const QString *text = display_text_cache_.object(value)) return *text;
+    const QString text = format();
+    display_text_cache_.insert(value, new QString(text));
+    return text;
+  }
+
   QTreeView *view_;
   QString suffix_;
+
+ private:
+  // The elided text of a cell shaped for its width and font, the cell text and width change with the data and the column size.
+  struct StaticTextKey {
+    QString text;
+    int width;
+    int alignment;
+    QFont font;
+    bool operator==(const StaticTextKey &other) const { return width == other.width && alignment == other.alignment && text == other.text && font == other.font; }
+    friend size_t qHash(const StaticTextKey &key, size_t seed = 0) { return qHashMulti(seed, key.text, key.width, key.alignment, key.font); }
+  };
+
+  void DrawItem(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &idx) const;
+  const QStaticText *CachedStaticText(const QStyleOptionViewItem &option, const QString &text, const QRect text_rect) const;
+
+  mutable QCache<qint64, QString> display_text_cache_;
+  mutable QCache<StaticTextKey, QStaticText> static_text_cache_;
 };
 
 class LengthItemDelegate : public PlaylistDelegateBase {
@@ -139,40 +174,23 @@ class TextItemDelegate : public PlaylistDelegateBase {
   QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &idx) const override;
 };
 
-class TagCompletionModel : public QStringListModel {
-  Q_OBJECT
-
- public:
-  explicit TagCompletionModel(SharedPtr<CollectionBackend> backend, const Playlist::Column column, QObject *parent = nullptr);
-
- private:
-  static QString database_column(const Playlist::Column column);
-};
-
 class TagCompleter : public QCompleter {
   Q_OBJECT
 
  public:
-  explicit TagCompleter(SharedPtr<CollectionBackend> backend, const Playlist::Column column, QLineEdit *editor);
-  ~TagCompleter() override;
-
- private Q_SLOTS:
-  void ModelReady();
-
- private:
-  QLineEdit *editor_;
+  explicit TagCompleter(TagCompletionStore *store, const Playlist::Column column, QLineEdit *editor);
 };
 
 class TagCompletionItemDelegate : public PlaylistDelegateBase {
   Q_OBJECT
 
  public:
-  explicit TagCompletionItemDelegate(QObject *parent, SharedPtr<CollectionBackend> backend, Playlist::Column column) : PlaylistDelegateBase(parent), backend_(backend), column_(column) {};
+  explicit TagCompletionItemDelegate(QObject *parent, TagCompletionStore *store, Playlist::Column column) : PlaylistDelegateBase(parent), store_(store), column_(column) {};
 
   QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &idx) const override;
 
  private:
-  SharedPtr<CollectionBackend> backend_;
+  TagCompletionStore *store_;
   Playlist::Column column_;
 };
 
@@ -0,0 +1,346 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <atomic>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <chrono>
+
+#include <QObject>
+#include <QThreadPool>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QList>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QFileInfo>
+#include <QStorageInfo>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "playlistfilechecker.h"
+
+using std::make_shared;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Number of files stat'ed by a worker before results are handed back.
+constexpr int kBatchSize = 200;
+
+// Maximum number of workers checking the same mount point in parallel.
+constexpr int kMaxWorkersPerMount = 4;
+
+// Maximum number of worker threads for all mount points, not counting workers stuck on abandoned mount points.
+constexpr int kMaxThreads = 8;
+
+// A mount point where a single check hasn't returned for this long is given up on.
+constexpr qint64 kCheckTimeoutMsec = 5000;
+
+struct AbandonedMounts {
+  QMutex mutex;
+  // Workers that were still checking files on an abandoned mount point, by root path.
+  // New jobs skip these mount points until all their workers have returned.
+  QHash<QString, int> stuck_workers;
+};
+
+AbandonedMounts *abandoned_mounts() {
+
+  // Never deleted, stuck workers can still be using it when the application exits.
+  static AbandonedMounts *abandoned_mounts = new AbandonedMounts;
+  return abandoned_mounts;
+
+}
+
+}  // namespace
+
+struct PlaylistFileChecker::MountGroup {
+  explicit MountGroup(const QString &_root_path) : root_path(_root_path), next_batch(0), active_workers(0), abandoned(false) {
+    for (std::atomic<qint64> &msec : check_started_msec) msec = -1;
+  }
+  QString root_path;
+  QList<int> positions;
+  std::atomic<int> next_batch;
+  // When the check each worker is in started, or -1 between checks.
+  std::array<std::atomic<qint64>, kMaxWorkersPerMount> check_started_msec;
+  // Held while changing active_workers or abandoned, so each stuck worker is counted exactly once.
+  QMutex mutex;
+  std::atomic<int> active_workers;
+  std::atomic<bool> abandoned;
+};
+
+struct PlaylistFileChecker::Job {
+  explicit Job(const int _id, const QStringList &_filenames) : id(_id), filenames(_filenames), planned(false), cancelled(false) { timer.start(); }
+  const int id;
+  const QStringList filenames;
+  QElapsedTimer timer;
+  std::atomic<bool> planned;
+  std::atomic<bool> cancelled;
+  // Only written by the planner before planned is set.
+  QList<SharedPtr<MountGroup>> groups;
+
+  QMutex mutex_results;
+  QList<int> existing;
+  QList<int> missing;
+};
+
+PlaylistFileChecker::PlaylistFileChecker(QObject *parent)
+    : QObject(parent),
+      timer_process_results_(new QTimer(this)),
+      next_id_(1) {
+
+  timer_process_results_->setInterval(100ms);
+  QObject::connect(timer_process_results_, &QTimer::timeout, this, &PlaylistFileChecker::ProcessResults);
+
+}
+
+PlaylistFileChecker::~PlaylistFileChecker() {
+  CancelAll();
+}
+
+QThreadPool *PlaylistFileChecker::threadpool() {
+
+  // Not the global thread pool, so a dead network share can't starve unrelated work.
+  // The pool is never deleted, deleting it on exit would wait for workers stuck in a stat call forever.
+  static QThreadPool *pool = []() {
+    QThreadPool *threadpool = new QThreadPool;
+    threadpool->setMaxThreadCount(kMaxThreads);
+    return threadpool;
+  }();
+
+  return pool;
+
+}
+
+int PlaylistFileChecker::CheckFiles(const QStringList &filenames) {
+
+  const int job_id = next_id_++;
+  JobPtr job = make_shared<Job>(job_id, filenames);
+  jobs_.insert(job_id, job);
+
+  threadpool()->start([job]() { PlanJob(job); });
+
+  if (!timer_process_results_->isActive()) {
+    timer_process_results_->start();
+  }
+
+  return job_id;
+
+}
+
+void PlaylistFileChecker::CancelAll() {
+
+  for (const JobPtr &job : std::as_const(jobs_)) {
+    job->cancelled = true;
+  }
+  jobs_.clear();
+  timer_process_results_->stop();
+
+}
+
+QString PlaylistFileChecker::RootPathForFile(const QStringList &root_paths, const QString &filename) {
+
+  // Only whole path components match, so /mnt/a isn't the mount point of /mnt/ab.
+  for (const QString &root_path : root_paths) {
+    if (root_path.endsWith(u'/') ? filename.startsWith(root_path) : filename.startsWith(root_path + u'/')) {
+      return root_path;
+    }
+  }
+
+  return QString();
+
+}
+
+void PlaylistFileChecker::PlanJob(JobPtr job) {
+
+  // Longest root paths first, so nested mount points are matched before their parents.
+  QStringList root_paths;
+  const QList<QStorageInfo> volumes = QStorageInfo::mountedVolumes();
+  root_paths.reserve(volumes.count());
+  for (const QStorageInfo &volume : volumes) {
+    root_paths << volume.rootPath();
+  }
+  std::sort(root_paths.begin(), root_paths.end(), [](const QString &a, const QString &b) { return a.length() > b.length(); });
+
+  QHash<QString, int> stuck_workers;
+  {
+    QMutexLocker l(&abandoned_mounts()->mutex);
+    stuck_workers = abandoned_mounts()->stuck_workers;
+  }
+
+  QHash<QString, SharedPtr<MountGroup>> groups;
+  for (int i = 0; i < job->filenames.count(); ++i) {
+    if (job->cancelled) return;
+    const QString root_path = RootPathForFile(root_paths, job->filenames[i]);
+    // Files on a mount point that still has workers stuck from an earlier job are not reported, like files on a mount point that times out.
+    if (stuck_workers.contains(root_path)) continue;
+    SharedPtr<MountGroup> group = groups.value(root_path);
+    if (!group) {
+      group = make_shared<MountGroup>(root_path);
+      groups.insert(root_path, group);
+      job->groups << group;
+    }
+    group->positions << i;
+  }
+
+  // Workers must be counted before the job is marked as planned, otherwise a group could look finished before it started.
+  QList<QPair<SharedPtr<MountGroup>, int>> workers;
+  for (const SharedPtr<MountGroup> &group : std::as_const(job->groups)) {
+    const int batches = (static_cast<int>(group->positions.count()) + kBatchSize - 1) / kBatchSize;
+    const int worker_count = std::min(batches, kMaxWorkersPerMount);
+    group->active_workers = worker_count;
+    workers << qMakePair(group, worker_count);
+  }
+
+  job->planned = true;
+
+  for (const QPair<SharedPtr<MountGroup>, int> &worker : std::as_const(workers)) {
+    for (int i = 0; i < worker.second; ++i) {
+      SharedPtr<MountGroup> group = worker.first;
+      threadpool()->start([job, group, i]() { CheckMountGroup(job, group, i); });
+    }
+  }
+
+}
+
+void PlaylistFileChecker::CheckMountGroup(JobPtr job, SharedPtr<MountGroup> group, const int worker) {
+
+  const int count = static_cast<int>(group->positions.count());
+  std::atomic<qint64> &check_started_msec = group->check_started_msec[worker];
+
+  while (!job->cancelled && !group->abandoned) {
+    const int begin = group->next_batch.fetch_add(kBatchSize);
+    if (begin >= count) break;
+    const int end = std::min(begin + kBatchSize, count);
+
+    QList<int> existing;
+    QList<int> missing;
+    for (int i = begin; i < end && !job->cancelled && !group->abandoned; ++i) {
+      const int position = group->positions[i];
+      check_started_msec = job->timer.elapsed();
+      if (QFileInfo::exists(job->filenames[position])) {
+        existing << position;
+      }
+      else {
+        missing << position;
+      }
+      check_started_msec = -1;
+    }
+
+    if (job->cancelled || group->abandoned) break;
+
+    QMutexLocker l(&job->mutex_results);
+    job->existing << existing;
+    job->missing << missing;
+  }
+
+  QMutexLocker l(&group->mutex);
+  --group->active_workers;
+  if (group->abandoned) {
+    // This worker was counted as stuck when the mount point was abandoned, give its thread back.
+    QMutexLocker l_abandoned(&abandoned_mounts()->mutex);
+    if (--abandoned_mounts()->stuck_workers[group->root_path] <= 0) {
+      abandoned_mounts()->stuck_workers.remove(group->root_path);
+    }
+    threadpool()->setMaxThreadCount(threadpool()->maxThreadCount() - 1);
+  }
+
+}
+
+void PlaylistFileChecker::AbandonMountGroup(SharedPtr<MountGroup> group) {
+
+  QMutexLocker l(&group->mutex);
+  if (group->abandoned) return;
+  group->abandoned = true;
+  if (group->active_workers <= 0) return;
+
+  // The workers might never return from the stat call they are in, so they no longer count against the thread limit.
+  QMutexLocker l_abandoned(&abandoned_mounts()->mutex);
+  abandoned_mounts()->stuck_workers[group->root_path] += group->active_workers;
+  threadpool()->setMaxThreadCount(threadpool()->maxThreadCount() + group->active_workers);
+
+}
+
+void PlaylistFileChecker::ProcessResults() {
+
+  const QList<int> job_ids = jobs_.keys();
+  for (const int job_id : job_ids) {
+    JobPtr job = jobs_.value(job_id);
+    if (!job) continue;
+
+    QList<int> existing;
+    QList<int> missing;
+    {
+      QMutexLocker l(&job->mutex_results);
+      existing.swap(job->existing);
+      missing.swap(job->missing);
+    }
+
+    if (!existing.isEmpty() || !missing.isEmpty()) {
+      Q_EMIT FilesChecked(job_id, existing, missing);
+      if (!jobs_.contains(job_id)) continue;
+    }
+
+    if (!job->planned) continue;
+
+    const qint64 elapsed_msec = job->timer.elapsed();
+    bool finished = true;
+    for (const SharedPtr<MountGroup> &group : std::as_const(job->groups)) {
+      if (group->active_workers == 0 || group->abandoned) continue;
+      const bool timed_out = std::any_of(group->check_started_msec.begin(), group->check_started_msec.end(), [elapsed_msec](const std::atomic<qint64> &check_started_msec) {
+        const qint64 msec = check_started_msec;
+        return msec >= 0 && elapsed_msec - msec > kCheckTimeoutMsec;
+      });
+      if (timed_out) {
+        qLog(Warning) << "Giving up checking files on" << group->root_path << "after a check didn't return for" << kCheckTimeoutMsec << "ms";
+        AbandonMountGroup(group);
+        continue;
+      }
+      finished = false;
+    }
+
+    if (finished) {
+      // Workers may have queued a last batch between taking the results and checking the groups.
+      existing.clear();
+      missing.clear();
+      {
+        QMutexLocker l(&job->mutex_results);
+        existing.swap(job->existing);
+        missing.swap(job->missing);
+      }
+      if (!existing.isEmpty() || !missing.isEmpty()) {
+        Q_EMIT FilesChecked(job_id, existing, missing);
+      }
+      jobs_.remove(job_id);
+      Q_EMIT Finished(job_id);
+    }
+  }
+
+  if (jobs_.isEmpty()) {
+    timer_process_results_->stop();
+  }
+
+}
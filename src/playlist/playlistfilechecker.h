@@ -0,0 +1,81 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PLAYLISTFILECHECKER_H
+#define PLAYLISTFILECHECKER_H
+
+#include "config.h"
+
+#include <QObject>
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "includes/shared_ptr.h"
+
+class QTimer;
+class QThreadPool;
+
+// Checks whether local files exist without blocking the GUI thread.
+// Files are grouped by mount point, each mount point is checked in batches by its own workers,
+// and a mount point where a single check doesn't return in time is abandoned so a dead network share can't stall the rest.
+// Results are delivered incrementally on the thread the checker lives in.
+class PlaylistFileChecker : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit PlaylistFileChecker(QObject *parent = nullptr);
+  ~PlaylistFileChecker() override;
+
+  // Starts checking the given local filenames and returns the job ID.
+  int CheckFiles(const QStringList &filenames);
+  void CancelAll();
+
+  bool is_idle() const { return jobs_.isEmpty(); }
+
+  // Returns the mount point of the file, root_paths has to be sorted with the longest paths first.
+  static QString RootPathForFile(const QStringList &root_paths, const QString &filename);
+
+ Q_SIGNALS:
+  // Positions refer to the filenames list passed to CheckFiles.
+  // Files on mount points that timed out are not reported at all.
+  void FilesChecked(const int job_id, const QList<int> &existing, const QList<int> &missing);
+  void Finished(const int job_id);
+
+ private:
+  struct MountGroup;
+  struct Job;
+  using JobPtr = SharedPtr<Job>;
+
+  static QThreadPool *threadpool();
+  static void PlanJob(JobPtr job);
+  static void CheckMountGroup(JobPtr job, SharedPtr<MountGroup> group, const int worker);
+  static void AbandonMountGroup(SharedPtr<MountGroup> group);
+
+ private Q_SLOTS:
+  void ProcessResults();
+
+ private:
+  QTimer *timer_process_results_;
+  int next_id_;
+  QMap<int, JobPtr> jobs_;
+};
+
+#endif  // PLAYLISTFILECHECKER_H
@@ -39,7 +39,7 @@
 using std::make_shared;
 using namespace Qt::Literals::StringLiterals;
 
-PlaylistItem::PlaylistItem(const Song::Source source) : should_skip_(false), source_(source) {}
+PlaylistItem::PlaylistItem(const Song::Source source) : should_skip_(false), source_(source), database_rowid_(-1), database_generation_(0) {}
 
 PlaylistItem::~PlaylistItem() = default;
 
@@ -25,6 +25,7 @@
 #include "config.h"
 
 #include <memory>
+#include <atomic>
 
 #include <QFuture>
 #include <QMetaType>
@@ -88,6 +89,12 @@ class PlaylistItem : public enable_shared_from_this<PlaylistItem> {
 
   virtual bool InitFromQuery(const SqlRow &query) = 0;
   void BindToQuery(SqlQuery *query) const;
+
+  // The playlist_items row the item was last saved to, and a number which changes each time the values BindToQuery writes change.
+  // The playlist backend uses these to only rewrite the rows of items that changed.
+  qint64 database_rowid() const { return database_rowid_; }
+  void set_database_rowid(const qint64 rowid) { database_rowid_ = rowid; }
+  quint64 database_generation() const { return database_generation_; }
   virtual void Reload() {}
   QFuture<void> BackgroundReload();
 
@@ -120,6 +127,7 @@ class PlaylistItem : public enable_shared_from_this<PlaylistItem> {
 
   virtual QVariant DatabaseValue(const DatabaseColumn database_column) const { Q_UNUSED(database_column); return QVariant(QString()); }
   virtual Song DatabaseSongMetadata() const { return Song(); }
+  void DatabaseValuesChanged() { ++database_generation_; }
 
   Song::Source source_;
   Song stream_song_;
@@ -127,6 +135,10 @@ class PlaylistItem : public enable_shared_from_this<PlaylistItem> {
   QMap<short, QColor> background_colors_;
   QMap<short, QColor> foreground_colors_;
 
+ private:
+  std::atomic<qint64> database_rowid_;
+  std::atomic<quint64> database_generation_;
+
   Q_DISABLE_COPY(PlaylistItem)
 };
 using PlaylistItemPtr = SharedPtr<PlaylistItem>;
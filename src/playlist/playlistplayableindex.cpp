@@ -0,0 +1,212 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <QList>
+
+#include "playlistplayableindex.h"
+
+namespace {
+
+constexpr int kWordBits = 64;
+
+// Bits from n and up.
+constexpr quint64 BitsFrom(const int n) { return ~0ULL << n; }
+
+// Bits below n, n can be outside the word.
+constexpr quint64 BitsBelow(const qint64 n) { return n <= 0 ? 0ULL : n >= kWordBits ? ~0ULL : (1ULL << n) - 1; }
+
+// Bits from 0 up to and including n.
+constexpr quint64 BitsUpTo(const int n) { return n == kWordBits - 1 ? ~0ULL : (1ULL << (n + 1)) - 1; }
+
+qsizetype WordCount(const qsizetype bits) { return (bits + kWordBits - 1) / kWordBits; }
+
+}  // namespace
+
+PlaylistPlayableIndex::PlaylistPlayableIndex() : count_(0) {}
+
+void PlaylistPlayableIndex::Reset(const int count) {
+
+  count_ = count;
+  words_.fill(0, WordCount(count));
+  summary_.fill(0, WordCount(words_.count()));
+
+}
+
+void PlaylistPlayableIndex::Set(const int i, const bool playable) {
+
+  if (i < 0 || i >= count_) return;
+
+  const int word = i / kWordBits;
+  if (playable) {
+    words_[word] |= 1ULL << (i % kWordBits);
+  }
+  else {
+    words_[word] &= ~(1ULL << (i % kWordBits));
+  }
+
+  if (words_[word] != 0) {
+    summary_[word / kWordBits] |= 1ULL << (word % kWordBits);
+  }
+  else {
+    summary_[word / kWordBits] &= ~(1ULL << (word % kWordBits));
+  }
+
+}
+
+quint64 PlaylistPlayableIndex::Bits(const qint64 i) const {
+
+  if (i <= -kWordBits || i >= static_cast<qint64>(words_.count()) * kWordBits) return 0;
+  if (i < 0) return words_[0] << -i;
+
+  const qsizetype word = static_cast<qsizetype>(i / kWordBits);
+  const int offset = static_cast<int>(i % kWordBits);
+  if (offset == 0) return words_[word];
+
+  quint64 bits = words_[word] >> offset;
+  if (word + 1 < words_.count()) bits |= words_[word + 1] << (kWordBits - offset);
+
+  return bits;
+
+}
+
+void PlaylistPlayableIndex::UpdateSummary(const qsizetype first_word) {
+
+  summary_.resize(WordCount(words_.count()));
+
+  for (qsizetype summary_word = first_word / kWordBits; summary_word < summary_.count(); ++summary_word) {
+    quint64 summary_bits = 0;
+    const qsizetype last_word = qMin(words_.count(), (summary_word + 1) * kWordBits);
+    for (qsizetype word = summary_word * kWordBits; word < last_word; ++word) {
+      if (words_[word] != 0) summary_bits |= 1ULL << (word % kWordBits);
+    }
+    summary_[summary_word] = summary_bits;
+  }
+
+}
+
+void PlaylistPlayableIndex::Insert(const int i, const int count) {
+
+  if (i < 0 || i > count_ || count <= 0) return;
+
+  count_ += count;
+  words_.resize(WordCount(count_), 0);
+
+  // Shift from the top down, each word only reads from itself and the words below it.
+  const qsizetype first_word = i / kWordBits;
+  for (qsizetype word = words_.count() - 1; word >= first_word; --word) {
+    const qint64 first_bit = static_cast<qint64>(word) * kWordBits;
+    const quint64 kept_bits = words_[word] & BitsBelow(i - first_bit);
+    const quint64 moved_bits = Bits(first_bit - count) & ~BitsBelow(static_cast<qint64>(i) + count - first_bit);
+    words_[word] = kept_bits | moved_bits;
+  }
+
+  UpdateSummary(first_word);
+
+}
+
+void PlaylistPlayableIndex::Remove(const int i, const int count) {
+
+  if (i < 0 || i >= count_ || count <= 0) return;
+
+  const int removed = qMin(count, count_ - i);
+
+  // Shift from the bottom up, each word only reads from itself and the words above it.
+  // The bits past the end are zero, so the words at the top are cleared as they're shifted down.
+  const qsizetype first_word = i / kWordBits;
+  for (qsizetype word = first_word; word < words_.count(); ++word) {
+    const qint64 first_bit = static_cast<qint64>(word) * kWordBits;
+    const quint64 kept_bits = words_[word] & BitsBelow(i - first_bit);
+    const quint64 moved_bits = Bits(first_bit + removed) & ~BitsBelow(i - first_bit);
+    words_[word] = kept_bits | moved_bits;
+  }
+
+  count_ -= removed;
+  words_.resize(WordCount(count_));
+
+  UpdateSummary(first_word);
+
+}
+
+bool PlaylistPlayableIndex::Contains(const int i) const {
+
+  if (i < 0 || i >= count_) return false;
+
+  return (words_[i / kWordBits] >> (i % kWordBits)) & 1ULL;
+
+}
+
+int PlaylistPlayableIndex::Next(const int i) const {
+
+  const int start = qMax(0, i + 1);
+  if (start >= count_) return count_;
+
+  // Rest of the word the search starts in
+  const int word = start / kWordBits;
+  const quint64 bits = words_[word] & BitsFrom(start % kWordBits);
+  if (bits != 0) {
+    return word * kWordBits + static_cast<int>(qCountTrailingZeroBits(bits));
+  }
+
+  // Find the next non-empty word through the summary
+  const int next_word = word + 1;
+  if (next_word >= words_.count()) return count_;
+  for (int summary_word = next_word / kWordBits; summary_word < summary_.count(); ++summary_word) {
+    quint64 summary_bits = summary_[summary_word];
+    if (summary_word == next_word / kWordBits) summary_bits &= BitsFrom(next_word % kWordBits);
+    if (summary_bits != 0) {
+      const int found_word = summary_word * kWordBits + static_cast<int>(qCountTrailingZeroBits(summary_bits));
+      return found_word * kWordBits + static_cast<int>(qCountTrailingZeroBits(words_[found_word]));
+    }
+  }
+
+  return count_;
+
+}
+
+int PlaylistPlayableIndex::Previous(const int i) const {
+
+  const int end = qMin(count_ - 1, i - 1);
+  if (end < 0) return -1;
+
+  // Start of the word the search starts in
+  const int word = end / kWordBits;
+  const quint64 bits = words_[word] & BitsUpTo(end % kWordBits);
+  if (bits != 0) {
+    return word * kWordBits + kWordBits - 1 - static_cast<int>(qCountLeadingZeroBits(bits));
+  }
+
+  // Find the previous non-empty word through the summary
+  const int previous_word = word - 1;
+  if (previous_word < 0) return -1;
+  for (int summary_word = previous_word / kWordBits; summary_word >= 0; --summary_word) {
+    quint64 summary_bits = summary_[summary_word];
+    if (summary_word == previous_word / kWordBits) summary_bits &= BitsUpTo(previous_word % kWordBits);
+    if (summary_bits != 0) {
+      const int found_word = summary_word * kWordBits + kWordBits - 1 - static_cast<int>(qCountLeadingZeroBits(summary_bits));
+      return found_word * kWordBits + kWordBits - 1 - static_cast<int>(qCountLeadingZeroBits(words_[found_word]));
+    }
+  }
+
+  return -1;
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PLAYLISTPLAYABLEINDEX_H
+#define PLAYLISTPLAYABLEINDEX_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QList>
+
+// A set of virtual indexes of the tracks that can be played next, those that are in the filter and not marked to be skipped.
+// It's a bitset with a summary bit for each word, so finding the next or previous playable track skips 4096 tracks per step
+// instead of testing every track against the filter.
+class PlaylistPlayableIndex {
+ public:
+  PlaylistPlayableIndex();
+
+  // Clears the set and resizes it to hold count indexes.
+  void Reset(const int count);
+
+  int count() const { return count_; }
+
+  void Set(const int i, const bool playable);
+  bool Contains(const int i) const;
+
+  // Inserts count indexes that are not playable before i, the indexes from i and up move up by count.
+  void Insert(const int i, const int count);
+
+  // Removes count indexes from i, the indexes after them move down by count.
+  void Remove(const int i, const int count);
+
+  // Returns the first playable index after i, or count() if there is none.
+  int Next(const int i) const;
+
+  // Returns the last playable index before i, or -1 if there is none.
+  int Previous(const int i) const;
+
+ private:
+  // Returns the 64 bits from bit i, bits outside the set are zero.
+  quint64 Bits(const qint64 i) const;
+  // Updates the summary bits of the words from first_word and up.
+  void UpdateSummary(const qsizetype first_word);
+
+  int count_;
+  QList<quint64> words_;
+  // Bit n is set when words_[n] is not zero.
+  QList<quint64> summary_;
+};
+
+#endif  // PLAYLISTPLAYABLEINDEX_H
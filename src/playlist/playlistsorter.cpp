@@ -0,0 +1,330 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <limits>
+#include <vector>
+
+#include <QtConcurrentMap>
+#include <QThread>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QCollator>
+
+#include "core/song.h"
+#include "playlist.h"
+#include "playlistitem.h"
+#include "playlistsorter.h"
+
+namespace {
+
+// Below this many items per thread, the overhead of parallelizing is larger than the gain.
+constexpr int kMinItemsPerThread = 4096;
+
+enum class KeyType {
+  None,
+  Collation,
+  Number,
+  Text
+};
+
+struct ColumnKeys {
+  Playlist::Column column;
+  Qt::SortOrder order;
+  KeyType type;
+  std::vector<std::optional<QCollatorSortKey>> collation_keys;
+  std::vector<double> numbers;
+  std::vector<QString> texts;
+};
+
+using Range = QPair<int, int>;
+
+KeyType ColumnKeyType(const Playlist::Column column) {
+
+  switch (column) {
+    case Playlist::Column::Title:
+    case Playlist::Column::TitleSort:
+    case Playlist::Column::Artist:
+    case Playlist::Column::ArtistSort:
+    case Playlist::Column::Album:
+    case Playlist::Column::AlbumSort:
+    case Playlist::Column::AlbumArtist:
+    case Playlist::Column::AlbumArtistSort:
+    case Playlist::Column::Performer:
+    case Playlist::Column::PerformerSort:
+    case Playlist::Column::Composer:
+    case Playlist::Column::ComposerSort:
+    case Playlist::Column::Genre:
+    case Playlist::Column::Grouping:
+    case Playlist::Column::Comment:
+    case Playlist::Column::URL:
+    case Playlist::Column::Mood:
+    case Playlist::Column::InitialKey:
+      return KeyType::Collation;
+
+    case Playlist::Column::BaseFilename:
+      return KeyType::Text;
+
+    case Playlist::Column::Year:
+    case Playlist::Column::OriginalYear:
+    case Playlist::Column::Track:
+    case Playlist::Column::Disc:
+    case Playlist::Column::Length:
+    case Playlist::Column::Samplerate:
+    case Playlist::Column::Bitdepth:
+    case Playlist::Column::Bitrate:
+    case Playlist::Column::Filesize:
+    case Playlist::Column::Filetype:
+    case Playlist::Column::DateCreated:
+    case Playlist::Column::DateModified:
+    case Playlist::Column::PlayCount:
+    case Playlist::Column::SkipCount:
+    case Playlist::Column::LastPlayed:
+    case Playlist::Column::Source:
+    case Playlist::Column::Rating:
+    case Playlist::Column::HasCUE:
+    case Playlist::Column::EBUR128IntegratedLoudness:
+    case Playlist::Column::EBUR128LoudnessRange:
+    case Playlist::Column::BPM:
+      return KeyType::Number;
+
+    case Playlist::Column::Moodbar:
+    case Playlist::Column::ColumnCount:
+      break;
+  }
+
+  return KeyType::None;
+
+}
+
+QString CollationText(const PlaylistItemPtr &item, const Song &song, const Playlist::Column column) {
+
+  switch (column) {
+    case Playlist::Column::Title:           return song.effective_titlesort();
+    case Playlist::Column::TitleSort:       return song.titlesort();
+    case Playlist::Column::Artist:          return song.effective_artistsort();
+    case Playlist::Column::ArtistSort:      return song.artistsort();
+    case Playlist::Column::Album:           return song.effective_albumsort();
+    case Playlist::Column::AlbumSort:       return song.albumsort();
+    case Playlist::Column::AlbumArtist:     return song.playlist_effective_albumartistsort();
+    case Playlist::Column::AlbumArtistSort: return song.albumartistsort();
+    case Playlist::Column::Performer:       return song.effective_performersort();
+    case Playlist::Column::PerformerSort:   return song.performersort();
+    case Playlist::Column::Composer:        return song.effective_composersort();
+    case Playlist::Column::ComposerSort:    return song.composersort();
+    case Playlist::Column::Genre:           return song.genre();
+    case Playlist::Column::Grouping:        return song.grouping();
+    case Playlist::Column::Comment:         return song.comment();
+    case Playlist::Column::URL:             return item->OriginalUrl().path();
+    case Playlist::Column::Mood:            return song.mood();
+    case Playlist::Column::InitialKey:      return song.initial_key();
+    default:
+      break;
+  }
+
+  return QString();
+
+}
+
+double NumberValue(const Song &song, const Playlist::Column column) {
+
+  // Missing loudness values sort before all others, like an empty std::optional does.
+  constexpr double kNoValue = -std::numeric_limits<double>::infinity();
+
+  switch (column) {
+    case Playlist::Column::Year:                      return song.year();
+    case Playlist::Column::OriginalYear:              return song.effective_originalyear();
+    case Playlist::Column::Track:                     return song.track();
+    case Playlist::Column::Disc:                      return song.disc();
+    case Playlist::Column::Length:                    return static_cast<double>(song.length_nanosec());
+    case Playlist::Column::Samplerate:                return song.samplerate();
+    case Playlist::Column::Bitdepth:                  return song.bitdepth();
+    case Playlist::Column::Bitrate:                   return song.bitrate();
+    case Playlist::Column::Filesize:                  return static_cast<double>(song.filesize());
+    case Playlist::Column::Filetype:                  return static_cast<double>(song.filetype());
+    case Playlist::Column::DateCreated:               return static_cast<double>(song.ctime());
+    case Playlist::Column::DateModified:              return static_cast<double>(song.mtime());
+    case Playlist::Column::PlayCount:                 return song.playcount();
+    case Playlist::Column::SkipCount:                 return song.skipcount();
+    case Playlist::Column::LastPlayed:                return static_cast<double>(song.lastplayed());
+    case Playlist::Column::Source:                    return static_cast<double>(song.source());
+    case Playlist::Column::Rating:                    return song.rating();
+    case Playlist::Column::HasCUE:                    return song.has_cue() ? 1 : 0;
+    case Playlist::Column::EBUR128IntegratedLoudness: return song.ebur128_integrated_loudness_lufs().value_or(kNoValue);
+    case Playlist::Column::EBUR128LoudnessRange:      return song.ebur128_loudness_range_lu().value_or(kNoValue);
+    case Playlist::Column::BPM:                       return song.bpm();
+    default:
+      break;
+  }
+
+  return 0;
+
+}
+
+QList<Range> SplitRange(const int begin, const int end) {
+
+  const int count = end - begin;
+  const int thread_count = std::max(1, std::min(QThread::idealThreadCount(), count / kMinItemsPerThread));
+  const int chunk_size = (count + thread_count - 1) / thread_count;
+
+  QList<Range> ranges;
+  for (int i = begin; i < end; i += chunk_size) {
+    ranges << qMakePair(i, std::min(i + chunk_size, end));
+  }
+
+  return ranges;
+
+}
+
+void ComputeKeys(const PlaylistItemPtrList &items, const int begin, QList<ColumnKeys> &columns) {
+
+  const int count = static_cast<int>(items.count()) - begin;
+
+  for (ColumnKeys &keys : columns) {
+    switch (keys.type) {
+      case KeyType::Collation:
+        keys.collation_keys.resize(count);
+        break;
+      case KeyType::Number:
+        keys.numbers.resize(count);
+        break;
+      case KeyType::Text:
+        keys.texts.resize(count);
+        break;
+      case KeyType::None:
+        break;
+    }
+  }
+
+  // Each chunk writes to its own part of the key vectors, and uses its own collator since QCollator is not thread-safe.
+  QList<Range> ranges = SplitRange(0, count);
+  QtConcurrent::blockingMap(ranges, [&items, begin, &columns](const Range &range) {
+    QCollator collator;
+    for (int i = range.first; i < range.second; ++i) {
+      const PlaylistItemPtr &item = items[begin + i];
+      const Song song = item->EffectiveMetadata();
+      for (ColumnKeys &keys : columns) {
+        switch (keys.type) {
+          case KeyType::Collation:
+            keys.collation_keys[i] = collator.sortKey(CollationText(item, song, keys.column).toLower());
+            break;
+          case KeyType::Number:
+            keys.numbers[i] = NumberValue(song, keys.column);
+            break;
+          case KeyType::Text:
+            keys.texts[i] = song.basefilename();
+            break;
+          case KeyType::None:
+            break;
+        }
+      }
+    }
+  });
+
+}
+
+}  // namespace
+
+PlaylistItemPtrList PlaylistSorter::Sort(const PlaylistItemPtrList &items, const Playlist::SortColumns &sort_columns, const int begin) {
+
+  if (begin >= items.count() - 1) return items;
+
+  QList<ColumnKeys> columns;
+  for (const Playlist::SortColumn &sort_column : sort_columns) {
+    const KeyType type = ColumnKeyType(sort_column.first);
+    if (type == KeyType::None) continue;
+    ColumnKeys keys;
+    keys.column = sort_column.first;
+    keys.order = sort_column.second;
+    keys.type = type;
+    columns << keys;
+  }
+
+  if (columns.isEmpty()) return items;
+
+  ComputeKeys(items, begin, columns);
+
+  const auto less = [&columns](const int a, const int b) {
+    for (const ColumnKeys &keys : columns) {
+      int result = 0;
+      switch (keys.type) {
+        case KeyType::Collation:
+          result = keys.collation_keys[a]->compare(*keys.collation_keys[b]);
+          break;
+        case KeyType::Number:
+          result = keys.numbers[a] < keys.numbers[b] ? -1 : (keys.numbers[b] < keys.numbers[a] ? 1 : 0);
+          break;
+        case KeyType::Text:
+          result = keys.texts[a].compare(keys.texts[b]);
+          break;
+        case KeyType::None:
+          break;
+      }
+      if (result != 0) {
+        return keys.order == Qt::AscendingOrder ? result < 0 : result > 0;
+      }
+    }
+    return false;
+  };
+
+  const int count = static_cast<int>(items.count()) - begin;
+  std::vector<int> indexes(count);
+  std::iota(indexes.begin(), indexes.end(), 0);
+
+  // Sort chunks in parallel, then merge neighbouring chunks pairwise until only one is left.
+  QList<Range> ranges = SplitRange(0, count);
+  QtConcurrent::blockingMap(ranges, [&indexes, &less](const Range &range) {
+    std::stable_sort(indexes.begin() + range.first, indexes.begin() + range.second, less);
+  });
+
+  while (ranges.count() > 1) {
+    QList<Range> merged_ranges;
+    QList<QPair<Range, Range>> merges;
+    for (int i = 0; i < ranges.count(); i += 2) {
+      if (i + 1 < ranges.count()) {
+        merges << qMakePair(ranges[i], ranges[i + 1]);
+        merged_ranges << qMakePair(ranges[i].first, ranges[i + 1].second);
+      }
+      else {
+        merged_ranges << ranges[i];
+      }
+    }
+    QtConcurrent::blockingMap(merges, [&indexes, &less](const QPair<Range, Range> &merge) {
+      std::inplace_merge(indexes.begin() + merge.first.first, indexes.begin() + merge.second.first, indexes.begin() + merge.second.second, less);
+    });
+    ranges = merged_ranges;
+  }
+
+  PlaylistItemPtrList new_items;
+  new_items.reserve(items.count());
+  for (int i = 0; i < begin; ++i) {
+    new_items << items[i];
+  }
+  for (const int index : indexes) {
+    new_items << items[begin + index];
+  }
+
+  return new_items;
+
+}
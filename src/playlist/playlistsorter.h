@@ -0,0 +1,36 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PLAYLISTSORTER_H
+#define PLAYLISTSORTER_H
+
+#include "config.h"
+
+#include "playlist.h"
+#include "playlistitem.h"
+
+// Sorts playlist items by one or more columns.
+// The sort keys (collation keys for text columns) are computed once per item and column in parallel,
+// the item indexes are then sorted in parallel chunks which are merged, keeping the sort stable.
+class PlaylistSorter {
+ public:
+  static PlaylistItemPtrList Sort(const PlaylistItemPtrList &items, const Playlist::SortColumns &sort_columns, const int begin = 0);
+};
+
+#endif  // PLAYLISTSORTER_H
@@ -135,7 +135,8 @@ PlaylistView::PlaylistView(QWidget *parent)
       column_alignment_(DefaultColumnAlignment()),
       rating_locked_(false),
       dynamic_controls_(new DynamicPlaylistControls(this)),
-      rating_delegate_(nullptr) {
+      rating_delegate_(nullptr),
+      tag_completion_store_(nullptr) {
 
   setHeader(header_);
   header_->setSectionsMovable(true);
@@ -187,7 +188,7 @@ PlaylistView::~PlaylistView() {
 
 void PlaylistView::Init(const SharedPtr<Player> player,
                         const SharedPtr<PlaylistManager> playlist_manager,
-                        const SharedPtr<CollectionBackend> collection_backend,
+                        TagCompletionStore *tag_completion_store,
 #ifdef HAVE_MOODBAR
                         const SharedPtr<MoodbarLoader> moodbar_loader,
 #endif
@@ -195,7 +196,7 @@ void PlaylistView::Init(const SharedPtr<Player> player,
 
   player_ = player;
   playlist_manager_ = playlist_manager;
-  collection_backend_ = collection_backend;
+  tag_completion_store_ = tag_completion_store;
   current_albumcover_loader_ = current_albumcover_loader;
 
 #ifdef HAVE_MOODBAR
@@ -217,19 +218,19 @@ void PlaylistView::SetItemDelegates() {
   setItemDelegate(new PlaylistDelegateBase(this));
 
   setItemDelegateForColumn(static_cast<int>(Playlist::Column::Title), new TextItemDelegate(this));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::TitleSort), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::TitleSort));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::Album), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::Album));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::AlbumSort), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::AlbumSort));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::Artist), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::Artist));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::ArtistSort), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::ArtistSort));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::AlbumArtist), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::AlbumArtist));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::AlbumArtistSort), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::AlbumArtistSort));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::Genre), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::Genre));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::Composer), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::Composer));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::ComposerSort), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::ComposerSort));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::Performer), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::Performer));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::PerformerSort), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::PerformerSort));
-  setItemDelegateForColumn(static_cast<int>(Playlist::Column::Grouping), new TagCompletionItemDelegate(this, collection_backend_, Playlist::Column::Grouping));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::TitleSort), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::TitleSort));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::Album), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::Album));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::AlbumSort), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::AlbumSort));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::Artist), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::Artist));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::ArtistSort), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::ArtistSort));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::AlbumArtist), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::AlbumArtist));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::AlbumArtistSort), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::AlbumArtistSort));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::Genre), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::Genre));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::Composer), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::Composer));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::ComposerSort), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::ComposerSort));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::Performer), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::Performer));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::PerformerSort), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::PerformerSort));
+  setItemDelegateForColumn(static_cast<int>(Playlist::Column::Grouping), new TagCompletionItemDelegate(this, tag_completion_store_, Playlist::Column::Grouping));
   setItemDelegateForColumn(static_cast<int>(Playlist::Column::Length), new LengthItemDelegate(this));
   setItemDelegateForColumn(static_cast<int>(Playlist::Column::Filesize), new SizeItemDelegate(this));
   setItemDelegateForColumn(static_cast<int>(Playlist::Column::Filetype), new FileTypeItemDelegate(this));
@@ -880,6 +881,22 @@ void PlaylistView::leaveEvent(QEvent *e) {
 
 }
 
+void PlaylistView::changeEvent(QEvent *event) {
+
+  switch (event->type()) {
+    case QEvent::LocaleChange:
+    case QEvent::FontChange:
+    case QEvent::StyleChange:
+      ClearDelegateCaches();
+      break;
+    default:
+      break;
+  }
+
+  QTreeView::changeEvent(event);
+
+}
+
 void PlaylistView::mousePressEvent(QMouseEvent *event) {
 
   if (editTriggers() & QAbstractItemView::NoEditTriggers) {
@@ -1320,6 +1337,17 @@ void PlaylistView::ReloadSettings() {
 
   if (playlist_) playlist_->set_auto_sort(auto_sort_);
 
+  ClearDelegateCaches();
+
+}
+
+void PlaylistView::ClearDelegateCaches() {
+
+  const QList<PlaylistDelegateBase*> delegates = findChildren<PlaylistDelegateBase*>(Qt::FindDirectChildrenOnly);
+  for (PlaylistDelegateBase *delegate : delegates) {
+    delegate->ClearCaches();
+  }
+
 }
 
 void PlaylistView::SaveSettings() {
@@ -67,13 +67,13 @@ class QPaintEvent;
 class QTimerEvent;
 
 class Player;
-class CollectionBackend;
 class PlaylistManager;
 class CurrentAlbumCoverLoader;
 class PlaylistHeader;
 class PlaylistProxyStyle;
 class DynamicPlaylistControls;
 class RatingItemDelegate;
+class TagCompletionStore;
 
 #ifdef HAVE_MOODBAR
 class MoodbarLoader;
@@ -90,7 +90,7 @@ class PlaylistView : public QTreeView {
 
   void Init(const SharedPtr<Player> player,
             const SharedPtr<PlaylistManager> playlist_manager,
-            const SharedPtr<CollectionBackend> collection_backend,
+            TagCompletionStore *tag_completion_store,
 #ifdef HAVE_MOODBAR
             const SharedPtr<MoodbarLoader> moodbar_loader,
 #endif
@@ -145,6 +145,7 @@ class PlaylistView : public QTreeView {
   bool eventFilter(QObject *object, QEvent *event) override;
   void focusInEvent(QFocusEvent *event) override;
   void resizeEvent(QResizeEvent *event) override;
+  void changeEvent(QEvent *event) override;
 
   // QTreeView
   void drawTree(QPainter *painter, const QRegion &region) const;
@@ -185,6 +186,7 @@ class PlaylistView : public QTreeView {
   void LoadHeaderState();
   void RestoreHeaderState();
 
+  void ClearDelegateCaches();
   void ReloadBarPixmaps();
   QList<QPixmap> LoadBarPixmap(const QString &filename, const bool keep_aspect_ratio);
   void LoadTinyPlayPausePixmaps(const int desired_size);
@@ -209,7 +211,6 @@ class PlaylistView : public QTreeView {
 
   SharedPtr<Player> player_;
   SharedPtr<PlaylistManager> playlist_manager_;
-  SharedPtr<CollectionBackend> collection_backend_;
   SharedPtr<CurrentAlbumCoverLoader> current_albumcover_loader_;
 #ifdef HAVE_MOODBAR
   SharedPtr<MoodbarLoader> moodbar_loader_;
@@ -293,6 +294,7 @@ class PlaylistView : public QTreeView {
 
   DynamicPlaylistControls *dynamic_controls_;
   RatingItemDelegate *rating_delegate_;
+  TagCompletionStore *tag_completion_store_;
 
   QColor playlist_playing_song_color_;
 
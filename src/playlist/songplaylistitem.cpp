@@ -48,6 +48,7 @@ void SongPlaylistItem::Reload() {
   }
 
   UpdateStreamMetadata(song_);
+  DatabaseValuesChanged();
 
 }
 
@@ -55,5 +56,6 @@ void SongPlaylistItem::SetArtManual(const QUrl &cover_url) {
 
   song_.set_art_manual(cover_url);
   if (HasStreamMetadata()) stream_song_.set_art_manual(cover_url);
+  DatabaseValuesChanged();
 
 }
@@ -53,6 +53,13 @@ bool StreamPlaylistItem::InitFromQuery(const SqlRow &query) {
 
 }
 
+void StreamPlaylistItem::SetOriginalMetadata(const Song &song) {
+
+  song_ = song;
+  DatabaseValuesChanged();
+
+}
+
 QVariant StreamPlaylistItem::DatabaseValue(const DatabaseColumn column) const {
   return PlaylistItem::DatabaseValue(column);
 }
@@ -61,5 +68,6 @@ void StreamPlaylistItem::SetArtManual(const QUrl &cover_url) {
 
   song_.set_art_manual(cover_url);
   stream_song_.set_art_manual(cover_url);
+  DatabaseValuesChanged();
 
 }
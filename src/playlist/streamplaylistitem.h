@@ -35,7 +35,7 @@ class StreamPlaylistItem : public PlaylistItem {
 
   Song OriginalMetadata() const override { return song_; }
   QUrl OriginalUrl() const override { return song_.url(); }
-  void SetOriginalMetadata(const Song &song) override { song_ = song; }
+  void SetOriginalMetadata(const Song &song) override;
   bool InitFromQuery(const SqlRow &query) override;
   void SetArtManual(const QUrl &cover_url) override;
 
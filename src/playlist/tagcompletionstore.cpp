@@ -0,0 +1,274 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+
+#include <QApplication>
+#include <QObject>
+#include <QThread>
+#include <QtConcurrentRun>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QStringListModel>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "core/song.h"
+#include "collection/collectionbackend.h"
+#include "playlist.h"
+#include "tagcompletionstore.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+// Case-insensitive order as expected by QCompleter::CaseInsensitivelySortedModel, with a case-sensitive tiebreak so duplicates end up next to each other.
+bool CompletionLessThan(const QString &a, const QString &b) {
+  const int result = a.compare(b, Qt::CaseInsensitive);
+  return result == 0 ? a < b : result < 0;
+}
+
+QStringList SortedUniqueValues(QStringList values) {
+
+  values.removeAll(QString());
+  std::sort(values.begin(), values.end(), CompletionLessThan);
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+
+  return values;
+
+}
+
+}  // namespace
+
+TagCompletionStore::TagCompletionStore(SharedPtr<CollectionBackend> backend, QObject *parent)
+    : QObject(parent),
+      backend_(backend),
+      generation_(0) {
+
+  if (!backend) return;
+
+  QObject::connect(&*backend, &CollectionBackend::SongsAdded, this, &TagCompletionStore::SongsChanged);
+  QObject::connect(&*backend, &CollectionBackend::SongsChanged, this, &TagCompletionStore::SongsChanged);
+  QObject::connect(&*backend, &CollectionBackend::SongsDeleted, this, &TagCompletionStore::SongsDeleted);
+  QObject::connect(&*backend, &CollectionBackend::DatabaseReset, this, &TagCompletionStore::DatabaseReset);
+
+}
+
+QString TagCompletionStore::database_column(const Playlist::Column column) {
+
+  switch (column) {
+    case Playlist::Column::Artist:          return u"artist"_s;
+    case Playlist::Column::ArtistSort:      return u"artistsort"_s;
+    case Playlist::Column::Album:           return u"album"_s;
+    case Playlist::Column::AlbumSort:       return u"albumsort"_s;
+    case Playlist::Column::AlbumArtist:     return u"albumartist"_s;
+    case Playlist::Column::AlbumArtistSort: return u"albumartistsort"_s;
+    case Playlist::Column::Composer:        return u"composer"_s;
+    case Playlist::Column::ComposerSort:    return u"composersort"_s;
+    case Playlist::Column::Performer:       return u"performer"_s;
+    case Playlist::Column::PerformerSort:   return u"performersort"_s;
+    case Playlist::Column::Grouping:        return u"grouping"_s;
+    case Playlist::Column::Genre:           return u"genre"_s;
+    case Playlist::Column::TitleSort:       return u"titlesort"_s;
+    default:
+      qLog(Warning) << "Unknown column" << static_cast<int>(column);
+      return QString();
+  }
+
+}
+
+QString TagCompletionStore::song_value(const Song &song, const Playlist::Column column) {
+
+  switch (column) {
+    case Playlist::Column::Artist:          return song.artist();
+    case Playlist::Column::ArtistSort:      return song.artistsort();
+    case Playlist::Column::Album:           return song.album();
+    case Playlist::Column::AlbumSort:       return song.albumsort();
+    case Playlist::Column::AlbumArtist:     return song.albumartist();
+    case Playlist::Column::AlbumArtistSort: return song.albumartistsort();
+    case Playlist::Column::Composer:        return song.composer();
+    case Playlist::Column::ComposerSort:    return song.composersort();
+    case Playlist::Column::Performer:       return song.performer();
+    case Playlist::Column::PerformerSort:   return song.performersort();
+    case Playlist::Column::Grouping:        return song.grouping();
+    case Playlist::Column::Genre:           return song.genre();
+    case Playlist::Column::TitleSort:       return song.titlesort();
+    default:
+      return QString();
+  }
+
+}
+
+QStringListModel *TagCompletionStore::model(const Playlist::Column column) {
+
+  if (columns_.contains(column)) return columns_[column].model;
+
+  ColumnValues &values = columns_[column];
+  values.model = new QStringListModel(this);
+  Load(column);
+
+  return values.model;
+
+}
+
+QHash<int, QString> TagCompletionStore::LoadValues(SharedPtr<CollectionBackend> backend, const QString &column) {
+
+  const QHash<int, QString> song_values = backend->GetAllBySongId(column);
+
+  if (QThread::currentThread() != backend->thread() && QThread::currentThread() != qApp->thread()) {
+    backend->Close();
+  }
+
+  return song_values;
+
+}
+
+void TagCompletionStore::Load(const Playlist::Column column) {
+
+  SharedPtr<CollectionBackend> backend = backend_.lock();
+  if (!backend) return;
+
+  const QString db_column = database_column(column);
+  if (db_column.isEmpty()) return;
+
+  columns_[column].loading = true;
+
+  const quint64 generation = generation_;
+  QFuture<QHash<int, QString>> future = QtConcurrent::run(&TagCompletionStore::LoadValues, backend, db_column);
+  QFutureWatcher<QHash<int, QString>> *watcher = new QFutureWatcher<QHash<int, QString>>(this);
+  QObject::connect(watcher, &QFutureWatcher<QHash<int, QString>>::finished, this, [this, watcher, column, generation]() {
+    const QHash<int, QString> loaded_song_values = watcher->result();
+    watcher->deleteLater();
+    // The values are from before the database was reset.
+    if (generation != generation_ || !columns_.contains(column)) return;
+    ColumnValues &values = columns_[column];
+    for (QHash<int, QString>::const_iterator it = loaded_song_values.constBegin(); it != loaded_song_values.constEnd(); ++it) {
+      if (values.updated_song_ids.contains(it.key())) continue;
+      // Share the string data between songs with the same value.
+      QHash<QString, int>::const_iterator count_it = values.value_counts.constFind(it.value());
+      values.song_values.insert(it.key(), count_it == values.value_counts.constEnd() ? it.value() : count_it.key());
+      ++values.value_counts[it.value()];
+    }
+    values.loading = false;
+    values.updated_song_ids.clear();
+    values.model->setStringList(SortedUniqueValues(values.value_counts.keys()));
+  });
+  watcher->setFuture(future);
+
+}
+
+void TagCompletionStore::SetSongValue(ColumnValues &values, const int song_id, const QString &value) {
+
+  if (values.loading) {
+    values.updated_song_ids.insert(song_id);
+  }
+
+  const QString old_value = values.song_values.value(song_id);
+  if (value == old_value) return;
+
+  if (!old_value.isEmpty()) {
+    values.song_values.remove(song_id);
+    QHash<QString, int>::iterator it = values.value_counts.find(old_value);
+    if (it != values.value_counts.end() && --it.value() <= 0) {
+      values.value_counts.erase(it);
+      RemoveValue(values.model, old_value);
+    }
+  }
+
+  if (!value.isEmpty()) {
+    values.song_values.insert(song_id, value);
+    if (values.value_counts[value]++ == 0) {
+      AddValue(values.model, value);
+    }
+  }
+
+}
+
+void TagCompletionStore::AddValue(QStringListModel *model, const QString &value) {
+
+  int row = 0;
+  {
+    // Release the copy of the list before inserting, so the model doesn't have to detach.
+    const QStringList values = model->stringList();
+    QStringList::const_iterator it = std::lower_bound(values.begin(), values.end(), value, CompletionLessThan);
+    if (it != values.end() && *it == value) return;
+    row = static_cast<int>(it - values.begin());
+  }
+
+  model->insertRows(row, 1);
+  model->setData(model->index(row), value);
+
+}
+
+void TagCompletionStore::RemoveValue(QStringListModel *model, const QString &value) {
+
+  int row = -1;
+  {
+    const QStringList values = model->stringList();
+    QStringList::const_iterator it = std::lower_bound(values.begin(), values.end(), value, CompletionLessThan);
+    if (it == values.end() || *it != value) return;
+    row = static_cast<int>(it - values.begin());
+  }
+
+  model->removeRows(row, 1);
+
+}
+
+void TagCompletionStore::SongsChanged(const SongList &songs) {
+
+  for (QMap<Playlist::Column, ColumnValues>::iterator it = columns_.begin(); it != columns_.end(); ++it) {
+    for (const Song &song : songs) {
+      // The collection query for completions excludes compilations, so do the same here.
+      SetSongValue(it.value(), song.id(), song.is_compilation() ? QString() : song_value(song, it.key()));
+    }
+  }
+
+}
+
+void TagCompletionStore::SongsDeleted(const SongList &songs) {
+
+  for (QMap<Playlist::Column, ColumnValues>::iterator it = columns_.begin(); it != columns_.end(); ++it) {
+    for (const Song &song : songs) {
+      SetSongValue(it.value(), song.id(), QString());
+    }
+  }
+
+}
+
+void TagCompletionStore::DatabaseReset() {
+
+  ++generation_;
+
+  for (QMap<Playlist::Column, ColumnValues>::iterator it = columns_.begin(); it != columns_.end(); ++it) {
+    ColumnValues &values = it.value();
+    values.song_values.clear();
+    values.value_counts.clear();
+    values.updated_song_ids.clear();
+    values.model->setStringList(QStringList());
+    Load(it.key());
+  }
+
+}
@@ -0,0 +1,86 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TAGCOMPLETIONSTORE_H
+#define TAGCOMPLETIONSTORE_H
+
+#include "config.h"
+
+#include <memory>
+
+#include <QtGlobal>
+#include <QObject>
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "playlist.h"
+
+class QStringListModel;
+class CollectionBackend;
+
+// Holds one completion model per tag column, shared by all tag completers for the collection that owns the store.
+// Each model is loaded from the collection once, kept sorted case-insensitively so QCompleter can use binary search for prefixes,
+// and updated incrementally from the old and new values of songs that are added, changed or deleted.
+class TagCompletionStore : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit TagCompletionStore(SharedPtr<CollectionBackend> backend, QObject *parent = nullptr);
+
+  // Returns the model for the column, it's filled in the background the first time it's requested.
+  QStringListModel *model(const Playlist::Column column);
+
+  static QString database_column(const Playlist::Column column);
+  static QString song_value(const Song &song, const Playlist::Column column);
+
+ private:
+  struct ColumnValues {
+    ColumnValues() : model(nullptr), loading(false) {}
+    QStringListModel *model;
+    // The value of each song, and the number of songs with each value, a value is removed from the model when its count drops to zero.
+    QHash<int, QString> song_values;
+    QHash<QString, int> value_counts;
+    bool loading;
+    // Songs updated while the column was loading, their loaded values are outdated.
+    QSet<int> updated_song_ids;
+  };
+
+  static QHash<int, QString> LoadValues(SharedPtr<CollectionBackend> backend, const QString &column);
+  void Load(const Playlist::Column column);
+  void SetSongValue(ColumnValues &values, const int song_id, const QString &value);
+  static void AddValue(QStringListModel *model, const QString &value);
+  static void RemoveValue(QStringListModel *model, const QString &value);
+
+ private Q_SLOTS:
+  void SongsChanged(const SongList &songs);
+  void SongsDeleted(const SongList &songs);
+  void DatabaseReset();
+
+ private:
+  std::weak_ptr<CollectionBackend> backend_;
+  QMap<Playlist::Column, ColumnValues> columns_;
+  // Increased when the database is reset, so values loaded before the reset are thrown away.
+  quint64 generation_;
+};
+
+#endif  // TAGCOMPLETIONSTORE_H
@@ -58,6 +58,9 @@ class QobuzBaseRequest : public JsonBaseRequest {
 
   QNetworkReply *CreateRequest(const QString &ressource_name, const ParamList &params_provided);
   JsonObjectResult ParseJsonObject(QNetworkReply *reply);
+  static JsonObjectResult ParseReplyData(ReplyData reply_data);
+  // Replies parsed with ParseReplyData are checked here on the thread of the request.
+  void CheckAuthentication(const QNetworkReply::NetworkError network_error);
 
  protected:
   QobuzService *service_;
@@ -33,11 +33,11 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonValue>
-#include <QTimer>
 #include <QScopeGuard>
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
+#include "core/adaptiveconcurrencylimiter.h"
 #include "core/song.h"
 #include "core/networkaccessmanager.h"
 #include "constants/timeconstants.h"
@@ -51,19 +51,13 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-constexpr int kMaxConcurrentArtistsRequests = 3;
-constexpr int kMaxConcurrentAlbumsRequests = 3;
-constexpr int kMaxConcurrentSongsRequests = 3;
-constexpr int kMaxConcurrentArtistAlbumsRequests = 3;
-constexpr int kMaxConcurrentAlbumSongsRequests = 3;
 constexpr int kMaxConcurrentAlbumCoverRequests = 1;
-constexpr int kFlushRequestsDelay = 200;
 }  // namespace
 
 QobuzRequest::QobuzRequest(QobuzService *service, QobuzUrlHandler *url_handler, const SharedPtr<NetworkAccessManager> network, const Type query_type, QObject *parent)
     : QobuzBaseRequest(service, network, parent),
       url_handler_(url_handler),
-      timer_flush_requests_(new QTimer(this)),
+      request_limiter_(service->request_limiter()),
       query_type_(query_type),
       query_id_(-1),
       finished_(false),
@@ -97,9 +91,7 @@ QobuzRequest::QobuzRequest(QobuzService *service, QobuzUrlHandler *url_handler,
       album_covers_requests_received_(0),
       no_results_(false) {
 
-  timer_flush_requests_->setInterval(kFlushRequestsDelay);
-  timer_flush_requests_->setSingleShot(false);
-  QObject::connect(timer_flush_requests_, &QTimer::timeout, this, &QobuzRequest::FlushRequests);
+  QObject::connect(request_limiter_, &AdaptiveConcurrencyLimiter::Ready, this, &QobuzRequest::FlushRequests);
 
 }
 
@@ -131,47 +123,15 @@ void QobuzRequest::Process() {
 
 }
 
-void QobuzRequest::StartRequests() {
-
-  if (!timer_flush_requests_->isActive()) {
-    timer_flush_requests_->start();
-  }
-
-}
-
 void QobuzRequest::FlushRequests() {
 
-  if (!artists_requests_queue_.isEmpty()) {
-    FlushArtistsRequests();
-    return;
-  }
-
-  if (!albums_requests_queue_.isEmpty()) {
-    FlushAlbumsRequests();
-    return;
-  }
-
-  if (!artist_albums_requests_queue_.isEmpty()) {
-    FlushArtistAlbumsRequests();
-    return;
-  }
-
-  if (!album_songs_requests_queue_.isEmpty()) {
-    FlushAlbumSongsRequests();
-    return;
-  }
-
-  if (!songs_requests_queue_.isEmpty()) {
-    FlushSongsRequests();
-    return;
-  }
-
-  if (!album_cover_requests_queue_.isEmpty()) {
-    FlushAlbumCoverRequests();
-    return;
-  }
-
-  timer_flush_requests_->stop();
+  // Queues are flushed in order, so earlier stages get the free request slots first.
+  FlushArtistsRequests();
+  FlushAlbumsRequests();
+  FlushArtistAlbumsRequests();
+  FlushAlbumSongsRequests();
+  FlushSongsRequests();
+  FlushAlbumCoverRequests();
 
 }
 
@@ -197,13 +157,13 @@ void QobuzRequest::AddArtistsRequest(const int offset, const int limit) {
 
   ++artists_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void QobuzRequest::FlushArtistsRequests() {
 
-  while (!artists_requests_queue_.isEmpty() && artists_requests_active_ < kMaxConcurrentArtistsRequests) {
+  while (!artists_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const Request request = artists_requests_queue_.dequeue();
 
@@ -225,6 +185,7 @@ void QobuzRequest::FlushArtistsRequests() {
     if (!reply) continue;
     replies_ << reply;
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { ArtistsReplyReceived(reply, request.limit, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++artists_requests_active_;
 
@@ -249,13 +210,13 @@ void QobuzRequest::AddAlbumsRequest(const int offset, const int limit) {
 
   ++albums_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void QobuzRequest::FlushAlbumsRequests() {
 
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
+  while (!albums_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const Request request = albums_requests_queue_.dequeue();
 
@@ -277,6 +238,7 @@ void QobuzRequest::FlushAlbumsRequests() {
     if (!reply) continue;
     replies_ << reply;
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumsReplyReceived(reply, request.limit, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++albums_requests_active_;
 
@@ -301,13 +263,13 @@ void QobuzRequest::AddSongsRequest(const int offset, const int limit) {
 
   ++songs_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void QobuzRequest::FlushSongsRequests() {
 
-  while (!songs_requests_queue_.isEmpty() && songs_requests_active_ < kMaxConcurrentSongsRequests) {
+  while (!songs_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const Request request = songs_requests_queue_.dequeue();
 
@@ -329,6 +291,7 @@ void QobuzRequest::FlushSongsRequests() {
     if (!reply) continue;
     replies_ << reply;
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { SongsReplyReceived(reply, request.limit, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++songs_requests_active_;
 
@@ -380,12 +343,13 @@ void QobuzRequest::AddSongsSearchRequest(const int offset) {
 
 void QobuzRequest::ArtistsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
-  QObject::disconnect(reply, nullptr, this, nullptr);
-  reply->deleteLater();
+  ParseReplyAsync<JsonObjectResult>(reply, &QobuzBaseRequest::ParseReplyData, [this, limit_requested, offset_requested](const JsonObjectResult &json_object_result) { ArtistsReceived(json_object_result, limit_requested, offset_requested); });
 
-  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+}
+
+void QobuzRequest::ArtistsReceived(const JsonObjectResult &json_object_result, const int limit_requested, const int offset_requested) {
+
+  CheckAuthentication(json_object_result.network_error);
 
   --artists_requests_active_;
   ++artists_requests_received_;
@@ -538,9 +502,11 @@ void QobuzRequest::ArtistsFinishCheck(const int limit, const int offset, const i
 
 void QobuzRequest::AlbumsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested) {
 
-  --albums_requests_active_;
-  ++albums_requests_received_;
-  AlbumsReceived(reply, Artist(), limit_requested, offset_requested);
+  ParseReplyAsync<JsonObjectResult>(reply, &QobuzBaseRequest::ParseReplyData, [this, limit_requested, offset_requested](const JsonObjectResult &json_object_result) {
+    --albums_requests_active_;
+    ++albums_requests_received_;
+    AlbumsReceived(json_object_result, Artist(), limit_requested, offset_requested);
+  });
 
 }
 
@@ -553,13 +519,13 @@ void QobuzRequest::AddArtistAlbumsRequest(const Artist &artist, const int offset
 
   ++artist_albums_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void QobuzRequest::FlushArtistAlbumsRequests() {
 
-  while (!artist_albums_requests_queue_.isEmpty() && artist_albums_requests_active_ < kMaxConcurrentArtistAlbumsRequests) {
+  while (!artist_albums_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const ArtistAlbumsRequest request = artist_albums_requests_queue_.dequeue();
 
@@ -569,6 +535,7 @@ void QobuzRequest::FlushArtistAlbumsRequests() {
     if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
     QNetworkReply *reply = CreateRequest(u"artist/get"_s, params);
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { ArtistAlbumsReplyReceived(reply, request.artist, request.offset); });
+    request_limiter_->AddReply(reply);
     replies_ << reply;
 
     ++artist_albums_requests_active_;
@@ -579,21 +546,18 @@ void QobuzRequest::FlushArtistAlbumsRequests() {
 
 void QobuzRequest::ArtistAlbumsReplyReceived(QNetworkReply *reply, const Artist &artist, const int offset_requested) {
 
-  --artist_albums_requests_active_;
-  ++artist_albums_requests_received_;
-  Q_EMIT UpdateProgress(query_id_, GetProgress(artist_albums_requests_received_, artist_albums_requests_total_));
-  AlbumsReceived(reply, artist, 0, offset_requested);
+  ParseReplyAsync<JsonObjectResult>(reply, &QobuzBaseRequest::ParseReplyData, [this, artist, offset_requested](const JsonObjectResult &json_object_result) {
+    --artist_albums_requests_active_;
+    ++artist_albums_requests_received_;
+    Q_EMIT UpdateProgress(query_id_, GetProgress(artist_albums_requests_received_, artist_albums_requests_total_));
+    AlbumsReceived(json_object_result, artist, 0, offset_requested);
+  });
 
 }
 
-void QobuzRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_requested, const int limit_requested, const int offset_requested) {
-
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
-  QObject::disconnect(reply, nullptr, this, nullptr);
-  reply->deleteLater();
+void QobuzRequest::AlbumsReceived(const JsonObjectResult &json_object_result, const Artist &artist_requested, const int limit_requested, const int offset_requested) {
 
-  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+  CheckAuthentication(json_object_result.network_error);
 
   if (finished_) return;
 
@@ -801,9 +765,11 @@ void QobuzRequest::AlbumsFinishCheck(const Artist &artist, const int limit, cons
 
 void QobuzRequest::SongsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested) {
 
-  --songs_requests_active_;
-  ++songs_requests_received_;
-  SongsReceived(reply, Artist(), Album(), limit_requested, offset_requested);
+  ParseReplyAsync<SongsPage>(reply, CreateSongsParser(Artist(), Album(), offset_requested), [this, limit_requested, offset_requested](const SongsPage &songs_page) {
+    --songs_requests_active_;
+    ++songs_requests_received_;
+    SongsReceived(songs_page, limit_requested, offset_requested);
+  });
 
 }
 
@@ -817,13 +783,13 @@ void QobuzRequest::AddAlbumSongsRequest(const Artist &artist, const Album &album
 
   ++album_songs_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void QobuzRequest::FlushAlbumSongsRequests() {
 
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+  while (!album_songs_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const AlbumSongsRequest request = album_songs_requests_queue_.dequeue();
     ParamList params = ParamList() << Param(u"album_id"_s, request.album.album_id);
@@ -831,6 +797,7 @@ void QobuzRequest::FlushAlbumSongsRequests() {
     QNetworkReply *reply = CreateRequest(u"album/get"_s, params);
     replies_ << reply;
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumSongsReplyReceived(reply, request.artist, request.album, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++album_songs_requests_active_;
 
@@ -840,31 +807,106 @@ void QobuzRequest::FlushAlbumSongsRequests() {
 
 void QobuzRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const Artist &artist, const Album &album, const int offset_requested) {
 
-  --album_songs_requests_active_;
-  ++album_songs_requests_received_;
-  if (offset_requested == 0) {
-    Q_EMIT UpdateProgress(query_id_, GetProgress(album_songs_requests_received_, album_songs_requests_total_));
-  }
-  SongsReceived(reply, artist, album, 0, offset_requested);
+  ParseReplyAsync<SongsPage>(reply, CreateSongsParser(artist, album, offset_requested), [this, offset_requested](const SongsPage &songs_page) {
+    --album_songs_requests_active_;
+    ++album_songs_requests_received_;
+    if (offset_requested == 0) {
+      Q_EMIT UpdateProgress(query_id_, GetProgress(album_songs_requests_received_, album_songs_requests_total_));
+    }
+    SongsReceived(songs_page, 0, offset_requested);
+  });
 
 }
 
-void QobuzRequest::SongsReceived(QNetworkReply *reply, const Artist &artist_requested, const Album &album_requested, const int limit_requested, const int offset_requested) {
+QobuzRequest::SongsParser QobuzRequest::CreateSongsParser(const Artist &artist, const Album &album, const int offset_requested) const {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
-  QObject::disconnect(reply, nullptr, this, nullptr);
-  reply->deleteLater();
+  return SongsParser(url_handler_->scheme(), service_->remove_remastered(), artist, album, offset_requested);
+
+}
 
-  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+void QobuzRequest::SongsReceived(const SongsPage &songs_page, const int limit_requested, const int offset_requested) {
+
+  CheckAuthentication(songs_page.network_error);
 
   if (finished_) return;
 
-  Artist album_artist;
-  Album album;
-  int songs_total = 0;
-  int songs_received = 0;
-  const QScopeGuard finish_check = qScopeGuard([this, &album_artist, &album, limit_requested, offset_requested, &songs_total, &songs_received]() { SongsFinishCheck(album_artist, album, limit_requested, offset_requested, songs_total, songs_received); });
+  const QScopeGuard finish_check = qScopeGuard([this, limit_requested, offset_requested, &songs_page]() { SongsFinishCheck(songs_page.album_artist, songs_page.album, limit_requested, offset_requested, songs_page.songs_total, songs_page.songs_received); });
+
+  // The parser logged the errors already.
+  if (!songs_page.errors.isEmpty()) {
+    error_ = QStringLiteral("Qobuz: %1").arg(songs_page.errors.last());
+  }
+
+  if (songs_page.no_items) {
+    if ((query_type_ == Type::FavouriteSongs || query_type_ == Type::SearchSongs) && offset_requested == 0) {
+      no_results_ = true;
+    }
+    return;
+  }
+
+  for (const Song &song : songs_page.songs) {
+    songs_.insert(song.song_id(), song);
+  }
+
+  if (query_type_ == Type::FavouriteSongs || query_type_ == Type::SearchSongs) {
+    songs_received_ += songs_page.songs_received;
+    Q_EMIT UpdateProgress(query_id_, GetProgress(songs_received_, songs_total_));
+  }
+
+}
+
+void QobuzRequest::SongsFinishCheck(const Artist &artist, const Album &album, const int limit, const int offset, const int songs_total, const int songs_received) {
+
+  if (finished_) return;
+
+  if (limit == 0 || limit > songs_received) {
+    int offset_next = offset + songs_received;
+    if (offset_next > 0 && offset_next < songs_total) {
+      switch (query_type_) {
+        case Type::FavouriteSongs:
+          AddSongsRequest(offset_next);
+          break;
+        case Type::SearchSongs:
+          AddSongsSearchRequest(offset_next);
+          break;
+        case Type::FavouriteArtists:
+        case Type::SearchArtists:
+        case Type::FavouriteAlbums:
+        case Type::SearchAlbums:
+          AddAlbumSongsRequest(artist, album, offset_next);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  GetAlbumCoversCheck();
+  FinishCheck();
+
+}
+
+QobuzRequest::SongsParser::SongsParser(const QString &scheme, const bool remove_remastered, const Artist &artist, const Album &album, const int offset_requested)
+    : scheme_(scheme),
+      remove_remastered_(remove_remastered),
+      artist_(artist),
+      album_(album),
+      offset_requested_(offset_requested) {}
+
+QobuzRequest::SongsPage QobuzRequest::SongsParser::operator()(ReplyData reply_data) {
+
+  // The Json document only lives while the songs are built, the reply data is released once it's parsed.
+  SongsPage songs_page;
+  const JsonObjectResult json_object_result = ParseReplyData(std::move(reply_data));
+  songs_page.network_error = json_object_result.network_error;
+  ParseSongs(json_object_result, songs_page);
+  songs_page.errors = errors_;
+
+  return songs_page;
+
+}
+
+void QobuzRequest::SongsParser::ParseSongs(const JsonObjectResult &json_object_result, SongsPage &songs_page) {
 
   if (!json_object_result.success()) {
     Error(json_object_result.error_message);
@@ -881,17 +923,17 @@ void QobuzRequest::SongsReceived(QNetworkReply *reply, const Artist &artist_requ
     return;
   }
 
-  album_artist = artist_requested;
-  album = album_requested;
+  songs_page.album_artist = artist_;
+  songs_page.album = album_;
 
   if (json_object.contains("id"_L1) && json_object.contains("title"_L1)) {
     if (json_object["id"_L1].isString()) {
-      album.album_id = json_object["id"_L1].toString();
+      songs_page.album.album_id = json_object["id"_L1].toString();
     }
     else {
-      album.album_id = QString::number(json_object["id"_L1].toInt());
+      songs_page.album.album_id = QString::number(json_object["id"_L1].toInt());
     }
-    album.album = json_object["title"_L1].toString();
+    songs_page.album.album = json_object["title"_L1].toString();
   }
 
   if (json_object.contains("artist"_L1)) {
@@ -906,12 +948,12 @@ void QobuzRequest::SongsReceived(QNetworkReply *reply, const Artist &artist_requ
       return;
     }
     if (obj_artist["id"_L1].isString()) {
-      album_artist.artist_id = obj_artist["id"_L1].toString();
+      songs_page.album_artist.artist_id = obj_artist["id"_L1].toString();
     }
     else {
-      album_artist.artist_id = QString::number(obj_artist["id"_L1].toInt());
+      songs_page.album_artist.artist_id = QString::number(obj_artist["id"_L1].toInt());
     }
-    album_artist.artist = obj_artist["name"_L1].toString();
+    songs_page.album_artist.artist = obj_artist["name"_L1].toString();
   }
 
   if (json_object.contains("image"_L1)) {
@@ -927,17 +969,17 @@ void QobuzRequest::SongsReceived(QNetworkReply *reply, const Artist &artist_requ
     }
     QString album_image = obj_image["large"_L1].toString();
     if (!album_image.isEmpty()) {
-      album.cover_url = QUrl(album_image);
+      songs_page.album.cover_url = QUrl(album_image);
     }
   }
 
   // Extract genre from album/get response if not already set
-  if (album.genre.isEmpty() && json_object.contains("genre"_L1)) {
+  if (songs_page.album.genre.isEmpty() && json_object.contains("genre"_L1)) {
     QJsonValue value_genre = json_object["genre"_L1];
     if (value_genre.isObject()) {
       QJsonObject obj_genre = value_genre.toObject();
       if (obj_genre.contains("name"_L1)) {
-        album.genre = obj_genre["name"_L1].toString();
+        songs_page.album.genre = obj_genre["name"_L1].toString();
       }
     }
   }
@@ -959,10 +1001,10 @@ void QobuzRequest::SongsReceived(QNetworkReply *reply, const Artist &artist_requ
 
   // int limit = obj_tracks["limit"].toInt();
   const int offset = obj_tracks["offset"_L1].toInt();
-  songs_total = obj_tracks["total"_L1].toInt();
+  songs_page.songs_total = obj_tracks["total"_L1].toInt();
 
-  if (offset != offset_requested) {
-    Error(QStringLiteral("Offset returned does not match offset requested! %1 != %2").arg(offset).arg(offset_requested));
+  if (offset != offset_requested_) {
+    Error(QStringLiteral("Offset returned does not match offset requested! %1 != %2").arg(offset).arg(offset_requested_));
     return;
   }
 
@@ -974,9 +1016,7 @@ void QobuzRequest::SongsReceived(QNetworkReply *reply, const Artist &artist_requ
 
   const QJsonArray &array_items = json_array_result.json_array;
   if (array_items.isEmpty()) {
-    if ((query_type_ == Type::FavouriteSongs || query_type_ == Type::SearchSongs) && offset_requested == 0) {
-      no_results_ = true;
-    }
+    songs_page.no_items = true;
     return;
   }
 
@@ -991,9 +1031,9 @@ void QobuzRequest::SongsReceived(QNetworkReply *reply, const Artist &artist_requ
     }
     const QJsonObject object_item = value_item.toObject();
 
-    ++songs_received;
+    ++songs_page.songs_received;
     Song song(Song::Source::Qobuz);
-    ParseSong(song, object_item, album_artist, album);
+    ParseSong(song, object_item, songs_page.album_artist, songs_page.album);
     if (!song.is_valid()) continue;
     if (song.disc() >= 2) multidisc = true;
     if (song.is_compilation()) compilation = true;
@@ -1003,48 +1043,12 @@ void QobuzRequest::SongsReceived(QNetworkReply *reply, const Artist &artist_requ
   for (Song song : std::as_const(songs)) {
     if (compilation) song.set_compilation_detected(true);
     if (!multidisc) song.set_disc(0);
-    songs_.insert(song.song_id(), song);
-  }
-
-  if (query_type_ == Type::FavouriteSongs || query_type_ == Type::SearchSongs) {
-    songs_received_ += songs_received;
-    Q_EMIT UpdateProgress(query_id_, GetProgress(songs_received_, songs_total_));
+    songs_page.songs << song;
   }
 
 }
 
-void QobuzRequest::SongsFinishCheck(const Artist &artist, const Album &album, const int limit, const int offset, const int songs_total, const int songs_received) {
-
-  if (finished_) return;
-
-  if (limit == 0 || limit > songs_received) {
-    int offset_next = offset + songs_received;
-    if (offset_next > 0 && offset_next < songs_total) {
-      switch (query_type_) {
-        case Type::FavouriteSongs:
-          AddSongsRequest(offset_next);
-          break;
-        case Type::SearchSongs:
-          AddSongsSearchRequest(offset_next);
-          break;
-        case Type::FavouriteArtists:
-        case Type::SearchArtists:
-        case Type::FavouriteAlbums:
-        case Type::SearchAlbums:
-          AddAlbumSongsRequest(artist, album, offset_next);
-          break;
-        default:
-          break;
-      }
-    }
-  }
-
-  GetAlbumCoversCheck();
-  FinishCheck();
-
-}
-
-void QobuzRequest::ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album) {
+void QobuzRequest::SongsParser::ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album) {
 
   if (
       !json_obj.contains("id"_L1) ||
@@ -1190,10 +1194,10 @@ void QobuzRequest::ParseSong(Song &song, const QJsonObject &json_obj, const Arti
   // }
 
   QUrl url;
-  url.setScheme(url_handler_->scheme());
+  url.setScheme(scheme_);
   url.setPath(song_id);
 
-  if (service_->remove_remastered()) {
+  if (remove_remastered_) {
     title = Song::TitleRemoveMisc(title);
   }
 
@@ -1265,7 +1269,7 @@ void QobuzRequest::GetAlbumCovers() {
   else Q_EMIT UpdateStatus(query_id_, tr("Receiving album covers for %1 albums...").arg(album_covers_requests_total_));
   Q_EMIT UpdateProgress(query_id_, 0);
 
-  StartRequests();
+  FlushRequests();
 
 }
 
@@ -1386,6 +1390,7 @@ void QobuzRequest::AlbumCoverReceived(QNetworkReply *reply, const QUrl &cover_ur
 
 void QobuzRequest::AlbumCoverFinishCheck() {
 
+  FlushAlbumCoverRequests();
   FinishCheck();
 
 }
@@ -1410,9 +1415,6 @@ void QobuzRequest::FinishCheck() {
       album_songs_requests_active_ <= 0 &&
       album_covers_requests_active_ <= 0
   ) {
-    if (timer_flush_requests_->isActive()) {
-      timer_flush_requests_->stop();
-    }
     finished_ = true;
     if (no_results_ && songs_.isEmpty()) {
       if (IsSearch()) {
@@ -1451,6 +1453,17 @@ void QobuzRequest::Error(const QString &error_message, const QVariant &debug_out
 
 }
 
+void QobuzRequest::SongsParser::Error(const QString &error_message, const QVariant &debug_output) {
+
+  qLog(Error) << "Qobuz:" << error_message;
+  if (debug_output.isValid()) {
+    qLog(Debug) << debug_output;
+  }
+
+  errors_ << error_message;
+
+}
+
 void QobuzRequest::Warn(const QString &error_message, const QVariant &debug_output) {
 
   qLog(Error) << "Qobuz:" << error_message;
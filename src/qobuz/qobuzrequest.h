@@ -30,6 +30,7 @@
 #include <QString>
 #include <QStringList>
 #include <QUrl>
+#include <QNetworkReply>
 #include <QJsonObject>
 #include <QScopedPointer>
 
@@ -37,8 +38,7 @@
 #include "core/song.h"
 #include "qobuzbaserequest.h"
 
-class QNetworkReply;
-class QTimer;
+class AdaptiveConcurrencyLimiter;
 class NetworkAccessManager;
 class QobuzService;
 class QobuzUrlHandler;
@@ -91,6 +91,36 @@ class QobuzRequest : public QobuzBaseRequest {
     QUrl url;
     QString filename;
   };
+  struct SongsPage {
+    SongsPage() : network_error(QNetworkReply::NoError), songs_total(0), songs_received(0), no_items(false) {}
+    QNetworkReply::NetworkError network_error;
+    QStringList errors;
+    Artist album_artist;
+    Album album;
+    int songs_total;
+    int songs_received;
+    bool no_items;
+    SongList songs;
+  };
+
+  // Builds the songs of a reply on a worker thread, so it only keeps copies of what it needs from the request.
+  class SongsParser {
+   public:
+    explicit SongsParser(const QString &scheme, const bool remove_remastered, const Artist &artist, const Album &album, const int offset_requested);
+    SongsPage operator()(ReplyData reply_data);
+
+   private:
+    void ParseSongs(const JsonObjectResult &json_object_result, SongsPage &songs_page);
+    void ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album);
+    void Error(const QString &error_message, const QVariant &debug_output = QVariant());
+
+    QString scheme_;
+    bool remove_remastered_;
+    Artist artist_;
+    Album album_;
+    int offset_requested_;
+    QStringList errors_;
+  };
 
  Q_SIGNALS:
   void Results(const int id, const SongMap &songs, const QString &error);
@@ -102,10 +132,7 @@ class QobuzRequest : public QobuzBaseRequest {
   void ArtistsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested);
 
   void AlbumsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested);
-  void AlbumsReceived(QNetworkReply *reply, const QobuzRequest::Artist &artist_requested, const int limit_requested, const int offset_requested);
-
   void SongsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested);
-  void SongsReceived(QNetworkReply *reply, const QobuzRequest::Artist &artist_requested, const QobuzRequest::Album &album_requested, const int limit_requested, const int offset_requested);
 
   void ArtistAlbumsReplyReceived(QNetworkReply *reply, const QobuzRequest::Artist &artist, const int offset_requested);
   void AlbumSongsReplyReceived(QNetworkReply *reply, const QobuzRequest::Artist &artist, const QobuzRequest::Album &album, const int offset_requested);
@@ -115,9 +142,13 @@ class QobuzRequest : public QobuzBaseRequest {
   bool IsQuery() const { return (query_type_ == Type::FavouriteArtists || query_type_ == Type::FavouriteAlbums || query_type_ == Type::FavouriteSongs); }
   bool IsSearch() const { return (query_type_ == Type::SearchArtists || query_type_ == Type::SearchAlbums || query_type_ == Type::SearchSongs); }
 
-  void StartRequests();
   void FlushRequests();
 
+  void ArtistsReceived(const JsonObjectResult &json_object_result, const int limit_requested, const int offset_requested);
+  void AlbumsReceived(const JsonObjectResult &json_object_result, const Artist &artist_requested, const int limit_requested, const int offset_requested);
+  SongsParser CreateSongsParser(const Artist &artist, const Album &album, const int offset_requested) const;
+  void SongsReceived(const SongsPage &songs_page, const int limit_requested, const int offset_requested);
+
   void GetArtists();
   void GetAlbums();
   void GetSongs();
@@ -146,8 +177,6 @@ class QobuzRequest : public QobuzBaseRequest {
   void AddAlbumSongsRequest(const Artist &artist, const Album &album, const int offset = 0);
   void FlushAlbumSongsRequests();
 
-  void ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album);
-
   QString AlbumCoverFileName(const Song &song);
 
   void GetAlbumCoversCheck();
@@ -163,7 +192,7 @@ class QobuzRequest : public QobuzBaseRequest {
   void Error(const QString &error_message, const QVariant &debug_output = QVariant());
 
   QobuzUrlHandler *url_handler_;
-  QTimer *timer_flush_requests_;
+  AdaptiveConcurrencyLimiter *request_limiter_;
 
   const Type query_type_;
   int query_id_;
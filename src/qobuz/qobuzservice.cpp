@@ -463,6 +463,8 @@ void QobuzService::ClearSession() {
   s.remove("user_auth_token");
   s.endGroup();
 
+  Q_EMIT SessionCleared();
+
 }
 
 void QobuzService::ResetLoginAttempts() {
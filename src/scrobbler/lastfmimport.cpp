@@ -94,6 +94,8 @@ void LastFMImport::AbortAll() {
   top_tracks_requests_.clear();
   timer_flush_requests_->stop();
 
+  statistics_.clear();
+
 }
 
 void LastFMImport::ReloadSettings() {
@@ -347,7 +349,7 @@ void LastFMImport::GetRecentTracksRequestFinished(QNetworkReply *reply, const in
       const QString title = obj_track["name"_L1].toString();
       const QDateTime datetime = QDateTime::fromString(date, u"dd MMM yyyy, hh:mm"_s);
       if (datetime.isValid()) {
-        Q_EMIT UpdateLastPlayed(artist, album, title, datetime.toSecsSinceEpoch());
+        statistics_ << PlayStatistics(artist, album, title, datetime.toSecsSinceEpoch());
       }
 
       UpdateProgressCheck();
@@ -499,7 +501,7 @@ void LastFMImport::GetTopTracksRequestFinished(QNetworkReply *reply, const int p
 
       if (playcount <= 0) continue;
 
-      Q_EMIT UpdatePlayCount(artist, title, playcount, false);
+      statistics_ << PlayStatistics(artist, QString(), title, -1, playcount);
       UpdateProgressCheck();
 
     }
@@ -527,7 +529,22 @@ void LastFMImport::UpdateProgressCheck() {
 }
 
 void LastFMImport::FinishCheck() {
-  if (replies_.isEmpty() && recent_tracks_requests_.isEmpty() && top_tracks_requests_.isEmpty()) Q_EMIT Finished();
+
+  if (replies_.isEmpty() && recent_tracks_requests_.isEmpty() && top_tracks_requests_.isEmpty()) {
+    FlushStatistics();
+    Q_EMIT Finished();
+  }
+
+}
+
+void LastFMImport::FlushStatistics() {
+
+  // The collection applies all statistics in one transaction, which is much faster than updating the songs for each track received.
+  if (statistics_.isEmpty()) return;
+
+  Q_EMIT UpdatePlayStatistics(statistics_);
+  statistics_.clear();
+
 }
 
 void LastFMImport::Error(const QString &error, const QVariant &debug) {
@@ -537,6 +554,7 @@ void LastFMImport::Error(const QString &error, const QVariant &debug) {
 
   Q_EMIT FinishedWithError(error);
 
+  FlushStatistics();
   AbortAll();
 
 }
@@ -32,6 +32,7 @@
 #include "core/jsonbaserequest.h"
 #include "includes/shared_ptr.h"
 #include "core/jsonbaserequest.h"
+#include "core/playstatistics.h"
 
 class QTimer;
 class QNetworkReply;
@@ -84,10 +85,10 @@ class LastFMImport : public JsonBaseRequest {
   void UpdateProgressCheck();
 
   void FinishCheck();
+  void FlushStatistics();
 
  Q_SIGNALS:
-  void UpdatePlayCount(const QString&, const QString&, const int, const bool = false);
-  void UpdateLastPlayed(const QString&, const QString&, const QString&, const qint64);
+  void UpdatePlayStatistics(const PlayStatisticsList &statistics_list);
   void UpdateTotal(const int, const int);
   void UpdateProgress(const int, const int);
   void Finished();
@@ -111,6 +112,7 @@ class LastFMImport : public JsonBaseRequest {
   int lastplayed_received_;
   QQueue<GetRecentTracksRequest> recent_tracks_requests_;
   QQueue<GetTopTracksRequest> top_tracks_requests_;
+  PlayStatisticsList statistics_;
 };
 
 #endif  // LASTFMIMPORT_H
@@ -19,18 +19,32 @@
 
 #include "config.h"
 
+#include <algorithm>
 #include <utility>
 #include <functional>
 #include <chrono>
 #include <memory>
 
+#include <QtGlobal>
+
+#ifdef Q_OS_UNIX
+#  include <unistd.h>
+#endif
+#ifdef Q_OS_WIN32
+#  include <io.h>
+#endif
+
 #include <QObject>
+#include <QMap>
+#include <QList>
+#include <QByteArray>
 #include <QString>
 #include <QFile>
+#include <QSaveFile>
 #include <QIODevice>
-#include <QTextStream>
 #include <QTimer>
 #include <QJsonDocument>
+#include <QJsonParseError>
 #include <QJsonValue>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -46,11 +60,20 @@ using namespace std::chrono_literals;
 using namespace Qt::Literals::StringLiterals;
 using std::make_shared;
 
+namespace {
+// Compact the log when it has at least this many records for removed items, and more of them than records for items still in the cache.
+constexpr qint64 kCompactMinRemovedRecords = 100;
+}  // namespace
+
 ScrobblerCache::ScrobblerCache(const QString &filename, QObject *parent)
     : QObject(parent),
       timer_flush_(new QTimer(this)),
+      timer_sync_(new QTimer(this)),
       filename_(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + QLatin1Char('/') + filename),
-      loaded_(false) {
+      loaded_(false),
+      next_id_(1),
+      removed_records_(0),
+      unsynced_(false) {
 
   ReadCache();
   loaded_ = true;
@@ -59,27 +82,85 @@ ScrobblerCache::ScrobblerCache(const QString &filename, QObject *parent)
   timer_flush_->setInterval(10min);
   QObject::connect(timer_flush_, &QTimer::timeout, this, &ScrobblerCache::WriteCache);
 
+  timer_sync_->setSingleShot(true);
+  timer_sync_->setInterval(5s);
+  QObject::connect(timer_sync_, &QTimer::timeout, this, &ScrobblerCache::Sync);
+
 }
 
 ScrobblerCache::~ScrobblerCache() {
+
+  Sync();
+  log_file_.close();
   scrobbler_cache_.clear();
+
 }
 
 void ScrobblerCache::ReadCache() {
 
   QFile file(filename_);
-  bool result = file.open(QIODevice::ReadOnly | QIODevice::Text);
-  if (!result) return;
-
-  QTextStream stream(&file);
-  stream.setEncoding(QStringConverter::Encoding::Utf8);
-  QString data = stream.readAll();
+  if (!file.open(QIODevice::ReadOnly)) return;
+  const QByteArray data = file.readAll();
   file.close();
 
   if (data.isEmpty()) return;
 
+  // Caches written by older versions are one indented Json document, convert them to the log format.
+  if (data.startsWith("{\n") || data.startsWith("{\r\n")) {
+    ReadLegacyCache(data);
+    for (ScrobblerCacheItemPtr cache_item : std::as_const(scrobbler_cache_)) {
+      cache_item->id = next_id_++;
+    }
+    Compact();
+    return;
+  }
+
+  // Each line is either an item, or a tombstone with the ID of an item that was removed.
+  QMap<quint64, ScrobblerCacheItemPtr> cache_items;
+  qint64 records = 0;
+  bool invalid_records = false;
+  const QList<QByteArray> lines = data.split('\n');
+  for (const QByteArray &line : lines) {
+    if (line.trimmed().isEmpty()) continue;
+    ++records;
+    QJsonParseError error;
+    const QJsonDocument json_doc = QJsonDocument::fromJson(line, &error);
+    if (error.error != QJsonParseError::NoError || !json_doc.isObject()) {
+      // Most likely the last record, if the application or system crashed while it was being written.
+      qLog(Error) << "Scrobbler cache" << filename_ << "has an invalid record.";
+      invalid_records = true;
+      continue;
+    }
+    const QJsonObject json_obj = json_doc.object();
+    if (json_obj.contains("remove"_L1)) {
+      cache_items.remove(json_obj["remove"_L1].toVariant().toULongLong());
+      continue;
+    }
+    ScrobblerCacheItemPtr cache_item = ItemFromJson(json_obj);
+    if (!cache_item) continue;
+    cache_item->id = json_obj["id"_L1].toVariant().toULongLong();
+    if (cache_item->id == 0) {
+      invalid_records = true;
+      continue;
+    }
+    cache_items.insert(cache_item->id, cache_item);
+    next_id_ = std::max(next_id_, cache_item->id + 1);
+  }
+
+  scrobbler_cache_ = cache_items.values();
+  removed_records_ = records - scrobbler_cache_.count();
+
+  // Don't append to a log with a partial record at the end.
+  if (invalid_records || !data.endsWith('\n') || CompactionNeeded()) {
+    Compact();
+  }
+
+}
+
+void ScrobblerCache::ReadLegacyCache(const QByteArray &data) {
+
   QJsonParseError error;
-  QJsonDocument json_doc = QJsonDocument::fromJson(data.toUtf8(), &error);
+  QJsonDocument json_doc = QJsonDocument::fromJson(data, &error);
   if (error.error != QJsonParseError::NoError) {
     qLog(Error) << "Scrobbler cache is missing JSON data.";
     return;
@@ -117,152 +198,234 @@ void ScrobblerCache::ReadCache() {
       qLog(Debug) << value;
       continue;
     }
-    QJsonObject json_obj_track = value.toObject();
-    if (!json_obj_track.contains("timestamp"_L1) ||
-        !json_obj_track.contains("artist"_L1) ||
-        !json_obj_track.contains("album"_L1) ||
-        !json_obj_track.contains("title"_L1) ||
-        !json_obj_track.contains("track"_L1) ||
-        !json_obj_track.contains("albumartist"_L1) ||
-        !json_obj_track.contains("length_nanosec"_L1)) {
-      qLog(Error) << "Scrobbler cache JSON tracks array value is missing data.";
-      qLog(Debug) << value;
-      continue;
+    ScrobblerCacheItemPtr cache_item = ItemFromJson(value.toObject());
+    if (cache_item) {
+      scrobbler_cache_ << cache_item;
     }
+  }
 
-    ScrobbleMetadata metadata;
-    quint64 timestamp = json_obj_track["timestamp"_L1].toVariant().toULongLong();
-    metadata.artist = json_obj_track["artist"_L1].toString();
-    metadata.album = json_obj_track["album"_L1].toString();
-    metadata.title = json_obj_track["title"_L1].toString();
-    metadata.track = json_obj_track["track"_L1].toInt();
-    metadata.albumartist = json_obj_track["albumartist"_L1].toString();
-    metadata.length_nanosec = json_obj_track["length_nanosec"_L1].toVariant().toLongLong();
-
-    if (timestamp == 0 || metadata.artist.isEmpty() || metadata.title.isEmpty() || metadata.length_nanosec <= 0) {
-      qLog(Error) << "Invalid cache data" << "for song" << metadata.title;
-      continue;
-    }
+}
 
-    if (json_obj_track.contains("grouping"_L1)) {
-      metadata.grouping = json_obj_track["grouping"_L1].toString();
-    }
+ScrobblerCacheItemPtr ScrobblerCache::ItemFromJson(const QJsonObject &json_obj_track) {
+
+  if (!json_obj_track.contains("timestamp"_L1) ||
+      !json_obj_track.contains("artist"_L1) ||
+      !json_obj_track.contains("album"_L1) ||
+      !json_obj_track.contains("title"_L1) ||
+      !json_obj_track.contains("track"_L1) ||
+      !json_obj_track.contains("albumartist"_L1) ||
+      !json_obj_track.contains("length_nanosec"_L1)) {
+    qLog(Error) << "Scrobbler cache JSON tracks array value is missing data.";
+    qLog(Debug) << json_obj_track;
+    return ScrobblerCacheItemPtr();
+  }
 
-    if (json_obj_track.contains("musicbrainz_album_artist_id"_L1)) {
-      metadata.musicbrainz_album_artist_id = json_obj_track["musicbrainz_album_artist_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_artist_id"_L1)) {
-      metadata.musicbrainz_artist_id = json_obj_track["musicbrainz_artist_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_original_artist_id"_L1)) {
-      metadata.musicbrainz_original_artist_id = json_obj_track["musicbrainz_original_artist_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_album_id"_L1)) {
-      metadata.musicbrainz_album_id = json_obj_track["musicbrainz_album_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_original_album_id"_L1)) {
-      metadata.musicbrainz_original_album_id = json_obj_track["musicbrainz_original_album_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_recording_id"_L1)) {
-      metadata.musicbrainz_recording_id = json_obj_track["musicbrainz_recording_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_track_id"_L1)) {
-      metadata.musicbrainz_track_id = json_obj_track["musicbrainz_track_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_disc_id"_L1)) {
-      metadata.musicbrainz_disc_id = json_obj_track["musicbrainz_disc_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_release_group_id"_L1)) {
-      metadata.musicbrainz_release_group_id = json_obj_track["musicbrainz_release_group_id"_L1].toString();
-    }
-    if (json_obj_track.contains("musicbrainz_work_id"_L1)) {
-      metadata.musicbrainz_work_id = json_obj_track["musicbrainz_work_id"_L1].toString();
-    }
-    if (json_obj_track.contains("music_service"_L1)) {
-      metadata.music_service = json_obj_track["music_service"_L1].toString();
-    }
-    if (json_obj_track.contains("music_service_name"_L1)) {
-      metadata.music_service_name = json_obj_track["music_service_name"_L1].toString();
-    }
-    if (json_obj_track.contains("share_url"_L1)) {
-      metadata.share_url = json_obj_track["share_url"_L1].toString();
-    }
-    if (json_obj_track.contains("spotify_id"_L1)) {
-      metadata.spotify_id = json_obj_track["spotify_id"_L1].toString();
+  ScrobbleMetadata metadata;
+  quint64 timestamp = json_obj_track["timestamp"_L1].toVariant().toULongLong();
+  metadata.artist = json_obj_track["artist"_L1].toString();
+  metadata.album = json_obj_track["album"_L1].toString();
+  metadata.title = json_obj_track["title"_L1].toString();
+  metadata.track = json_obj_track["track"_L1].toInt();
+  metadata.albumartist = json_obj_track["albumartist"_L1].toString();
+  metadata.length_nanosec = json_obj_track["length_nanosec"_L1].toVariant().toLongLong();
+
+  if (timestamp == 0 || metadata.artist.isEmpty() || metadata.title.isEmpty() || metadata.length_nanosec <= 0) {
+    qLog(Error) << "Invalid cache data" << "for song" << metadata.title;
+    return ScrobblerCacheItemPtr();
+  }
+
+  if (json_obj_track.contains("grouping"_L1)) {
+    metadata.grouping = json_obj_track["grouping"_L1].toString();
+  }
+
+  if (json_obj_track.contains("musicbrainz_album_artist_id"_L1)) {
+    metadata.musicbrainz_album_artist_id = json_obj_track["musicbrainz_album_artist_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_artist_id"_L1)) {
+    metadata.musicbrainz_artist_id = json_obj_track["musicbrainz_artist_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_original_artist_id"_L1)) {
+    metadata.musicbrainz_original_artist_id = json_obj_track["musicbrainz_original_artist_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_album_id"_L1)) {
+    metadata.musicbrainz_album_id = json_obj_track["musicbrainz_album_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_original_album_id"_L1)) {
+    metadata.musicbrainz_original_album_id = json_obj_track["musicbrainz_original_album_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_recording_id"_L1)) {
+    metadata.musicbrainz_recording_id = json_obj_track["musicbrainz_recording_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_track_id"_L1)) {
+    metadata.musicbrainz_track_id = json_obj_track["musicbrainz_track_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_disc_id"_L1)) {
+    metadata.musicbrainz_disc_id = json_obj_track["musicbrainz_disc_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_release_group_id"_L1)) {
+    metadata.musicbrainz_release_group_id = json_obj_track["musicbrainz_release_group_id"_L1].toString();
+  }
+  if (json_obj_track.contains("musicbrainz_work_id"_L1)) {
+    metadata.musicbrainz_work_id = json_obj_track["musicbrainz_work_id"_L1].toString();
+  }
+  if (json_obj_track.contains("music_service"_L1)) {
+    metadata.music_service = json_obj_track["music_service"_L1].toString();
+  }
+  if (json_obj_track.contains("music_service_name"_L1)) {
+    metadata.music_service_name = json_obj_track["music_service_name"_L1].toString();
+  }
+  if (json_obj_track.contains("share_url"_L1)) {
+    metadata.share_url = json_obj_track["share_url"_L1].toString();
+  }
+  if (json_obj_track.contains("spotify_id"_L1)) {
+    metadata.spotify_id = json_obj_track["spotify_id"_L1].toString();
+  }
+
+  return make_shared<ScrobblerCacheItem>(metadata, timestamp);
+
+}
+
+QJsonObject ScrobblerCache::ItemToJson(ScrobblerCacheItemPtr cache_item) {
+
+  QJsonObject object;
+  object.insert("id"_L1, QJsonValue::fromVariant(cache_item->id));
+  object.insert("timestamp"_L1, QJsonValue::fromVariant(cache_item->timestamp));
+  object.insert("artist"_L1, QJsonValue::fromVariant(cache_item->metadata.artist));
+  object.insert("album"_L1, QJsonValue::fromVariant(cache_item->metadata.album));
+  object.insert("title"_L1, QJsonValue::fromVariant(cache_item->metadata.title));
+  object.insert("track"_L1, QJsonValue::fromVariant(cache_item->metadata.track));
+  object.insert("albumartist"_L1, QJsonValue::fromVariant(cache_item->metadata.albumartist));
+  object.insert("grouping"_L1, QJsonValue::fromVariant(cache_item->metadata.grouping));
+  object.insert("musicbrainz_album_artist_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_album_artist_id));
+  object.insert("musicbrainz_artist_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_artist_id));
+  object.insert("musicbrainz_original_artist_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_original_artist_id));
+  object.insert("musicbrainz_album_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_album_id));
+  object.insert("musicbrainz_original_album_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_original_album_id));
+  object.insert("musicbrainz_recording_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_recording_id));
+  object.insert("musicbrainz_track_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_track_id));
+  object.insert("musicbrainz_disc_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_disc_id));
+  object.insert("musicbrainz_release_group_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_release_group_id));
+  object.insert("musicbrainz_work_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_work_id));
+  object.insert("music_service"_L1, QJsonValue::fromVariant(cache_item->metadata.music_service));
+  object.insert("music_service_name"_L1, QJsonValue::fromVariant(cache_item->metadata.music_service_name));
+  object.insert("share_url"_L1, QJsonValue::fromVariant(cache_item->metadata.share_url));
+  object.insert("spotify_id"_L1, QJsonValue::fromVariant(cache_item->metadata.spotify_id));
+  object.insert("length_nanosec"_L1, QJsonValue::fromVariant(cache_item->metadata.length_nanosec));
+
+  return object;
+
+}
+
+bool ScrobblerCache::AppendRecords(const QList<QJsonObject> &records) {
+
+  if (!log_file_.isOpen()) {
+    log_file_.setFileName(filename_);
+    if (!log_file_.open(QIODevice::WriteOnly | QIODevice::Append)) {
+      qLog(Error) << "Unable to open scrobbler cache file" << filename_ << log_file_.errorString();
+      return false;
     }
+  }
+
+  QByteArray data;
+  for (const QJsonObject &record : records) {
+    data.append(QJsonDocument(record).toJson(QJsonDocument::Compact));
+    data.append('\n');
+  }
 
-    ScrobblerCacheItemPtr cache_item = make_shared<ScrobblerCacheItem>(metadata, timestamp);
-    scrobbler_cache_ << cache_item;
+  if (log_file_.write(data) != data.size() || !log_file_.flush()) {
+    qLog(Error) << "Unable to write to scrobbler cache file" << filename_ << log_file_.errorString();
+    return false;
+  }
 
+  // The records are in the page cache now, which survives the application crashing, sync them to disk in batches.
+  unsynced_ = true;
+  if (!timer_sync_->isActive()) {
+    timer_sync_->start();
   }
 
+  return true;
+
 }
 
-void ScrobblerCache::WriteCache() {
+void ScrobblerCache::Sync() {
 
-  if (!loaded_) return;
+  if (!unsynced_ || !log_file_.isOpen()) return;
+
+  unsynced_ = false;
+  timer_sync_->stop();
+
+#if defined(Q_OS_UNIX)
+  ::fsync(log_file_.handle());
+#elif defined(Q_OS_WIN32)
+  ::_commit(log_file_.handle());
+#endif
+
+}
+
+bool ScrobblerCache::CompactionNeeded() const {
+
+  return removed_records_ >= kCompactMinRemovedRecords && removed_records_ > scrobbler_cache_.count();
+
+}
+
+void ScrobblerCache::Compact() {
+
+  qLog(Debug) << "Compacting scrobbler cache file" << filename_;
 
-  qLog(Debug) << "Writing scrobbler cache file" << filename_;
+  Sync();
+  log_file_.close();
 
   if (scrobbler_cache_.isEmpty()) {
     QFile file(filename_);
     if (file.exists()) file.remove();
+    removed_records_ = 0;
     return;
   }
 
-  QJsonArray array;
+  QByteArray data;
   for (ScrobblerCacheItemPtr cache_item : std::as_const(scrobbler_cache_)) {
-    QJsonObject object;
-    object.insert("timestamp"_L1, QJsonValue::fromVariant(cache_item->timestamp));
-    object.insert("artist"_L1, QJsonValue::fromVariant(cache_item->metadata.artist));
-    object.insert("album"_L1, QJsonValue::fromVariant(cache_item->metadata.album));
-    object.insert("title"_L1, QJsonValue::fromVariant(cache_item->metadata.title));
-    object.insert("track"_L1, QJsonValue::fromVariant(cache_item->metadata.track));
-    object.insert("albumartist"_L1, QJsonValue::fromVariant(cache_item->metadata.albumartist));
-    object.insert("grouping"_L1, QJsonValue::fromVariant(cache_item->metadata.grouping));
-    object.insert("musicbrainz_album_artist_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_album_artist_id));
-    object.insert("musicbrainz_artist_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_artist_id));
-    object.insert("musicbrainz_original_artist_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_original_artist_id));
-    object.insert("musicbrainz_album_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_album_id));
-    object.insert("musicbrainz_original_album_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_original_album_id));
-    object.insert("musicbrainz_recording_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_recording_id));
-    object.insert("musicbrainz_track_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_track_id));
-    object.insert("musicbrainz_disc_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_disc_id));
-    object.insert("musicbrainz_release_group_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_release_group_id));
-    object.insert("musicbrainz_work_id"_L1, QJsonValue::fromVariant(cache_item->metadata.musicbrainz_work_id));
-    object.insert("music_service"_L1, QJsonValue::fromVariant(cache_item->metadata.music_service));
-    object.insert("music_service_name"_L1, QJsonValue::fromVariant(cache_item->metadata.music_service_name));
-    object.insert("share_url"_L1, QJsonValue::fromVariant(cache_item->metadata.share_url));
-    object.insert("spotify_id"_L1, QJsonValue::fromVariant(cache_item->metadata.spotify_id));
-    object.insert("length_nanosec"_L1, QJsonValue::fromVariant(cache_item->metadata.length_nanosec));
-    array.append(QJsonValue::fromVariant(object));
+    data.append(QJsonDocument(ItemToJson(cache_item)).toJson(QJsonDocument::Compact));
+    data.append('\n');
   }
 
-  QJsonObject object;
-  object.insert("tracks"_L1, array);
-  QJsonDocument doc(object);
-
-  QFile file(filename_);
-  bool result = file.open(QIODevice::WriteOnly | QIODevice::Text);
-  if (!result) {
-    qLog(Error) << "Unable to open scrobbler cache file" << filename_;
+  // Write the new log next to the old one and replace it, so a crash while compacting keeps the old log.
+  QSaveFile file(filename_);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qLog(Error) << "Unable to open scrobbler cache file" << filename_ << file.errorString();
     return;
   }
-  QTextStream stream(&file);
-  stream.setEncoding(QStringConverter::Encoding::Utf8);
-  stream << doc.toJson();
-  file.close();
+  file.write(data);
+  if (!file.commit()) {
+    qLog(Error) << "Unable to write scrobbler cache file" << filename_ << file.errorString();
+    return;
+  }
+
+  removed_records_ = 0;
+
+}
+
+void ScrobblerCache::WriteCache() {
+
+  if (!loaded_) return;
+
+  if (CompactionNeeded() || (scrobbler_cache_.isEmpty() && removed_records_ > 0)) {
+    Compact();
+  }
+  else {
+    Sync();
+  }
 
 }
 
 ScrobblerCacheItemPtr ScrobblerCache::Add(const Song &song, const quint64 timestamp) {
 
   ScrobblerCacheItemPtr cache_item = make_shared<ScrobblerCacheItem>(ScrobbleMetadata(song), timestamp);
+  cache_item->id = next_id_++;
 
   scrobbler_cache_ << cache_item;
 
-  if (loaded_ && !timer_flush_->isActive()) {
-    timer_flush_->start();
+  if (loaded_) {
+    AppendRecords(QList<QJsonObject>() << ItemToJson(cache_item));
   }
 
   return cache_item;
@@ -271,9 +434,8 @@ ScrobblerCacheItemPtr ScrobblerCache::Add(const Song &song, const quint64 timest
 
 void ScrobblerCache::Remove(ScrobblerCacheItemPtr cache_item) {
 
-  if (scrobbler_cache_.contains(cache_item)) {
-    scrobbler_cache_.removeAll(cache_item);
-  }
+  Flush(ScrobblerCacheItemPtrList() << cache_item);
+
 }
 
 void ScrobblerCache::ClearSent(ScrobblerCacheItemPtrList cache_items) {
@@ -294,13 +456,23 @@ void ScrobblerCache::SetError(ScrobblerCacheItemPtrList cache_items) {
 
 void ScrobblerCache::Flush(ScrobblerCacheItemPtrList cache_items) {
 
+  QList<QJsonObject> tombstones;
   for (ScrobblerCacheItemPtr cache_item : cache_items) {
     if (scrobbler_cache_.contains(cache_item)) {
       scrobbler_cache_.removeAll(cache_item);
+      QJsonObject tombstone;
+      tombstone.insert("remove"_L1, QJsonValue::fromVariant(cache_item->id));
+      tombstones << tombstone;
     }
   }
 
-  if (!timer_flush_->isActive()) {
+  if (tombstones.isEmpty()) return;
+
+  // Both the item and its tombstone are now dead records in the log.
+  removed_records_ += tombstones.count() * 2;
+  AppendRecords(tombstones);
+
+  if (CompactionNeeded() && !timer_flush_->isActive()) {
     timer_flush_->start();
   }
 
@@ -27,13 +27,18 @@
 #include <QtGlobal>
 #include <QObject>
 #include <QList>
+#include <QByteArray>
 #include <QString>
+#include <QFile>
+#include <QJsonObject>
 
 #include "scrobblercacheitem.h"
 
 class QTimer;
 class Song;
 
+// Pending scrobbles are stored in a log with one Json record per line, each item is appended when it's added,
+// and a tombstone record when it's removed. The log is compacted when most of the records are for removed items.
 class ScrobblerCache : public QObject {
   Q_OBJECT
 
@@ -54,10 +59,26 @@ class ScrobblerCache : public QObject {
  public Q_SLOTS:
   void WriteCache();
 
+ private Q_SLOTS:
+  void Sync();
+
+ private:
+  void ReadLegacyCache(const QByteArray &data);
+  static ScrobblerCacheItemPtr ItemFromJson(const QJsonObject &json_obj_track);
+  static QJsonObject ItemToJson(ScrobblerCacheItemPtr cache_item);
+  bool AppendRecords(const QList<QJsonObject> &records);
+  bool CompactionNeeded() const;
+  void Compact();
+
  private:
   QTimer *timer_flush_;
+  QTimer *timer_sync_;
   QString filename_;
   bool loaded_;
+  QFile log_file_;
+  quint64 next_id_;
+  qint64 removed_records_;
+  bool unsynced_;
   QList<ScrobblerCacheItemPtr> scrobbler_cache_;
 };
 
@@ -33,6 +33,7 @@ class ScrobblerCacheItem {
  public:
   explicit ScrobblerCacheItem(const ScrobbleMetadata &_metadata, const quint64 _timestamp);
 
+  quint64 id;
   ScrobbleMetadata metadata;
   quint64 timestamp;
   bool sent;
@@ -46,6 +46,7 @@ using std::make_shared;
 SmartPlaylistQueryWizardPlugin::SmartPlaylistQueryWizardPlugin(const SharedPtr<Player> player,
                                                                const SharedPtr<PlaylistManager> playlist_manager,
                                                                const SharedPtr<CollectionBackend> collection_backend,
+                                                               TagCompletionStore *tag_completion_store,
 #ifdef HAVE_MOODBAR
                                                                const SharedPtr<MoodbarLoader> moodbar_loader,
 #endif
@@ -55,6 +56,7 @@ SmartPlaylistQueryWizardPlugin::SmartPlaylistQueryWizardPlugin(const SharedPtr<P
       player_(player),
       playlist_manager_(playlist_manager),
       collection_backend_(collection_backend),
+      tag_completion_store_(tag_completion_store),
 #ifdef HAVE_MOODBAR
       moodbar_loader_(moodbar_loader),
 #endif
@@ -84,7 +86,7 @@ int SmartPlaylistQueryWizardPlugin::CreatePages(QWizard *wizard, int finish_page
   QObject::connect(search_page_->ui_->type, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SmartPlaylistQueryWizardPlugin::SearchTypeChanged);
 
   // Create the new search term widget
-  search_page_->new_term_ = new SmartPlaylistSearchTermWidget(collection_backend_, search_page_);
+  search_page_->new_term_ = new SmartPlaylistSearchTermWidget(tag_completion_store_, search_page_);
   search_page_->new_term_->SetActive(false);
   QObject::connect(search_page_->new_term_, &SmartPlaylistSearchTermWidget::Clicked, this, &SmartPlaylistQueryWizardPlugin::AddSearchTerm);
 
@@ -103,6 +105,7 @@ int SmartPlaylistQueryWizardPlugin::CreatePages(QWizard *wizard, int finish_page
   search_page_->preview_->Init(player_,
                                playlist_manager_,
                                collection_backend_,
+                               tag_completion_store_,
 #ifdef HAVE_MOODBAR
                                moodbar_loader_,
 #endif
@@ -127,6 +130,7 @@ int SmartPlaylistQueryWizardPlugin::CreatePages(QWizard *wizard, int finish_page
   sort_ui_->preview->Init(player_,
                           playlist_manager_,
                           collection_backend_,
+                          tag_completion_store_,
 #ifdef HAVE_MOODBAR
                           moodbar_loader_,
 #endif
@@ -218,7 +222,7 @@ void SmartPlaylistQueryWizardPlugin::UpdateSortOrder() {
 
 void SmartPlaylistQueryWizardPlugin::AddSearchTerm() {
 
-  SmartPlaylistSearchTermWidget *widget = new SmartPlaylistSearchTermWidget(collection_backend_, search_page_);
+  SmartPlaylistSearchTermWidget *widget = new SmartPlaylistSearchTermWidget(tag_completion_store_, search_page_);
   QObject::connect(widget, &SmartPlaylistSearchTermWidget::RemoveClicked, this, &SmartPlaylistQueryWizardPlugin::RemoveSearchTerm);
   QObject::connect(widget, &SmartPlaylistSearchTermWidget::Changed, this, &SmartPlaylistQueryWizardPlugin::UpdateTermPreview);
 
@@ -36,6 +36,7 @@ class Player;
 class PlaylistManager;
 class CollectionBackend;
 class CurrentAlbumCoverLoader;
+class TagCompletionStore;
 class SmartPlaylistSearch;
 class SmartPlaylistQueryWizardPluginSearchPage;
 class Ui_SmartPlaylistQuerySortPage;
@@ -51,6 +52,7 @@ class SmartPlaylistQueryWizardPlugin : public SmartPlaylistWizardPlugin {
   explicit SmartPlaylistQueryWizardPlugin(const SharedPtr<Player> player,
                                           const SharedPtr<PlaylistManager> playlist_manager,
                                           const SharedPtr<CollectionBackend> collection_backend,
+                                          TagCompletionStore *tag_completion_store,
 #ifdef HAVE_MOODBAR
                                           const SharedPtr<MoodbarLoader> moodbar_loader,
 #endif
@@ -86,6 +88,7 @@ class SmartPlaylistQueryWizardPlugin : public SmartPlaylistWizardPlugin {
   const SharedPtr<Player> player_;
   const SharedPtr<PlaylistManager> playlist_manager_;
   const SharedPtr<CollectionBackend> collection_backend_;
+  TagCompletionStore *tag_completion_store_;
 #ifdef HAVE_MOODBAR
   const SharedPtr<MoodbarLoader> moodbar_loader_;
 #endif
@@ -65,6 +65,7 @@ SmartPlaylistSearchPreview::~SmartPlaylistSearchPreview() {
 void SmartPlaylistSearchPreview::Init(const SharedPtr<Player> player,
                                       const SharedPtr<PlaylistManager> playlist_manager,
                                       const SharedPtr<CollectionBackend> collection_backend,
+                                      TagCompletionStore *tag_completion_store,
 #ifdef HAVE_MOODBAR
                                       const SharedPtr<MoodbarLoader> moodbar_loader,
 #endif
@@ -78,7 +79,7 @@ void SmartPlaylistSearchPreview::Init(const SharedPtr<Player> player,
 
   ui_->tree->Init(player,
                   playlist_manager,
-                  collection_backend,
+                  tag_completion_store,
 #ifdef HAVE_MOODBAR
                   moodbar_loader,
 #endif
@@ -37,6 +37,7 @@ class Player;
 class PlaylistManager;
 class CollectionBackend;
 class CurrentAlbumCoverLoader;
+class TagCompletionStore;
 class Playlist;
 class Ui_SmartPlaylistSearchPreview;
 
@@ -54,6 +55,7 @@ class SmartPlaylistSearchPreview : public QWidget {
   void Init(const SharedPtr<Player> player,
             const SharedPtr<PlaylistManager> playlist_manager,
             const SharedPtr<CollectionBackend> collection_backend,
+            TagCompletionStore *tag_completion_store,
 #ifdef HAVE_MOODBAR
             const SharedPtr<MoodbarLoader> moodbar_loader,
 #endif
@@ -31,7 +31,6 @@
 #include <QShowEvent>
 #include <QResizeEvent>
 
-#include "includes/shared_ptr.h"
 #include "core/iconloader.h"
 #include "utilities/colorutils.h"
 #include "playlist/playlist.h"
@@ -43,10 +42,10 @@
 
 using namespace Qt::Literals::StringLiterals;
 
-SmartPlaylistSearchTermWidget::SmartPlaylistSearchTermWidget(SharedPtr<CollectionBackend> collection_backend, QWidget *parent)
+SmartPlaylistSearchTermWidget::SmartPlaylistSearchTermWidget(TagCompletionStore *tag_completion_store, QWidget *parent)
     : QWidget(parent),
       ui_(new Ui_SmartPlaylistSearchTermWidget),
-      collection_backend_(collection_backend),
+      tag_completion_store_(tag_completion_store),
       overlay_(nullptr),
       animation_(new QPropertyAnimation(this, "overlay_opacity", this)),
       active_(true),
@@ -160,31 +159,31 @@ void SmartPlaylistSearchTermWidget::FieldChanged(int index) {
   // Maybe set a tag completer
   switch (field) {
     case SmartPlaylistSearchTerm::Field::Artist:
-      new TagCompleter(collection_backend_, Playlist::Column::Artist, ui_->value_text);
+      new TagCompleter(tag_completion_store_, Playlist::Column::Artist, ui_->value_text);
       break;
     case SmartPlaylistSearchTerm::Field::ArtistSort:
-      new TagCompleter(collection_backend_, Playlist::Column::ArtistSort, ui_->value_text);
+      new TagCompleter(tag_completion_store_, Playlist::Column::ArtistSort, ui_->value_text);
       break;
     case SmartPlaylistSearchTerm::Field::Album:
-      new TagCompleter(collection_backend_, Playlist::Column::Album, ui_->value_text);
+      new TagCompleter(tag_completion_store_, Playlist::Column::Album, ui_->value_text);
       break;
     case SmartPlaylistSearchTerm::Field::AlbumSort:
-      new TagCompleter(collection_backend_, Playlist::Column::AlbumSort, ui_->value_text);
+      new TagCompleter(tag_completion_store_, Playlist::Column::AlbumSort, ui_->value_text);
       break;
     case SmartPlaylistSearchTerm::Field::AlbumArtist:
-      new TagCompleter(collection_backend_, Playlist::Column::AlbumArtist, ui_->value_text);
+      new TagCompleter(tag_completion_store_, Playlist::Column::AlbumArtist, ui_->value_text);
       break;
     case SmartPlaylistSearchTerm::Field::AlbumArtistSort:
-      new TagCompleter(collection_backend_, Playlist::Column::AlbumArtistSort, ui_->value_text);
+      new TagCompleter(tag_completion_store_, Playlist::Column::AlbumArtistSort, ui_->value_text);
       break;
     case SmartPlaylistSearchTerm::Field::ComposerSort:
-      new TagCompleter(collection_backend_, Playlist::Column::ComposerSort, ui_->value_text);
+      new TagCompleter(tag_completion_store_, Playlist::Column::ComposerSort, ui_->value_text);
       break;
     case SmartPlaylistSearchTerm::Field::PerformerSort:
-      new TagCompleter(collection_backend_, Playlist::Column::PerformerSort, ui_->value_text);
+      new TagCompleter(tag_completion_store_, Playlist::Column::PerformerSort, ui_->value_text);
       break;
     case SmartPlaylistSearchTerm::Field::TitleSort:
-      new TagCompleter(collection_backend_, Playlist::Column::TitleSort, ui_->value_text);
+      new TagCompleter(tag_completion_store_, Playlist::Column::TitleSort, ui_->value_text);
       break;
     default:
       ui_->value_text->setCompleter(nullptr);
@@ -26,7 +26,6 @@
 #include <QWidget>
 #include <QPushButton>
 
-#include "includes/shared_ptr.h"
 #include "smartplaylistsearchterm.h"
 
 class QPropertyAnimation;
@@ -35,7 +34,7 @@ class QShowEvent;
 class QEnterEvent;
 class QResizeEvent;
 
-class CollectionBackend;
+class TagCompletionStore;
 class Ui_SmartPlaylistSearchTermWidget;
 class SmartPlaylistSearchTermWidgetOverlay;
 
@@ -45,7 +44,7 @@ class SmartPlaylistSearchTermWidget : public QWidget {
   Q_PROPERTY(float overlay_opacity READ overlay_opacity WRITE set_overlay_opacity)
 
  public:
-  explicit SmartPlaylistSearchTermWidget(SharedPtr<CollectionBackend> collection_backend, QWidget *parent);
+  explicit SmartPlaylistSearchTermWidget(TagCompletionStore *tag_completion_store, QWidget *parent);
   ~SmartPlaylistSearchTermWidget() override;
 
   void SetActive(const bool active);
@@ -76,7 +75,7 @@ class SmartPlaylistSearchTermWidget : public QWidget {
 
  private:
   Ui_SmartPlaylistSearchTermWidget *ui_;
-  SharedPtr<CollectionBackend> collection_backend_;
+  TagCompletionStore *tag_completion_store_;
 
   SmartPlaylistSearchTermWidgetOverlay *overlay_;
   QPropertyAnimation *animation_;
@@ -42,6 +42,7 @@ using namespace Qt::Literals::StringLiterals;
 SmartPlaylistsViewContainer::SmartPlaylistsViewContainer(const SharedPtr<Player> player,
                                                          const SharedPtr<PlaylistManager> playlist_manager,
                                                          const SharedPtr<CollectionBackend> collection_backend,
+                                                         TagCompletionStore *tag_completion_store,
 #ifdef HAVE_MOODBAR
                                                          const SharedPtr<MoodbarLoader> moodbar_loader,
 #endif
@@ -52,6 +53,7 @@ SmartPlaylistsViewContainer::SmartPlaylistsViewContainer(const SharedPtr<Player>
       player_(player),
       playlist_manager_(playlist_manager),
       collection_backend_(collection_backend),
+      tag_completion_store_(tag_completion_store),
 #ifdef HAVE_MOODBAR
       moodbar_loader_(moodbar_loader),
 #endif
@@ -210,6 +212,7 @@ void SmartPlaylistsViewContainer::NewSmartPlaylist() {
   SmartPlaylistWizard *wizard = new SmartPlaylistWizard(player_,
                                                         playlist_manager_,
                                                         collection_backend_,
+                                                        tag_completion_store_,
 #ifdef HAVE_MOODBAR
                                                         moodbar_loader_,
 #endif
@@ -229,6 +232,7 @@ void SmartPlaylistsViewContainer::EditSmartPlaylist(const QModelIndex &idx) {
   SmartPlaylistWizard *wizard = new SmartPlaylistWizard(player_,
                                                         playlist_manager_,
                                                         collection_backend_,
+                                                        tag_completion_store_,
 #ifdef HAVE_MOODBAR
                                                         moodbar_loader_,
 #endif
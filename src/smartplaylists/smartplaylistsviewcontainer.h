@@ -36,6 +36,7 @@ class Player;
 class PlaylistManager;
 class CollectionBackend;
 class CurrentAlbumCoverLoader;
+class TagCompletionStore;
 class SmartPlaylistsModel;
 class SmartPlaylistsView;
 class Ui_SmartPlaylistsViewContainer;
@@ -51,6 +52,7 @@ class SmartPlaylistsViewContainer : public QWidget {
   explicit SmartPlaylistsViewContainer(const SharedPtr<Player> player,
                                        const SharedPtr<PlaylistManager> playlist_manager,
                                        const SharedPtr<CollectionBackend> collection_backend,
+                                       TagCompletionStore *tag_completion_store,
 #ifdef HAVE_MOODBAR
                                        const SharedPtr<MoodbarLoader> moodbar_loader,
 #endif
@@ -103,6 +105,7 @@ class SmartPlaylistsViewContainer : public QWidget {
   const SharedPtr<Player> player_;
   const SharedPtr<PlaylistManager> playlist_manager_;
   const SharedPtr<CollectionBackend> collection_backend_;
+  TagCompletionStore *tag_completion_store_;
 #ifdef HAVE_MOODBAR
   const SharedPtr<MoodbarLoader> moodbar_loader_;
 #endif
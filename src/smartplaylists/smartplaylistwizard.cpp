@@ -43,6 +43,7 @@ using namespace Qt::Literals::StringLiterals;
 SmartPlaylistWizard::SmartPlaylistWizard(const SharedPtr<Player> player,
                                          const SharedPtr<PlaylistManager> playlist_manager,
                                          const SharedPtr<CollectionBackend> collection_backend,
+                                         TagCompletionStore *tag_completion_store,
 #ifdef HAVE_MOODBAR
                                          const SharedPtr<MoodbarLoader> moodbar_loader,
 #endif
@@ -85,6 +86,7 @@ SmartPlaylistWizard::SmartPlaylistWizard(const SharedPtr<Player> player,
   AddPlugin(new SmartPlaylistQueryWizardPlugin(player,
                                                playlist_manager,
                                                collection_backend,
+                                               tag_completion_store,
 #ifdef HAVE_MOODBAR
                                                moodbar_loader,
 #endif
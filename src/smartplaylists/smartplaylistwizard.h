@@ -33,6 +33,7 @@ class Player;
 class PlaylistManager;
 class CollectionBackend;
 class CurrentAlbumCoverLoader;
+class TagCompletionStore;
 class SmartPlaylistWizardPlugin;
 class SmartPlaylistWizardTypePage;
 class SmartPlaylistWizardFinishPage;
@@ -48,6 +49,7 @@ class SmartPlaylistWizard : public QWizard {
   explicit SmartPlaylistWizard(const SharedPtr<Player> player,
                                const SharedPtr<PlaylistManager> playlist_manager,
                                const SharedPtr<CollectionBackend> collection_backend,
+                               TagCompletionStore *tag_completion_store,
 #ifdef HAVE_MOODBAR
                                const SharedPtr<MoodbarLoader> moodbar_loader,
 #endif
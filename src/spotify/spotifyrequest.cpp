@@ -31,13 +31,13 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonValue>
-#include <QTimer>
 #include <QScopeGuard>
 
 #include "constants/timeconstants.h"
 #include "utilities/imageutils.h"
 #include "utilities/coverutils.h"
 #include "core/logging.h"
+#include "core/adaptiveconcurrencylimiter.h"
 #include "core/networkaccessmanager.h"
 #include "core/song.h"
 #include "spotifyservice.h"
@@ -47,19 +47,13 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-constexpr int kMaxConcurrentArtistsRequests = 1;
-constexpr int kMaxConcurrentAlbumsRequests = 1;
-constexpr int kMaxConcurrentSongsRequests = 1;
-constexpr int kMaxConcurrentArtistAlbumsRequests = 1;
-constexpr int kMaxConcurrentAlbumSongsRequests = 1;
 constexpr int kMaxConcurrentAlbumCoverRequests = 10;
-constexpr int kFlushRequestsDelay = 200;
 }  // namespace
 
 SpotifyRequest::SpotifyRequest(SpotifyService *service, const SharedPtr<NetworkAccessManager> network, const Type type, QObject *parent)
     : SpotifyBaseRequest(service, network, parent),
       network_(network),
-      timer_flush_requests_(new QTimer(this)),
+      request_limiter_(service->request_limiter()),
       type_(type),
       fetchalbums_(service->fetchalbums()),
       query_id_(-1),
@@ -94,17 +88,7 @@ SpotifyRequest::SpotifyRequest(SpotifyService *service, const SharedPtr<NetworkA
       album_covers_requests_received_(0),
       no_results_(false) {
 
-  timer_flush_requests_->setInterval(kFlushRequestsDelay);
-  timer_flush_requests_->setSingleShot(false);
-  QObject::connect(timer_flush_requests_, &QTimer::timeout, this, &SpotifyRequest::FlushRequests);
-
-}
-
-SpotifyRequest::~SpotifyRequest() {
-
-  if (timer_flush_requests_->isActive()) {
-    timer_flush_requests_->stop();
-  }
+  QObject::connect(request_limiter_, &AdaptiveConcurrencyLimiter::Ready, this, &SpotifyRequest::FlushRequests);
 
 }
 
@@ -141,47 +125,15 @@ void SpotifyRequest::Process() {
 
 }
 
-void SpotifyRequest::StartRequests() {
-
-  if (!timer_flush_requests_->isActive()) {
-    timer_flush_requests_->start();
-  }
-
-}
-
 void SpotifyRequest::FlushRequests() {
 
-  if (!artists_requests_queue_.isEmpty()) {
-    FlushArtistsRequests();
-    return;
-  }
-
-  if (!albums_requests_queue_.isEmpty()) {
-    FlushAlbumsRequests();
-    return;
-  }
-
-  if (!artist_albums_requests_queue_.isEmpty()) {
-    FlushArtistAlbumsRequests();
-    return;
-  }
-
-  if (!album_songs_requests_queue_.isEmpty()) {
-    FlushAlbumSongsRequests();
-    return;
-  }
-
-  if (!songs_requests_queue_.isEmpty()) {
-    FlushSongsRequests();
-    return;
-  }
-
-  if (!album_cover_requests_queue_.isEmpty()) {
-    FlushAlbumCoverRequests();
-    return;
-  }
-
-  timer_flush_requests_->stop();
+  // Queues are flushed in order, so earlier stages get the free request slots first.
+  FlushArtistsRequests();
+  FlushAlbumsRequests();
+  FlushArtistAlbumsRequests();
+  FlushAlbumSongsRequests();
+  FlushSongsRequests();
+  FlushAlbumCoverRequests();
 
 }
 
@@ -209,13 +161,13 @@ void SpotifyRequest::AddArtistsRequest(const int offset, const int limit) {
 
   ++artists_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void SpotifyRequest::FlushArtistsRequests() {
 
-  while (!artists_requests_queue_.isEmpty() && artists_requests_active_ < kMaxConcurrentArtistsRequests) {
+  while (!artists_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const Request request = artists_requests_queue_.dequeue();
 
@@ -238,6 +190,7 @@ void SpotifyRequest::FlushArtistsRequests() {
     }
     if (!reply) continue;
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { ArtistsReplyReceived(reply, request.limit, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++artists_requests_active_;
 
@@ -262,13 +215,13 @@ void SpotifyRequest::AddAlbumsRequest(const int offset, const int limit) {
 
   ++albums_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void SpotifyRequest::FlushAlbumsRequests() {
 
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
+  while (!albums_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const Request request = albums_requests_queue_.dequeue();
 
@@ -291,6 +244,7 @@ void SpotifyRequest::FlushAlbumsRequests() {
     }
     if (!reply) continue;
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumsReplyReceived(reply, request.limit, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++albums_requests_active_;
 
@@ -315,13 +269,13 @@ void SpotifyRequest::AddSongsRequest(const int offset, const int limit) {
 
   ++songs_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void SpotifyRequest::FlushSongsRequests() {
 
-  while (!songs_requests_queue_.isEmpty() && songs_requests_active_ < kMaxConcurrentSongsRequests) {
+  while (!songs_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const Request request = songs_requests_queue_.dequeue();
 
@@ -345,6 +299,7 @@ void SpotifyRequest::FlushSongsRequests() {
     }
     if (!reply) continue;
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { SongsReplyReceived(reply, request.limit, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++songs_requests_active_;
 
@@ -396,12 +351,13 @@ void SpotifyRequest::AddSongsSearchRequest(const int offset) {
 
 void SpotifyRequest::ArtistsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
-  QObject::disconnect(reply, nullptr, this, nullptr);
-  reply->deleteLater();
+  ParseReplyAsync<JsonObjectResult>(reply, &SpotifyBaseRequest::ParseReplyData, [this, limit_requested, offset_requested](const JsonObjectResult &json_object_result) { ArtistsReceived(json_object_result, limit_requested, offset_requested); });
+
+}
+
+void SpotifyRequest::ArtistsReceived(const JsonObjectResult &json_object_result, const int limit_requested, const int offset_requested) {
 
-  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+  CheckAuthentication(json_object_result.network_error);
 
   --artists_requests_active_;
   ++artists_requests_received_;
@@ -554,9 +510,11 @@ void SpotifyRequest::ArtistsFinishCheck(const int limit, const int offset, const
 
 void SpotifyRequest::AlbumsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested) {
 
-  --albums_requests_active_;
-  ++albums_requests_received_;
-  AlbumsReceived(reply, Artist(), limit_requested, offset_requested);
+  ParseReplyAsync<JsonObjectResult>(reply, &SpotifyBaseRequest::ParseReplyData, [this, limit_requested, offset_requested](const JsonObjectResult &json_object_result) {
+    --albums_requests_active_;
+    ++albums_requests_received_;
+    AlbumsReceived(json_object_result, Artist(), limit_requested, offset_requested);
+  });
 
 }
 
@@ -569,13 +527,13 @@ void SpotifyRequest::AddArtistAlbumsRequest(const Artist &artist, const int offs
 
   ++artist_albums_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void SpotifyRequest::FlushArtistAlbumsRequests() {
 
-  while (!artist_albums_requests_queue_.isEmpty() && artist_albums_requests_active_ < kMaxConcurrentArtistAlbumsRequests) {
+  while (!artist_albums_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const ArtistAlbumsRequest request = artist_albums_requests_queue_.dequeue();
 
@@ -583,6 +541,7 @@ void SpotifyRequest::FlushArtistAlbumsRequests() {
     if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
     QNetworkReply *reply = CreateRequest(QStringLiteral("artists/%1/albums").arg(request.artist.artist_id), parameters);
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { ArtistAlbumsReplyReceived(reply, request.artist, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++artist_albums_requests_active_;
 
@@ -592,21 +551,18 @@ void SpotifyRequest::FlushArtistAlbumsRequests() {
 
 void SpotifyRequest::ArtistAlbumsReplyReceived(QNetworkReply *reply, const Artist &artist, const int offset_requested) {
 
-  --artist_albums_requests_active_;
-  ++artist_albums_requests_received_;
-  Q_EMIT UpdateProgress(query_id_, GetProgress(artist_albums_requests_received_, artist_albums_requests_total_));
-  AlbumsReceived(reply, artist, 0, offset_requested);
+  ParseReplyAsync<JsonObjectResult>(reply, &SpotifyBaseRequest::ParseReplyData, [this, artist, offset_requested](const JsonObjectResult &json_object_result) {
+    --artist_albums_requests_active_;
+    ++artist_albums_requests_received_;
+    Q_EMIT UpdateProgress(query_id_, GetProgress(artist_albums_requests_received_, artist_albums_requests_total_));
+    AlbumsReceived(json_object_result, artist, 0, offset_requested);
+  });
 
 }
 
-void SpotifyRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_artist, const int limit_requested, const int offset_requested) {
-
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
-  QObject::disconnect(reply, nullptr, this, nullptr);
-  reply->deleteLater();
+void SpotifyRequest::AlbumsReceived(const JsonObjectResult &json_object_result, const Artist &artist_artist, const int limit_requested, const int offset_requested) {
 
-  JsonObjectResult json_object_result = ParseJsonObject(reply);
+  CheckAuthentication(json_object_result.network_error);
 
   if (finished_) return;
 
@@ -774,6 +730,7 @@ void SpotifyRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_a
         bool compilation = false;
         bool multidisc = false;
         SongList songs;
+        SongsParser songs_parser = CreateSongsParser(artist, album, 0);
         for (const QJsonValue &value : array_tracks) {
           if (!value.isObject()) {
             continue;
@@ -783,12 +740,15 @@ void SpotifyRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_a
             obj_track = obj_track["track"_L1].toObject();
           }
           Song song(Song::Source::Spotify);
-          ParseSong(song, obj_track, artist, album);
+          songs_parser.ParseSong(song, obj_track, artist, album);
           if (!song.is_valid()) continue;
           if (song.disc() >= 2) multidisc = true;
           if (song.is_compilation()) compilation = true;
           songs << song;
         }
+        if (!songs_parser.errors().isEmpty()) {
+          error_ = songs_parser.errors().last();
+        }
         for (Song song : std::as_const(songs)) {
           if (compilation) song.set_compilation_detected(true);
           if (!multidisc) song.set_disc(0);
@@ -866,13 +826,19 @@ void SpotifyRequest::AlbumsFinishCheck(const Artist &artist, const int limit, co
 
 void SpotifyRequest::SongsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested) {
 
-  --songs_requests_active_;
-  ++songs_requests_received_;
   if (type_ == Type::SearchSongs && fetchalbums_) {
-    AlbumsReceived(reply, Artist(), limit_requested, offset_requested);
+    ParseReplyAsync<JsonObjectResult>(reply, &SpotifyBaseRequest::ParseReplyData, [this, limit_requested, offset_requested](const JsonObjectResult &json_object_result) {
+      --songs_requests_active_;
+      ++songs_requests_received_;
+      AlbumsReceived(json_object_result, Artist(), limit_requested, offset_requested);
+    });
   }
   else {
-    SongsReceived(reply, Artist(), Album(), limit_requested, offset_requested);
+    ParseReplyAsync<SongsPage>(reply, CreateSongsParser(Artist(), Album(), offset_requested), [this, limit_requested, offset_requested](const SongsPage &songs_page) {
+      --songs_requests_active_;
+      ++songs_requests_received_;
+      SongsReceived(songs_page, Artist(), Album(), limit_requested, offset_requested);
+    });
   }
 
 }
@@ -887,48 +853,134 @@ void SpotifyRequest::AddAlbumSongsRequest(const Artist &artist, const Album &alb
 
   ++album_songs_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void SpotifyRequest::FlushAlbumSongsRequests() {
 
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+  while (!album_songs_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
     const AlbumSongsRequest request = album_songs_requests_queue_.dequeue();
     ++album_songs_requests_active_;
     ParamList parameters;
     if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
     QNetworkReply *reply = CreateRequest(QStringLiteral("albums/%1/tracks").arg(request.album.album_id), parameters);
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumSongsReplyReceived(reply, request.artist, request.album, request.offset); });
+    request_limiter_->AddReply(reply);
   }
 
 }
 
 void SpotifyRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const Artist &artist, const Album &album, const int offset_requested) {
 
-  --album_songs_requests_active_;
-  ++album_songs_requests_received_;
-  if (offset_requested == 0) {
-    Q_EMIT UpdateProgress(query_id_, GetProgress(album_songs_requests_received_, album_songs_requests_total_));
-  }
-  SongsReceived(reply, artist, album, 0, offset_requested);
+  ParseReplyAsync<SongsPage>(reply, CreateSongsParser(artist, album, offset_requested), [this, artist, album, offset_requested](const SongsPage &songs_page) {
+    --album_songs_requests_active_;
+    ++album_songs_requests_received_;
+    if (offset_requested == 0) {
+      Q_EMIT UpdateProgress(query_id_, GetProgress(album_songs_requests_received_, album_songs_requests_total_));
+    }
+    SongsReceived(songs_page, artist, album, 0, offset_requested);
+  });
+
+}
+
+SpotifyRequest::SongsParser SpotifyRequest::CreateSongsParser(const Artist &artist, const Album &album, const int offset_requested) const {
+
+  return SongsParser(service_->remove_remastered(), artist, album, offset_requested);
 
 }
 
-void SpotifyRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, const Album &album, const int limit_requested, const int offset_requested) {
+void SpotifyRequest::SongsReceived(const SongsPage &songs_page, const Artist &artist, const Album &album, const int limit_requested, const int offset_requested) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
-  QObject::disconnect(reply, nullptr, this, nullptr);
-  reply->deleteLater();
+  CheckAuthentication(songs_page.network_error);
 
-  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+  if (finished_) return;
+
+  const QScopeGuard finish_check = qScopeGuard([this, artist, album, limit_requested, offset_requested, &songs_page]() { SongsFinishCheck(artist, album, limit_requested, offset_requested, songs_page.songs_total, songs_page.songs_received); });
+
+  // The parser logged the errors already.
+  if (!songs_page.errors.isEmpty()) {
+    error_ = songs_page.errors.last();
+  }
+
+  if ((type_ == Type::FavouriteSongs || type_ == Type::SearchSongs) && songs_page.songs_total > 0) {
+    songs_total_ = songs_page.songs_total;
+  }
+
+  if (songs_page.no_items) {
+    if ((type_ == Type::FavouriteSongs || type_ == Type::SearchSongs) && offset_requested == 0) {
+      no_results_ = true;
+    }
+    return;
+  }
+
+  for (const Song &song : songs_page.songs) {
+    songs_.insert(song.song_id(), song);
+  }
+
+  if (type_ == Type::FavouriteSongs || type_ == Type::SearchSongs) {
+    songs_received_ += songs_page.songs_received;
+    Q_EMIT UpdateProgress(query_id_, GetProgress(songs_received_, songs_total_));
+  }
+
+}
+
+void SpotifyRequest::SongsFinishCheck(const Artist &artist, const Album &album, const int limit, const int offset, const int songs_total, const int songs_received) {
 
   if (finished_) return;
 
-  int songs_total = 0;
-  int songs_received = 0;
-  const QScopeGuard finish_check = qScopeGuard([this, artist, album, limit_requested, offset_requested, &songs_total, &songs_received]() { SongsFinishCheck(artist, album, limit_requested, offset_requested, songs_total, songs_received); });
+  if (songs_received > 0 && (limit == 0 || limit > songs_received)) {
+    int offset_next = offset + songs_received;
+    if (offset_next > 0 && offset_next < songs_total) {
+      switch (type_) {
+        case Type::FavouriteSongs:
+          AddSongsRequest(offset_next);
+          break;
+        case Type::SearchSongs:
+          // If artist_id and album_id isn't zero it means that it's a songs search where we fetch all albums too. So fallthrough.
+          if (artist.artist_id.isEmpty() && album.album_id.isEmpty()) {
+            AddSongsSearchRequest(offset_next);
+            break;
+          }
+        // fallthrough
+        case Type::FavouriteArtists:
+        case Type::SearchArtists:
+        case Type::FavouriteAlbums:
+        case Type::SearchAlbums:
+          AddAlbumSongsRequest(artist, album, offset_next);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  GetAlbumCoversCheck();
+
+  FinishCheck();
+
+}
+
+SpotifyRequest::SongsParser::SongsParser(const bool remove_remastered, const Artist &artist, const Album &album, const int offset_requested)
+    : remove_remastered_(remove_remastered),
+      artist_(artist),
+      album_(album),
+      offset_requested_(offset_requested) {}
+
+SpotifyRequest::SongsPage SpotifyRequest::SongsParser::operator()(ReplyData reply_data) {
+
+  // The Json document only lives while the songs are built, the reply data is released once it's parsed.
+  SongsPage songs_page;
+  const JsonObjectResult json_object_result = ParseReplyData(std::move(reply_data));
+  songs_page.network_error = json_object_result.network_error;
+  ParseSongs(json_object_result, songs_page);
+  songs_page.errors = errors_;
+
+  return songs_page;
+
+}
+
+void SpotifyRequest::SongsParser::ParseSongs(const JsonObjectResult &json_object_result, SongsPage &songs_page) {
 
   if (!json_object_result.success()) {
     Error(json_object_result.error_message);
@@ -953,14 +1005,10 @@ void SpotifyRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, c
   }
 
   const int offset = json_object["offset"_L1].toInt();
-  songs_total = json_object["total"_L1].toInt();
+  songs_page.songs_total = json_object["total"_L1].toInt();
 
-  if (type_ == Type::FavouriteSongs || type_ == Type::SearchSongs) {
-    songs_total_ = songs_total;
-  }
-
-  if (offset != offset_requested) {
-    Error(QStringLiteral("Offset returned does not match offset requested! %1 != %2").arg(offset).arg(offset_requested));
+  if (offset != offset_requested_) {
+    Error(QStringLiteral("Offset returned does not match offset requested! %1 != %2").arg(offset).arg(offset_requested_));
     return;
   }
 
@@ -972,9 +1020,7 @@ void SpotifyRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, c
 
   const QJsonArray &array_items = json_array_result.json_array;
   if (array_items.isEmpty()) {
-    if ((type_ == Type::FavouriteSongs || type_ == Type::SearchSongs) && offset_requested == 0) {
-      no_results_ = true;
-    }
+    songs_page.no_items = true;
     return;
   }
 
@@ -997,9 +1043,9 @@ void SpotifyRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, c
       object_item = object_item["track"_L1].toObject();
     }
 
-    ++songs_received;
+    ++songs_page.songs_received;
     Song song(Song::Source::Spotify);
-    ParseSong(song, object_item, artist, album);
+    ParseSong(song, object_item, artist_, album_);
     if (!song.is_valid()) continue;
     if (song.disc() >= 2) multidisc = true;
     if (song.is_compilation()) compilation = true;
@@ -1009,53 +1055,12 @@ void SpotifyRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, c
   for (Song song : std::as_const(songs)) {
     if (compilation) song.set_compilation_detected(true);
     if (!multidisc) song.set_disc(0);
-    songs_.insert(song.song_id(), song);
-  }
-
-  if (type_ == Type::FavouriteSongs || type_ == Type::SearchSongs) {
-    songs_received_ += songs_received;
-    Q_EMIT UpdateProgress(query_id_, GetProgress(songs_received_, songs_total_));
-  }
-
-}
-
-void SpotifyRequest::SongsFinishCheck(const Artist &artist, const Album &album, const int limit, const int offset, const int songs_total, const int songs_received) {
-
-  if (finished_) return;
-
-  if (songs_received > 0 && (limit == 0 || limit > songs_received)) {
-    int offset_next = offset + songs_received;
-    if (offset_next > 0 && offset_next < songs_total) {
-      switch (type_) {
-        case Type::FavouriteSongs:
-          AddSongsRequest(offset_next);
-          break;
-        case Type::SearchSongs:
-          // If artist_id and album_id isn't zero it means that it's a songs search where we fetch all albums too. So fallthrough.
-          if (artist.artist_id.isEmpty() && album.album_id.isEmpty()) {
-            AddSongsSearchRequest(offset_next);
-            break;
-          }
-        // fallthrough
-        case Type::FavouriteArtists:
-        case Type::SearchArtists:
-        case Type::FavouriteAlbums:
-        case Type::SearchAlbums:
-          AddAlbumSongsRequest(artist, album, offset_next);
-          break;
-        default:
-          break;
-      }
-    }
+    songs_page.songs << song;
   }
 
-  GetAlbumCoversCheck();
-
-  FinishCheck();
-
 }
 
-void SpotifyRequest::ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album) {
+void SpotifyRequest::SongsParser::ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album) {
 
   if (!json_obj.contains("type"_L1) ||
       !json_obj.contains("id"_L1) ||
@@ -1148,7 +1153,7 @@ void SpotifyRequest::ParseSong(Song &song, const QJsonObject &json_obj, const Ar
 
   QUrl url(uri);
 
-  if (service_->remove_remastered()) {
+  if (remove_remastered_) {
     title = Song::TitleRemoveMisc(title);
   }
 
@@ -1213,7 +1218,7 @@ void SpotifyRequest::GetAlbumCovers() {
   else Q_EMIT UpdateStatus(query_id_, tr("Receiving album covers for %1 albums...").arg(album_covers_requests_total_));
   Q_EMIT UpdateProgress(query_id_, 0);
 
-  StartRequests();
+  FlushRequests();
 
 }
 
@@ -1332,6 +1337,7 @@ void SpotifyRequest::AlbumCoverReceived(QNetworkReply *reply, const QString &alb
 
 void SpotifyRequest::AlbumCoverFinishCheck() {
 
+  FlushAlbumCoverRequests();
   FinishCheck();
 
 }
@@ -1354,9 +1360,6 @@ void SpotifyRequest::FinishCheck() {
       artist_albums_requests_active_ <= 0 &&
       album_songs_requests_active_ <= 0 &&
       album_covers_requests_active_ <= 0) {
-    if (timer_flush_requests_->isActive()) {
-      timer_flush_requests_->stop();
-    }
     finished_ = true;
     if (no_results_ && songs_.isEmpty()) {
       if (IsSearch()) {
@@ -1395,6 +1398,17 @@ void SpotifyRequest::Error(const QString &error_message, const QVariant &debug_o
 
 }
 
+void SpotifyRequest::SongsParser::Error(const QString &error_message, const QVariant &debug_output) {
+
+  qLog(Error) << "Spotify:" << error_message;
+  if (debug_output.isValid()) {
+    qLog(Debug) << debug_output;
+  }
+
+  errors_ << error_message;
+
+}
+
 void SpotifyRequest::Warn(const QString &error_message, const QVariant &debug) {
 
   qLog(Error) << "Spotify:" << error_message;
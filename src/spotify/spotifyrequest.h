@@ -29,15 +29,15 @@
 #include <QString>
 #include <QStringList>
 #include <QUrl>
+#include <QNetworkReply>
 #include <QJsonObject>
-#include <QTimer>
 #include <QScopedPointer>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
 #include "spotifybaserequest.h"
 
-class QNetworkReply;
+class AdaptiveConcurrencyLimiter;
 class NetworkAccessManager;
 class SpotifyService;
 
@@ -46,7 +46,6 @@ class SpotifyRequest : public SpotifyBaseRequest {
 
  public:
   explicit SpotifyRequest(SpotifyService *service, const SharedPtr<NetworkAccessManager> network, const Type type, QObject *parent);
-  ~SpotifyRequest() override;
 
   void ReloadSettings();
 
@@ -89,6 +88,34 @@ class SpotifyRequest : public SpotifyBaseRequest {
     QUrl url;
     QString filename;
   };
+  struct SongsPage {
+    SongsPage() : network_error(QNetworkReply::NoError), songs_total(0), songs_received(0), no_items(false) {}
+    QNetworkReply::NetworkError network_error;
+    QStringList errors;
+    int songs_total;
+    int songs_received;
+    bool no_items;
+    SongList songs;
+  };
+
+  // Builds the songs of a reply on a worker thread, so it only keeps copies of what it needs from the request.
+  class SongsParser {
+   public:
+    explicit SongsParser(const bool remove_remastered, const Artist &artist, const Album &album, const int offset_requested);
+    SongsPage operator()(ReplyData reply_data);
+    void ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album);
+    QStringList errors() const { return errors_; }
+
+   private:
+    void ParseSongs(const JsonObjectResult &json_object_result, SongsPage &songs_page);
+    void Error(const QString &error_message, const QVariant &debug_output = QVariant());
+
+    bool remove_remastered_;
+    Artist artist_;
+    Album album_;
+    int offset_requested_;
+    QStringList errors_;
+  };
 
  Q_SIGNALS:
   void Results(int id, SongMap songs, QString error);
@@ -103,21 +130,22 @@ class SpotifyRequest : public SpotifyBaseRequest {
   void ArtistsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested);
 
   void AlbumsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested);
-  void AlbumsReceived(QNetworkReply *reply, const SpotifyRequest::Artist &artist_artist, const int limit_requested, const int offset_requested);
-
   void SongsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested);
-  void SongsReceived(QNetworkReply *reply, const SpotifyRequest::Artist &artist, const SpotifyRequest::Album &album, const int limit_requested, const int offset_requested);
 
   void ArtistAlbumsReplyReceived(QNetworkReply *reply, const SpotifyRequest::Artist &artist, const int offset_requested);
   void AlbumSongsReplyReceived(QNetworkReply *reply, const SpotifyRequest::Artist &artist, const SpotifyRequest::Album &album, const int offset_requested);
   void AlbumCoverReceived(QNetworkReply *reply, const QString &album_id, const QUrl &url, const QString &filename);
 
  private:
-  void StartRequests();
 
   bool IsQuery() const { return (type_ == Type::FavouriteArtists || type_ == Type::FavouriteAlbums || type_ == Type::FavouriteSongs); }
   bool IsSearch() const { return (type_ == Type::SearchArtists || type_ == Type::SearchAlbums || type_ == Type::SearchSongs); }
 
+  void ArtistsReceived(const JsonObjectResult &json_object_result, const int limit_requested, const int offset_requested);
+  void AlbumsReceived(const JsonObjectResult &json_object_result, const Artist &artist_artist, const int limit_requested, const int offset_requested);
+  SongsParser CreateSongsParser(const Artist &artist, const Album &album, const int offset_requested) const;
+  void SongsReceived(const SongsPage &songs_page, const Artist &artist, const Album &album, const int limit_requested, const int offset_requested);
+
   void GetArtists();
   void GetAlbums();
   void GetSongs();
@@ -146,8 +174,6 @@ class SpotifyRequest : public SpotifyBaseRequest {
   void AddAlbumSongsRequest(const Artist &artist, const Album &album, const int offset = 0);
   void FlushAlbumSongsRequests();
 
-  void ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album);
-
   void GetAlbumCoversCheck();
   void GetAlbumCovers();
   void AddAlbumCoverRequest(const Song &song);
@@ -161,7 +187,7 @@ class SpotifyRequest : public SpotifyBaseRequest {
 
  private:
   const SharedPtr<NetworkAccessManager> network_;
-  QTimer *timer_flush_requests_;
+  AdaptiveConcurrencyLimiter *request_limiter_;
 
   const Type type_;
   bool fetchalbums_;
@@ -28,6 +28,7 @@
 
 #include "constants/spotifysettings.h"
 #include "core/logging.h"
+#include "core/adaptiveconcurrencylimiter.h"
 #include "core/song.h"
 #include "core/settings.h"
 #include "core/taskmanager.h"
@@ -104,6 +105,9 @@ SpotifyService::SpotifyService(const SharedPtr<TaskManager> task_manager,
   oauth_->set_random_port(false);
   QObject::connect(oauth_, &OAuthenticator::AuthenticationFinished, this, &SpotifyService::OAuthFinished);
 
+  // The Spotify Web API is strict about rate limits, so start with one request at a time.
+  request_limiter()->set_limit(1);
+
   // Backends
 
   artists_collection_backend_ = make_shared<CollectionBackend>();
@@ -223,6 +227,8 @@ void SpotifyService::ClearSession() {
 
   oauth_->ClearSession();
 
+  Q_EMIT SessionCleared();
+
 }
 
 void SpotifyService::OAuthFinished(const bool success, const QString &error) {
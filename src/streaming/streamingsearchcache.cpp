@@ -0,0 +1,257 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QObject>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QMutexLocker>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QSqlDatabase>
+
+#include "includes/shared_ptr.h"
+#include "core/database.h"
+#include "core/sqlquery.h"
+#include "core/scopedtransaction.h"
+#include "core/song.h"
+#include "streamingservice.h"
+#include "streamingsearchcache.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr qint64 kResultsTtlSec = 24LL * 60LL * 60LL;
+constexpr int kMaxEntries = 64;
+constexpr qint64 kMinPrefixLength = 2;
+}  // namespace
+
+StreamingSearchCache::StreamingSearchCache(const SharedPtr<Database> database, const Song::Source source, QObject *parent)
+    : QObject(parent),
+      database_(database),
+      source_(source),
+      thread_pool_(new QThreadPool(this)),
+      entries_(kMaxEntries),
+      generation_(0) {
+
+  thread_pool_->setMaxThreadCount(1);
+  thread_pool_->setExpiryTimeout(-1);
+
+}
+
+StreamingSearchCache::~StreamingSearchCache() {
+
+  // Close the connection of the pool thread before the thread goes away.
+  (void)QtConcurrent::run(thread_pool_, [database = database_]() { database->Close(); });
+  thread_pool_->waitForDone();
+
+}
+
+QString StreamingSearchCache::NormalizeQuery(const QString &query) {
+
+  return query.simplified().toCaseFolded();
+
+}
+
+QString StreamingSearchCache::CacheKey(const StreamingService::SearchType type, const QString &normalized_query) {
+
+  return QString::number(static_cast<int>(type)) + u':' + normalized_query;
+
+}
+
+qint64 StreamingSearchCache::ExpiryTime() {
+
+  return QDateTime::currentSecsSinceEpoch() - kResultsTtlSec;
+
+}
+
+bool StreamingSearchCache::Results(const StreamingService::SearchType type, const QString &query, SongMap *songs) {
+
+  const QString key = CacheKey(type, NormalizeQuery(query));
+  const Entry *entry = entries_.object(key);
+  if (!entry) return false;
+
+  if (entry->time < ExpiryTime()) {
+    entries_.remove(key);
+    return false;
+  }
+
+  *songs = entry->songs;
+
+  return true;
+
+}
+
+SongMap StreamingSearchCache::PrefixResults(const StreamingService::SearchType type, const QString &query) {
+
+  const QString key = CacheKey(type, NormalizeQuery(query));
+  const QString type_prefix = CacheKey(type, QString());
+  const qint64 min_time = ExpiryTime();
+
+  QString best_key;
+  const QList<QString> keys = entries_.keys();
+  for (const QString &cached_key : keys) {
+    if (cached_key.length() - type_prefix.length() < kMinPrefixLength || cached_key.length() >= key.length() || cached_key.length() <= best_key.length()) continue;
+    if (!cached_key.startsWith(type_prefix) || !key.startsWith(cached_key)) continue;
+    const Entry *entry = entries_.object(cached_key);
+    if (entry && entry->time >= min_time) {
+      best_key = cached_key;
+    }
+  }
+
+  if (best_key.isEmpty()) return SongMap();
+
+  return entries_.object(best_key)->songs;
+
+}
+
+void StreamingSearchCache::Insert(const StreamingService::SearchType type, const QString &query, const SongMap &songs) {
+
+  const QString normalized_query = NormalizeQuery(query);
+  const qint64 time = QDateTime::currentSecsSinceEpoch();
+
+  entries_.insert(CacheKey(type, normalized_query), new Entry{time, songs});
+
+  (void)QtConcurrent::run(thread_pool_, &StreamingSearchCache::SaveResults, database_, source_, type, normalized_query, songs, time);
+
+}
+
+void StreamingSearchCache::LoadAsync(const int id, const StreamingService::SearchType type, const QString &query) {
+
+  const QString normalized_query = NormalizeQuery(query);
+
+  const quint64 generation = generation_;
+
+  QFuture<Entry> future = QtConcurrent::run(thread_pool_, &StreamingSearchCache::LoadResults, database_, source_, type, normalized_query, ExpiryTime());
+  QFutureWatcher<Entry> *watcher = new QFutureWatcher<Entry>(this);
+  QObject::connect(watcher, &QFutureWatcher<Entry>::finished, this, [this, watcher, id, type, query, normalized_query, generation]() {
+    const Entry entry = watcher->result();
+    watcher->deleteLater();
+    // Results loaded before the cache was cleared belong to the previous session.
+    if (generation != generation_) {
+      Q_EMIT ResultsLoaded(id, type, query, SongMap());
+      return;
+    }
+    if (!entry.songs.isEmpty()) {
+      entries_.insert(CacheKey(type, normalized_query), new Entry{entry.time, entry.songs});
+    }
+    Q_EMIT ResultsLoaded(id, type, query, entry.songs);
+  });
+  watcher->setFuture(future);
+
+}
+
+void StreamingSearchCache::Clear() {
+
+  ++generation_;
+  entries_.clear();
+
+  (void)QtConcurrent::run(thread_pool_, &StreamingSearchCache::DeleteResults, database_, source_);
+
+}
+
+StreamingSearchCache::Entry StreamingSearchCache::LoadResults(const SharedPtr<Database> database, const Song::Source source, const StreamingService::SearchType type, const QString &normalized_query, const qint64 min_time) {
+
+  QMutexLocker l(database->Mutex());
+
+  Entry entry{0, SongMap()};
+  {
+    QSqlDatabase db(database->Connect());
+    SqlQuery q(db);
+    q.prepare(u"SELECT search_time, %1 FROM streaming_search_songs WHERE search_source = :search_source AND search_type = :search_type AND search_query = :search_query AND search_time >= :search_time"_s.arg(Song::kRowIdColumnSpec));
+    q.BindValue(u":search_source"_s, static_cast<int>(source));
+    q.BindValue(u":search_type"_s, static_cast<int>(type));
+    q.BindValue(u":search_query"_s, normalized_query);
+    q.BindValue(u":search_time"_s, min_time);
+    if (q.Exec()) {
+      while (q.next()) {
+        // All rows of a query are saved together, so they share the same time.
+        entry.time = q.value(0).toLongLong();
+        Song song;
+        song.InitFromQuery(q, true, 1);
+        entry.songs.insert(song.song_id(), song);
+      }
+    }
+    else {
+      database->ReportErrors(q);
+    }
+  }
+
+  return entry;
+
+}
+
+void StreamingSearchCache::SaveResults(const SharedPtr<Database> database, const Song::Source source, const StreamingService::SearchType type, const QString &normalized_query, const SongMap &songs, const qint64 time) {
+
+  QMutexLocker l(database->Mutex());
+
+  {
+    QSqlDatabase db(database->Connect());
+    ScopedTransaction t(&db);
+
+    // Replace the previous results for the query and drop all expired results for the service.
+    SqlQuery q(db);
+    q.prepare(u"DELETE FROM streaming_search_songs WHERE search_source = :search_source AND ((search_type = :search_type AND search_query = :search_query) OR search_time < :search_time)"_s);
+    q.BindValue(u":search_source"_s, static_cast<int>(source));
+    q.BindValue(u":search_type"_s, static_cast<int>(type));
+    q.BindValue(u":search_query"_s, normalized_query);
+    q.BindValue(u":search_time"_s, time - kResultsTtlSec);
+    bool success = q.Exec();
+    if (!success) {
+      database->ReportErrors(q);
+    }
+
+    SqlQuery insert(db);
+    insert.prepare(u"INSERT INTO streaming_search_songs (search_source, search_type, search_query, search_time, %1) VALUES (:search_source, :search_type, :search_query, :search_time, %2)"_s.arg(Song::kColumnSpec, Song::kBindSpec));
+    for (SongMap::const_iterator it = songs.constBegin(); success && it != songs.constEnd(); ++it) {
+      insert.BindValue(u":search_source"_s, static_cast<int>(source));
+      insert.BindValue(u":search_type"_s, static_cast<int>(type));
+      insert.BindValue(u":search_query"_s, normalized_query);
+      insert.BindValue(u":search_time"_s, time);
+      it.value().BindToQuery(&insert);
+      success = insert.Exec();
+      if (!success) {
+        database->ReportErrors(insert);
+      }
+    }
+
+    if (success) {
+      t.Commit();
+    }
+  }
+
+}
+
+void StreamingSearchCache::DeleteResults(const SharedPtr<Database> database, const Song::Source source) {
+
+  QMutexLocker l(database->Mutex());
+  QSqlDatabase db(database->Connect());
+
+  SqlQuery q(db);
+  q.prepare(u"DELETE FROM streaming_search_songs WHERE search_source = :search_source"_s);
+  q.BindValue(u":search_source"_s, static_cast<int>(source));
+  if (!q.Exec()) {
+    database->ReportErrors(q);
+  }
+
+}
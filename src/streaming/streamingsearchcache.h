@@ -0,0 +1,87 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef STREAMINGSEARCHCACHE_H
+#define STREAMINGSEARCHCACHE_H
+
+#include "config.h"
+
+#include <QObject>
+#include <QCache>
+#include <QString>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "streamingservice.h"
+
+class QThreadPool;
+class Database;
+
+// Caches search results of a streaming service, keyed by search type and normalized query.
+// Results are kept in memory for the session and written to the database, so they survive restarts until they expire.
+// Results of a shorter query that the new query starts with can be shown while the service is still searching.
+class StreamingSearchCache : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit StreamingSearchCache(const SharedPtr<Database> database, const Song::Source source, QObject *parent = nullptr);
+  ~StreamingSearchCache() override;
+
+  static QString NormalizeQuery(const QString &query);
+
+  // Returns true and sets songs if there are fresh results for the query in memory.
+  bool Results(const StreamingService::SearchType type, const QString &query, SongMap *songs);
+
+  // Returns the results of the longest cached query that the query starts with, or an empty map.
+  SongMap PrefixResults(const StreamingService::SearchType type, const QString &query);
+
+  // Looks up the query in the database, emits ResultsLoaded with empty songs if there are no fresh results.
+  void LoadAsync(const int id, const StreamingService::SearchType type, const QString &query);
+
+  void Insert(const StreamingService::SearchType type, const QString &query, const SongMap &songs);
+
+ public Q_SLOTS:
+  // Drops all results of the service from memory and the database, called when the user logs out or in again.
+  void Clear();
+
+ private:
+  struct Entry {
+    qint64 time;
+    SongMap songs;
+  };
+
+  static QString CacheKey(const StreamingService::SearchType type, const QString &normalized_query);
+  static qint64 ExpiryTime();
+  static Entry LoadResults(const SharedPtr<Database> database, const Song::Source source, const StreamingService::SearchType type, const QString &normalized_query, const qint64 min_time);
+  static void SaveResults(const SharedPtr<Database> database, const Song::Source source, const StreamingService::SearchType type, const QString &normalized_query, const SongMap &songs, const qint64 time);
+  static void DeleteResults(const SharedPtr<Database> database, const Song::Source source);
+
+ Q_SIGNALS:
+  void ResultsLoaded(const int id, const StreamingService::SearchType type, const QString &query, const SongMap &songs);
+
+ private:
+  const SharedPtr<Database> database_;
+  const Song::Source source_;
+  // All database work runs on this single, persistent thread so it reuses one connection.
+  QThreadPool *thread_pool_;
+  QCache<QString, Entry> entries_;
+  quint64 generation_;
+};
+
+#endif  // STREAMINGSEARCHCACHE_H
@@ -78,6 +78,7 @@
 #include "streamingservice.h"
 #include "streamingsearchitemdelegate.h"
 #include "streamingsearchmodel.h"
+#include "streamingsearchcache.h"
 #include "streamingsearchsortmodel.h"
 #include "streamingsearchview.h"
 #include "ui_streamingsearchview.h"
@@ -95,6 +96,7 @@ constexpr int kArtHeight = 32;
 StreamingSearchView::StreamingSearchView(QWidget *parent)
     : QWidget(parent),
       service_(nullptr),
+      search_cache_(nullptr),
       ui_(new Ui_StreamingSearchView),
       context_menu_(nullptr),
       group_by_actions_(nullptr),
@@ -109,7 +111,8 @@ StreamingSearchView::StreamingSearchView(QWidget *parent)
       search_type_(StreamingService::SearchType::Artists),
       search_error_(false),
       last_search_id_(0),
-      searches_next_id_(1) {
+      searches_next_id_(1),
+      provisional_search_id_(-1) {
 
   ui_->setupUi(this);
 
@@ -147,10 +150,11 @@ StreamingSearchView::StreamingSearchView(QWidget *parent)
 
 StreamingSearchView::~StreamingSearchView() { delete ui_; }
 
-void StreamingSearchView::Init(const StreamingServicePtr service, const SharedPtr<AlbumCoverLoader> albumcover_loader) {
+void StreamingSearchView::Init(const StreamingServicePtr service, const SharedPtr<AlbumCoverLoader> albumcover_loader, const SharedPtr<Database> database) {
 
   service_ = service;
   albumcover_loader_ = albumcover_loader;
+  search_cache_ = new StreamingSearchCache(database, service_->source(), this);
 
   front_model_ = new StreamingSearchModel(service, this);
   back_model_ = new StreamingSearchModel(service, this);
@@ -199,6 +203,9 @@ void StreamingSearchView::Init(const StreamingServicePtr service, const SharedPt
   QObject::connect(&*service_, &StreamingService::SearchProgressSetMaximum, this, &StreamingSearchView::ProgressSetMaximum);
   QObject::connect(&*service_, &StreamingService::SearchUpdateProgress, this, &StreamingSearchView::UpdateProgress);
   QObject::connect(&*service_, &StreamingService::SearchResults, this, &StreamingSearchView::SearchDone);
+  QObject::connect(search_cache_, &StreamingSearchCache::ResultsLoaded, this, &StreamingSearchView::CachedResultsLoaded);
+  QObject::connect(&*service_, &StreamingService::LoginSuccess, search_cache_, &StreamingSearchCache::Clear);
+  QObject::connect(&*service_, &StreamingService::SessionCleared, search_cache_, &StreamingSearchCache::Clear);
 
   QObject::connect(&*albumcover_loader_, &AlbumCoverLoader::AlbumCoverLoaded, this, &StreamingSearchView::AlbumCoverLoaded);
 
@@ -388,6 +395,7 @@ void StreamingSearchView::TextEdited(const QString &text) {
   const QString trimmed(text.trimmed());
 
   search_error_ = false;
+  provisional_search_id_ = -1;
   cover_loader_tasks_.clear();
 
   // Add results to the back model, switch models after some delay.
@@ -410,6 +418,7 @@ void StreamingSearchView::TextEdited(const QString &text) {
   else {
     ui_->progressbar->reset();
     last_search_id_ = SearchAsync(trimmed, search_type_);
+    ShowCachedResults(last_search_id_, trimmed, search_type_);
   }
 
 }
@@ -479,8 +488,61 @@ int StreamingSearchView::SearchAsync(const QString &query, const StreamingServic
 
 void StreamingSearchView::SearchAsync(const int id, const QString &query, const StreamingService::SearchType type) {
 
+  // Results from a previous session are used if they haven't expired, otherwise the service is searched.
+  search_cache_->LoadAsync(id, type, query);
+
+}
+
+void StreamingSearchView::CachedResultsLoaded(const int id, const StreamingService::SearchType type, const QString &query, const SongMap &songs) {
+
+  if (id != last_search_id_) return;
+
+  if (!songs.isEmpty()) {
+    ClearProvisionalResults(id);
+    AddResults(id, CreateResults(songs));
+    return;
+  }
+
   const int service_id = service_->Search(query, type);
-  pending_searches_[service_id] = PendingState(id, TokenizeQuery(query));
+  pending_searches_[service_id] = PendingState(id, query, type, TokenizeQuery(query));
+
+}
+
+void StreamingSearchView::ShowCachedResults(const int id, const QString &query, const StreamingService::SearchType type) {
+
+  SongMap songs;
+  if (search_cache_->Results(type, query, &songs)) {
+    // Results for the same query from this session are still fresh, so don't search again.
+    CancelSearch(id);
+    AddResults(id, CreateResults(songs));
+    return;
+  }
+
+  // While searching, show the results of a shorter query which also match this query, like "radiohe" for "radiohead".
+  const QStringList tokens = TokenizeQuery(query);
+  const SongMap prefix_songs = search_cache_->PrefixResults(type, query);
+  SongMap matching_songs;
+  for (SongMap::const_iterator it = prefix_songs.constBegin(); it != prefix_songs.constEnd(); ++it) {
+    const Song &song = it.value();
+    if (Matches(tokens, song.artist() + u' ' + song.album() + u' ' + song.title())) {
+      matching_songs.insert(it.key(), song);
+    }
+  }
+
+  if (!matching_songs.isEmpty()) {
+    provisional_search_id_ = id;
+    AddResults(id, CreateResults(matching_songs));
+  }
+
+}
+
+void StreamingSearchView::ClearProvisionalResults(const int id) {
+
+  if (id != provisional_search_id_) return;
+
+  provisional_search_id_ = -1;
+  cover_loader_tasks_.clear();
+  current_model_->Clear();
 
 }
 
@@ -497,6 +559,17 @@ void StreamingSearchView::SearchDone(const int service_id, const SongMap &songs,
     return;
   }
 
+  search_cache_->Insert(state.type_, state.query_, songs);
+
+  if (search_id != last_search_id_) return;
+
+  ClearProvisionalResults(search_id);
+  AddResults(search_id, CreateResults(songs));
+
+}
+
+StreamingSearchView::ResultList StreamingSearchView::CreateResults(const SongMap &songs) const {
+
   ResultList results;
   results.reserve(songs.count());
   for (const Song &song : songs) {
@@ -510,7 +583,7 @@ void StreamingSearchView::SearchDone(const int service_id, const SongMap &songs,
     it->pixmap_cache_key_ = PixmapCacheKey(*it);
   }
 
-  AddResults(search_id, results);
+  return results;
 
 }
 
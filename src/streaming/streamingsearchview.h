@@ -56,8 +56,10 @@ class QTimerEvent;
 
 class MimeData;
 class AlbumCoverLoader;
+class Database;
 class GroupByDialog;
 class StreamingSearchModel;
+class StreamingSearchCache;
 class Ui_StreamingSearchView;
 
 class StreamingSearchView : public QWidget {
@@ -73,7 +75,7 @@ class StreamingSearchView : public QWidget {
   };
   using ResultList = QList<Result>;
 
-  void Init(const SharedPtr<StreamingService> service, const SharedPtr<AlbumCoverLoader> albumcover_loader);
+  void Init(const SharedPtr<StreamingService> service, const SharedPtr<AlbumCoverLoader> albumcover_loader, const SharedPtr<Database> database);
 
   bool SearchFieldHasFocus() const;
   void FocusSearchField();
@@ -82,9 +84,11 @@ class StreamingSearchView : public QWidget {
 
  protected:
   struct PendingState {
-    PendingState() : orig_id_(-1) {}
-    PendingState(int orig_id, const QStringList &tokens) : orig_id_(orig_id), tokens_(tokens) {}
+    PendingState() : orig_id_(-1), type_(StreamingService::SearchType::Artists) {}
+    PendingState(int orig_id, const QString &query, const StreamingService::SearchType type, const QStringList &tokens) : orig_id_(orig_id), query_(query), type_(type), tokens_(tokens) {}
     int orig_id_;
+    QString query_;
+    StreamingService::SearchType type_;
     QStringList tokens_;
 
     bool operator<(const PendingState &b) const {
@@ -123,6 +127,10 @@ class StreamingSearchView : public QWidget {
   void SearchAsync(const int id, const QString &query, const StreamingService::SearchType type);
   void SearchError(const int id, const QString &error);
   void CancelSearch(const int id);
+  void ShowCachedResults(const int id, const QString &query, const StreamingService::SearchType type);
+  void ClearProvisionalResults(const int id);
+
+  ResultList CreateResults(const SongMap &songs) const;
 
   QString PixmapCacheKey(const Result &result) const;
   bool FindCachedPixmap(const Result &result, QPixmap *pixmap) const;
@@ -140,6 +148,7 @@ class StreamingSearchView : public QWidget {
   void TextEdited(const QString &text);
   void StartSearch(const QString &query);
   void SearchDone(const int service_id, const SongMap &songs, const QString &error);
+  void CachedResultsLoaded(const int id, const StreamingService::SearchType type, const QString &query, const SongMap &songs);
 
   void UpdateStatus(const int service_id, const QString &text);
   void ProgressSetMaximum(const int service_id, const int max);
@@ -172,6 +181,7 @@ class StreamingSearchView : public QWidget {
  private:
   SharedPtr<StreamingService> service_;
   SharedPtr<AlbumCoverLoader> albumcover_loader_;
+  StreamingSearchCache *search_cache_;
 
   Ui_StreamingSearchView *ui_;
   ScopedPtr<GroupByDialog> group_by_dialog_;
@@ -198,6 +208,7 @@ class StreamingSearchView : public QWidget {
   bool search_error_;
   int last_search_id_;
   int searches_next_id_;
+  int provisional_search_id_;
 
   QMap<int, DelayedSearch> delayed_searches_;
   QMap<int, PendingState> pending_searches_;
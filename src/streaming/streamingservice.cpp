@@ -22,10 +22,12 @@
 
 #include "streamingservice.h"
 #include "core/song.h"
+#include "core/adaptiveconcurrencylimiter.h"
 
 StreamingService::StreamingService(const Song::Source source, const QString &name, const QString &url_scheme, const QString &settings_group, QObject *parent)
     : QObject(parent),
       source_(source),
       name_(name),
       url_scheme_(url_scheme),
-      settings_group_(settings_group) {}
+      settings_group_(settings_group),
+      request_limiter_(new AdaptiveConcurrencyLimiter(name, this)) {}
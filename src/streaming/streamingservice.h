@@ -31,6 +31,7 @@
 class CollectionBackend;
 class CollectionModel;
 class CollectionFilter;
+class AdaptiveConcurrencyLimiter;
 
 class StreamingService : public QObject {
   Q_OBJECT
@@ -62,6 +63,9 @@ class StreamingService : public QObject {
   virtual bool show_progress() const { return true; }
   virtual bool enable_refresh_button() const { return true; }
 
+  // Shared by all API requests to the service, so they together adapt to how many requests the service can handle.
+  AdaptiveConcurrencyLimiter *request_limiter() const { return request_limiter_; }
+
   virtual SharedPtr<CollectionBackend> artists_collection_backend() { return nullptr; }
   virtual SharedPtr<CollectionBackend> albums_collection_backend() { return nullptr; }
   virtual SharedPtr<CollectionBackend> songs_collection_backend() { return nullptr; }
@@ -91,6 +95,7 @@ class StreamingService : public QObject {
   void LoginSuccess();
   void LoginFailure(const QString &error);
   void LoginFinished(const bool success, const QString &error = QString());
+  void SessionCleared();
 
   void TestSuccess();
   void TestFailure(const QString &error);
@@ -142,6 +147,7 @@ class StreamingService : public QObject {
   QString name_;
   QString url_scheme_;
   QString settings_group_;
+  AdaptiveConcurrencyLimiter *request_limiter_;
 };
 
 using StreamingServicePtr = SharedPtr<StreamingService>;
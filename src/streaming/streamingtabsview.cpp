@@ -47,7 +47,7 @@
 
 using namespace Qt::Literals::StringLiterals;
 
-StreamingTabsView::StreamingTabsView(const StreamingServicePtr service, const SharedPtr<AlbumCoverLoader> albumcover_loader, const QString &settings_group, QWidget *parent)
+StreamingTabsView::StreamingTabsView(const StreamingServicePtr service, const SharedPtr<AlbumCoverLoader> albumcover_loader, const SharedPtr<Database> database, const QString &settings_group, QWidget *parent)
     : QWidget(parent),
       service_(service),
       settings_group_(settings_group),
@@ -55,7 +55,7 @@ StreamingTabsView::StreamingTabsView(const StreamingServicePtr service, const Sh
 
   ui_->setupUi(this);
 
-  ui_->search_view->Init(service, albumcover_loader);
+  ui_->search_view->Init(service, albumcover_loader, database);
   QObject::connect(ui_->search_view, &StreamingSearchView::AddArtistsSignal, &*service_, &StreamingService::AddArtists);
   QObject::connect(ui_->search_view, &StreamingSearchView::AddAlbumsSignal, &*service_, &StreamingService::AddAlbums);
   QObject::connect(ui_->search_view, &StreamingSearchView::AddSongsSignal, &*service_, &StreamingService::AddSongs);
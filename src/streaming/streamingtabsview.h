@@ -39,12 +39,13 @@ class StreamingService;
 class StreamingCollectionView;
 class StreamingSearchView;
 class AlbumCoverLoader;
+class Database;
 
 class StreamingTabsView : public QWidget {
   Q_OBJECT
 
  public:
-  explicit StreamingTabsView(const SharedPtr<StreamingService> service, const SharedPtr<AlbumCoverLoader> albumcover_loader, const QString &settings_group, QWidget *parent = nullptr);
+  explicit StreamingTabsView(const SharedPtr<StreamingService> service, const SharedPtr<AlbumCoverLoader> albumcover_loader, const SharedPtr<Database> database, const QString &settings_group, QWidget *parent = nullptr);
   ~StreamingTabsView() override;
 
   void ReloadSettings();
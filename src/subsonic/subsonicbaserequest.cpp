@@ -36,6 +36,7 @@
 #include <QSslConfiguration>
 #include <QSslSocket>
 #include <QSslError>
+#include <QFutureWatcher>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
@@ -58,6 +59,12 @@ SubsonicBaseRequest::SubsonicBaseRequest(SubsonicService *service, QObject *pare
 
 }
 
+void SubsonicBaseRequest::SetNetworkAccessManager(QNetworkAccessManager *network) {
+
+  network_.reset(network);
+
+}
+
 QUrl SubsonicBaseRequest::CreateUrl(const QUrl &server_url, const SubsonicSettings::AuthMethod auth_method, const QString &username, const QString &password, const QString &ressource_name, const ParamList &params_provided) {
 
   ParamList params = ParamList() << params_provided
@@ -132,17 +139,32 @@ void SubsonicBaseRequest::HandleSSLErrors(const QList<QSslError> &ssl_errors) {
 
 JsonBaseRequest::JsonObjectResult SubsonicBaseRequest::ParseJsonObject(QNetworkReply *reply) {
 
-  if (reply->error() != QNetworkReply::NoError && reply->error() < 200) {
-    return JsonObjectResult(ErrorCode::NetworkError, QStringLiteral("%1 (%2)").arg(reply->errorString()).arg(reply->error()));
+  return ParseReplyData(JsonBaseRequest::TakeReplyData(reply));
+
+}
+
+void SubsonicBaseRequest::AbortParsing() {
+
+  // The parsing can't be stopped, but the results are dropped.
+  while (!parse_watchers_.isEmpty()) {
+    QFutureWatcherBase *watcher = parse_watchers_.takeFirst();
+    QObject::disconnect(watcher, nullptr, this, nullptr);
+    watcher->deleteLater();
   }
 
-  JsonObjectResult result(ErrorCode::Success);
-  result.network_error = reply->error();
-  if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid()) {
-    result.http_status_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+}
+
+JsonBaseRequest::JsonObjectResult SubsonicBaseRequest::ParseReplyData(ReplyData reply_data) {
+
+  if (reply_data.network_error != QNetworkReply::NoError && reply_data.network_error < 200) {
+    return JsonObjectResult(ErrorCode::NetworkError, QStringLiteral("%1 (%2)").arg(reply_data.error_string).arg(reply_data.network_error));
   }
 
-  const QByteArray data = reply->readAll();
+  JsonObjectResult result(ErrorCode::Success);
+  result.network_error = reply_data.network_error;
+  result.http_status_code = reply_data.http_status_code;
+
+  const QByteArray data = std::move(reply_data.data);
   if (!data.isEmpty()) {
     QJsonParseError json_parse_error;
     const QJsonDocument json_document = QJsonDocument::fromJson(data, &json_parse_error);
@@ -173,9 +195,9 @@ JsonBaseRequest::JsonObjectResult SubsonicBaseRequest::ParseJsonObject(QNetworkR
   }
 
   if (result.error_code != ErrorCode::APIError) {
-    if (reply->error() != QNetworkReply::NoError) {
+    if (reply_data.network_error != QNetworkReply::NoError) {
       result.error_code = ErrorCode::NetworkError;
-      result.error_message = QStringLiteral("%1 (%2)").arg(reply->errorString()).arg(reply->error());
+      result.error_message = QStringLiteral("%1 (%2)").arg(reply_data.error_string).arg(reply_data.network_error);
     }
     else if (result.http_status_code != 200) {
       result.error_code = ErrorCode::HttpError;
@@ -183,7 +205,7 @@ JsonBaseRequest::JsonObjectResult SubsonicBaseRequest::ParseJsonObject(QNetworkR
     }
   }
 
-  if (reply->error() == QNetworkReply::AuthenticationRequiredError) {
+  if (reply_data.network_error == QNetworkReply::AuthenticationRequiredError) {
     // service_->ClearSession();
   }
 
@@ -22,6 +22,8 @@
 
 #include "config.h"
 
+#include <utility>
+
 #include <QObject>
 #include <QList>
 #include <QSet>
@@ -32,6 +34,9 @@
 #include <QStringList>
 #include <QUrl>
 #include <QSslError>
+#include <QNetworkReply>
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
 #include <QJsonObject>
 
 #include "includes/scoped_ptr.h"
@@ -40,7 +45,6 @@
 #include "subsonicservice.h"
 
 class QNetworkAccessManager;
-class QNetworkReply;
 
 class SubsonicBaseRequest : public QObject {
   Q_OBJECT
@@ -50,6 +54,7 @@ class SubsonicBaseRequest : public QObject {
 
   using JsonObjectResult = JsonBaseRequest::JsonObjectResult;
   using ErrorCode = JsonBaseRequest::ErrorCode;
+  using ReplyData = JsonBaseRequest::ReplyData;
 
  protected:
   using Param = QPair<QString, QString>;
@@ -57,11 +62,21 @@ class SubsonicBaseRequest : public QObject {
 
  public:
   static QUrl CreateUrl(const QUrl &server_url, const SubsonicSettings::AuthMethod auth_method, const QString &username, const QString &password, const QString &ressource_name, const ParamList &params_provided);
+  static JsonObjectResult ParseReplyData(ReplyData reply_data);
+
+  // Replaces the network access manager used for the requests and takes ownership of it, for the tests.
+  void SetNetworkAccessManager(QNetworkAccessManager *network);
 
  protected:
   QNetworkReply *CreateGetRequest(const QString &ressource_name, const ParamList &params_provided) const;
   JsonObjectResult ParseJsonObject(QNetworkReply *reply);
 
+  // Takes the reply data and calls parser with it on a worker thread, then handler with the result on the thread of this object.
+  // The parser must not touch this object, it can outlive it.
+  template<typename Result, typename Parser, typename Handler>
+  void ParseReplyAsync(QNetworkReply *reply, Parser &&parser, Handler &&handler);
+  void AbortParsing();
+
   virtual void Error(const QString &error, const QVariant &debug = QVariant()) = 0;
 
   QUrl server_url() const { return service_->server_url(); }
@@ -79,6 +94,22 @@ class SubsonicBaseRequest : public QObject {
  private:
   SubsonicService *service_;
   ScopedPtr<QNetworkAccessManager> network_;
+  QList<QFutureWatcherBase*> parse_watchers_;
 };
 
+template<typename Result, typename Parser, typename Handler>
+void SubsonicBaseRequest::ParseReplyAsync(QNetworkReply *reply, Parser &&parser, Handler &&handler) {
+
+  QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
+  parse_watchers_ << watcher;
+  QObject::connect(watcher, &QFutureWatcher<Result>::finished, this, [this, watcher, handler = std::forward<Handler>(handler)]() {
+    parse_watchers_.removeAll(watcher);
+    const Result result = watcher->result();
+    watcher->deleteLater();
+    handler(result);
+  });
+  watcher->setFuture(QtConcurrent::run([parser = std::forward<Parser>(parser), reply_data = JsonBaseRequest::TakeReplyData(reply)]() mutable { return parser(std::move(reply_data)); }));
+
+}
+
 #endif  // SUBSONICBASEREQUEST_H
@@ -40,6 +40,7 @@
 #include <QJsonValue>
 
 #include "core/logging.h"
+#include "core/adaptiveconcurrencylimiter.h"
 #include "core/song.h"
 #include "core/networktimeouts.h"
 #include "utilities/strutils.h"
@@ -53,9 +54,31 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-constexpr int kMaxConcurrentAlbumsRequests = 3;
-constexpr int kMaxConcurrentAlbumSongsRequests = 3;
 constexpr int kMaxConcurrentAlbumCoverRequests = 1;
+
+qint64 JsonNumber(const QJsonValue &value) {
+
+  if (value.type() == QJsonValue::String) {
+    return value.toString().toLongLong();
+  }
+
+  return static_cast<qint64>(value.toDouble());
+
+}
+
+// Album modification time from the OpenSubsonic "changed" value, or 0 when the server doesn't have it.
+// The "created" time is not used, tags edited later don't update it.
+qint64 AlbumChanged(const QJsonObject &object_album) {
+
+  if (!object_album.contains("changed"_L1)) return 0;
+
+  const QString changed = object_album["changed"_L1].toString();
+  if (changed.isEmpty()) return 0;
+
+  return QDateTime::fromString(changed, Qt::ISODate).toSecsSinceEpoch();
+
+}
+
 }  // namespace
 
 SubsonicRequest::SubsonicRequest(SubsonicService *service, SubsonicUrlHandler *url_handler, QObject *parent)
@@ -64,7 +87,10 @@ SubsonicRequest::SubsonicRequest(SubsonicService *service, SubsonicUrlHandler *u
       url_handler_(url_handler),
       network_(new QNetworkAccessManager(this)),
       timeouts_(new NetworkTimeouts(30000, this)),
+      request_limiter_(service->request_limiter()),
       finished_(false),
+      last_modified_(0),
+      last_modified_requested_(0),
       albums_requests_active_(0),
       album_songs_requests_active_(0),
       album_songs_requested_(0),
@@ -76,6 +102,8 @@ SubsonicRequest::SubsonicRequest(SubsonicService *service, SubsonicUrlHandler *u
 
   network_->setRedirectPolicy(QNetworkRequest::NoLessSafeRedirectPolicy);
 
+  QObject::connect(request_limiter_, &AdaptiveConcurrencyLimiter::Ready, this, &SubsonicRequest::FlushRequests);
+
 }
 
 SubsonicRequest::~SubsonicRequest() {
@@ -98,8 +126,14 @@ SubsonicRequest::~SubsonicRequest() {
 
 void SubsonicRequest::Reset() {
 
+  AbortParsing();
+
   finished_ = false;
 
+  local_album_songs_.clear();
+  last_modified_ = 0;
+  last_modified_requested_ = 0;
+
   albums_requests_queue_.clear();
   album_songs_requests_queue_.clear();
   album_cover_requests_queue_.clear();
@@ -115,7 +149,6 @@ void SubsonicRequest::Reset() {
   album_covers_received_ = 0;
 
   songs_.clear();
-  cover_urls_.clear();
   errors_.clear();
   no_results_ = false;
   replies_.clear();
@@ -123,6 +156,78 @@ void SubsonicRequest::Reset() {
 
 }
 
+void SubsonicRequest::FlushRequests() {
+
+  FlushAlbumsRequests();
+  FlushAlbumSongsRequests();
+
+}
+
+void SubsonicRequest::GetSongs(const SongList &local_songs, const qint64 last_modified) {
+
+  for (const Song &song : local_songs) {
+    local_album_songs_[song.album_id()] << song;
+  }
+  last_modified_requested_ = last_modified;
+
+  // Get the last modification time of the server collection first, so unchanged collections don't need to be listed again.
+  Q_EMIT UpdateStatus(tr("Checking for changes..."));
+  Q_EMIT UpdateProgress(0);
+
+  ParamList params;
+  if (last_modified > 0) params << Param(u"ifModifiedSince"_s, QString::number(last_modified));
+
+  QNetworkReply *reply = CreateGetRequest(u"getIndexes"_s, params);
+  replies_ << reply;
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, last_modified]() { IndexesReplyReceived(reply, last_modified); });
+  timeouts_->AddReply(reply);
+  request_limiter_->AddReply(reply);
+
+}
+
+void SubsonicRequest::IndexesReplyReceived(QNetworkReply *reply, const qint64 last_modified_requested) {
+
+  if (!replies_.contains(reply)) return;
+  replies_.removeAll(reply);
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
+
+  if (finished_) return;
+
+  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+  if (!json_object_result.success()) {
+    Warn(json_object_result.error_message);
+    GetAlbums();
+    return;
+  }
+
+  const QJsonObject &json_object = json_object_result.json_object;
+  if (!json_object.contains("indexes"_L1) || !json_object["indexes"_L1].isObject()) {
+    Warn(u"Json reply is missing indexes."_s, json_object);
+    GetAlbums();
+    return;
+  }
+  const QJsonObject object_indexes = json_object["indexes"_L1].toObject();
+
+  last_modified_ = object_indexes.contains("lastModified"_L1) ? JsonNumber(object_indexes["lastModified"_L1]) : 0;
+  if (local_album_songs_.isEmpty() || last_modified_requested <= 0 || last_modified_ <= 0 || last_modified_ > last_modified_requested) {
+    GetAlbums();
+    return;
+  }
+
+  qLog(Debug) << "Subsonic: No changes since" << last_modified_requested;
+
+  for (QHash<QString, SongList>::const_iterator it = local_album_songs_.constBegin(); it != local_album_songs_.constEnd(); ++it) {
+    for (const Song &song : it.value()) {
+      songs_.insert(song.song_id(), song);
+    }
+  }
+
+  finished_ = true;
+  Q_EMIT Results(songs_, QString());
+
+}
+
 void SubsonicRequest::GetAlbums() {
 
   Q_EMIT UpdateStatus(tr("Retrieving albums..."));
@@ -137,13 +242,13 @@ void SubsonicRequest::AddAlbumsRequest(const int offset, const int size) {
   request.size = size;
   request.offset = offset;
   albums_requests_queue_.enqueue(request);
-  if (albums_requests_active_ < kMaxConcurrentAlbumsRequests) FlushAlbumsRequests();
+  if (request_limiter_->CanStartRequest()) FlushAlbumsRequests();
 
 }
 
 void SubsonicRequest::FlushAlbumsRequests() {
 
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
+  while (!albums_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const Request request = albums_requests_queue_.dequeue();
     ++albums_requests_active_;
@@ -156,6 +261,7 @@ void SubsonicRequest::FlushAlbumsRequests() {
     replies_ << reply;
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumsReplyReceived(reply, request.offset, request.size); });
     timeouts_->AddReply(reply);
+    request_limiter_->AddReply(reply);
 
   }
 
@@ -168,6 +274,19 @@ void SubsonicRequest::AlbumsReplyReceived(QNetworkReply *reply, const int offset
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
+  if (finished_) {
+    --albums_requests_active_;
+    AlbumsFinishCheck(offset_requested, size_requested, 0);
+    return;
+  }
+
+  // Album list pages hold up to 500 albums, parse them on a worker thread, the request stays active until it's handled.
+  ParseReplyAsync<JsonObjectResult>(reply, &SubsonicBaseRequest::ParseReplyData, [this, offset_requested, size_requested](const JsonObjectResult &json_object_result) { AlbumsReceived(json_object_result, offset_requested, size_requested); });
+
+}
+
+void SubsonicRequest::AlbumsReceived(const JsonObjectResult &json_object_result, const int offset_requested, const int size_requested) {
+
   --albums_requests_active_;
 
   int albums_received = 0;
@@ -175,7 +294,6 @@ void SubsonicRequest::AlbumsReplyReceived(QNetworkReply *reply, const int offset
 
   if (finished_) return;
 
-  const JsonObjectResult json_object_result = ParseJsonObject(reply);
   if (!json_object_result.success()) {
     Error(json_object_result.error_message);
     return;
@@ -253,6 +371,14 @@ void SubsonicRequest::AlbumsReplyReceived(QNetworkReply *reply, const int offset
 
     if (album_songs_requests_pending_.contains(album_id)) continue;
 
+    if (LocalAlbumUnchanged(album_id, object_album)) {
+      const SongList songs = local_album_songs_.value(album_id);
+      for (const Song &song : songs) {
+        songs_.insert(song.song_id(), song);
+      }
+      continue;
+    }
+
     Request request;
     request.album_id = album_id;
     request.album_artist = artist;
@@ -262,6 +388,29 @@ void SubsonicRequest::AlbumsReplyReceived(QNetworkReply *reply, const int offset
 
 }
 
+bool SubsonicRequest::LocalAlbumUnchanged(const QString &album_id, const QJsonObject &object_album) const {
+
+  const QHash<QString, SongList>::const_iterator it = local_album_songs_.constFind(album_id);
+  if (it == local_album_songs_.constEnd()) return false;
+
+  // The local songs were received by the previous successful sync, albums changed after the server's lastModified time of that sync have changed since.
+  // Both times are from the server clock, lastModified is in milliseconds. Without a changed time the album is always fetched again.
+  const qint64 changed = AlbumChanged(object_album);
+  if (changed <= 0 || last_modified_requested_ <= 0 || changed > last_modified_requested_ / 1000) return false;
+
+  const SongList &songs = it.value();
+  if (object_album.contains("songCount"_L1) && JsonNumber(object_album["songCount"_L1]) != songs.count()) return false;
+
+  qint64 duration = 0;
+  for (const Song &song : songs) {
+    duration += song.length_nanosec() / kNsecPerSec;
+  }
+  if (object_album.contains("duration"_L1) && JsonNumber(object_album["duration"_L1]) != duration) return false;
+
+  return true;
+
+}
+
 void SubsonicRequest::AlbumsFinishCheck(const int offset, const int size, const int albums_received) {
 
   if (finished_) return;
@@ -273,7 +422,7 @@ void SubsonicRequest::AlbumsFinishCheck(const int offset, const int size, const
     }
   }
 
-  if (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) FlushAlbumsRequests();
+  if (!albums_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) FlushAlbumsRequests();
 
   if (albums_requests_queue_.isEmpty() && albums_requests_active_ <= 0) { // Albums list is finished, get songs for all albums.
 
@@ -304,30 +453,49 @@ void SubsonicRequest::AddAlbumSongsRequest(const QString &artist_id, const QStri
   request.offset = offset;
   album_songs_requests_queue_.enqueue(request);
   ++album_songs_requested_;
-  if (album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) FlushAlbumSongsRequests();
+  if (request_limiter_->CanStartRequest()) FlushAlbumSongsRequests();
 
 }
 
 void SubsonicRequest::FlushAlbumSongsRequests() {
 
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+  while (!album_songs_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
     const Request request = album_songs_requests_queue_.dequeue();
     ++album_songs_requests_active_;
     QNetworkReply *reply = CreateGetRequest(u"getAlbum"_s, ParamList() << Param(u"id"_s, request.album_id));
     replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumSongsReplyReceived(reply, request.artist_id, request.album_id, request.album_artist); });
+    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumSongsReplyReceived(reply, request.album_artist); });
     timeouts_->AddReply(reply);
+    request_limiter_->AddReply(reply);
   }
 
 }
 
-void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist) {
+void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QString &album_artist) {
 
   if (!replies_.contains(reply)) return;
   replies_.removeAll(reply);
   QObject::disconnect(reply, nullptr, this, nullptr);
   reply->deleteLater();
 
+  if (finished_) {
+    AlbumSongsReceived(SongsPage());
+    return;
+  }
+
+  // The songs of the album are built on a worker thread, the request stays active until they're handled.
+  ParseReplyAsync<SongsPage>(reply, CreateSongsParser(album_artist), [this](const SongsPage &songs_page) { AlbumSongsReceived(songs_page); });
+
+}
+
+SubsonicRequest::SongsParser SubsonicRequest::CreateSongsParser(const QString &album_artist) const {
+
+  return SongsParser(url_handler_->scheme(), server_url(), auth_method(), username(), password(), use_album_id_for_album_covers(), album_artist);
+
+}
+
+void SubsonicRequest::AlbumSongsReceived(const SongsPage &songs_page) {
+
   --album_songs_requests_active_;
   ++album_songs_received_;
 
@@ -337,7 +505,37 @@ void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QStrin
 
   if (finished_) return;
 
-  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+  // The parser logged the errors already.
+  errors_ << songs_page.errors;
+
+  for (const Song &song : songs_page.songs) {
+    songs_.insert(song.song_id(), song);
+  }
+
+}
+
+SubsonicRequest::SongsParser::SongsParser(const QString &scheme, const QUrl &server_url, const SubsonicSettings::AuthMethod auth_method, const QString &username, const QString &password, const bool use_album_id_for_album_covers, const QString &album_artist)
+    : scheme_(scheme),
+      server_url_(server_url),
+      auth_method_(auth_method),
+      username_(username),
+      password_(password),
+      use_album_id_for_album_covers_(use_album_id_for_album_covers),
+      album_artist_(album_artist) {}
+
+SubsonicRequest::SongsPage SubsonicRequest::SongsParser::operator()(ReplyData reply_data) {
+
+  // The Json document only lives while the songs are built, the reply data is released once it's parsed.
+  SongsPage songs_page;
+  ParseSongs(ParseReplyData(std::move(reply_data)), songs_page);
+  songs_page.errors = errors_;
+
+  return songs_page;
+
+}
+
+void SubsonicRequest::SongsParser::ParseSongs(const JsonObjectResult &json_object_result, SongsPage &songs_page) {
+
   if (!json_object_result.success()) {
     Error(json_object_result.error_message);
     return;
@@ -398,7 +596,7 @@ void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QStrin
     const QJsonObject object_song = value_song.toObject();
 
     Song song(Song::Source::Subsonic);
-    ParseSong(song, object_song, artist_id, album_id, album_artist, album_cover_id, created);
+    ParseSong(song, object_song, album_cover_id, created);
     if (!song.is_valid()) continue;
     if (song.disc() >= 2) multidisc = true;
     if (song.is_compilation()) compilation = true;
@@ -410,7 +608,7 @@ void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QStrin
     if (!multidisc) {
       song.set_disc(0);
     }
-    songs_.insert(song.song_id(), song);
+    songs_page.songs << song;
   }
 
 }
@@ -419,7 +617,7 @@ void SubsonicRequest::SongsFinishCheck() {
 
   if (finished_) return;
 
-  if (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) FlushAlbumSongsRequests();
+  if (!album_songs_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) FlushAlbumSongsRequests();
 
   if (download_album_covers() &&
       album_songs_requests_queue_.isEmpty() &&
@@ -435,10 +633,7 @@ void SubsonicRequest::SongsFinishCheck() {
 
 }
 
-QString SubsonicRequest::ParseSong(Song &song, const QJsonObject &json_object, const QString &artist_id_requested, const QString &album_id_requested, const QString &album_artist, const QString &album_cover_id, const qint64 album_created) {
-
-  Q_UNUSED(artist_id_requested);
-  Q_UNUSED(album_id_requested);
+QString SubsonicRequest::SongsParser::ParseSong(Song &song, const QJsonObject &json_object, const QString &album_cover_id, const qint64 album_created) {
 
   if (!json_object.contains("id"_L1) ||
       !json_object.contains("title"_L1) ||
@@ -554,7 +749,7 @@ QString SubsonicRequest::ParseSong(Song &song, const QJsonObject &json_object, c
   if (json_object.contains("genre"_L1)) genre = json_object["genre"_L1].toString();
 
   QString cover_id;
-  if (use_album_id_for_album_covers() && !album_cover_id.isEmpty()) {
+  if (use_album_id_for_album_covers_ && !album_cover_id.isEmpty()) {
     cover_id = album_cover_id;
   }
   else {
@@ -575,7 +770,7 @@ QString SubsonicRequest::ParseSong(Song &song, const QJsonObject &json_object, c
   }
 
   QUrl url;
-  url.setScheme(url_handler_->scheme());
+  url.setScheme(scheme_);
   url.setPath(song_id);
 
   QUrl cover_url;
@@ -584,7 +779,7 @@ QString SubsonicRequest::ParseSong(Song &song, const QJsonObject &json_object, c
       cover_url = cover_urls_[cover_id];
     }
     else {
-      cover_url = CreateUrl(server_url(), auth_method(), username(), password(), u"getCoverArt"_s, ParamList() << Param(u"id"_s, cover_id));
+      cover_url = CreateUrl(server_url_, auth_method_, username_, password_, u"getCoverArt"_s, ParamList() << Param(u"id"_s, cover_id));
       cover_urls_.insert(cover_id, cover_url);
     }
   }
@@ -607,7 +802,7 @@ QString SubsonicRequest::ParseSong(Song &song, const QJsonObject &json_object, c
   song.set_song_id(song_id);
   if (!album_id.isEmpty()) song.set_album_id(album_id);
   if (!artist_id.isEmpty()) song.set_artist_id(artist_id);
-  if (!album_artist.isEmpty()) song.set_albumartist(album_artist);
+  if (!album_artist_.isEmpty()) song.set_albumartist(album_artist_);
   song.set_album(album);
   song.set_artist(artist);
   song.set_title(title);
@@ -821,6 +1016,8 @@ void SubsonicRequest::FinishCheck() {
       album_covers_requests_active_ <= 0 &&
       album_covers_received_ >= album_covers_requested_) {
     finished_ = true;
+    // Changes missed because of errors have to be requested again by the next sync.
+    if (!errors_.isEmpty()) last_modified_ = 0;
     if (no_results_ && songs_.isEmpty()) {
       Q_EMIT Results(SongMap(), QString());
     }
@@ -847,6 +1044,16 @@ void SubsonicRequest::Error(const QString &error, const QVariant &debug) {
 
 }
 
+void SubsonicRequest::SongsParser::Error(const QString &error, const QVariant &debug) {
+
+  if (!error.isEmpty()) {
+    qLog(Error) << "Subsonic:" << error;
+    errors_ << error;
+  }
+  if (debug.isValid()) qLog(Debug) << debug;
+
+}
+
 void SubsonicRequest::Warn(const QString &error, const QVariant &debug) {
 
   qLog(Error) << "Subsonic:" << error;
@@ -45,6 +45,7 @@ class QNetworkReply;
 class SubsonicService;
 class SubsonicUrlHandler;
 class NetworkTimeouts;
+class AdaptiveConcurrencyLimiter;
 
 class SubsonicRequest : public SubsonicBaseRequest {
   Q_OBJECT
@@ -55,9 +56,40 @@ class SubsonicRequest : public SubsonicBaseRequest {
 
   void ReloadSettings();
 
+  // Gets all songs from the server, reusing the local songs of albums that are unchanged since they were last received.
+  void GetSongs(const SongList &local_songs = SongList(), const qint64 last_modified = 0);
   void GetAlbums();
   void Reset();
 
+  qint64 last_modified() const { return last_modified_; }
+
+  struct SongsPage {
+    QStringList errors;
+    SongList songs;
+  };
+
+  // Builds the songs of a getAlbum reply on a worker thread, so it only keeps copies of what it needs from the request.
+  class SongsParser {
+   public:
+    explicit SongsParser(const QString &scheme, const QUrl &server_url, const SubsonicSettings::AuthMethod auth_method, const QString &username, const QString &password, const bool use_album_id_for_album_covers, const QString &album_artist);
+    SongsPage operator()(ReplyData reply_data);
+
+   private:
+    void ParseSongs(const JsonObjectResult &json_object_result, SongsPage &songs_page);
+    QString ParseSong(Song &song, const QJsonObject &json_object, const QString &album_cover_id, const qint64 album_created);
+    void Error(const QString &error, const QVariant &debug = QVariant());
+
+    QString scheme_;
+    QUrl server_url_;
+    SubsonicSettings::AuthMethod auth_method_;
+    QString username_;
+    QString password_;
+    bool use_album_id_for_album_covers_;
+    QString album_artist_;
+    QMap<QString, QUrl> cover_urls_;
+    QStringList errors_;
+  };
+
  private:
   struct Request {
     explicit Request() : offset(0), size(0) {}
@@ -83,11 +115,18 @@ class SubsonicRequest : public SubsonicBaseRequest {
   void UpdateProgress(const int progress);
 
  private Q_SLOTS:
+  void IndexesReplyReceived(QNetworkReply *reply, const qint64 last_modified_requested);
   void AlbumsReplyReceived(QNetworkReply *reply, const int offset_requested, const int size_requested);
-  void AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist);
+  void AlbumSongsReplyReceived(QNetworkReply *reply, const QString &album_artist);
   void AlbumCoverReceived(QNetworkReply *reply, const SubsonicRequest::AlbumCoverRequest &request);
 
  private:
+  void AlbumsReceived(const JsonObjectResult &json_object_result, const int offset_requested, const int size_requested);
+  SongsParser CreateSongsParser(const QString &album_artist) const;
+  void AlbumSongsReceived(const SongsPage &songs_page);
+  bool LocalAlbumUnchanged(const QString &album_id, const QJsonObject &object_album) const;
+
+  void FlushRequests();
   void AddAlbumsRequest(const int offset = 0, const int size = 500);
   void FlushAlbumsRequests();
 
@@ -97,8 +136,6 @@ class SubsonicRequest : public SubsonicBaseRequest {
   void AddAlbumSongsRequest(const QString &artist_id, const QString &album_id, const QString &album_artist, const int offset = 0);
   void FlushAlbumSongsRequests();
 
-  QString ParseSong(Song &song, const QJsonObject &json_object, const QString &artist_id_requested = QString(), const QString &album_id_requested = QString(), const QString &album_artist = QString(), const QString &album_cover_id = QString(), const qint64 album_created = 0);
-
   void GetAlbumCovers();
   void AddAlbumCoverRequest(const Song &song);
   void FlushAlbumCoverRequests();
@@ -112,9 +149,14 @@ class SubsonicRequest : public SubsonicBaseRequest {
   SubsonicUrlHandler *url_handler_;
   QNetworkAccessManager *network_;
   NetworkTimeouts *timeouts_;
+  AdaptiveConcurrencyLimiter *request_limiter_;
 
   bool finished_;
 
+  QHash<QString, SongList> local_album_songs_;
+  qint64 last_modified_;
+  qint64 last_modified_requested_;
+
   QQueue<Request> albums_requests_queue_;
   QQueue<Request> album_songs_requests_queue_;
   QQueue<AlbumCoverRequest> album_cover_requests_queue_;
@@ -134,7 +176,6 @@ class SubsonicRequest : public SubsonicBaseRequest {
   int album_covers_received_;
 
   SongMap songs_;
-  QMap<QString, QUrl> cover_urls_;
   QStringList errors_;
   bool no_results_;
   QList<QNetworkReply*> replies_;
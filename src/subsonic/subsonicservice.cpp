@@ -84,7 +84,9 @@ SubsonicService::SubsonicService(const SharedPtr<TaskManager> task_manager,
       download_album_covers_(true),
       use_album_id_for_album_covers_(false),
       auth_method_(SubsonicSettings::AuthMethod::MD5),
-      ping_redirects_(0) {
+      ping_redirects_(0),
+      local_songs_request_id_(0),
+      last_modified_pending_(0) {
 
   url_handlers->Register(url_handler_);
 
@@ -93,6 +95,9 @@ SubsonicService::SubsonicService(const SharedPtr<TaskManager> task_manager,
   collection_backend_->Init(database, task_manager, Song::Source::Subsonic, QLatin1String(kSongsTable));
   collection_model_ = new CollectionModel(collection_backend_, albumcover_loader, this);
 
+  QObject::connect(&*collection_backend_, &CollectionBackend::GotSongs, this, &SubsonicService::LocalSongsReceived);
+  QObject::connect(&*collection_backend_, &CollectionBackend::SongsBySongIDUpdated, this, &SubsonicService::CollectionSongsUpdated);
+
   SubsonicService::ReloadSettings();
 
 }
@@ -423,7 +428,23 @@ void SubsonicService::GetSongs() {
   QObject::connect(&*songs_request_, &SubsonicRequest::ProgressSetMaximum, this, &SubsonicService::SongsProgressSetMaximum);
   QObject::connect(&*songs_request_, &SubsonicRequest::UpdateProgress, this, &SubsonicService::SongsUpdateProgress);
 
-  songs_request_->GetAlbums();
+  last_modified_pending_ = 0;
+
+  // Only albums that are new or changed since the songs in the collection were received are requested again, the local songs are read on the database thread.
+  collection_backend_->GetAllSongsAsync(++local_songs_request_id_);
+
+}
+
+void SubsonicService::LocalSongsReceived(const SongList &songs, const int id) {
+
+  if (id != local_songs_request_id_ || !songs_request_) return;
+
+  Settings s;
+  s.beginGroup(SubsonicSettings::kSettingsGroup);
+  const qint64 last_modified = s.value(SubsonicSettings::kLastModifiedServer).toString() == LastModifiedServer() ? s.value(SubsonicSettings::kLastModified, 0).toLongLong() : 0;
+  s.endGroup();
+
+  songs_request_->GetSongs(songs, last_modified);
 
 }
 
@@ -431,16 +452,47 @@ void SubsonicService::DeleteSongs() {
 
   collection_backend_->DeleteAllAsync();
 
+  last_modified_pending_ = 0;
+
+  Settings s;
+  s.beginGroup(SubsonicSettings::kSettingsGroup);
+  s.remove(SubsonicSettings::kLastModified);
+  s.remove(SubsonicSettings::kLastModifiedServer);
+  s.endGroup();
+
+}
+
+QString SubsonicService::LastModifiedServer() const {
+
+  return username_ + u'@' + server_url_.toString();
+
 }
 
 void SubsonicService::SongsResultsReceived(const SongMap &songs, const QString &error) {
 
+  // The modification time is saved when the songs are committed to the collection, see CollectionSongsUpdated().
+  last_modified_pending_ = songs_request_ && error.isEmpty() ? songs_request_->last_modified() : 0;
+
   Q_EMIT SongsResults(songs, error);
 
   ResetSongsRequest();
 
 }
 
+void SubsonicService::CollectionSongsUpdated() {
+
+  if (last_modified_pending_ <= 0) return;
+
+  Settings s;
+  s.beginGroup(SubsonicSettings::kSettingsGroup);
+  s.setValue(SubsonicSettings::kLastModified, last_modified_pending_);
+  s.setValue(SubsonicSettings::kLastModifiedServer, LastModifiedServer());
+  s.endGroup();
+
+  last_modified_pending_ = 0;
+
+}
+
 void SubsonicService::PingError(const QString &error, const QVariant &debug) {
 
   if (!error.isEmpty()) errors_ << error;
@@ -105,10 +105,13 @@ class SubsonicService : public StreamingService {
  private Q_SLOTS:
   void HandlePingSSLErrors(const QList<QSslError> &ssl_errors);
   void HandlePingReply(QNetworkReply *reply, const QUrl &url, const QString &username, const QString &password, const SubsonicSettings::AuthMethod auth_method);
+  void LocalSongsReceived(const SongList &songs, const int id);
   void SongsResultsReceived(const SongMap &songs, const QString &error);
+  void CollectionSongsUpdated();
 
  private:
   void PingError(const QString &error = QString(), const QVariant &debug = QVariant());
+  QString LastModifiedServer() const;
 
   ScopedPtr<QNetworkAccessManager> network_;
   SubsonicUrlHandler *url_handler_;
@@ -131,6 +134,9 @@ class SubsonicService : public StreamingService {
   QStringList errors_;
   int ping_redirects_;
 
+  int local_songs_request_id_;
+  qint64 last_modified_pending_;
+
   QList<QNetworkReply*> replies_;
 };
 
@@ -332,7 +332,9 @@ TagReaderReplyPtr TagReaderClient::WriteFileAsync(const QString &filename, const
 
 TagReaderResult TagReaderClient::LoadCoverDataBlocking(const QString &filename, QByteArray &data) {
 
-  return tagreader_.LoadEmbeddedCover(filename, data);
+  // The album cover loader calls this from all threads of its thread pool at once, so don't share the reader of the tagreader thread.
+  const TagReaderTagLib tagreader;
+  return tagreader.LoadEmbeddedCover(filename, data);
 
 }
 
@@ -19,6 +19,8 @@
 
 #include "config.h"
 
+#include <utility>
+
 #include <QByteArray>
 #include <QString>
 #include <QUrl>
@@ -78,17 +80,21 @@ QNetworkReply *TidalBaseRequest::CreateRequest(const QString &ressource_name, co
 
 JsonBaseRequest::JsonObjectResult TidalBaseRequest::ParseJsonObject(QNetworkReply *reply) {
 
-  if (reply->error() != QNetworkReply::NoError && reply->error() < 200) {
-    return ReplyDataResult(ErrorCode::NetworkError, QStringLiteral("%1 (%2)").arg(reply->errorString()).arg(reply->error()));
+  return ParseReplyData(TakeReplyData(reply));
+
+}
+
+JsonBaseRequest::JsonObjectResult TidalBaseRequest::ParseReplyData(ReplyData reply_data) {
+
+  if (reply_data.network_error != QNetworkReply::NoError && reply_data.network_error < 200) {
+    return ReplyDataResult(ErrorCode::NetworkError, QStringLiteral("%1 (%2)").arg(reply_data.error_string).arg(reply_data.network_error));
   }
 
   JsonObjectResult result(ErrorCode::Success);
-  result.network_error = reply->error();
-  if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid()) {
-    result.http_status_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-  }
+  result.network_error = reply_data.network_error;
+  result.http_status_code = reply_data.http_status_code;
 
-  const QByteArray data = reply->readAll();
+  const QByteArray data = std::move(reply_data.data);
   if (!data.isEmpty()) {
     QJsonParseError json_parse_error;
     const QJsonDocument json_document = QJsonDocument::fromJson(data, &json_parse_error);
@@ -113,9 +119,9 @@ JsonBaseRequest::JsonObjectResult TidalBaseRequest::ParseJsonObject(QNetworkRepl
   }
 
   if (result.error_code != ErrorCode::APIError) {
-    if (reply->error() != QNetworkReply::NoError) {
+    if (reply_data.network_error != QNetworkReply::NoError) {
       result.error_code = ErrorCode::NetworkError;
-      result.error_message = QStringLiteral("%1 (%2)").arg(reply->errorString()).arg(reply->error());
+      result.error_message = QStringLiteral("%1 (%2)").arg(reply_data.error_string).arg(reply_data.network_error);
     }
     else if (result.http_status_code != 200) {
       result.error_code = ErrorCode::HttpError;
@@ -59,6 +59,7 @@ class TidalBaseRequest : public JsonBaseRequest {
 
   QNetworkReply *CreateRequest(const QString &ressource_name, const ParamList &params_provided);
   JsonObjectResult ParseJsonObject(QNetworkReply *reply);
+  static JsonObjectResult ParseReplyData(ReplyData reply_data);
 
  private:
   TidalService *service_;
@@ -33,11 +33,11 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonValue>
-#include <QTimer>
 #include <QScopeGuard>
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
+#include "core/adaptiveconcurrencylimiter.h"
 #include "core/networkaccessmanager.h"
 #include "core/song.h"
 #include "constants/timeconstants.h"
@@ -52,13 +52,7 @@ using namespace Qt::Literals::StringLiterals;
 
 namespace {
 constexpr char kResourcesUrl[] = "https://resources.tidal.com";
-constexpr int kMaxConcurrentArtistsRequests = 3;
-constexpr int kMaxConcurrentAlbumsRequests = 3;
-constexpr int kMaxConcurrentSongsRequests = 3;
-constexpr int kMaxConcurrentArtistAlbumsRequests = 3;
-constexpr int kMaxConcurrentAlbumSongsRequests = 3;
 constexpr int kMaxConcurrentAlbumCoverRequests = 1;
-constexpr int kFlushRequestsDelay = 200;
 }  // namespace
 
 TidalRequest::TidalRequest(TidalService *service, TidalUrlHandler *url_handler, const SharedPtr<NetworkAccessManager> network, const Type query_type, QObject *parent)
@@ -66,7 +60,7 @@ TidalRequest::TidalRequest(TidalService *service, TidalUrlHandler *url_handler,
       service_(service),
       url_handler_(url_handler),
       network_(network),
-      timer_flush_requests_(new QTimer(this)),
+      request_limiter_(service->request_limiter()),
       query_type_(query_type),
       fetchalbums_(service->fetchalbums()),
       coversize_(service->coversize()),
@@ -101,9 +95,7 @@ TidalRequest::TidalRequest(TidalService *service, TidalUrlHandler *url_handler,
       album_covers_requests_active_(0),
       album_covers_requests_received_(0) {
 
-  timer_flush_requests_->setInterval(kFlushRequestsDelay);
-  timer_flush_requests_->setSingleShot(false);
-  QObject::connect(timer_flush_requests_, &QTimer::timeout, this, &TidalRequest::FlushRequests);
+  QObject::connect(request_limiter_, &AdaptiveConcurrencyLimiter::Ready, this, &TidalRequest::FlushRequests);
 
 }
 
@@ -135,47 +127,15 @@ void TidalRequest::Process() {
 
 }
 
-void TidalRequest::StartRequests() {
-
-  if (!timer_flush_requests_->isActive()) {
-    timer_flush_requests_->start();
-  }
-
-}
-
 void TidalRequest::FlushRequests() {
 
-  if (!artists_requests_queue_.isEmpty()) {
-    FlushArtistsRequests();
-    return;
-  }
-
-  if (!albums_requests_queue_.isEmpty()) {
-    FlushAlbumsRequests();
-    return;
-  }
-
-  if (!artist_albums_requests_queue_.isEmpty()) {
-    FlushArtistAlbumsRequests();
-    return;
-  }
-
-  if (!album_songs_requests_queue_.isEmpty()) {
-    FlushAlbumSongsRequests();
-    return;
-  }
-
-  if (!songs_requests_queue_.isEmpty()) {
-    FlushSongsRequests();
-    return;
-  }
-
-  if (!album_cover_requests_queue_.isEmpty()) {
-    FlushAlbumCoverRequests();
-    return;
-  }
-
-  timer_flush_requests_->stop();
+  // Queues are flushed in order, so earlier stages get the free request slots first.
+  FlushArtistsRequests();
+  FlushAlbumsRequests();
+  FlushArtistAlbumsRequests();
+  FlushAlbumSongsRequests();
+  FlushSongsRequests();
+  FlushAlbumCoverRequests();
 
 }
 
@@ -201,13 +161,13 @@ void TidalRequest::AddArtistsRequest(const int offset, const int limit) {
 
   ++artists_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void TidalRequest::FlushArtistsRequests() {
 
-  while (!artists_requests_queue_.isEmpty() && artists_requests_active_ < kMaxConcurrentArtistsRequests) {
+  while (!artists_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const Request request = artists_requests_queue_.dequeue();
 
@@ -224,6 +184,7 @@ void TidalRequest::FlushArtistsRequests() {
     }
     if (!reply) continue;
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { ArtistsReplyReceived(reply, request.limit, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++artists_requests_active_;
 
@@ -248,13 +209,13 @@ void TidalRequest::AddAlbumsRequest(const int offset, const int limit) {
 
   ++albums_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void TidalRequest::FlushAlbumsRequests() {
 
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
+  while (!albums_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const Request request = albums_requests_queue_.dequeue();
 
@@ -271,6 +232,7 @@ void TidalRequest::FlushAlbumsRequests() {
     }
     if (!reply) continue;
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumsReplyReceived(reply, request.limit, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++albums_requests_active_;
 
@@ -295,13 +257,13 @@ void TidalRequest::AddSongsRequest(const int offset, const int limit) {
 
   ++songs_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void TidalRequest::FlushSongsRequests() {
 
-  while (!songs_requests_queue_.isEmpty() && songs_requests_active_ < kMaxConcurrentSongsRequests) {
+  while (!songs_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const Request request = songs_requests_queue_.dequeue();
 
@@ -318,6 +280,7 @@ void TidalRequest::FlushSongsRequests() {
     }
     if (!reply) continue;
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { SongsReplyReceived(reply, request.limit, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++songs_requests_active_;
 
@@ -369,12 +332,11 @@ void TidalRequest::AddSongsSearchRequest(const int offset) {
 
 void TidalRequest::ArtistsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested) {
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
-  QObject::disconnect(reply, nullptr, this, nullptr);
-  reply->deleteLater();
+  ParseReplyAsync<JsonObjectResult>(reply, &TidalBaseRequest::ParseReplyData, [this, limit_requested, offset_requested](const JsonObjectResult &json_object_result) { ArtistsReceived(json_object_result, limit_requested, offset_requested); });
 
-  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+}
+
+void TidalRequest::ArtistsReceived(const JsonObjectResult &json_object_result, const int limit_requested, const int offset_requested) {
 
   --artists_requests_active_;
   ++artists_requests_received_;
@@ -511,9 +473,11 @@ void TidalRequest::ArtistsFinishCheck(const int limit, const int offset, const i
 
 void TidalRequest::AlbumsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested) {
 
-  --albums_requests_active_;
-  ++albums_requests_received_;
-  AlbumsReceived(reply, Artist(), limit_requested, offset_requested);
+  ParseReplyAsync<JsonObjectResult>(reply, &TidalBaseRequest::ParseReplyData, [this, limit_requested, offset_requested](const JsonObjectResult &json_object_result) {
+    --albums_requests_active_;
+    ++albums_requests_received_;
+    AlbumsReceived(json_object_result, Artist(), limit_requested, offset_requested);
+  });
 
 }
 
@@ -526,13 +490,13 @@ void TidalRequest::AddArtistAlbumsRequest(const Artist &artist, const int offset
 
   ++artist_albums_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void TidalRequest::FlushArtistAlbumsRequests() {
 
-  while (!artist_albums_requests_queue_.isEmpty() && artist_albums_requests_active_ < kMaxConcurrentArtistAlbumsRequests) {
+  while (!artist_albums_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     const ArtistAlbumsRequest request = artist_albums_requests_queue_.dequeue();
 
@@ -540,6 +504,7 @@ void TidalRequest::FlushArtistAlbumsRequests() {
     if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
     QNetworkReply *reply = CreateRequest(QStringLiteral("artists/%1/albums").arg(request.artist.artist_id), parameters);
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { ArtistAlbumsReplyReceived(reply, request.artist, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++artist_albums_requests_active_;
 
@@ -549,21 +514,16 @@ void TidalRequest::FlushArtistAlbumsRequests() {
 
 void TidalRequest::ArtistAlbumsReplyReceived(QNetworkReply *reply, const Artist &artist, const int offset_requested) {
 
-  --artist_albums_requests_active_;
-  ++artist_albums_requests_received_;
-  Q_EMIT UpdateProgress(query_id_, GetProgress(artist_albums_requests_received_, artist_albums_requests_total_));
-  AlbumsReceived(reply, artist, 0, offset_requested);
+  ParseReplyAsync<JsonObjectResult>(reply, &TidalBaseRequest::ParseReplyData, [this, artist, offset_requested](const JsonObjectResult &json_object_result) {
+    --artist_albums_requests_active_;
+    ++artist_albums_requests_received_;
+    Q_EMIT UpdateProgress(query_id_, GetProgress(artist_albums_requests_received_, artist_albums_requests_total_));
+    AlbumsReceived(json_object_result, artist, 0, offset_requested);
+  });
 
 }
 
-void TidalRequest::AlbumsReceived(QNetworkReply *reply, const Artist &artist_requested, const int limit_requested, const int offset_requested) {
-
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
-  QObject::disconnect(reply, nullptr, this, nullptr);
-  reply->deleteLater();
-
-  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+void TidalRequest::AlbumsReceived(const JsonObjectResult &json_object_result, const Artist &artist_requested, const int limit_requested, const int offset_requested) {
 
   if (finished_) return;
 
@@ -778,13 +738,19 @@ void TidalRequest::AlbumsFinishCheck(const Artist &artist, const int limit, cons
 
 void TidalRequest::SongsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested) {
 
-  --songs_requests_active_;
-  ++songs_requests_received_;
   if (query_type_ == Type::SearchSongs && fetchalbums_) {
-    AlbumsReceived(reply, Artist(), limit_requested, offset_requested);
+    ParseReplyAsync<JsonObjectResult>(reply, &TidalBaseRequest::ParseReplyData, [this, limit_requested, offset_requested](const JsonObjectResult &json_object_result) {
+      --songs_requests_active_;
+      ++songs_requests_received_;
+      AlbumsReceived(json_object_result, Artist(), limit_requested, offset_requested);
+    });
   }
   else {
-    SongsReceived(reply, Artist(), Album(), limit_requested, offset_requested);
+    ParseReplyAsync<SongsPage>(reply, CreateSongsParser(Artist(), Album(), offset_requested), [this, limit_requested, offset_requested](const SongsPage &songs_page) {
+      --songs_requests_active_;
+      ++songs_requests_received_;
+      SongsReceived(songs_page, Artist(), Album(), limit_requested, offset_requested);
+    });
   }
 
 }
@@ -799,19 +765,20 @@ void TidalRequest::AddAlbumSongsRequest(const Artist &artist, const Album &album
 
   ++album_songs_requests_total_;
 
-  StartRequests();
+  FlushRequests();
 
 }
 
 void TidalRequest::FlushAlbumSongsRequests() {
 
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+  while (!album_songs_requests_queue_.isEmpty() && request_limiter_->CanStartRequest()) {
 
     AlbumSongsRequest request = album_songs_requests_queue_.dequeue();
     ParamList parameters;
     if (request.offset > 0) parameters << Param(u"offset"_s, QString::number(request.offset));
     QNetworkReply *reply = CreateRequest(QStringLiteral("albums/%1/tracks").arg(request.album.album_id), parameters);
     QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumSongsReplyReceived(reply, request.artist, request.album, request.offset); });
+    request_limiter_->AddReply(reply);
 
     ++album_songs_requests_active_;
 
@@ -821,29 +788,100 @@ void TidalRequest::FlushAlbumSongsRequests() {
 
 void TidalRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const Artist &artist, const Album &album, const int offset_requested) {
 
-  --album_songs_requests_active_;
-  ++album_songs_requests_received_;
-  if (offset_requested == 0) {
-    Q_EMIT UpdateProgress(query_id_, GetProgress(album_songs_requests_received_, album_songs_requests_total_));
-  }
-  SongsReceived(reply, artist, album, 0, offset_requested);
+  ParseReplyAsync<SongsPage>(reply, CreateSongsParser(artist, album, offset_requested), [this, artist, album, offset_requested](const SongsPage &songs_page) {
+    --album_songs_requests_active_;
+    ++album_songs_requests_received_;
+    if (offset_requested == 0) {
+      Q_EMIT UpdateProgress(query_id_, GetProgress(album_songs_requests_received_, album_songs_requests_total_));
+    }
+    SongsReceived(songs_page, artist, album, 0, offset_requested);
+  });
 
 }
 
-void TidalRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, const Album &album, const int limit_requested, const int offset_requested) {
+TidalRequest::SongsParser TidalRequest::CreateSongsParser(const Artist &artist, const Album &album, const int offset_requested) const {
+
+  return SongsParser(url_handler_->scheme(), coversize_, service_->remove_remastered(), artist, album, offset_requested);
 
-  if (!replies_.contains(reply)) return;
-  replies_.removeAll(reply);
-  QObject::disconnect(reply, nullptr, this, nullptr);
-  reply->deleteLater();
+}
 
-  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+void TidalRequest::SongsReceived(const SongsPage &songs_page, const Artist &artist, const Album &album, const int limit_requested, const int offset_requested) {
 
   if (finished_) return;
 
-  int songs_total = 0;
-  int songs_received = 0;
-  const QScopeGuard finish_check = qScopeGuard([this, artist, album, limit_requested, offset_requested, &songs_total, &songs_received]() { SongsFinishCheck(artist, album, limit_requested, offset_requested, songs_total, songs_received); });
+  const QScopeGuard finish_check = qScopeGuard([this, artist, album, limit_requested, offset_requested, &songs_page]() { SongsFinishCheck(artist, album, limit_requested, offset_requested, songs_page.songs_total, songs_page.songs_received); });
+
+  // The parser logged the errors already.
+  if (!songs_page.errors.isEmpty()) {
+    error_ = songs_page.errors.last();
+  }
+
+  for (const Song &song : songs_page.songs) {
+    songs_.insert(song.song_id(), song);
+  }
+
+  if (query_type_ == Type::FavouriteSongs || query_type_ == Type::SearchSongs) {
+    songs_received_ += songs_page.songs_received;
+    Q_EMIT UpdateProgress(query_id_, GetProgress(songs_received_, songs_total_));
+  }
+
+}
+
+void TidalRequest::SongsFinishCheck(const Artist &artist, const Album &album, const int limit, const int offset, const int songs_total, const int songs_received) {
+
+  if (finished_) return;
+
+  if (limit == 0 || limit > songs_received) {
+    int offset_next = offset + songs_received;
+    if (offset_next > 0 && offset_next < songs_total) {
+      switch (query_type_) {
+        case Type::FavouriteSongs:
+          AddSongsRequest(offset_next);
+          break;
+        case Type::SearchSongs:
+          // If artist_id and album_id isn't zero it means that it's a songs search where we fetch all albums too. So fallthrough.
+          if (artist.artist_id.isEmpty() && album.album_id.isEmpty()) {
+            AddSongsSearchRequest(offset_next);
+            break;
+          }
+          [[fallthrough]];
+        case Type::FavouriteArtists:
+        case Type::SearchArtists:
+        case Type::FavouriteAlbums:
+        case Type::SearchAlbums:
+          AddAlbumSongsRequest(artist, album, offset_next);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  GetAlbumCoversCheck();
+  FinishCheck();
+
+}
+
+TidalRequest::SongsParser::SongsParser(const QString &scheme, const QString &coversize, const bool remove_remastered, const Artist &artist, const Album &album, const int offset_requested)
+    : scheme_(scheme),
+      coversize_(coversize),
+      remove_remastered_(remove_remastered),
+      artist_(artist),
+      album_(album),
+      offset_requested_(offset_requested) {}
+
+TidalRequest::SongsPage TidalRequest::SongsParser::operator()(ReplyData reply_data) {
+
+  // The Json document only lives while the songs are built, the reply data is released once it's parsed.
+  SongsPage songs_page;
+  ParseSongs(ParseReplyData(std::move(reply_data)), songs_page);
+  songs_page.errors = errors_;
+
+  return songs_page;
+
+}
+
+void TidalRequest::SongsParser::ParseSongs(const JsonObjectResult &json_object_result, SongsPage &songs_page) {
 
   if (!json_object_result.success()) {
     Error(json_object_result.error_message);
@@ -865,10 +903,10 @@ void TidalRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, con
 
   // int limit = json_obj["limit"].toInt();
   const int offset = json_object["offset"_L1].toInt();
-  songs_total = json_object["totalNumberOfItems"_L1].toInt();
+  songs_page.songs_total = json_object["totalNumberOfItems"_L1].toInt();
 
-  if (offset != offset_requested) {
-    Error(QStringLiteral("Offset returned does not match offset requested! %1 != %2").arg(offset).arg(offset_requested));
+  if (offset != offset_requested_) {
+    Error(QStringLiteral("Offset returned does not match offset requested! %1 != %2").arg(offset).arg(offset_requested_));
     return;
   }
 
@@ -903,9 +941,9 @@ void TidalRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, con
       object_item = item.toObject();
     }
 
-    ++songs_received;
+    ++songs_page.songs_received;
     Song song(Song::Source::Tidal);
-    ParseSong(song, object_item, artist, album);
+    ParseSong(song, object_item, artist_, album_);
     if (!song.is_valid()) continue;
     if (song.disc() >= 2) multidisc = true;
     if (song.is_compilation()) compilation = true;
@@ -915,52 +953,12 @@ void TidalRequest::SongsReceived(QNetworkReply *reply, const Artist &artist, con
   for (Song song : std::as_const(songs)) {
     if (compilation) song.set_compilation_detected(true);
     if (!multidisc) song.set_disc(0);
-    songs_.insert(song.song_id(), song);
-  }
-
-  if (query_type_ == Type::FavouriteSongs || query_type_ == Type::SearchSongs) {
-    songs_received_ += songs_received;
-    Q_EMIT UpdateProgress(query_id_, GetProgress(songs_received_, songs_total_));
-  }
-
-}
-
-void TidalRequest::SongsFinishCheck(const Artist &artist, const Album &album, const int limit, const int offset, const int songs_total, const int songs_received) {
-
-  if (finished_) return;
-
-  if (limit == 0 || limit > songs_received) {
-    int offset_next = offset + songs_received;
-    if (offset_next > 0 && offset_next < songs_total) {
-      switch (query_type_) {
-        case Type::FavouriteSongs:
-          AddSongsRequest(offset_next);
-          break;
-        case Type::SearchSongs:
-          // If artist_id and album_id isn't zero it means that it's a songs search where we fetch all albums too. So fallthrough.
-          if (artist.artist_id.isEmpty() && album.album_id.isEmpty()) {
-            AddSongsSearchRequest(offset_next);
-            break;
-          }
-          [[fallthrough]];
-        case Type::FavouriteArtists:
-        case Type::SearchArtists:
-        case Type::FavouriteAlbums:
-        case Type::SearchAlbums:
-          AddAlbumSongsRequest(artist, album, offset_next);
-          break;
-        default:
-          break;
-      }
-    }
+    songs_page.songs << song;
   }
 
-  GetAlbumCoversCheck();
-  FinishCheck();
-
 }
 
-void TidalRequest::ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album) {
+void TidalRequest::SongsParser::ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album) {
 
   if (!json_obj.contains("album"_L1) ||
       !json_obj.contains("allowStreaming"_L1) ||
@@ -1057,7 +1055,7 @@ void TidalRequest::ParseSong(Song &song, const QJsonObject &json_obj, const Arti
   }
 
   QUrl url;
-  url.setScheme(url_handler_->scheme());
+  url.setScheme(scheme_);
   url.setPath(song_id);
 
   QVariant q_duration = json_duration.toVariant();
@@ -1078,7 +1076,7 @@ void TidalRequest::ParseSong(Song &song, const QJsonObject &json_obj, const Arti
     }
   }
 
-  if (service_->remove_remastered()) {
+  if (remove_remastered_) {
     title = Song::TitleRemoveMisc(title);
   }
 
@@ -1146,7 +1144,7 @@ void TidalRequest::GetAlbumCovers() {
   else Q_EMIT UpdateStatus(query_id_, tr("Receiving album covers for %1 albums...").arg(album_covers_requests_total_));
   Q_EMIT UpdateProgress(query_id_, 0);
 
-  StartRequests();
+  FlushRequests();
 
 }
 
@@ -1268,6 +1266,7 @@ void TidalRequest::AlbumCoverReceived(QNetworkReply *reply, const QString &album
 
 void TidalRequest::AlbumCoverFinishCheck() {
 
+  FlushAlbumCoverRequests();
   FinishCheck();
 
 }
@@ -1290,9 +1289,6 @@ void TidalRequest::FinishCheck() {
       artist_albums_requests_active_ <= 0 &&
       album_songs_requests_active_ <= 0 &&
       album_covers_requests_active_ <= 0) {
-    if (timer_flush_requests_->isActive()) {
-      timer_flush_requests_->stop();
-    }
     finished_ = true;
     if (songs_.isEmpty()) {
       if (error_.isEmpty()) {
@@ -1331,6 +1327,17 @@ void TidalRequest::Error(const QString &error_message, const QVariant &debug_out
 
 }
 
+void TidalRequest::SongsParser::Error(const QString &error_message, const QVariant &debug_output) {
+
+  qLog(Error) << "Tidal:" << error_message;
+  if (debug_output.isValid()) {
+    qLog(Debug) << debug_output;
+  }
+
+  errors_ << error_message;
+
+}
+
 void TidalRequest::Warn(const QString &error_message, const QVariant &debug) {
 
   qLog(Warning) << "Tidal:" << error_message;
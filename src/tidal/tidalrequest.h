@@ -28,6 +28,7 @@
 #include <QQueue>
 #include <QVariant>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
 #include <QJsonObject>
 #include <QScopedPointer>
@@ -38,7 +39,7 @@
 #include "tidalbaserequest.h"
 
 class QNetworkReply;
-class QTimer;
+class AdaptiveConcurrencyLimiter;
 class NetworkAccessManager;
 class TidalService;
 class TidalUrlHandler;
@@ -54,7 +55,6 @@ class TidalRequest : public TidalBaseRequest {
   void Process();
   void Search(const int query_id, const QString &search_text);
 
- private:
   struct Artist {
     QString artist_id;
     QString artist;
@@ -66,6 +66,35 @@ class TidalRequest : public TidalBaseRequest {
     QUrl cover_url;
     bool album_explicit;
   };
+  struct SongsPage {
+    SongsPage() : songs_total(0), songs_received(0) {}
+    QStringList errors;
+    int songs_total;
+    int songs_received;
+    SongList songs;
+  };
+
+  // Builds the songs of a reply on a worker thread, so it only keeps copies of what it needs from the request.
+  class SongsParser {
+   public:
+    explicit SongsParser(const QString &scheme, const QString &coversize, const bool remove_remastered, const Artist &artist, const Album &album, const int offset_requested);
+    SongsPage operator()(ReplyData reply_data);
+
+   private:
+    void ParseSongs(const JsonObjectResult &json_object_result, SongsPage &songs_page);
+    void ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album);
+    void Error(const QString &error_message, const QVariant &debug_output = QVariant());
+
+    QString scheme_;
+    QString coversize_;
+    bool remove_remastered_;
+    Artist artist_;
+    Album album_;
+    int offset_requested_;
+    QStringList errors_;
+  };
+
+ private:
   struct Request {
     Request() : offset(0), limit(0) {}
     int offset;
@@ -103,10 +132,7 @@ class TidalRequest : public TidalBaseRequest {
   void ArtistsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested);
 
   void AlbumsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested);
-  void AlbumsReceived(QNetworkReply *reply, const TidalRequest::Artist &artist_requested, const int limit_requested, const int offset_requested);
-
   void SongsReplyReceived(QNetworkReply *reply, const int limit_requested, const int offset_requested);
-  void SongsReceived(QNetworkReply *reply, const TidalRequest::Artist &artist, const TidalRequest::Album &album, const int limit_requested, const int offset_requested);
 
   void ArtistAlbumsReplyReceived(QNetworkReply *reply, const TidalRequest::Artist &artist, const int offset_requested);
   void AlbumSongsReplyReceived(QNetworkReply *reply, const TidalRequest::Artist &artist, const TidalRequest::Album &album, const int offset_requested);
@@ -116,9 +142,13 @@ class TidalRequest : public TidalBaseRequest {
   bool IsQuery() const { return (query_type_ == Type::FavouriteArtists || query_type_ == Type::FavouriteAlbums || query_type_ == Type::FavouriteSongs); }
   bool IsSearch() const { return (query_type_ == Type::SearchArtists || query_type_ == Type::SearchAlbums || query_type_ == Type::SearchSongs); }
 
-  void StartRequests();
   void FlushRequests();
 
+  void ArtistsReceived(const JsonObjectResult &json_object_result, const int limit_requested, const int offset_requested);
+  void AlbumsReceived(const JsonObjectResult &json_object_result, const Artist &artist_requested, const int limit_requested, const int offset_requested);
+  SongsParser CreateSongsParser(const Artist &artist, const Album &album, const int offset_requested) const;
+  void SongsReceived(const SongsPage &songs_page, const Artist &artist, const Album &album, const int limit_requested, const int offset_requested);
+
   void GetArtists();
   void GetAlbums();
   void GetSongs();
@@ -147,8 +177,6 @@ class TidalRequest : public TidalBaseRequest {
   void AddAlbumSongsRequest(const Artist &artist, const Album &album, const int offset = 0);
   void FlushAlbumSongsRequests();
 
-  void ParseSong(Song &song, const QJsonObject &json_obj, const Artist &album_artist, const Album &album);
-
   void GetAlbumCoversCheck();
   void GetAlbumCovers();
   void AddAlbumCoverRequest(const Song &song);
@@ -164,7 +192,7 @@ class TidalRequest : public TidalBaseRequest {
   TidalService *service_;
   TidalUrlHandler *url_handler_;
   SharedPtr<NetworkAccessManager> network_;
-  QTimer *timer_flush_requests_;
+  AdaptiveConcurrencyLimiter *request_limiter_;
 
   const Type query_type_;
   const bool fetchalbums_;
@@ -275,6 +275,8 @@ void TidalService::ClearSession() {
 
   oauth_->ClearSession();
 
+  Q_EMIT SessionCleared();
+
 }
 
 void TidalService::GetArtists() {
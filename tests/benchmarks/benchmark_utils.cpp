@@ -0,0 +1,110 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+
+#include "core/song.h"
+#include "benchmark_utils.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+constexpr int kTracksPerAlbum = 10;
+constexpr int kAlbumsPerArtist = 4;
+constexpr int kCompilationInterval = 25;
+
+const QStringList &Genres() {
+
+  static const QStringList genres = QStringList() << u"Rock"_s << u"Pop"_s << u"Jazz"_s << u"Classical"_s << u"Electronic"_s << u"Folk"_s << u"Hip-Hop"_s << u"Metal"_s;
+  return genres;
+
+}
+
+const QStringList &Words() {
+
+  static const QStringList words = QStringList() << u"Love"_s << u"Night"_s << u"Strawberry"_s << u"Fields"_s << u"River"_s << u"Blue"_s << u"Summer"_s << u"Dream"_s << u"Heart"_s << u"Road"_s << u"Fire"_s << u"Rain"_s;
+  return words;
+
+}
+
+}  // namespace
+
+SongList GenerateSongs(const int count) {
+
+  std::mt19937 generator(count);
+  std::uniform_int_distribution<int> word_distribution(0, static_cast<int>(Words().count()) - 1);
+  std::uniform_int_distribution<int> length_distribution(90, 600);
+  std::uniform_int_distribution<int> playcount_distribution(0, 50);
+
+  const QList<Song::FileType> filetypes = QList<Song::FileType>() << Song::FileType::FLAC << Song::FileType::MPEG << Song::FileType::OggVorbis << Song::FileType::MP4;
+
+  SongList songs;
+  songs.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    const int album = i / kTracksPerAlbum;
+    const int artist = album / kAlbumsPerArtist;
+    const bool compilation = album % kCompilationInterval == 0;
+    const QString artist_name = u"Artist %1"_s.arg(compilation ? i : artist);
+    const QString album_name = u"%1 Album %2"_s.arg(Words().value(album % Words().count())).arg(album);
+    const QString word1 = Words().value(word_distribution(generator));
+    const QString word2 = Words().value(word_distribution(generator));
+    const QString title = u"%1 %2 %3"_s.arg(word1, word2).arg(i);
+    const Song::FileType filetype = filetypes.value(artist % filetypes.count());
+
+    Song song(Song::Source::Collection);
+    song.set_title(title);
+    song.set_artist(artist_name);
+    song.set_albumartist(compilation ? u"Various artists"_s : artist_name);
+    song.set_album(album_name);
+    song.set_track((i % kTracksPerAlbum) + 1);
+    song.set_disc(1);
+    song.set_year(1960 + (album % 64));
+    song.set_genre(Genres().value(artist % Genres().count()));
+    song.set_length_nanosec(static_cast<qint64>(length_distribution(generator)) * 1000000000LL);
+    song.set_bitrate(filetype == Song::FileType::FLAC ? 1411 : 320);
+    song.set_samplerate(44100);
+    song.set_filetype(filetype);
+    song.set_playcount(static_cast<uint>(playcount_distribution(generator)));
+    song.set_directory_id(1);
+    song.set_url(QUrl::fromLocalFile(u"/tmp/%1/%2/%3.%4"_s.arg(artist_name, album_name, title, Song::ExtensionForFiletype(filetype))));
+    song.set_filesize(static_cast<qint64>(length_distribution(generator)) * 100000LL);
+    song.set_mtime(1);
+    song.set_ctime(1);
+    song.set_valid(true);
+    songs << song;
+  }
+
+  return songs;
+
+}
+
+void SongCountArguments(benchmark::internal::Benchmark *benchmark) {
+
+  benchmark->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+}
@@ -0,0 +1,34 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BENCHMARK_UTILS_H
+#define BENCHMARK_UTILS_H
+
+#include <benchmark/benchmark.h>
+
+#include "core/song.h"
+
+// Builds a deterministic collection of songs with the shape of a real collection:
+// ten tracks per album, four albums per artist, a compilation every 25th album and a mix of genres, years and file types.
+SongList GenerateSongs(const int count);
+
+// Runs a benchmark with 10k, 100k and 1M songs.
+void SongCountArguments(benchmark::internal::Benchmark *benchmark);
+
+#endif  // BENCHMARK_UTILS_H
@@ -0,0 +1,114 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QString>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/memorydatabase.h"
+#include "collection/collectionlibrary.h"
+#include "collection/collectionbackend.h"
+#include "benchmark_utils.h"
+
+using std::make_shared;
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+// Writes all songs to an empty in-memory database in one transaction, as the collection watcher does after a scan.
+void BM_CollectionBackendAddOrUpdateSongs(benchmark::State &state) {
+
+  const SongList songs = GenerateSongs(static_cast<int>(state.range(0)));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    SharedPtr<Database> database = make_shared<MemoryDatabase>(nullptr);
+    SharedPtr<CollectionBackend> backend = make_shared<CollectionBackend>();
+    backend->Init(database, nullptr, Song::Source::Collection, QLatin1String(CollectionLibrary::kSongsTable), QLatin1String(CollectionLibrary::kDirsTable), QLatin1String(CollectionLibrary::kSubdirsTable));
+    backend->AddDirectory(u"/tmp"_s);
+    state.ResumeTiming();
+
+    backend->AddOrUpdateSongs(songs);
+
+    state.PauseTiming();
+    backend.reset();
+    database.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * songs.count());
+
+}
+
+// Syncs a synthetic import of 50k streaming favorites, keyed by song ID.
+// With resync set the database already holds the favorites and the new sync only changes or removes a few of them.
+void BM_CollectionBackendUpdateSongsBySongID(benchmark::State &state) {
+
+  constexpr int kSongCount = 50000;
+  const bool resync = state.range(0) != 0;
+
+  SongMap songs;
+  const SongList generated_songs = GenerateSongs(kSongCount);
+  for (int i = 0; i < generated_songs.count(); ++i) {
+    Song song = generated_songs[i];
+    song.set_song_id(u"song"_s + QString::number(i));
+    songs.insert(song.song_id(), song);
+  }
+
+  SongMap updated_songs = songs;
+  if (resync) {
+    for (int i = 0; i < kSongCount; i += 100) {
+      updated_songs[u"song"_s + QString::number(i)].set_artist(u"New artist"_s);
+    }
+    for (int i = 50; i < kSongCount; i += 500) {
+      updated_songs.remove(u"song"_s + QString::number(i));
+    }
+  }
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    SharedPtr<Database> database = make_shared<MemoryDatabase>(nullptr);
+    SharedPtr<CollectionBackend> backend = make_shared<CollectionBackend>();
+    backend->Init(database, nullptr, Song::Source::Collection, QLatin1String(CollectionLibrary::kSongsTable), QLatin1String(CollectionLibrary::kDirsTable), QLatin1String(CollectionLibrary::kSubdirsTable));
+    backend->AddDirectory(u"/tmp"_s);
+    if (resync) {
+      backend->UpdateSongsBySongID(songs);
+    }
+    state.ResumeTiming();
+
+    backend->UpdateSongsBySongID(updated_songs);
+
+    state.PauseTiming();
+    backend.reset();
+    database.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * updated_songs.count());
+
+}
+
+}  // namespace
+
+BENCHMARK(BM_CollectionBackendAddOrUpdateSongs)->Apply(SongCountArguments);
+BENCHMARK(BM_CollectionBackendUpdateSongsBySongID)->ArgName("resync")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,97 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#include "includes/shared_ptr.h"
+#include "includes/scoped_ptr.h"
+#include "core/song.h"
+#include "core/memorydatabase.h"
+#include "collection/collectionlibrary.h"
+#include "collection/collectionbackend.h"
+#include "collection/collectionmodel.h"
+#include "benchmark_utils.h"
+
+using std::make_shared;
+using std::make_unique;
+
+namespace {
+
+using GroupBy = CollectionModel::GroupBy;
+using Grouping = CollectionModel::Grouping;
+
+const QList<Grouping> &Groupings() {
+
+  static const QList<Grouping> groupings = QList<Grouping>()
+    << Grouping(GroupBy::AlbumArtist, GroupBy::AlbumDisc)
+    << Grouping(GroupBy::Artist, GroupBy::YearAlbum)
+    << Grouping(GroupBy::Genre, GroupBy::AlbumArtist, GroupBy::Album)
+    << Grouping(GroupBy::FileType, GroupBy::Bitrate, GroupBy::Year);
+  return groupings;
+
+}
+
+// Builds the container keys, display text and sort text for every song the same way CollectionModel::AddSongsInternal() does when it populates the tree.
+// The model itself processes songs in timer driven batches, so driving it directly would mostly measure the timer.
+void BM_CollectionModelGrouping(benchmark::State &state) {
+
+  const SongList songs = GenerateSongs(static_cast<int>(state.range(0)));
+  const Grouping grouping = Groupings().value(state.range(1));
+
+  SharedPtr<Database> database = make_shared<MemoryDatabase>(nullptr);
+  SharedPtr<CollectionBackend> backend = make_shared<CollectionBackend>();
+  backend->Init(database, nullptr, Song::Source::Collection, QLatin1String(CollectionLibrary::kSongsTable), QLatin1String(CollectionLibrary::kDirsTable), QLatin1String(CollectionLibrary::kSubdirsTable));
+  ScopedPtr<CollectionModel> model = make_unique<CollectionModel>(backend, nullptr);
+
+  for (auto _ : state) {
+    QMap<QString, QString> container_nodes[3];
+    QStringList song_sort_texts;
+    song_sort_texts.reserve(songs.count());
+    for (const Song &song : songs) {
+      QString container_key;
+      bool has_unique_album_identifier = false;
+      for (int i = 0; i < 3; ++i) {
+        const GroupBy group_by = grouping[i];
+        if (group_by == GroupBy::None) break;
+        if (!container_key.isEmpty()) container_key.append(u'-');
+        container_key.append(model->ContainerKey(group_by, song, has_unique_album_identifier));
+        if (!container_nodes[i].contains(container_key)) {
+          container_nodes[i].insert(container_key, CollectionModel::DisplayText(group_by, song) + CollectionModel::SortText(group_by, song, true, true, true));
+        }
+      }
+      song_sort_texts << CollectionModel::SortTextForSong(song);
+    }
+    benchmark::DoNotOptimize(container_nodes);
+    benchmark::DoNotOptimize(song_sort_texts);
+  }
+
+  state.SetItemsProcessed(state.iterations() * songs.count());
+
+}
+
+}  // namespace
+
+BENCHMARK(BM_CollectionModelGrouping)->ArgsProduct({ { 10000, 100000, 1000000 }, { 0, 1, 2, 3 } })->Unit(benchmark::kMillisecond);
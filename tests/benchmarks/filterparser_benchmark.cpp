@@ -0,0 +1,94 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QString>
+#include <QStringList>
+#include <QScopedPointer>
+
+#include "core/song.h"
+#include "filterparser/filterparser.h"
+#include "filterparser/filtertree.h"
+#include "benchmark_utils.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+const QStringList &Filters() {
+
+  static const QStringList filters = QStringList()
+    << u"strawberry"_s
+    << u"artist:\"Artist 42\""_s
+    << u"genre:rock year:>=1990 -title:love"_s
+    << u"(album:river OR album:fire) AND playcount:>10"_s
+    << u"love night strawberry fields river blue summer dream"_s;
+  return filters;
+
+}
+
+void FilterArguments(benchmark::internal::Benchmark *benchmark) {
+
+  for (qsizetype i = 0; i < Filters().count(); ++i) {
+    benchmark->Arg(i);
+  }
+
+}
+
+void BM_FilterParserParse(benchmark::State &state) {
+
+  const QString filter = Filters().value(state.range(0));
+  state.SetLabel(filter.toStdString());
+
+  for (auto _ : state) {
+    FilterParser parser(filter);
+    QScopedPointer<FilterTree> filter_tree(parser.parse());
+    benchmark::DoNotOptimize(filter_tree.data());
+  }
+
+}
+
+void BM_FilterTreeAccept(benchmark::State &state) {
+
+  const SongList songs = GenerateSongs(static_cast<int>(state.range(0)));
+  const QString filter = Filters().value(state.range(1));
+  state.SetLabel(filter.toStdString());
+
+  FilterParser parser(filter);
+  QScopedPointer<FilterTree> filter_tree(parser.parse());
+
+  for (auto _ : state) {
+    int accepted = 0;
+    for (const Song &song : songs) {
+      if (filter_tree->accept(song)) ++accepted;
+    }
+    benchmark::DoNotOptimize(accepted);
+  }
+
+  state.SetItemsProcessed(state.iterations() * songs.count());
+
+}
+
+}  // namespace
+
+BENCHMARK(BM_FilterParserParse)->Apply(FilterArguments);
+BENCHMARK(BM_FilterTreeAccept)->ArgsProduct({ { 10000, 100000, 1000000 }, { 0, 1, 2, 3, 4 } })->Unit(benchmark::kMillisecond);
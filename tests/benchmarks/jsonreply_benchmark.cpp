@@ -0,0 +1,147 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QFile>
+
+#include "core/song.h"
+#include "core/jsonbaserequest.h"
+#ifdef HAVE_SUBSONIC
+#  include "constants/subsonicsettings.h"
+#  include "subsonic/subsonicbaserequest.h"
+#  include "subsonic/subsonicrequest.h"
+#endif
+#ifdef HAVE_TIDAL
+#  include "tidal/tidalrequest.h"
+#endif
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+#if defined(HAVE_SUBSONIC) || defined(HAVE_TIDAL)
+
+// Recorded replies, with the ids and names replaced.
+constexpr char kSubsonicAlbumReply[] = ":/json/subsonic_getalbum.json";
+constexpr char kSubsonicAlbumListReply[] = ":/json/subsonic_getalbumlist2.json";
+constexpr char kTidalFavoriteTracksReply[] = ":/json/tidal_favorites_tracks.json";
+
+QByteArray ReadReply(const char *filename) {
+
+  QFile file(QString::fromLatin1(filename));
+  if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+  return file.readAll();
+
+}
+
+JsonBaseRequest::ReplyData CreateReplyData(const QByteArray &data) {
+
+  JsonBaseRequest::ReplyData reply_data;
+  reply_data.data = data;
+  return reply_data;
+
+}
+
+#endif
+
+#ifdef HAVE_SUBSONIC
+
+// A getAlbumList2 page of 500 albums, only parsed on the worker thread, the albums are read on the GUI thread.
+void BM_JsonReplySubsonicAlbumList(benchmark::State &state) {
+
+  const QByteArray reply = ReadReply(kSubsonicAlbumListReply);
+  if (reply.isEmpty()) {
+    state.SkipWithError("Missing reply fixture.");
+    return;
+  }
+
+  for (auto _ : state) {
+    const SubsonicBaseRequest::JsonObjectResult json_object_result = SubsonicBaseRequest::ParseReplyData(CreateReplyData(reply));
+    benchmark::DoNotOptimize(json_object_result);
+  }
+
+  state.SetBytesProcessed(state.iterations() * reply.size());
+
+}
+
+// A getAlbum reply, parsed and turned into songs by the parser the request runs on the worker thread.
+void BM_JsonReplySubsonicAlbumSongs(benchmark::State &state) {
+
+  const QByteArray reply = ReadReply(kSubsonicAlbumReply);
+  if (reply.isEmpty()) {
+    state.SkipWithError("Missing reply fixture.");
+    return;
+  }
+
+  qint64 songs_received = 0;
+  for (auto _ : state) {
+    SubsonicRequest::SongsParser parser(u"subsonic"_s, QUrl(u"https://music.example.com"_s), SubsonicSettings::AuthMethod::MD5, u"user"_s, u"password"_s, false, QString());
+    const SubsonicRequest::SongsPage songs_page = parser(CreateReplyData(reply));
+    songs_received += songs_page.songs.count();
+    benchmark::DoNotOptimize(songs_page);
+  }
+
+  state.SetItemsProcessed(songs_received);
+  state.SetBytesProcessed(state.iterations() * reply.size());
+
+}
+
+#endif  // HAVE_SUBSONIC
+
+#ifdef HAVE_TIDAL
+
+// A page of 100 Tidal favorite tracks, parsed and turned into songs.
+void BM_JsonReplyTidalFavoriteSongs(benchmark::State &state) {
+
+  const QByteArray reply = ReadReply(kTidalFavoriteTracksReply);
+  if (reply.isEmpty()) {
+    state.SkipWithError("Missing reply fixture.");
+    return;
+  }
+
+  qint64 songs_received = 0;
+  for (auto _ : state) {
+    TidalRequest::SongsParser parser(u"tidal"_s, u"640x640"_s, false, TidalRequest::Artist(), TidalRequest::Album(), 0);
+    const TidalRequest::SongsPage songs_page = parser(CreateReplyData(reply));
+    songs_received += songs_page.songs.count();
+    benchmark::DoNotOptimize(songs_page);
+  }
+
+  state.SetItemsProcessed(songs_received);
+  state.SetBytesProcessed(state.iterations() * reply.size());
+
+}
+
+#endif  // HAVE_TIDAL
+
+}  // namespace
+
+#ifdef HAVE_SUBSONIC
+BENCHMARK(BM_JsonReplySubsonicAlbumList)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_JsonReplySubsonicAlbumSongs)->Unit(benchmark::kMicrosecond);
+#endif
+#ifdef HAVE_TIDAL
+BENCHMARK(BM_JsonReplyTidalFavoriteSongs)->Unit(benchmark::kMicrosecond);
+#endif
@@ -0,0 +1,54 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QApplication>
+#include <QResource>
+#include <QMetaType>
+#include <QString>
+
+#include "core/logging.h"
+#include "core/song.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+int main(int argc, char **argv) {
+
+  QApplication a(argc, argv);
+
+  Q_INIT_RESOURCE(data);
+  Q_INIT_RESOURCE(icons);
+  Q_INIT_RESOURCE(testdata);
+
+  qRegisterMetaType<SongList>("SongList");
+
+  logging::Init();
+  logging::SetLevels(u"*:1"_s);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  return 0;
+
+}
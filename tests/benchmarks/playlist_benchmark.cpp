@@ -0,0 +1,110 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QString>
+#include <QStringList>
+#include <QUndoStack>
+
+#include "includes/scoped_ptr.h"
+#include "core/song.h"
+#include "playlist/playlist.h"
+#include "playlist/playlistfilter.h"
+#include "benchmark_utils.h"
+
+using std::make_unique;
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+ScopedPtr<Playlist> CreatePlaylist() {
+
+  return make_unique<Playlist>(nullptr, nullptr, nullptr, nullptr, nullptr, 1);
+
+}
+
+void BM_PlaylistInsertSongs(benchmark::State &state) {
+
+  const SongList songs = GenerateSongs(static_cast<int>(state.range(0)));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    ScopedPtr<Playlist> playlist = CreatePlaylist();
+    state.ResumeTiming();
+    playlist->InsertSongs(songs);
+    benchmark::DoNotOptimize(playlist->rowCount());
+    state.PauseTiming();
+    playlist.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * songs.count());
+
+}
+
+void BM_PlaylistSort(benchmark::State &state) {
+
+  const Playlist::Column column = static_cast<Playlist::Column>(state.range(1));
+
+  ScopedPtr<Playlist> playlist = CreatePlaylist();
+  playlist->InsertSongs(GenerateSongs(static_cast<int>(state.range(0))));
+
+  Qt::SortOrder order = Qt::AscendingOrder;
+  for (auto _ : state) {
+    playlist->sort(static_cast<int>(column), order);
+    state.PauseTiming();
+    playlist->undo_stack()->clear();
+    order = order == Qt::AscendingOrder ? Qt::DescendingOrder : Qt::AscendingOrder;
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * playlist->rowCount());
+
+}
+
+void BM_PlaylistFilter(benchmark::State &state) {
+
+  static const QStringList filters = QStringList() << u"strawberry"_s << u"artist:\"Artist 42\""_s << u"genre:rock year:>=1990 -title:love"_s;
+  const QString filter = filters.value(state.range(1));
+  state.SetLabel(filter.toStdString());
+
+  ScopedPtr<Playlist> playlist = CreatePlaylist();
+  playlist->InsertSongs(GenerateSongs(static_cast<int>(state.range(0))));
+  PlaylistFilter *playlist_filter = playlist->filter();
+
+  for (auto _ : state) {
+    playlist_filter->SetFilterString(filter);
+    benchmark::DoNotOptimize(playlist_filter->rowCount());
+    state.PauseTiming();
+    playlist_filter->SetFilterString(QString());
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * playlist->rowCount());
+
+}
+
+}  // namespace
+
+BENCHMARK(BM_PlaylistInsertSongs)->Apply(SongCountArguments);
+BENCHMARK(BM_PlaylistSort)->ArgsProduct({ { 10000, 100000, 1000000 }, { static_cast<int>(Playlist::Column::Title), static_cast<int>(Playlist::Column::Album), static_cast<int>(Playlist::Column::Length) } })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PlaylistFilter)->ArgsProduct({ { 10000, 100000, 1000000 }, { 0, 1, 2 } })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,124 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "engine/sampleconversion.h"
+
+namespace {
+
+// Interleaved stereo buffers from 10 ms to 1 s at 44.1 kHz.
+void SampleCountArguments(benchmark::internal::Benchmark *benchmark) {
+
+  benchmark->Arg(441 * 2)->Arg(4410 * 2)->Arg(44100 * 2)->Unit(benchmark::kMicrosecond);
+
+}
+
+template<typename T, typename Distribution>
+std::vector<T> GenerateSamples(const size_t count, Distribution distribution) {
+
+  std::mt19937 generator(static_cast<std::mt19937::result_type>(count));
+  std::vector<T> samples(count);
+  for (T &sample : samples) {
+    sample = static_cast<T>(distribution(generator));
+  }
+  return samples;
+
+}
+
+void BM_SampleConversionS32LEToS16(benchmark::State &state) {
+
+  const int count = static_cast<int>(state.range(0));
+  const std::vector<int32_t> source = GenerateSamples<int32_t>(static_cast<size_t>(count), std::uniform_int_distribution<int32_t>(INT32_MIN, INT32_MAX));
+  std::vector<int16_t> dest(static_cast<size_t>(count));
+
+  for (auto _ : state) {
+    SampleConversion::S32LEToS16(source.data(), dest.data(), count);
+    benchmark::DoNotOptimize(dest.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * count * static_cast<int64_t>(sizeof(int32_t)));
+
+}
+
+void BM_SampleConversionF32LEToS16(benchmark::State &state) {
+
+  const int count = static_cast<int>(state.range(0));
+  const std::vector<float> source = GenerateSamples<float>(static_cast<size_t>(count), std::uniform_real_distribution<float>(-1.0F, 0.999F));
+  std::vector<int16_t> dest(static_cast<size_t>(count));
+
+  for (auto _ : state) {
+    SampleConversion::F32LEToS16(source.data(), dest.data(), count);
+    benchmark::DoNotOptimize(dest.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * count * static_cast<int64_t>(sizeof(float)));
+
+}
+
+void BM_SampleConversionS24LEToS16(benchmark::State &state) {
+
+  const int count = static_cast<int>(state.range(0));
+  const std::vector<int8_t> source = GenerateSamples<int8_t>(static_cast<size_t>(count) * 3, std::uniform_int_distribution<int>(INT8_MIN, INT8_MAX));
+  std::vector<int16_t> dest(static_cast<size_t>(count));
+
+  for (auto _ : state) {
+    SampleConversion::S24LEToS16(source.data(), source.size(), dest.data(), count);
+    benchmark::DoNotOptimize(dest.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * count * 3);
+
+}
+
+void BM_SampleConversionS24_32LEToS16(benchmark::State &state) {
+
+  const int count = static_cast<int>(state.range(0));
+  const std::vector<int32_t> source = GenerateSamples<int32_t>(static_cast<size_t>(count), std::uniform_int_distribution<int32_t>(-8388608, 8388607));
+  std::vector<int16_t> dest(static_cast<size_t>(count));
+
+  for (auto _ : state) {
+    SampleConversion::S24_32LEToS16(source.data(), dest.data(), count);
+    benchmark::DoNotOptimize(dest.data());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * count * static_cast<int64_t>(sizeof(int32_t)));
+
+}
+
+}  // namespace
+
+BENCHMARK(BM_SampleConversionS32LEToS16)->Apply(SampleCountArguments);
+BENCHMARK(BM_SampleConversionF32LEToS16)->Apply(SampleCountArguments);
+BENCHMARK(BM_SampleConversionS24LEToS16)->Apply(SampleCountArguments);
+BENCHMARK(BM_SampleConversionS24_32LEToS16)->Apply(SampleCountArguments);
@@ -0,0 +1,122 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include <QList>
+#include <QString>
+#include <QSqlDatabase>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/memorydatabase.h"
+#include "core/sqlquery.h"
+#include "core/sqlrow.h"
+#include "collection/collectionlibrary.h"
+#include "collection/collectionbackend.h"
+#include "benchmark_utils.h"
+
+using std::make_shared;
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+void BM_SongCopy(benchmark::State &state) {
+
+  const SongList songs = GenerateSongs(static_cast<int>(state.range(0)));
+
+  for (auto _ : state) {
+    SongList copies;
+    copies.reserve(songs.count());
+    for (const Song &song : songs) {
+      copies << song;
+    }
+    benchmark::DoNotOptimize(copies);
+  }
+
+  state.SetItemsProcessed(state.iterations() * songs.count());
+
+}
+
+// Copying a song only increments a reference count, modifying the copy detaches it.
+void BM_SongCopyDetach(benchmark::State &state) {
+
+  const SongList songs = GenerateSongs(static_cast<int>(state.range(0)));
+
+  for (auto _ : state) {
+    SongList copies;
+    copies.reserve(songs.count());
+    for (const Song &song : songs) {
+      Song copy = song;
+      copy.set_playcount(song.playcount() + 1);
+      copies << copy;
+    }
+    benchmark::DoNotOptimize(copies);
+  }
+
+  state.SetItemsProcessed(state.iterations() * songs.count());
+
+}
+
+void BM_SongInitFromQuery(benchmark::State &state) {
+
+  SharedPtr<Database> database = make_shared<MemoryDatabase>(nullptr);
+  SharedPtr<CollectionBackend> backend = make_shared<CollectionBackend>();
+  backend->Init(database, nullptr, Song::Source::Collection, QLatin1String(CollectionLibrary::kSongsTable), QLatin1String(CollectionLibrary::kDirsTable), QLatin1String(CollectionLibrary::kSubdirsTable));
+  backend->AddDirectory(u"/tmp"_s);
+  backend->AddOrUpdateSongs(GenerateSongs(static_cast<int>(state.range(0))));
+
+  QList<SqlRow> rows;
+  {
+    QSqlDatabase db(database->Connect());
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("SELECT %1 FROM %2").arg(Song::kRowIdColumnSpec, QLatin1String(CollectionLibrary::kSongsTable)));
+    if (!q.Exec()) {
+      state.SkipWithError("Failed to query songs.");
+      return;
+    }
+    while (q.next()) {
+      rows << SqlRow(q);
+    }
+  }
+
+  for (auto _ : state) {
+    SongList songs;
+    songs.reserve(rows.count());
+    for (const SqlRow &row : std::as_const(rows)) {
+      Song song;
+      song.InitFromQuery(row, true);
+      songs << song;
+    }
+    benchmark::DoNotOptimize(songs);
+  }
+
+  state.SetItemsProcessed(state.iterations() * rows.count());
+
+}
+
+}  // namespace
+
+BENCHMARK(BM_SongCopy)->Apply(SongCountArguments);
+BENCHMARK(BM_SongCopyDetach)->Apply(SongCountArguments);
+BENCHMARK(BM_SongInitFromQuery)->Apply(SongCountArguments);
@@ -0,0 +1,87 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QString>
+#include <QStringList>
+
+#include "core/song.h"
+#include "tagreader/tagreadertaglib.h"
+#include "tagreader/tagreaderresult.h"
+#include "test_utils.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+const QStringList &AudioFiles() {
+
+  static const QStringList audio_files = QStringList()
+    << u":/audio/strawberry.wav"_s
+    << u":/audio/strawberry.flac"_s
+    << u":/audio/strawberry.wv"_s
+    << u":/audio/strawberry.oga"_s
+    << u":/audio/strawberry.ogg"_s
+    << u":/audio/strawberry.opus"_s
+    << u":/audio/strawberry.spx"_s
+    << u":/audio/strawberry.aif"_s
+    << u":/audio/strawberry.asf"_s
+    << u":/audio/strawberry.mp3"_s
+    << u":/audio/strawberry.m4a"_s
+    << u":/audio/strawberry.mp4"_s;
+  return audio_files;
+
+}
+
+void AudioFileArguments(benchmark::internal::Benchmark *benchmark) {
+
+  for (qsizetype i = 0; i < AudioFiles().count(); ++i) {
+    benchmark->Arg(i);
+  }
+  benchmark->Unit(benchmark::kMicrosecond);
+
+}
+
+void BM_TagReaderReadFile(benchmark::State &state) {
+
+  const QString resource = AudioFiles().value(state.range(0));
+  state.SetLabel(resource.section(u'.', -1, -1).toStdString());
+
+  TemporaryResource file(resource);
+  const QString filename = file.fileName();
+  const TagReaderTagLib tagreader;
+
+  for (auto _ : state) {
+    Song song;
+    const TagReaderResult result = tagreader.ReadFile(filename, &song);
+    if (!result.success()) {
+      state.SkipWithError("Failed to read tags.");
+      break;
+    }
+    benchmark::DoNotOptimize(song);
+  }
+
+}
+
+}  // namespace
+
+BENCHMARK(BM_TagReaderReadFile)->Apply(AudioFileArguments);
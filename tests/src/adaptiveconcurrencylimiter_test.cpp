@@ -0,0 +1,69 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QString>
+
+#include "core/adaptiveconcurrencylimiter.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+TEST(AdaptiveConcurrencyLimiterTest, IncreasesWhenFast) {
+
+  AdaptiveConcurrencyLimiter limiter(u"Test"_s);
+  const int initial_limit = limiter.limit();
+
+  for (int i = 0; i < initial_limit; ++i) {
+    limiter.RequestFinished(100, 200);
+  }
+
+  EXPECT_EQ(limiter.limit(), initial_limit + 1);
+  EXPECT_TRUE(limiter.CanStartRequest());
+
+}
+
+TEST(AdaptiveConcurrencyLimiterTest, DecreasesWhenSlow) {
+
+  AdaptiveConcurrencyLimiter limiter(u"Test"_s);
+  limiter.set_limit(8);
+
+  limiter.RequestFinished(100, 200);
+  limiter.RequestFinished(1000, 200);
+
+  EXPECT_LT(limiter.limit(), 8);
+
+}
+
+TEST(AdaptiveConcurrencyLimiterTest, BacksOffWhenThrottled) {
+
+  AdaptiveConcurrencyLimiter limiter(u"Test"_s);
+  limiter.set_limit(8);
+
+  limiter.RequestFinished(100, 429, 5000);
+
+  EXPECT_EQ(limiter.limit(), 4);
+  EXPECT_FALSE(limiter.CanStartRequest());
+  EXPECT_EQ(limiter.statistics().throttled, 1);
+
+}
+
+}  // namespace
@@ -0,0 +1,183 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <utility>
+
+#include <QtGlobal>
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QList>
+#include <QVariant>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QImage>
+#include <QColor>
+#include <QSize>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "includes/shared_ptr.h"
+#include "includes/scoped_ptr.h"
+#include "core/standardpaths.h"
+#include "tagreader/tagreaderclient.h"
+#include "covermanager/albumcoverloader.h"
+#include "covermanager/albumcoverloaderoptions.h"
+#include "covermanager/albumcoverloaderresult.h"
+#include "covermanager/albumcoverthumbnailstore.h"
+
+using std::make_shared;
+using namespace Qt::Literals::StringLiterals;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+class AlbumCoverLoaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    qputenv("XDG_CACHE_HOME", cache_directory_.path().toLocal8Bit());
+    QDir().mkpath(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation));
+    cover_filename_ = cover_directory_.path() + "/cover.png"_L1;
+    QImage image(200, 200, QImage::Format_RGB32);
+    image.fill(Qt::red);
+    ASSERT_TRUE(image.save(cover_filename_, "PNG"));
+    tagreader_client_ = make_shared<TagReaderClient>();
+    loader_.reset(new AlbumCoverLoader(tagreader_client_));
+  }
+
+  void TearDown() override {
+    loader_.reset();
+  }
+
+  quint64 LoadCover(const AlbumCoverLoaderOptions &options) {
+    return loader_->LoadImageAsync(options, false, QUrl(), QUrl::fromLocalFile(cover_filename_), false);
+  }
+
+  static AlbumCoverLoaderOptions OriginalImageOptions() {
+    return AlbumCoverLoaderOptions(AlbumCoverLoaderOptions::Option::OriginalImage, QSize(), 1.0, AlbumCoverLoaderOptions::Types() << AlbumCoverLoaderOptions::Type::Manual);
+  }
+
+  static QSet<quint64> EmittedIds(const QSignalSpy &spy) {
+    QSet<quint64> ids;
+    for (const QList<QVariant> &arguments : spy) {
+      ids << arguments.value(0).toULongLong();
+    }
+    return ids;
+  }
+
+  QTemporaryDir cache_directory_;
+  QTemporaryDir cover_directory_;
+  QString cover_filename_;
+  SharedPtr<TagReaderClient> tagreader_client_;
+  ScopedPtr<AlbumCoverLoader> loader_;
+};
+
+TEST_F(AlbumCoverLoaderTest, IdenticalRequestsAreCoalesced) {
+
+  QSignalSpy spy(&*loader_, &AlbumCoverLoader::AlbumCoverLoaded);
+  const quint64 id1 = LoadCover(OriginalImageOptions());
+  const quint64 id2 = LoadCover(OriginalImageOptions());
+  ASSERT_NE(id1, id2);
+
+  while (spy.count() < 2) {
+    ASSERT_TRUE(spy.wait(5000));
+  }
+
+  EXPECT_EQ(QSet<quint64>() << id1 << id2, EmittedIds(spy));
+  for (const QList<QVariant> &arguments : std::as_const(spy)) {
+    const AlbumCoverLoaderResult result = arguments.value(1).value<AlbumCoverLoaderResult>();
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(AlbumCoverLoaderResult::Type::Manual, result.type);
+    EXPECT_EQ(QSize(200, 200), result.album_cover.image.size());
+  }
+
+}
+
+TEST_F(AlbumCoverLoaderTest, CancelledQueuedRequestIsNotEmitted) {
+
+  QSignalSpy spy(&*loader_, &AlbumCoverLoader::AlbumCoverLoaded);
+  const quint64 id1 = LoadCover(OriginalImageOptions());
+  const quint64 id2 = LoadCover(OriginalImageOptions());
+  loader_->CancelTask(id2);
+
+  ASSERT_TRUE(spy.wait(5000));
+  EXPECT_FALSE(spy.wait(200));
+  EXPECT_EQ(QSet<quint64>() << id1, EmittedIds(spy));
+
+}
+
+TEST_F(AlbumCoverLoaderTest, CancelledRunningRequestIsNotEmitted) {
+
+  QSignalSpy spy(&*loader_, &AlbumCoverLoader::AlbumCoverLoaded);
+  const quint64 id1 = LoadCover(OriginalImageOptions());
+  const quint64 id2 = LoadCover(OriginalImageOptions());
+
+  // Start the task right away, its result can't be handled before the event loop runs again.
+  ASSERT_TRUE(QMetaObject::invokeMethod(&*loader_, "ProcessTasks", Qt::DirectConnection));
+  loader_->CancelTask(id2);
+
+  ASSERT_TRUE(spy.wait(5000));
+  EXPECT_FALSE(spy.wait(200));
+  EXPECT_EQ(QSet<quint64>() << id1, EmittedIds(spy));
+
+}
+
+TEST_F(AlbumCoverLoaderTest, NewRequestAfterCancelledRunningRequestIsEmitted) {
+
+  QSignalSpy spy(&*loader_, &AlbumCoverLoader::AlbumCoverLoaded);
+  const quint64 id1 = LoadCover(OriginalImageOptions());
+  ASSERT_TRUE(QMetaObject::invokeMethod(&*loader_, "ProcessTasks", Qt::DirectConnection));
+  loader_->CancelTask(id1);
+  const quint64 id2 = LoadCover(OriginalImageOptions());
+
+  ASSERT_TRUE(spy.wait(5000));
+  EXPECT_FALSE(spy.wait(200));
+  EXPECT_EQ(QSet<quint64>() << id2, EmittedIds(spy));
+
+}
+
+TEST_F(AlbumCoverLoaderTest, ScaledImageIsAddedToThumbnailStore) {
+
+  QSignalSpy spy(&*loader_, &AlbumCoverLoader::AlbumCoverLoaded);
+  LoadCover(AlbumCoverLoaderOptions(AlbumCoverLoaderOptions::Option::ScaledImage, QSize(64, 64), 1.0, AlbumCoverLoaderOptions::Types() << AlbumCoverLoaderOptions::Type::Manual));
+  ASSERT_TRUE(spy.wait(5000));
+
+  const AlbumCoverLoaderResult result = spy.first().value(1).value<AlbumCoverLoaderResult>();
+  EXPECT_TRUE(result.success);
+  EXPECT_EQ(QSize(64, 64), result.image_scaled.size());
+  EXPECT_TRUE(result.album_cover.image.isNull());
+
+  QFile file(cover_filename_);
+  ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+  const QByteArray hash = AlbumCoverThumbnailStore::ImageDataHash(file.readAll());
+  file.close();
+
+  // The thumbnail is also on disk, so a new store finds it.
+  AlbumCoverThumbnailStore thumbnail_store;
+  EXPECT_EQ(QSize(64, 64), thumbnail_store.Thumbnail(hash, 64).size());
+
+}
+
+}  // namespace
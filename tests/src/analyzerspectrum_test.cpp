@@ -0,0 +1,121 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+
+#include "gtest_include.h"
+
+#include <QSignalSpy>
+
+#include "engine/enginebase.h"
+#include "analyzer/analyzerspectrum.h"
+
+// clazy:excludeall=non-pod-global-static
+
+namespace {
+
+AnalyzerSpectrum::Scope ProcessScope(AnalyzerSpectrum &spectrum, const AnalyzerSpectrum::Options &options, const EngineBase::Scope &scope) {
+
+  QSignalSpy spy(&spectrum, &AnalyzerSpectrum::FrameReady);
+  EXPECT_TRUE(spectrum.Process(options, scope));
+  EXPECT_TRUE(spy.wait(5000));
+  return spectrum.frame();
+
+}
+
+TEST(AnalyzerSpectrumTest, WaveformIsMono) {
+
+  AnalyzerSpectrum spectrum;
+  AnalyzerSpectrum::Options options;
+  options.size_exp = 4;
+  options.transform = AnalyzerSpectrum::Transform::Waveform;
+
+  EngineBase::Scope scope(EngineBase::kScopeSize, 0);
+  for (size_t i = 0; i < scope.size(); i += 2) {
+    scope[i] = 16384;
+    scope[i + 1] = -16384 / 2;
+  }
+
+  const AnalyzerSpectrum::Scope frame = ProcessScope(spectrum, options, scope);
+  ASSERT_EQ(16U, frame.size());
+  for (const float sample : frame) {
+    EXPECT_FLOAT_EQ(0.125F, sample);
+  }
+
+}
+
+TEST(AnalyzerSpectrumTest, SpectrumPeak) {
+
+  AnalyzerSpectrum spectrum;
+  AnalyzerSpectrum::Options options;
+  options.size_exp = 8;
+  options.transform = AnalyzerSpectrum::Transform::Spectrum;
+  options.output_size = 128;
+
+  // A sine in the middle of bin 20 of a 256 point transform.
+  EngineBase::Scope scope(EngineBase::kScopeSize, 0);
+  for (size_t i = 0; i < scope.size() / 2; ++i) {
+    const double sample = 16384.0 * sin(2.0 * M_PI * 20.0 * static_cast<double>(i) / 256.0);
+    scope[i * 2] = static_cast<int16_t>(sample);
+    scope[i * 2 + 1] = static_cast<int16_t>(sample);
+  }
+
+  const AnalyzerSpectrum::Scope frame = ProcessScope(spectrum, options, scope);
+  ASSERT_EQ(128U, frame.size());
+  EXPECT_EQ(20, std::distance(frame.begin(), std::max_element(frame.begin(), frame.end())));
+
+  // The window keeps the leakage far from the peak low.
+  EXPECT_LT(frame[60], frame[20] / 1000.0F);
+
+}
+
+TEST(AnalyzerSpectrumTest, Bands) {
+
+  AnalyzerSpectrum spectrum;
+  AnalyzerSpectrum::Options options;
+  options.size_exp = 7;
+  options.transform = AnalyzerSpectrum::Transform::LogSpectrum;
+  options.output_size = 64;
+  options.bands = 23;
+
+  const AnalyzerSpectrum::Scope frame = ProcessScope(spectrum, options, EngineBase::Scope(EngineBase::kScopeSize, 0));
+  EXPECT_EQ(23U, frame.size());
+
+}
+
+TEST(AnalyzerSpectrumTest, Interpolate) {
+
+  const AnalyzerSpectrum::Scope in_scope = { 0.0F, 1.0F, 2.0F, 3.0F };
+
+  AnalyzerSpectrum::Scope same_scope(4);
+  AnalyzerSpectrum::Interpolate(in_scope, same_scope);
+  EXPECT_EQ(in_scope, same_scope);
+
+  AnalyzerSpectrum::Scope out_scope(8);
+  AnalyzerSpectrum::Interpolate(in_scope, out_scope);
+  EXPECT_FLOAT_EQ(0.0F, out_scope[0]);
+  EXPECT_FLOAT_EQ(0.5F, out_scope[1]);
+  EXPECT_FLOAT_EQ(1.5F, out_scope[3]);
+  EXPECT_FLOAT_EQ(3.0F, out_scope[7]);
+
+}
+
+}  // namespace
@@ -31,6 +31,7 @@
 #include "includes/scoped_ptr.h"
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "core/playstatistics.h"
 #include "core/memorydatabase.h"
 #include "constants/timeconstants.h"
 #include "collection/collectionbackend.h"
@@ -350,6 +351,40 @@ TEST_F(SingleSong, MarkSongsUnavailable) {
 
 }
 
+TEST_F(SingleSong, UpdatePlayStatistics) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  QSignalSpy statistics_spy(&*backend_, &CollectionBackend::SongsStatisticsChanged);
+
+  PlayStatisticsList statistics_list;
+  statistics_list << PlayStatistics(u"artist"_s, u"album"_s, u"title"_s, 1000);
+  statistics_list << PlayStatistics(u"Artist"_s, u"Album"_s, u"Title"_s, 2000);
+  statistics_list << PlayStatistics(u"Artist"_s, u"Other album"_s, u"Title"_s, 3000);
+  statistics_list << PlayStatistics(u"Artist"_s, QString(), u"Title"_s, -1, 5);
+  statistics_list << PlayStatistics(u"Other artist"_s, QString(), u"Title"_s, -1, 7);
+
+  backend_->UpdatePlayStatistics(statistics_list);
+
+  // All matching entries are applied together, with a single notification.
+  ASSERT_EQ(1, statistics_spy.size());
+  const SongList songs_changed = *(reinterpret_cast<SongList*>(statistics_spy[0][0].data()));
+  ASSERT_EQ(1, songs_changed.size());
+  EXPECT_EQ(1, songs_changed[0].id());
+  EXPECT_EQ(2000, songs_changed[0].lastplayed());
+  EXPECT_EQ(5, songs_changed[0].playcount());
+
+  const Song song = backend_->GetSongById(1);
+  EXPECT_EQ(2000, song.lastplayed());
+  EXPECT_EQ(5, song.playcount());
+
+  // Importing the same statistics again doesn't change anything.
+  backend_->UpdatePlayStatistics(statistics_list);
+  EXPECT_EQ(1, statistics_spy.size());
+
+}
+
 class TestUrls : public CollectionBackendTest {
  protected:
   void SetUp() override {
@@ -437,6 +472,22 @@ class UpdateSongsBySongID : public CollectionBackendTest {
     CollectionBackendTest::SetUp();
     backend_->AddDirectory(u"/mnt/music"_s);
   }
+
+  static Song MakeStreamingSong(const QString &song_id) {
+    Song song(Song::Source::Collection);
+    song.set_song_id(song_id);
+    song.set_directory_id(1);
+    song.set_title(u"Test Title "_s + song_id);
+    song.set_album(u"Test Album "_s + QString::number(qHash(song_id) % 5000));
+    song.set_artist(u"Test Artist "_s + QString::number(qHash(song_id) % 1000));
+    song.set_url(QUrl(u"file:///music/"_s + song_id));
+    song.set_length_nanosec(kNsecPerSec);
+    song.set_mtime(1);
+    song.set_ctime(1);
+    song.set_filesize(1);
+    song.set_valid(true);
+    return song;
+  }
 };
 
 TEST_F(UpdateSongsBySongID, UpdateSongsBySongID) {
@@ -475,10 +526,12 @@ TEST_F(UpdateSongsBySongID, UpdateSongsBySongID) {
     }
 
     QSignalSpy spy(&*backend_, &CollectionBackend::SongsAdded);
+    QSignalSpy spy_updated(&*backend_, &CollectionBackend::SongsBySongIDUpdated);
 
     backend_->UpdateSongsBySongID(songs);
 
     ASSERT_EQ(1, spy.count());
+    EXPECT_EQ(1, spy_updated.count());
     SongList new_songs = spy[0][0].value<SongList>();
     EXPECT_EQ(new_songs.count(), song_ids.count());
     EXPECT_EQ(song_ids[0], new_songs[0].song_id());
@@ -609,4 +662,45 @@ TEST_F(UpdateSongsBySongID, UpdateSongsBySongID) {
 
 }
 
+TEST_F(UpdateSongsBySongID, LargeUpdate) {
+
+  // Synthetic import of a large favorites collection.
+  constexpr int kSongCount = 50000;
+
+  SongMap songs;
+  for (int i = 0; i < kSongCount; ++i) {
+    const QString song_id = u"song"_s + QString::number(i);
+    songs.insert(song_id, MakeStreamingSong(song_id));
+  }
+
+  {  // Add all songs, the models should be reset once instead of being updated song by song.
+    QSignalSpy reset_spy(&*backend_, &CollectionBackend::DatabaseReset);
+    QSignalSpy added_spy(&*backend_, &CollectionBackend::SongsAdded);
+
+    backend_->UpdateSongsBySongID(songs);
+
+    EXPECT_EQ(1, reset_spy.count());
+    EXPECT_EQ(0, added_spy.count());
+    EXPECT_EQ(kSongCount, backend_->GetAllSongs().count());
+  }
+
+  {  // Sync again with a few changes, these are sent as an update.
+    songs[u"song1"_s].set_artist(u"New artist"_s);
+    songs.remove(u"song2"_s);
+
+    QSignalSpy reset_spy(&*backend_, &CollectionBackend::DatabaseReset);
+    QSignalSpy changed_spy(&*backend_, &CollectionBackend::SongsChanged);
+    QSignalSpy deleted_spy(&*backend_, &CollectionBackend::SongsDeleted);
+
+    backend_->UpdateSongsBySongID(songs);
+
+    EXPECT_EQ(0, reset_spy.count());
+    ASSERT_EQ(1, changed_spy.count());
+    EXPECT_EQ(1, changed_spy[0][0].value<SongList>().count());
+    ASSERT_EQ(1, deleted_spy.count());
+    EXPECT_EQ(u"song2"_s, deleted_spy[0][0].value<SongList>().first().song_id());
+  }
+
+}
+
 } // namespace
@@ -0,0 +1,171 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QFile>
+#include <QDir>
+#include <QString>
+#include <QUrl>
+#include <QSize>
+#include <QTemporaryDir>
+
+#include "includes/scoped_ptr.h"
+#include "core/standardpaths.h"
+#include "covermanager/albumcoverfetcher.h"
+#include "covermanager/albumcoverfetchersearch.h"
+#include "covermanager/coversearchcache.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+class CoverSearchCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    qputenv("XDG_CACHE_HOME", cache_directory_.path().toLocal8Bit());
+    QDir().mkpath(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation));
+    filename_ = StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + "/coversearch.cache"_L1;
+    cache_.reset(new CoverSearchCache);
+  }
+
+  static CoverProviderSearchResult Result(const QString &provider) {
+    CoverProviderSearchResult result;
+    result.provider = provider;
+    result.artist = u"Artist"_s;
+    result.album = u"Album"_s;
+    result.image_url = QUrl(u"https://example.com/cover.jpg"_s);
+    result.image_size = QSize(600, 600);
+    result.score_match = 1.0;
+    return result;
+  }
+
+  QTemporaryDir cache_directory_;
+  QString filename_;
+  ScopedPtr<CoverSearchCache> cache_;
+};
+
+TEST_F(CoverSearchCacheTest, AddAndRemoveResult) {
+
+  CoverProviderSearchResult result;
+  EXPECT_FALSE(cache_->Result(u"artist\nalbum"_s, &result));
+
+  cache_->AddResult(u"artist\nalbum"_s, Result(u"Provider"_s));
+  ASSERT_TRUE(cache_->Result(u"artist\nalbum"_s, &result));
+  EXPECT_EQ(QUrl(u"https://example.com/cover.jpg"_s), result.image_url);
+  EXPECT_EQ(u"Provider"_s, result.provider);
+  EXPECT_EQ(1U, cache_->provider_statistics(u"Provider"_s).chosen_images);
+
+  cache_->RemoveResult(u"artist\nalbum"_s);
+  EXPECT_FALSE(cache_->Result(u"artist\nalbum"_s, &result));
+
+  cache_->AddMissing(u"artist\nalbum"_s);
+  ASSERT_TRUE(cache_->Result(u"artist\nalbum"_s, &result));
+  EXPECT_TRUE(result.image_url.isEmpty());
+
+}
+
+TEST_F(CoverSearchCacheTest, WriteAndRead) {
+
+  cache_->AddResult(u"artist\nalbum"_s, Result(u"Provider"_s));
+  cache_->AddMissing(u"artist\nmissing"_s);
+  cache_->AddProviderSearch(u"Provider"_s, 100, true);
+  cache_->WriteCache();
+  cache_.reset();
+
+  CoverSearchCache cache;
+  CoverProviderSearchResult result;
+  ASSERT_TRUE(cache.Result(u"artist\nalbum"_s, &result));
+  EXPECT_EQ(QUrl(u"https://example.com/cover.jpg"_s), result.image_url);
+  EXPECT_EQ(QSize(600, 600), result.image_size);
+  ASSERT_TRUE(cache.Result(u"artist\nmissing"_s, &result));
+  EXPECT_TRUE(result.image_url.isEmpty());
+
+  const CoverSearchCache::ProviderStatistics statistics = cache.provider_statistics(u"Provider"_s);
+  EXPECT_EQ(1U, statistics.searches);
+  EXPECT_EQ(1U, statistics.successful_searches);
+  EXPECT_EQ(1U, statistics.chosen_images);
+  EXPECT_DOUBLE_EQ(100.0, statistics.average_latency_msec);
+
+}
+
+TEST_F(CoverSearchCacheTest, WritesOnlyWhenChanged) {
+
+  cache_->AddMissing(u"artist\nalbum"_s);
+  cache_->WriteCache();
+  ASSERT_TRUE(QFile::exists(filename_));
+
+  ASSERT_TRUE(QFile::remove(filename_));
+  cache_->WriteCache();
+  EXPECT_FALSE(QFile::exists(filename_));
+
+  cache_->AddProviderSearch(u"Provider"_s, 100, false);
+  cache_->WriteCache();
+  EXPECT_TRUE(QFile::exists(filename_));
+
+}
+
+TEST_F(CoverSearchCacheTest, ProviderRank) {
+
+  for (int i = 0; i < 4; ++i) {
+    cache_->AddProviderSearch(u"Good"_s, 100, true);
+    cache_->AddProviderSearch(u"Bad"_s, 100, false);
+    cache_->AddResult(u"artist\nalbum%1"_s.arg(i), Result(u"Good"_s));
+  }
+
+  // Providers without statistics start in the middle.
+  EXPECT_DOUBLE_EQ(0.5, cache_->ProviderRank(u"New"_s));
+  EXPECT_GT(cache_->ProviderRank(u"Good"_s), cache_->ProviderRank(u"New"_s));
+  EXPECT_LT(cache_->ProviderRank(u"Bad"_s), cache_->ProviderRank(u"New"_s));
+
+}
+
+TEST_F(CoverSearchCacheTest, ExploreProviders) {
+
+  int explored = 0;
+  for (int i = 0; i < 30; ++i) {
+    if (cache_->ExploreProviders()) ++explored;
+  }
+  EXPECT_EQ(3, explored);
+
+}
+
+TEST(AlbumCoverFetcherSearchTest, IsGoodMatch) {
+
+  CoverProviderSearchResult result;
+  result.score_match = 1.0;
+  result.score_quality = 2.0;
+
+  // Unknown size.
+  EXPECT_FALSE(AlbumCoverFetcherSearch::IsGoodMatch(result));
+
+  result.image_size = QSize(300, 300);
+  EXPECT_FALSE(AlbumCoverFetcherSearch::IsGoodMatch(result));
+
+  result.image_size = QSize(600, 600);
+  EXPECT_TRUE(AlbumCoverFetcherSearch::IsGoodMatch(result));
+
+  result.score_match = 0.5;
+  EXPECT_FALSE(AlbumCoverFetcherSearch::IsGoodMatch(result));
+
+}
+
+}  // namespace
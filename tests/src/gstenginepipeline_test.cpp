@@ -0,0 +1,228 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include <gst/gst.h>
+
+#include "gtest_include.h"
+
+#include <QtGlobal>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QIODevice>
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QUrl>
+
+#include "test_utils.h"
+#include "includes/scoped_ptr.h"
+#include "constants/timeconstants.h"
+#include "engine/gstenginepipeline.h"
+
+// clazy:excludeall=non-pod-global-static
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+constexpr char kTestFile[] = ":/audio/strawberry.wav";
+constexpr qint64 kRenderTimeoutMsec = 30000;
+
+// Reads the samples of a 16-bit PCM wav file, scaled to -1.0..1.0 like audioconvert does.
+QList<float> ReadWavSamples(const QString &filename) {
+
+  QFile file(filename);
+  if (!file.open(QIODevice::ReadOnly)) return QList<float>();
+  const QByteArray data = file.readAll();
+  file.close();
+
+  qsizetype pos = 12;
+  while (pos + 8 <= data.size()) {
+    const QByteArray chunk_id = data.mid(pos, 4);
+    quint32 chunk_size = 0;
+    memcpy(&chunk_size, data.constData() + pos + 4, sizeof(chunk_size));
+    pos += 8;
+    if (chunk_id == "data") {
+      QList<float> samples;
+      const qsizetype count = qMin(static_cast<qsizetype>(chunk_size), data.size() - pos) / static_cast<qsizetype>(sizeof(qint16));
+      samples.reserve(count);
+      for (qsizetype i = 0; i < count; ++i) {
+        qint16 sample = 0;
+        memcpy(&sample, data.constData() + pos + (i * static_cast<qsizetype>(sizeof(qint16))), sizeof(sample));
+        samples << static_cast<float>(sample) / 32768.0F;
+      }
+      return samples;
+    }
+    pos += chunk_size + (chunk_size % 2);
+  }
+
+  return QList<float>();
+
+}
+
+QList<float> ToFloatSamples(const QByteArray &data) {
+
+  QList<float> samples(data.size() / static_cast<qsizetype>(sizeof(float)));
+  memcpy(samples.data(), data.constData(), static_cast<size_t>(samples.size()) * sizeof(float));
+  return samples;
+
+}
+
+class GstEnginePipelineOfflineRenderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    gst_init(nullptr, nullptr);
+    input_.reset(new TemporaryResource(QLatin1String(kTestFile)));
+    reference_ = ReadWavSamples(QLatin1String(kTestFile));
+    ASSERT_FALSE(reference_.isEmpty());
+    pipeline_.reset(new GstEnginePipeline);
+    pipeline_->set_offline_render(true);
+    pipeline_->set_volume_enabled(false);
+  }
+
+  void TearDown() override {
+    pipeline_.reset();
+    input_.reset();
+  }
+
+  bool Init(const double ebur128_loudness_normalizing_gain_db = 0.0) {
+    const QUrl url = QUrl::fromLocalFile(input_->fileName());
+    QString error;
+    const bool success = pipeline_->InitFromUrl(url, url, url.toEncoded(), 0, 0, ebur128_loudness_normalizing_gain_db, error);
+    EXPECT_TRUE(success) << error.toStdString();
+    return success;
+  }
+
+  // Plays the pipeline until the appsink got end of stream, and returns the rendered samples.
+  QList<float> Render() {
+    QElapsedTimer timer;
+    timer.start();
+    (void)pipeline_->Play(false, 0);
+    while (!pipeline_->offline_render_finished() && timer.elapsed() < kRenderTimeoutMsec) {
+      QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    EXPECT_TRUE(pipeline_->offline_render_finished());
+    elapsed_msec_ = qMax(1LL, timer.elapsed());
+    return ToFloatSamples(pipeline_->offline_render_data());
+  }
+
+  ScopedPtr<TemporaryResource> input_;
+  QList<float> reference_;
+  ScopedPtr<GstEnginePipeline> pipeline_;
+  qint64 elapsed_msec_ = 0;
+};
+
+TEST_F(GstEnginePipelineOfflineRenderTest, BypassMatchesInput) {
+
+  ASSERT_TRUE(Init());
+  const QList<float> samples = Render();
+
+  // Without any processing enabled the audiobin only converts the samples to float.
+  ASSERT_EQ(reference_.size(), samples.size());
+  for (qsizetype i = 0; i < samples.size(); ++i) {
+    ASSERT_NEAR(reference_[i], samples[i], 1e-6) << "at sample " << i;
+  }
+
+  // The whole file should be rendered much faster than it plays.
+  const double realtime_multiple = static_cast<double>(pipeline_->offline_rendered_nanosec() / kNsecPerMsec) / static_cast<double>(elapsed_msec_);
+  RecordProperty("realtime_multiple", QString::number(realtime_multiple, 'f', 1).toStdString());
+  EXPECT_GT(realtime_multiple, 1.0);
+
+}
+
+TEST_F(GstEnginePipelineOfflineRenderTest, EqualizerPreamp) {
+
+  pipeline_->set_equalizer_enabled(true);
+  ASSERT_TRUE(Init());
+  // Flat bands leave the equalizer in passthrough, a preamp of -50 scales the signal by 0.5.
+  pipeline_->SetEqualizerParams(-50, QList<int>(10, 0));
+  const QList<float> samples = Render();
+
+  ASSERT_EQ(reference_.size(), samples.size());
+  for (qsizetype i = 0; i < samples.size(); ++i) {
+    ASSERT_NEAR(reference_[i] * 0.5F, samples[i], 1e-5) << "at sample " << i;
+  }
+
+}
+
+TEST_F(GstEnginePipelineOfflineRenderTest, SparePipelineAppliesLoudnessGain) {
+
+  pipeline_->set_ebur128_loudness_normalization(true);
+
+  // Build the pipeline up front like GstEngine does for a spare, before the track and its gain are known.
+  QString error;
+  ASSERT_TRUE(pipeline_->InitPipeline(error)) << error.toStdString();
+  ASSERT_TRUE(Init(20.0 * std::log10(0.5)));
+  const QList<float> samples = Render();
+
+  ASSERT_EQ(reference_.size(), samples.size());
+  for (qsizetype i = 0; i < samples.size(); ++i) {
+    ASSERT_NEAR(reference_[i] * 0.5F, samples[i], 1e-5) << "at sample " << i;
+  }
+
+}
+
+TEST_F(GstEnginePipelineOfflineRenderTest, StereoBalanceLeft) {
+
+  pipeline_->set_stereo_balancer_enabled(true);
+  ASSERT_TRUE(Init());
+  pipeline_->SetStereoBalance(-1.0F);
+  const QList<float> samples = Render();
+
+  // The panorama element makes the mono input stereo, fully to the left the right channel is silent.
+  ASSERT_EQ(reference_.size() * 2, samples.size());
+  float left_peak = 0.0F;
+  for (qsizetype i = 0; i < samples.size(); i += 2) {
+    left_peak = qMax(left_peak, std::fabs(samples[i]));
+    ASSERT_NEAR(0.0F, samples[i + 1], 1e-6) << "at frame " << i / 2;
+  }
+  EXPECT_GT(left_peak, 0.1F);
+
+}
+
+TEST(GstEnginePipelineTest, ALSAHardwareDeviceIsDirect) {
+
+  gst_init(nullptr, nullptr);
+  GstElementFactory *factory = gst_element_factory_find("alsasink");
+  if (!factory) {
+    GTEST_SKIP() << "alsasink is not available";
+  }
+  gst_object_unref(factory);
+
+  // Building the pipeline only creates the sink, the device is not opened until the pipeline leaves NULL.
+  GstEnginePipeline hardware_pipeline;
+  hardware_pipeline.set_output_device(u"alsasink"_s, u"hw:0,0"_s);
+  QString error;
+  ASSERT_TRUE(hardware_pipeline.InitPipeline(error)) << error.toStdString();
+  EXPECT_TRUE(hardware_pipeline.direct_device());
+  EXPECT_EQ(GST_STATE_NULL, hardware_pipeline.state());
+
+  GstEnginePipeline default_pipeline;
+  default_pipeline.set_output_device(u"alsasink"_s, QByteArray("default"));
+  ASSERT_TRUE(default_pipeline.InitPipeline(error)) << error.toStdString();
+  EXPECT_FALSE(default_pipeline.direct_device());
+
+}
+
+}  // namespace
@@ -0,0 +1,153 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include <gst/gst.h>
+#include <gst/app/gstappsink.h>
+
+#include "gtest_include.h"
+
+#include <QList>
+#include <QEasingCurve>
+
+#include "constants/timeconstants.h"
+#include "engine/gstvolumefader.h"
+
+// clazy:excludeall=non-pod-global-static
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+
+class GstVolumeFaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    gst_init(nullptr, nullptr);
+    // A full scale square wave, so the absolute value of each output sample is the gain applied to it. One second is rendered.
+    pipeline_ = gst_parse_launch("audiotestsrc wave=square freq=100 volume=1.0 samplesperbuffer=441 num-buffers=100 ! audio/x-raw,format=F32LE,rate=44100,channels=1 ! volume name=volume ! appsink name=sink sync=false", nullptr);
+    ASSERT_NE(pipeline_, nullptr);
+    volume_ = gst_bin_get_by_name(GST_BIN(pipeline_), "volume");
+    sink_ = gst_bin_get_by_name(GST_BIN(pipeline_), "sink");
+    ASSERT_NE(volume_, nullptr);
+    ASSERT_NE(sink_, nullptr);
+  }
+
+  void TearDown() override {
+    if (sink_) gst_object_unref(sink_);
+    if (volume_) gst_object_unref(volume_);
+    if (pipeline_) gst_object_unref(pipeline_);
+  }
+
+  // Renders the pipeline offline, and returns the gain of each sample.
+  QList<float> Render() {
+    QList<float> gains;
+    gains.reserve(kSampleRate);
+    gst_element_set_state(pipeline_, GST_STATE_PLAYING);
+    while (GstSample *sample = gst_app_sink_pull_sample(GST_APP_SINK(sink_))) {
+      GstBuffer *buffer = gst_sample_get_buffer(sample);
+      GstMapInfo map_info;
+      if (gst_buffer_map(buffer, &map_info, GST_MAP_READ)) {
+        const float *data = reinterpret_cast<const float*>(map_info.data);
+        for (gsize i = 0; i < map_info.size / sizeof(float); ++i) {
+          gains << std::abs(data[i]);
+        }
+        gst_buffer_unmap(buffer, &map_info);
+      }
+      gst_sample_unref(sample);
+    }
+    gst_element_set_state(pipeline_, GST_STATE_NULL);
+    return gains;
+  }
+
+  GstElement *pipeline_ = nullptr;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  GstElement *volume_ = nullptr;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  GstElement *sink_ = nullptr;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(GstVolumeFaderTest, LinearFadeIn) {
+
+  GstVolumeFader fader(volume_);
+  fader.SetVolume(0.0);
+  fader.SetCurve(0, kNsecPerSec, 0.0, 1.0, QEasingCurve(QEasingCurve::Linear));
+
+  const QList<float> gains = Render();
+  ASSERT_EQ(gains.count(), kSampleRate);
+
+  // The gain ramps with every sample, not in steps.
+  double max_error = 0.0;
+  for (qsizetype i = 0; i < gains.count(); ++i) {
+    max_error = std::max(max_error, std::abs(static_cast<double>(gains[i]) - (static_cast<double>(i) / kSampleRate)));
+  }
+  EXPECT_LT(max_error, 1e-4);
+  EXPECT_GT(gains[1], gains[0]);
+
+}
+
+TEST_F(GstVolumeFaderTest, Crossfade) {
+
+  const QEasingCurve easing_curve(QEasingCurve::InOutQuad);
+
+  QList<float> gains_out;
+  {
+    GstVolumeFader fader(volume_);
+    fader.SetCurve(0, kNsecPerSec, 1.0, 0.0, easing_curve);
+    gains_out = Render();
+    fader.SetVolume(1.0);
+  }
+
+  QList<float> gains_in;
+  {
+    GstVolumeFader fader(volume_);
+    fader.SetCurve(0, kNsecPerSec, 0.0, 1.0, easing_curve);
+    gains_in = Render();
+    fader.SetVolume(1.0);
+  }
+
+  ASSERT_EQ(gains_out.count(), kSampleRate);
+  ASSERT_EQ(gains_in.count(), kSampleRate);
+
+  // The curves follow the easing curve, and the two tracks always add up to full volume.
+  EXPECT_NEAR(gains_in[kSampleRate / 4], easing_curve.valueForProgress(0.25), 1e-3);
+  EXPECT_NEAR(gains_out[kSampleRate / 4], easing_curve.valueForProgress(0.75), 1e-3);
+  double max_error = 0.0;
+  for (qsizetype i = 0; i < kSampleRate; ++i) {
+    max_error = std::max(max_error, std::abs(static_cast<double>(gains_out[i] + gains_in[i]) - 1.0));
+  }
+  EXPECT_LT(max_error, 1e-3);
+
+}
+
+TEST_F(GstVolumeFaderTest, SetVolumeRemovesCurve) {
+
+  GstVolumeFader fader(volume_);
+  fader.SetCurve(0, kNsecPerSec, 1.0, 0.0, QEasingCurve(QEasingCurve::Linear));
+  EXPECT_TRUE(fader.active());
+  fader.SetVolume(0.5);
+  EXPECT_FALSE(fader.active());
+
+  const QList<float> gains = Render();
+  ASSERT_EQ(gains.count(), kSampleRate);
+  EXPECT_FLOAT_EQ(gains.first(), 0.5F);
+  EXPECT_FLOAT_EQ(gains.last(), 0.5F);
+
+}
+
+}  // namespace
@@ -26,6 +26,7 @@
 #include <QMap>
 #include <QByteArray>
 #include <QString>
+#include <QMetaObject>
 #include <QIODevice>
 #include <QNetworkRequest>
 #include <QUrlQuery>
@@ -33,6 +34,8 @@
 
 using std::min;
 
+using ::testing::DoAll;
+using ::testing::InvokeWithoutArgs;
 using ::testing::MakeMatcher;
 using ::testing::Matcher;
 using ::testing::MatcherInterface;
@@ -94,6 +97,17 @@ MockNetworkReply *MockNetworkAccessManager::ExpectGet(const QString &contains, c
 
 }
 
+MockNetworkReply *MockNetworkAccessManager::ExpectGetAndFinish(const QString &contains, const QMap<QString, QString> &expected_params, int status, const QByteArray &data) {
+
+  MockNetworkReply *reply = new MockNetworkReply(data);
+  reply->setAttribute(QNetworkRequest::HttpStatusCodeAttribute, status);
+
+  EXPECT_CALL(*this, createRequest(GetOperation, RequestForUrl(contains, expected_params), nullptr)).WillOnce(DoAll(InvokeWithoutArgs([reply]() { QMetaObject::invokeMethod(reply, &MockNetworkReply::Done, Qt::QueuedConnection); }), Return(reply)));
+
+  return reply;
+
+}
+
 MockNetworkReply::MockNetworkReply(QObject *parent)
     : QNetworkReply(parent), data_(nullptr), pos_(0) {
 }
@@ -69,6 +69,12 @@ class MockNetworkAccessManager : public QNetworkAccessManager {
       const QMap<QString, QString>& params,  // Required URL parameters.
       int status,  // Returned HTTP status code.
       const QByteArray &ret_data);  // Returned data.
+  // Like ExpectGet(), but the reply finishes by itself when control returns to the event loop after it was requested.
+  MockNetworkReply* ExpectGetAndFinish(
+      const QString& contains,
+      const QMap<QString, QString>& params,
+      int status,
+      const QByteArray &ret_data);
  protected:
   MOCK_METHOD3(createRequest, QNetworkReply*(Operation, const QNetworkRequest&, QIODevice*));  // clazy:exclude=function-args-by-value
 };
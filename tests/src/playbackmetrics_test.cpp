@@ -0,0 +1,87 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QJsonObject>
+
+#include "constants/timeconstants.h"
+#include "engine/playbackmetrics.h"
+
+// clazy:excludeall=non-pod-global-static
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+TEST(PlaybackMetricsTest, Distributions) {
+
+  PlaybackMetrics metrics;
+  metrics.AddTimeToFirstAudio(300, false);
+  metrics.AddTimeToFirstAudio(100, true);
+  metrics.AddTimeToFirstAudio(200, false);
+
+  const QJsonObject json_obj = metrics.ToJson()["time_to_first_audio_msec"_L1].toObject();
+  EXPECT_EQ(3, json_obj["count"_L1].toInteger());
+  EXPECT_EQ(100, json_obj["min"_L1].toInteger());
+  EXPECT_EQ(300, json_obj["max"_L1].toInteger());
+  EXPECT_EQ(200, json_obj["last"_L1].toInteger());
+  EXPECT_DOUBLE_EQ(200.0, json_obj["average"_L1].toDouble());
+
+  const QJsonObject json_obj_spare = metrics.ToJson()["time_to_first_audio_spare_pipeline_msec"_L1].toObject();
+  EXPECT_EQ(1, json_obj_spare["count"_L1].toInteger());
+  EXPECT_EQ(100, json_obj_spare["last"_L1].toInteger());
+
+}
+
+TEST(PlaybackMetricsTest, BufferFillLevelWatermarks) {
+
+  PlaybackMetrics metrics;
+  metrics.AddBufferFillLevel(5, 0.1, 0.99);
+  metrics.AddBufferFillLevel(50, 0.1, 0.99);
+  metrics.AddBufferFillLevel(100, 0.1, 0.99);
+
+  const QJsonObject json_obj = metrics.ToJson()["buffer_fill_level_percent"_L1].toObject();
+  EXPECT_EQ(3, json_obj["count"_L1].toInteger());
+  EXPECT_EQ(1, json_obj["below_low_watermark"_L1].toInteger());
+  EXPECT_EQ(1, json_obj["above_high_watermark"_L1].toInteger());
+
+}
+
+TEST(PlaybackMetricsTest, DecoderLoadAndReset) {
+
+  PlaybackMetrics metrics;
+  metrics.AddDecoderTime(50 * kNsecPerMsec, 1000 * kNsecPerMsec);
+  metrics.AddDecoderTime(50 * kNsecPerMsec, 1000 * kNsecPerMsec);
+  metrics.AddSinkXrun(441);
+
+  QJsonObject json_obj = metrics.ToJson();
+  EXPECT_DOUBLE_EQ(0.05, json_obj["decoder"_L1].toObject()["cpu_load"_L1].toDouble());
+  EXPECT_EQ(100, json_obj["decoder"_L1].toObject()["cpu_msec"_L1].toInteger());
+  EXPECT_EQ(1, json_obj["sink"_L1].toObject()["xruns"_L1].toInteger());
+  EXPECT_EQ(441, json_obj["sink"_L1].toObject()["dropped"_L1].toInteger());
+
+  metrics.Reset();
+  json_obj = metrics.ToJson();
+  EXPECT_EQ(0, json_obj["sink"_L1].toObject()["xruns"_L1].toInteger());
+  EXPECT_EQ(0, json_obj["time_to_first_audio_msec"_L1].toObject()["count"_L1].toInteger());
+
+}
+
+}  // namespace
@@ -25,14 +25,25 @@
 
 #include "test_utils.h"
 
+#include "includes/shared_ptr.h"
+#include "core/database.h"
 #include "collection/collectionplaylistitem.h"
 #include "playlist/playlist.h"
+#include "playlist/playlistbackend.h"
+#include "playlist/playlistfilter.h"
+#include "playlist/playlistundocommandmoveitems.h"
 #include "mock_settingsprovider.h"
 #include "mock_playlistitem.h"
 
 #include <QtDebug>
 #include <QUndoStack>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QSignalSpy>
 
+using std::make_shared;
 using ::testing::Return;
 
 using namespace Qt::Literals::StringLiterals;
@@ -474,6 +485,150 @@ TEST_F(PlaylistTest, ShuffleThenNext) {
 
 }
 
+TEST_F(PlaylistTest, NextSkipsUnplayableTracks) {
+
+  PlaylistItemPtrList items;
+  for (int i = 0; i < 200; ++i) {
+    items << MakeMockItemP(u"Item "_s + QString::number(i));
+  }
+  playlist_.InsertItems(items);
+
+  // Skip everything between the first and the last track
+  QModelIndexList skipped;
+  for (int i = 1; i < 199; ++i) {
+    skipped << playlist_.index(i, 0);
+  }
+  playlist_.SkipTracks(skipped);
+
+  playlist_.set_current_row(0);
+  EXPECT_EQ(199, playlist_.next_row());
+
+  playlist_.set_current_row(199);
+  EXPECT_EQ(-1, playlist_.next_row());
+  EXPECT_EQ(0, playlist_.previous_row());
+
+  // Unskipping a track makes it playable again
+  playlist_.SkipTracks(QModelIndexList() << playlist_.index(100, 0));
+  playlist_.set_current_row(0);
+  EXPECT_EQ(100, playlist_.next_row());
+
+}
+
+TEST_F(PlaylistTest, PlayableTracksFollowInsertRemoveAndMove) {
+
+  PlaylistItemPtrList items;
+  for (int i = 0; i < 200; ++i) {
+    items << MakeMockItemP(u"Item "_s + QString::number(i));
+  }
+  playlist_.InsertItems(items);
+
+  QModelIndexList skipped;
+  for (int i = 1; i < 199; ++i) {
+    skipped << playlist_.index(i, 0);
+  }
+  playlist_.SkipTracks(skipped);
+
+  playlist_.set_current_row(0);
+  EXPECT_EQ(199, playlist_.next_row());
+
+  // Inserted tracks are playable, the tracks after them move down
+  PlaylistItemPtrList inserted_items;
+  for (int i = 0; i < 10; ++i) {
+    inserted_items << MakeMockItemP(u"Inserted "_s + QString::number(i));
+  }
+  playlist_.InsertItems(inserted_items, 50);
+  ASSERT_EQ(210, playlist_.rowCount(QModelIndex()));
+  EXPECT_EQ(50, playlist_.next_row());
+  playlist_.set_current_row(59);
+  EXPECT_EQ(209, playlist_.next_row());
+
+  playlist_.removeRows(50, 10);
+  ASSERT_EQ(200, playlist_.rowCount(QModelIndex()));
+  playlist_.set_current_row(0);
+  EXPECT_EQ(199, playlist_.next_row());
+
+  // A moved track keeps its state
+  playlist_.undo_stack()->push(new PlaylistUndoCommandMoveItems(&playlist_, QList<int>() << 199, 10));
+  EXPECT_EQ(u"Item 199"_s, playlist_.item_at(10)->EffectiveMetadata().title());
+  EXPECT_EQ(10, playlist_.next_row());
+
+  playlist_.undo_stack()->undo();
+  EXPECT_EQ(u"Item 199"_s, playlist_.item_at(199)->EffectiveMetadata().title());
+  EXPECT_EQ(199, playlist_.next_row());
+
+}
+
+TEST_F(PlaylistTest, PlayableTracksFollowFilter) {
+
+  PlaylistItemPtrList items;
+  for (int i = 0; i < 200; ++i) {
+    items << MakeMockItemP((i == 70 || i == 150 ? u"Bonus "_s : u"Item "_s) + QString::number(i));
+  }
+  playlist_.InsertItems(items);
+
+  playlist_.set_current_row(0);
+  EXPECT_EQ(1, playlist_.next_row());
+
+  playlist_.filter()->SetFilterString(u"bonus"_s);
+  EXPECT_EQ(70, playlist_.next_row());
+  playlist_.set_current_row(70);
+  EXPECT_EQ(150, playlist_.next_row());
+
+  playlist_.filter()->SetFilterString(QString());
+  EXPECT_EQ(71, playlist_.next_row());
+
+}
+
+TEST_F(PlaylistTest, ShuffleWithSeed) {
+
+  Playlist other_playlist(nullptr, nullptr, nullptr, nullptr, nullptr, 2);
+  PlaylistSequence other_sequence(nullptr, new DummySettingsProvider);
+  other_playlist.set_sequence(&other_sequence);
+
+  for (Playlist *playlist : {&playlist_, &other_playlist}) {
+    PlaylistItemPtrList items;
+    for (int i = 0; i < 100; ++i) {
+      items << MakeMockItemP(u"Item "_s + QString::number(i));
+    }
+    playlist->InsertItems(items);
+    playlist->SetShuffleSeed(1234);
+    playlist->Shuffle();
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(playlist_.item_at(i)->EffectiveMetadata().title(), other_playlist.item_at(i)->EffectiveMetadata().title());
+  }
+
+}
+
+TEST_F(PlaylistTest, SortByColumns) {
+
+  playlist_.InsertItems(PlaylistItemPtrList()
+                        << MakeMockItemP(u"One"_s, u"Beta"_s, QString(), 200)
+                        << MakeMockItemP(u"Two"_s, u"alpha"_s, QString(), 100)
+                        << MakeMockItemP(u"Three"_s, u"Beta"_s, QString(), 100)
+                        << MakeMockItemP(u"Four"_s, u"Alpha"_s, QString(), 300));
+  ASSERT_EQ(4, playlist_.rowCount(QModelIndex()));
+
+  // Artist ascending ignoring case, then title descending
+  playlist_.SortByColumns(Playlist::SortColumns() << qMakePair(Playlist::Column::Artist, Qt::AscendingOrder) << qMakePair(Playlist::Column::Title, Qt::DescendingOrder));
+  EXPECT_EQ(u"Two"_s, playlist_.item_at(0)->EffectiveMetadata().title());
+  EXPECT_EQ(u"Four"_s, playlist_.item_at(1)->EffectiveMetadata().title());
+  EXPECT_EQ(u"Three"_s, playlist_.item_at(2)->EffectiveMetadata().title());
+  EXPECT_EQ(u"One"_s, playlist_.item_at(3)->EffectiveMetadata().title());
+
+  // Sorting is stable, so items with the same length keep their order
+  playlist_.sort(static_cast<int>(Playlist::Column::Length), Qt::AscendingOrder);
+  EXPECT_EQ(u"Two"_s, playlist_.item_at(0)->EffectiveMetadata().title());
+  EXPECT_EQ(u"Three"_s, playlist_.item_at(1)->EffectiveMetadata().title());
+  EXPECT_EQ(u"One"_s, playlist_.item_at(2)->EffectiveMetadata().title());
+  EXPECT_EQ(u"Four"_s, playlist_.item_at(3)->EffectiveMetadata().title());
+
+  playlist_.undo_stack()->undo();
+  EXPECT_EQ(u"Four"_s, playlist_.item_at(1)->EffectiveMetadata().title());
+
+}
+
 TEST_F(PlaylistTest, CollectionIdMapSingle) {
 
   Song song(Song::Source::Collection);
@@ -543,5 +698,134 @@ TEST_F(PlaylistTest, CollectionIdMapMulti) {
 
 }
 
+TEST_F(PlaylistTest, RemoveDeletedSongs) {
+
+  QTemporaryDir temp_dir;
+  ASSERT_TRUE(temp_dir.isValid());
+
+  auto make_item = [&temp_dir](const QString &title, const bool exists) {
+    const QString filename = temp_dir.filePath(title);
+    if (exists) {
+      QFile file(filename);
+      EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+    }
+    Song song(Song::Source::Collection);
+    song.Init(title, u"artist"_s, u"album"_s, 123);
+    song.set_url(QUrl::fromLocalFile(filename));
+    return PlaylistItemPtr(std::make_shared<CollectionPlaylistItem>(song));
+  };
+
+  playlist_.InsertItems(PlaylistItemPtrList() << make_item(u"one"_s, true) << make_item(u"two"_s, false) << make_item(u"three"_s, true));
+  ASSERT_EQ(3, playlist_.rowCount(QModelIndex()));
+
+  playlist_.RemoveDeletedSongs();
+
+  // Rows inserted while the files are checked move the checked items down.
+  playlist_.InsertItems(PlaylistItemPtrList() << MakeMockItemP(u"stream"_s), 0);
+
+  QElapsedTimer timer;
+  timer.start();
+  while (playlist_.rowCount(QModelIndex()) > 3 && timer.elapsed() < 10000) {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+  }
+
+  ASSERT_EQ(3, playlist_.rowCount(QModelIndex()));
+  EXPECT_EQ(u"stream"_s, playlist_.item_at(0)->EffectiveMetadata().title());
+  EXPECT_EQ(u"one"_s, playlist_.item_at(1)->EffectiveMetadata().title());
+  EXPECT_EQ(u"three"_s, playlist_.item_at(2)->EffectiveMetadata().title());
+
+}
+
+class PlaylistRestoreTest : public ::testing::Test {
+ protected:
+  // More than the first page and more than the undo stack can keep.
+  static constexpr int kItemCount = 700;
+
+  PlaylistRestoreTest() : sequence_(nullptr, new DummySettingsProvider) {}
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.isValid());
+    database_ = make_shared<Database>(nullptr, nullptr, temp_dir_.filePath(u"strawberry.db"_s));
+    playlist_backend_ = make_shared<PlaylistBackend>(database_, nullptr, nullptr);
+    const int id = playlist_backend_->CreatePlaylist(u"Test"_s, QString());
+
+    PlaylistItemPtrList items;
+    for (int i = 0; i < kItemCount; ++i) {
+      Song song(Song::Source::Stream);
+      song.Init(u"Song %1"_s.arg(i), u"artist"_s, u"album"_s, 123);
+      song.set_url(QUrl(u"http://example.com/%1.mp3"_s.arg(i)));
+      items << PlaylistItem::NewFromSong(song);
+    }
+    playlist_backend_->SavePlaylist(id, items, -1, nullptr);
+
+    playlist_ = make_shared<Playlist>(nullptr, nullptr, playlist_backend_, nullptr, nullptr, id);
+    playlist_->set_sequence(&sequence_);
+  }
+
+  void TearDown() override {
+    playlist_.reset();
+    playlist_backend_.reset();
+    database_->Close();
+    database_.reset();
+  }
+
+  QTemporaryDir temp_dir_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<Database> database_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<PlaylistBackend> playlist_backend_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  PlaylistSequence sequence_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<Playlist> playlist_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(PlaylistRestoreTest, RestoreInPages) {
+
+  QSignalSpy spy(playlist_.get(), &Playlist::RestoreFinished);
+  playlist_->Restore();
+  ASSERT_TRUE(spy.wait(10000));
+
+  ASSERT_EQ(kItemCount, playlist_->rowCount(QModelIndex()));
+  for (int i = 0; i < kItemCount; ++i) {
+    EXPECT_EQ(u"Song %1"_s.arg(i), playlist_->item_at(i)->EffectiveMetadata().title());
+  }
+
+  // Restoring is not something to undo.
+  EXPECT_EQ(0, playlist_->undo_stack()->count());
+
+}
+
+TEST_F(PlaylistRestoreTest, RestoreTwice) {
+
+  QSignalSpy spy(playlist_.get(), &Playlist::RestoreFinished);
+  playlist_->Restore();
+  playlist_->Restore();
+  ASSERT_TRUE(spy.wait(10000));
+
+  // The pages of the first restore are dropped.
+  EXPECT_FALSE(spy.wait(1000));
+  EXPECT_EQ(1, spy.count());
+  ASSERT_EQ(kItemCount, playlist_->rowCount(QModelIndex()));
+  EXPECT_EQ(u"Song 0"_s, playlist_->item_at(0)->EffectiveMetadata().title());
+  EXPECT_EQ(u"Song %1"_s.arg(kItemCount - 1), playlist_->item_at(kItemCount - 1)->EffectiveMetadata().title());
+
+}
+
+TEST_F(PlaylistRestoreTest, BackendPages) {
+
+  const int id = playlist_->id();
+
+  PlaylistItemPtrList items;
+  PlaylistBackend::PlaylistItemsPage page = playlist_backend_->GetPlaylistItemsPage(id, 0, -1, 300);
+  items << page.items;
+  EXPECT_FALSE(page.finished);
+  while (!page.finished) {
+    page = playlist_backend_->GetPlaylistItemsPage(id, page.last_position, page.last_rowid, 300);
+    items << page.items;
+  }
+
+  ASSERT_EQ(kItemCount, items.count());
+  for (int i = 0; i < kItemCount; ++i) {
+    EXPECT_EQ(QUrl(u"http://example.com/%1.mp3"_s.arg(i)), items[i]->EffectiveMetadata().url());
+  }
+
+}
 
 }  // namespace
@@ -0,0 +1,205 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QUrl>
+#include <QTemporaryDir>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/database.h"
+#include "core/memorydatabase.h"
+#include "playlist/playlistitem.h"
+#include "playlist/playlistbackend.h"
+
+using std::make_shared;
+using namespace Qt::Literals::StringLiterals;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+using PlaylistRow = QPair<qint64, QString>;
+
+class PlaylistBackendTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    database_ = make_shared<MemoryDatabase>(nullptr);
+    backend_ = make_shared<PlaylistBackend>(database_, nullptr, nullptr);
+    playlist_ = backend_->CreatePlaylist(u"Test"_s, QString());
+  }
+
+  static Song MakeSong(const QString &title) {
+    Song song(Song::Source::Stream);
+    song.Init(title, u"artist"_s, u"album"_s, 123);
+    song.set_url(QUrl(u"http://example.com/"_s + title));
+    return song;
+  }
+
+  static PlaylistItemPtr MakeItem(const QString &title) {
+    return PlaylistItem::NewFromSong(MakeSong(title));
+  }
+
+  // The row IDs and titles of the saved playlist in playlist order.
+  QList<PlaylistRow> Rows() const {
+    QList<PlaylistRow> rows;
+    QSqlDatabase db(database_->Connect());
+    QSqlQuery q(db);
+    q.prepare(u"SELECT ROWID, title FROM playlist_items WHERE playlist = :playlist ORDER BY position, ROWID"_s);
+    q.bindValue(u":playlist"_s, playlist_);
+    EXPECT_TRUE(q.exec());
+    while (q.next()) {
+      rows << PlaylistRow(q.value(0).toLongLong(), q.value(1).toString());
+    }
+    return rows;
+  }
+
+  SharedPtr<Database> database_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  SharedPtr<PlaylistBackend> backend_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  int playlist_;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+TEST_F(PlaylistBackendTest, SaveKeepsUnchangedRows) {
+
+  PlaylistItemPtrList items;
+  for (const QString &title : {u"a"_s, u"b"_s, u"c"_s, u"d"_s, u"e"_s}) {
+    items << MakeItem(title);
+  }
+  backend_->SavePlaylist(playlist_, items, -1, nullptr);
+
+  const QList<PlaylistRow> rows = Rows();
+  ASSERT_EQ(5, rows.count());
+  for (int i = 0; i < items.count(); ++i) {
+    EXPECT_EQ(rows[i].first, items[i]->database_rowid());
+  }
+
+  // Remove "b", move "d" to the top and add "f" at the end.
+  PlaylistItemPtrList new_items = PlaylistItemPtrList() << items[3] << items[0] << items[2] << items[4] << MakeItem(u"f"_s);
+  backend_->SavePlaylist(playlist_, new_items, -1, nullptr);
+
+  const QList<PlaylistRow> new_rows = Rows();
+  ASSERT_EQ(5, new_rows.count());
+  EXPECT_EQ(PlaylistRow(rows[3].first, u"d"_s), new_rows[0]);
+  EXPECT_EQ(PlaylistRow(rows[0].first, u"a"_s), new_rows[1]);
+  EXPECT_EQ(PlaylistRow(rows[2].first, u"c"_s), new_rows[2]);
+  EXPECT_EQ(PlaylistRow(rows[4].first, u"e"_s), new_rows[3]);
+  EXPECT_EQ(u"f"_s, new_rows[4].second);
+  EXPECT_EQ(new_rows[4].first, new_items[4]->database_rowid());
+
+}
+
+TEST_F(PlaylistBackendTest, ChangedItemIsRewritten) {
+
+  const PlaylistItemPtrList items = PlaylistItemPtrList() << MakeItem(u"a"_s) << MakeItem(u"b"_s);
+  backend_->SavePlaylist(playlist_, items, -1, nullptr);
+  const QList<PlaylistRow> rows = Rows();
+
+  items[1]->SetOriginalMetadata(MakeSong(u"changed"_s));
+  backend_->SavePlaylist(playlist_, items, -1, nullptr);
+
+  const QList<PlaylistRow> new_rows = Rows();
+  ASSERT_EQ(2, new_rows.count());
+  EXPECT_EQ(rows[0], new_rows[0]);
+  EXPECT_EQ(PlaylistRow(rows[1].first, u"changed"_s), new_rows[1]);
+
+}
+
+TEST_F(PlaylistBackendTest, ReplacedItemKeepsRow) {
+
+  PlaylistItemPtrList items = PlaylistItemPtrList() << MakeItem(u"a"_s) << MakeItem(u"b"_s);
+  backend_->SavePlaylist(playlist_, items, -1, nullptr);
+  const QList<PlaylistRow> rows = Rows();
+
+  // The playlist replaces items with new ones when their song is updated, those take over the row.
+  PlaylistItemPtr new_item = MakeItem(u"replaced"_s);
+  new_item->set_database_rowid(items[0]->database_rowid());
+  items[0] = new_item;
+  backend_->SavePlaylist(playlist_, items, -1, nullptr);
+
+  const QList<PlaylistRow> new_rows = Rows();
+  ASSERT_EQ(2, new_rows.count());
+  EXPECT_EQ(PlaylistRow(rows[0].first, u"replaced"_s), new_rows[0]);
+  EXPECT_EQ(rows[1], new_rows[1]);
+
+}
+
+TEST_F(PlaylistBackendTest, DuplicateItems) {
+
+  const PlaylistItemPtr item = MakeItem(u"a"_s);
+  const PlaylistItemPtrList items = PlaylistItemPtrList() << item << MakeItem(u"b"_s) << item;
+  backend_->SavePlaylist(playlist_, items, -1, nullptr);
+  const QList<PlaylistRow> rows = Rows();
+  ASSERT_EQ(3, rows.count());
+
+  // Saving again leaves all rows alone.
+  backend_->SavePlaylist(playlist_, items, -1, nullptr);
+  EXPECT_EQ(rows, Rows());
+
+}
+
+TEST(PlaylistBackendSchemaTest, MigratePositions) {
+
+  QTemporaryDir temp_dir;
+  ASSERT_TRUE(temp_dir.isValid());
+  const QString filename = temp_dir.filePath(u"strawberry.db"_s);
+
+  {
+    SharedPtr<Database> database = make_shared<Database>(nullptr, nullptr, filename);
+    PlaylistBackend backend(database, nullptr, nullptr);
+    const int playlist = backend.CreatePlaylist(u"Test"_s, QString());
+    backend.SavePlaylist(playlist, PlaylistItemPtrList() << PlaylistItem::NewFromSong(Song(Song::Source::Stream)) << PlaylistItem::NewFromSong(Song(Song::Source::Stream)), -1, nullptr);
+
+    // Turn the database back into schema 21, before playlist items had a position.
+    {
+      QSqlDatabase db(database->Connect());
+      QSqlQuery q(db);
+      ASSERT_TRUE(q.exec(u"DROP INDEX idx_playlist_items_position"_s));
+      ASSERT_TRUE(q.exec(u"ALTER TABLE playlist_items DROP COLUMN position"_s));
+      ASSERT_TRUE(q.exec(u"UPDATE schema_version SET version=21"_s));
+    }
+    database->Close();
+  }
+
+  SharedPtr<Database> database = make_shared<Database>(nullptr, nullptr, filename);
+  {
+    QSqlDatabase db(database->Connect());
+    QSqlQuery q(db);
+    ASSERT_TRUE(q.exec(u"SELECT version FROM schema_version"_s));
+    ASSERT_TRUE(q.next());
+    EXPECT_EQ(Database::kSchemaVersion, q.value(0).toInt());
+
+    ASSERT_TRUE(q.exec(u"SELECT ROWID, position FROM playlist_items ORDER BY ROWID"_s));
+    int rows = 0;
+    while (q.next()) {
+      EXPECT_EQ(q.value(0).toLongLong() * 1024, q.value(1).toLongLong());
+      ++rows;
+    }
+    EXPECT_EQ(2, rows);
+  }
+  database->Close();
+
+}
+
+}  // namespace
@@ -0,0 +1,107 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+
+#include "gtest_include.h"
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+
+#include "playlist/playlistfilechecker.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+TEST(PlaylistFileCheckerTest, RootPathForFile) {
+
+  const QStringList root_paths = QStringList() << u"/mnt/music"_s << u"/mnt/a"_s << u"/"_s;
+
+  EXPECT_EQ(u"/mnt/music"_s, PlaylistFileChecker::RootPathForFile(root_paths, u"/mnt/music/song.flac"_s));
+  EXPECT_EQ(u"/mnt/a"_s, PlaylistFileChecker::RootPathForFile(root_paths, u"/mnt/a/song.flac"_s));
+  // A mount point only matches whole path components.
+  EXPECT_EQ(u"/"_s, PlaylistFileChecker::RootPathForFile(root_paths, u"/mnt/ab/song.flac"_s));
+  EXPECT_EQ(u"/"_s, PlaylistFileChecker::RootPathForFile(root_paths, u"/mnt/musicvideos/video.mkv"_s));
+  EXPECT_EQ(QString(), PlaylistFileChecker::RootPathForFile(QStringList() << u"/mnt/a"_s, u"/home/song.flac"_s));
+
+}
+
+TEST(PlaylistFileCheckerTest, CheckFiles) {
+
+  QTemporaryDir temp_dir;
+  ASSERT_TRUE(temp_dir.isValid());
+
+  // More files than fit in one batch, every third file is missing.
+  QStringList filenames;
+  QList<int> expected_missing;
+  for (int i = 0; i < 1000; ++i) {
+    const QString filename = temp_dir.filePath(QString::number(i));
+    if (i % 3 == 0) {
+      expected_missing << i;
+    }
+    else {
+      QFile file(filename);
+      ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    }
+    filenames << filename;
+  }
+
+  PlaylistFileChecker checker;
+  QList<int> existing;
+  QList<int> missing;
+  QObject::connect(&checker, &PlaylistFileChecker::FilesChecked, &checker, [&existing, &missing](const int, const QList<int> &_existing, const QList<int> &_missing) {
+    existing << _existing;
+    missing << _missing;
+  });
+
+  QSignalSpy spy_finished(&checker, &PlaylistFileChecker::Finished);
+  const int job_id = checker.CheckFiles(filenames);
+  ASSERT_TRUE(spy_finished.wait(10000));
+  EXPECT_EQ(job_id, spy_finished[0][0].toInt());
+  EXPECT_TRUE(checker.is_idle());
+
+  std::sort(missing.begin(), missing.end());
+  EXPECT_EQ(expected_missing, missing);
+  EXPECT_EQ(filenames.count() - expected_missing.count(), existing.count());
+
+}
+
+TEST(PlaylistFileCheckerTest, CancelAll) {
+
+  PlaylistFileChecker checker;
+  QSignalSpy spy_checked(&checker, &PlaylistFileChecker::FilesChecked);
+  QSignalSpy spy_finished(&checker, &PlaylistFileChecker::Finished);
+
+  checker.CheckFiles(QStringList() << u"/nonexistent/file"_s);
+  checker.CancelAll();
+  EXPECT_TRUE(checker.is_idle());
+
+  EXPECT_FALSE(spy_finished.wait(500));
+  EXPECT_EQ(0, spy_checked.count());
+
+}
+
+}  // namespace
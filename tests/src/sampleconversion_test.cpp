@@ -0,0 +1,81 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest_include.h"
+
+#include "engine/sampleconversion.h"
+
+// clazy:excludeall=non-pod-global-static
+
+namespace {
+
+TEST(SampleConversionTest, S32LEToS16) {
+
+  const std::vector<int32_t> source = { 0, 0x7FFFFFFF, static_cast<int32_t>(0x80000000), 0x12345678, -0x12345678 };
+  std::vector<int16_t> dest(source.size());
+  SampleConversion::S32LEToS16(source.data(), dest.data(), static_cast<int>(source.size()));
+
+  EXPECT_EQ(0, dest[0]);
+  EXPECT_EQ(32767, dest[1]);
+  EXPECT_EQ(-32768, dest[2]);
+  EXPECT_EQ(0x1234, dest[3]);
+  EXPECT_EQ(-0x1235, dest[4]);
+
+}
+
+TEST(SampleConversionTest, F32LEToS16) {
+
+  const std::vector<float> source = { 0.0F, 0.5F, -0.5F, -1.0F };
+  std::vector<int16_t> dest(source.size());
+  SampleConversion::F32LEToS16(source.data(), dest.data(), static_cast<int>(source.size()));
+
+  EXPECT_EQ(0, dest[0]);
+  EXPECT_EQ(16384, dest[1]);
+  EXPECT_EQ(-16384, dest[2]);
+  EXPECT_EQ(-32768, dest[3]);
+
+}
+
+TEST(SampleConversionTest, S24LEToS16) {
+
+  // 0x123456 and -2 (0xFFFFFE) packed as little endian 3 byte samples.
+  const std::vector<int8_t> source = { 0x56, 0x34, 0x12, -2, -1, -1 };
+  std::vector<int16_t> dest(2);
+  SampleConversion::S24LEToS16(source.data(), source.size(), dest.data(), static_cast<int>(dest.size()));
+
+  EXPECT_EQ(0x1234, dest[0]);
+  EXPECT_EQ(-1, dest[1]);
+
+}
+
+TEST(SampleConversionTest, S24_32LEToS16) {
+
+  const std::vector<int32_t> source = { 0x00123456, -2 };
+  std::vector<int16_t> dest(source.size());
+  SampleConversion::S24_32LEToS16(source.data(), dest.data(), static_cast<int>(source.size()));
+
+  EXPECT_EQ(0x1234, dest[0]);
+  EXPECT_EQ(-1, dest[1]);
+
+}
+
+}  // namespace
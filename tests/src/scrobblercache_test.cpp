@@ -0,0 +1,263 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QFile>
+#include <QDir>
+#include <QList>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+
+#include "includes/scoped_ptr.h"
+#include "constants/timeconstants.h"
+#include "core/song.h"
+#include "core/standardpaths.h"
+#include "scrobbler/scrobblercache.h"
+#include "scrobbler/scrobblercacheitem.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+class ScrobblerCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    qputenv("XDG_CACHE_HOME", cache_directory_.path().toLocal8Bit());
+    QDir().mkpath(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation));
+    filename_ = StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + "/scrobbler.cache"_L1;
+  }
+
+  void TearDown() override {
+    cache_.reset();
+  }
+
+  void OpenCache() {
+    cache_.reset();
+    cache_.reset(new ScrobblerCache(u"scrobbler.cache"_s, nullptr));
+  }
+
+  static Song MakeSong(const QString &title) {
+    Song song;
+    song.set_title(title);
+    song.set_artist(u"Artist"_s);
+    song.set_album(u"Album"_s);
+    song.set_track(1);
+    song.set_length_nanosec(180 * kNsecPerSec);
+    return song;
+  }
+
+  QList<QByteArray> Lines() const {
+    QFile file(filename_);
+    if (!file.open(QIODevice::ReadOnly)) return QList<QByteArray>();
+    const QByteArray data = file.readAll();
+    file.close();
+    EXPECT_TRUE(data.endsWith('\n'));
+    QList<QByteArray> lines = data.split('\n');
+    lines.removeAll(QByteArray());
+    return lines;
+  }
+
+  void WriteFile(const QByteArray &data) const {
+    QFile file(filename_);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(data);
+    file.close();
+  }
+
+  QStringList Titles() const {
+    QStringList titles;
+    const ScrobblerCacheItemPtrList cache_items = cache_->List();
+    for (ScrobblerCacheItemPtr cache_item : cache_items) {
+      titles << cache_item->metadata.title;
+    }
+    return titles;
+  }
+
+  QTemporaryDir cache_directory_;
+  QString filename_;
+  ScopedPtr<ScrobblerCache> cache_;
+};
+
+TEST_F(ScrobblerCacheTest, ReplaysAddedItems) {
+
+  OpenCache();
+  cache_->Add(MakeSong(u"One"_s), 1000);
+  cache_->Add(MakeSong(u"Two"_s), 2000);
+  cache_->Add(MakeSong(u"Three"_s), 3000);
+  EXPECT_EQ(3, Lines().count());
+
+  OpenCache();
+  ASSERT_EQ(3, cache_->Count());
+  EXPECT_EQ(QStringList() << u"One"_s << u"Two"_s << u"Three"_s, Titles());
+  const ScrobblerCacheItemPtr cache_item = cache_->List().constFirst();
+  EXPECT_EQ(1U, cache_item->id);
+  EXPECT_EQ(1000U, cache_item->timestamp);
+  EXPECT_EQ(u"Artist"_s, cache_item->metadata.artist);
+  EXPECT_EQ(u"Album"_s, cache_item->metadata.album);
+  EXPECT_EQ(180 * kNsecPerSec, cache_item->metadata.length_nanosec);
+
+  // New items continue after the highest ID in the log.
+  EXPECT_EQ(4U, cache_->Add(MakeSong(u"Four"_s), 4000)->id);
+
+}
+
+TEST_F(ScrobblerCacheTest, TombstonesRemoveItems) {
+
+  OpenCache();
+  cache_->Add(MakeSong(u"One"_s), 1000);
+  ScrobblerCacheItemPtr cache_item = cache_->Add(MakeSong(u"Two"_s), 2000);
+  cache_->Add(MakeSong(u"Three"_s), 3000);
+  cache_->Flush(ScrobblerCacheItemPtrList() << cache_item);
+  EXPECT_EQ(2, cache_->Count());
+
+  // The removal is appended as a tombstone record.
+  const QList<QByteArray> lines = Lines();
+  ASSERT_EQ(4, lines.count());
+  const QJsonObject tombstone = QJsonDocument::fromJson(lines.constLast()).object();
+  EXPECT_EQ(cache_item->id, tombstone["remove"_L1].toVariant().toULongLong());
+
+  OpenCache();
+  EXPECT_EQ(QStringList() << u"One"_s << u"Three"_s, Titles());
+
+  // A removed ID is not reused.
+  EXPECT_EQ(4U, cache_->Add(MakeSong(u"Four"_s), 4000)->id);
+
+}
+
+TEST_F(ScrobblerCacheTest, TruncatedLastLineIsDropped) {
+
+  OpenCache();
+  cache_->Add(MakeSong(u"One"_s), 1000);
+  cache_->Add(MakeSong(u"Two"_s), 2000);
+  cache_.reset();
+
+  // Simulate a crash while the third record was being written.
+  QFile file(filename_);
+  ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+  QByteArray data = file.readAll();
+  file.close();
+  const QByteArray last_line = data.mid(data.lastIndexOf('\n', data.size() - 2) + 1);
+  data.append(last_line.left(last_line.size() / 2));
+  WriteFile(data);
+
+  OpenCache();
+  EXPECT_EQ(QStringList() << u"One"_s << u"Two"_s, Titles());
+
+  // The log is rewritten without the partial record, so new records start on their own line.
+  EXPECT_EQ(2, Lines().count());
+  cache_->Add(MakeSong(u"Three"_s), 3000);
+  EXPECT_EQ(3, Lines().count());
+
+  OpenCache();
+  EXPECT_EQ(QStringList() << u"One"_s << u"Two"_s << u"Three"_s, Titles());
+
+}
+
+TEST_F(ScrobblerCacheTest, CompactsRemovedRecords) {
+
+  OpenCache();
+  ScrobblerCacheItemPtrList cache_items;
+  for (int i = 0; i < 150; ++i) {
+    cache_items << cache_->Add(MakeSong(QString::number(i)), 1000 + i);
+  }
+  cache_->Flush(cache_items.mid(0, 120));
+  EXPECT_EQ(30, cache_->Count());
+  EXPECT_EQ(270, Lines().count());
+
+  cache_->WriteCache();
+  EXPECT_EQ(30, Lines().count());
+
+  OpenCache();
+  ASSERT_EQ(30, cache_->Count());
+  EXPECT_EQ(u"120"_s, cache_->List().constFirst()->metadata.title);
+  EXPECT_EQ(121U, cache_->List().constFirst()->id);
+
+}
+
+TEST_F(ScrobblerCacheTest, CompactsRemovedRecordsWhenRead) {
+
+  OpenCache();
+  ScrobblerCacheItemPtrList cache_items;
+  for (int i = 0; i < 150; ++i) {
+    cache_items << cache_->Add(MakeSong(QString::number(i)), 1000 + i);
+  }
+  cache_->Flush(cache_items.mid(0, 120));
+
+  OpenCache();
+  EXPECT_EQ(30, cache_->Count());
+  EXPECT_EQ(30, Lines().count());
+
+}
+
+TEST_F(ScrobblerCacheTest, RemovingAllItemsRemovesLog) {
+
+  OpenCache();
+  ScrobblerCacheItemPtr cache_item = cache_->Add(MakeSong(u"One"_s), 1000);
+  cache_->Remove(cache_item);
+  cache_->WriteCache();
+  EXPECT_FALSE(QFile::exists(filename_));
+
+}
+
+TEST_F(ScrobblerCacheTest, ConvertsLegacyCache) {
+
+  QJsonArray json_tracks;
+  for (const QString &title : {u"One"_s, u"Two"_s}) {
+    QJsonObject json_track;
+    json_track.insert("timestamp"_L1, QJsonValue::fromVariant(1000));
+    json_track.insert("artist"_L1, u"Artist"_s);
+    json_track.insert("album"_L1, u"Album"_s);
+    json_track.insert("title"_L1, title);
+    json_track.insert("track"_L1, 1);
+    json_track.insert("albumartist"_L1, u"Album Artist"_s);
+    json_track.insert("grouping"_L1, QString());
+    json_track.insert("length_nanosec"_L1, QJsonValue::fromVariant(180 * kNsecPerSec));
+    json_tracks.append(json_track);
+  }
+  QJsonObject json_obj;
+  json_obj.insert("tracks"_L1, json_tracks);
+  WriteFile(QJsonDocument(json_obj).toJson(QJsonDocument::Indented));
+
+  OpenCache();
+  EXPECT_EQ(QStringList() << u"One"_s << u"Two"_s, Titles());
+  EXPECT_EQ(u"Album Artist"_s, cache_->List().constFirst()->metadata.albumartist);
+
+  // The file is rewritten as a log with one record per item, and the items get IDs.
+  const QList<QByteArray> lines = Lines();
+  ASSERT_EQ(2, lines.count());
+  EXPECT_EQ(1U, QJsonDocument::fromJson(lines.constFirst()).object()["id"_L1].toVariant().toULongLong());
+  EXPECT_EQ(2U, QJsonDocument::fromJson(lines.constLast()).object()["id"_L1].toVariant().toULongLong());
+
+  EXPECT_EQ(3U, cache_->Add(MakeSong(u"Three"_s), 3000)->id);
+
+  OpenCache();
+  EXPECT_EQ(QStringList() << u"One"_s << u"Two"_s << u"Three"_s, Titles());
+
+}
+
+}  // namespace
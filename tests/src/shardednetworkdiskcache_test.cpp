@@ -0,0 +1,164 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QIODevice>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QDirIterator>
+#include <QNetworkCacheMetaData>
+
+#include "includes/scoped_ptr.h"
+#include "core/standardpaths.h"
+#include "core/shardednetworkdiskcache.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+constexpr qint64 kMegabyte = 1024LL * 1024LL;
+
+class ShardedNetworkDiskCacheTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    cache_directory_ = new QTemporaryDir;
+    qputenv("XDG_CACHE_HOME", cache_directory_->path().toLocal8Bit());
+  }
+
+  static void TearDownTestSuite() {
+    delete cache_directory_;
+    cache_directory_ = nullptr;
+  }
+
+  void SetUp() override {
+    cache_.reset(new ShardedNetworkDiskCache(nullptr));
+    cache_->clear();
+  }
+
+  void TearDown() override {
+    cache_.reset();
+  }
+
+  QIODevice *Prepare(const QUrl &url, const qint64 size) {
+    QNetworkCacheMetaData metadata;
+    metadata.setUrl(url);
+    metadata.setSaveToDisk(true);
+    metadata.setRawHeaders(QNetworkCacheMetaData::RawHeaderList() << qMakePair(QByteArray("Content-Length"), QByteArray::number(size)));
+    return cache_->prepare(metadata);
+  }
+
+  bool Insert(const QUrl &url, const QByteArray &data) {
+    QIODevice *device = Prepare(url, data.size());
+    if (!device) return false;
+    device->write(data);
+    cache_->insert(device);
+    return true;
+  }
+
+  QByteArray Read(const QUrl &url) {
+    ScopedPtr<QIODevice> device(cache_->data(url));
+    return device ? device->readAll() : QByteArray();
+  }
+
+  static QTemporaryDir *cache_directory_;
+  ScopedPtr<ShardedNetworkDiskCache> cache_;
+};
+
+QTemporaryDir *ShardedNetworkDiskCacheTest::cache_directory_ = nullptr;
+
+TEST_F(ShardedNetworkDiskCacheTest, InsertAndRemove) {
+
+  const QUrl url(u"https://example.com/cover.jpg"_s);
+  const QByteArray data("cover data");
+
+  ASSERT_TRUE(Insert(url, data));
+  EXPECT_EQ(data, Read(url));
+  EXPECT_EQ(url, cache_->metaData(url).url());
+
+  EXPECT_TRUE(cache_->remove(url));
+  EXPECT_TRUE(Read(url).isEmpty());
+
+}
+
+#ifndef Q_OS_WIN32
+TEST_F(ShardedNetworkDiskCacheTest, ShardIsStable) {
+
+  // The first byte of the MD5 digest of the URL picks the shard, so the entry must end up in the same directory on every run.
+  const QUrl url(u"https://example.com/cover.jpg"_s);
+  ASSERT_TRUE(Insert(url, QByteArray("cover data")));
+
+  int files = 0;
+  QDirIterator it(StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + u"/networkcache/9"_s, QDir::Files, QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    it.next();
+    ++files;
+  }
+  EXPECT_EQ(1, files);
+
+}
+#endif
+
+TEST_F(ShardedNetworkDiskCacheTest, LargeEntry) {
+
+  // Larger than the total size divided by the number of shards.
+  const QUrl url(u"https://example.com/large.png"_s);
+  const QByteArray data(8 * kMegabyte, 'x');
+
+  ASSERT_TRUE(Insert(url, data));
+  EXPECT_EQ(data.size(), Read(url).size());
+
+}
+
+TEST_F(ShardedNetworkDiskCacheTest, TotalSizeIsLimited) {
+
+  const QByteArray data(kMegabyte, 'x');
+  const int count = static_cast<int>(ShardedNetworkDiskCache::maximumCacheSize() / kMegabyte) + 8;
+  for (int i = 0; i < count; ++i) {
+    ASSERT_TRUE(Insert(QUrl(u"https://example.com/%1.jpg"_s.arg(i)), data));
+  }
+
+  EXPECT_LE(cache_->cacheSize(), ShardedNetworkDiskCache::maximumCacheSize());
+  EXPECT_GT(cache_->cacheSize(), ShardedNetworkDiskCache::maximumCacheSize() / 2);
+
+}
+
+TEST_F(ShardedNetworkDiskCacheTest, AbortedInsert) {
+
+  const QUrl url(u"https://example.com/aborted.jpg"_s);
+  const QByteArray data("cover data");
+
+  // An aborted reply removes the URL instead of inserting the prepared device, which deletes the device.
+  QIODevice *device = Prepare(url, data.size());
+  ASSERT_TRUE(device);
+  device->write(data);
+  cache_->remove(url);
+  EXPECT_TRUE(Read(url).isEmpty());
+
+  ASSERT_TRUE(Insert(url, data));
+  EXPECT_EQ(data, Read(url));
+
+}
+
+}  // namespace
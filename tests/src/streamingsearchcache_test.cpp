@@ -0,0 +1,199 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QMutexLocker>
+#include <QDateTime>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QSqlDatabase>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "includes/shared_ptr.h"
+#include "includes/scoped_ptr.h"
+#include "core/song.h"
+#include "core/database.h"
+#include "core/sqlquery.h"
+#include "streaming/streamingservice.h"
+#include "streaming/streamingsearchcache.h"
+
+using std::make_shared;
+using namespace Qt::Literals::StringLiterals;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+constexpr qint64 kResultsTtlSec = 24LL * 60LL * 60LL;
+
+class StreamingSearchCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // The results are loaded and saved on another thread, so the database can't be in memory.
+    database_ = make_shared<Database>(nullptr, nullptr, temp_dir_.filePath(u"strawberry.db"_s));
+    CreateCache();
+  }
+
+  void TearDown() override {
+    cache_.reset();
+    database_->Close();
+  }
+
+  static SongMap MakeSongs(const QStringList &titles) {
+    SongMap songs;
+    for (const QString &title : titles) {
+      Song song(Song::Source::Tidal);
+      song.set_song_id(title);
+      song.set_title(title);
+      song.set_artist(u"Artist"_s);
+      song.set_url(QUrl(u"tidal://track/"_s + title));
+      song.set_valid(true);
+      songs.insert(song.song_id(), song);
+    }
+    return songs;
+  }
+
+  void CreateCache() {
+    cache_.reset(new StreamingSearchCache(database_, Song::Source::Tidal));
+    QObject::connect(&*cache_, &StreamingSearchCache::ResultsLoaded, &*cache_, [this](const int, const StreamingService::SearchType, const QString&, const SongMap &songs) {
+      loaded_songs_ = songs;
+      loaded_ = true;
+    });
+  }
+
+  // Destroying the cache waits until its pending writes are done.
+  void RecreateCache() {
+    cache_.reset();
+    CreateCache();
+  }
+
+  void SetSearchTime(const qint64 time) {
+    QMutexLocker l(database_->Mutex());
+    QSqlDatabase db(database_->Connect());
+    SqlQuery q(db);
+    q.prepare(u"UPDATE streaming_search_songs SET search_time = :search_time"_s);
+    q.BindValue(u":search_time"_s, time);
+    ASSERT_TRUE(q.Exec());
+  }
+
+  int RowCount() {
+    QMutexLocker l(database_->Mutex());
+    QSqlDatabase db(database_->Connect());
+    SqlQuery q(db);
+    q.prepare(u"SELECT COUNT(*) FROM streaming_search_songs"_s);
+    if (!q.Exec() || !q.next()) return -1;
+    return q.value(0).toInt();
+  }
+
+  SongMap Load(const QString &query) {
+    loaded_ = false;
+    loaded_songs_.clear();
+    cache_->LoadAsync(1, StreamingService::SearchType::Songs, query);
+    EXPECT_TRUE(QTest::qWaitFor([this]() { return loaded_; }));
+    return loaded_songs_;
+  }
+
+  QTemporaryDir temp_dir_;
+  SharedPtr<Database> database_;
+  ScopedPtr<StreamingSearchCache> cache_;
+  bool loaded_ = false;
+  SongMap loaded_songs_;
+};
+
+TEST_F(StreamingSearchCacheTest, ResultsAreKeyedByTypeAndNormalizedQuery) {
+
+  cache_->Insert(StreamingService::SearchType::Songs, u"Foo  Bar"_s, MakeSongs(QStringList() << u"1"_s << u"2"_s));
+
+  SongMap songs;
+  ASSERT_TRUE(cache_->Results(StreamingService::SearchType::Songs, u" foo bar"_s, &songs));
+  EXPECT_EQ(2, songs.count());
+  EXPECT_FALSE(cache_->Results(StreamingService::SearchType::Albums, u"foo bar"_s, &songs));
+  EXPECT_FALSE(cache_->Results(StreamingService::SearchType::Songs, u"foo"_s, &songs));
+
+}
+
+TEST_F(StreamingSearchCacheTest, PrefixResultsUseLongestCachedPrefix) {
+
+  cache_->Insert(StreamingService::SearchType::Songs, u"ab"_s, MakeSongs(QStringList() << u"1"_s));
+  cache_->Insert(StreamingService::SearchType::Songs, u"abc"_s, MakeSongs(QStringList() << u"1"_s << u"2"_s));
+
+  EXPECT_EQ(2, cache_->PrefixResults(StreamingService::SearchType::Songs, u"abcd"_s).count());
+  EXPECT_EQ(1, cache_->PrefixResults(StreamingService::SearchType::Songs, u"abd"_s).count());
+  EXPECT_TRUE(cache_->PrefixResults(StreamingService::SearchType::Albums, u"abcd"_s).isEmpty());
+  EXPECT_TRUE(cache_->PrefixResults(StreamingService::SearchType::Songs, u"xyz"_s).isEmpty());
+
+}
+
+TEST_F(StreamingSearchCacheTest, ResultsAreLoadedFromDatabase) {
+
+  cache_->Insert(StreamingService::SearchType::Songs, u"foo"_s, MakeSongs(QStringList() << u"1"_s << u"2"_s));
+  RecreateCache();
+
+  SongMap songs;
+  EXPECT_FALSE(cache_->Results(StreamingService::SearchType::Songs, u"foo"_s, &songs));
+  EXPECT_EQ(2, Load(u"foo"_s).count());
+  ASSERT_TRUE(cache_->Results(StreamingService::SearchType::Songs, u"foo"_s, &songs));
+  EXPECT_EQ(2, songs.count());
+
+}
+
+TEST_F(StreamingSearchCacheTest, ExpiredResultsAreNotLoaded) {
+
+  cache_->Insert(StreamingService::SearchType::Songs, u"foo"_s, MakeSongs(QStringList() << u"1"_s));
+  RecreateCache();
+  SetSearchTime(QDateTime::currentSecsSinceEpoch() - kResultsTtlSec - 60);
+
+  EXPECT_TRUE(Load(u"foo"_s).isEmpty());
+
+}
+
+TEST_F(StreamingSearchCacheTest, LoadedResultsKeepStoredTime) {
+
+  cache_->Insert(StreamingService::SearchType::Songs, u"foo"_s, MakeSongs(QStringList() << u"1"_s));
+  RecreateCache();
+  SetSearchTime(QDateTime::currentSecsSinceEpoch() - kResultsTtlSec + 2);
+
+  ASSERT_EQ(1, Load(u"foo"_s).count());
+
+  // The results expire at their stored time, not relative to when they were loaded.
+  QTest::qWait(3000);
+  SongMap songs;
+  EXPECT_FALSE(cache_->Results(StreamingService::SearchType::Songs, u"foo"_s, &songs));
+
+}
+
+TEST_F(StreamingSearchCacheTest, ClearRemovesResults) {
+
+  cache_->Insert(StreamingService::SearchType::Songs, u"foo"_s, MakeSongs(QStringList() << u"1"_s));
+  cache_->Clear();
+
+  SongMap songs;
+  EXPECT_FALSE(cache_->Results(StreamingService::SearchType::Songs, u"foo"_s, &songs));
+  EXPECT_TRUE(cache_->PrefixResults(StreamingService::SearchType::Songs, u"foobar"_s).isEmpty());
+
+  RecreateCache();
+  EXPECT_EQ(0, RowCount());
+  EXPECT_TRUE(Load(u"foo"_s).isEmpty());
+
+}
+
+}  // namespace
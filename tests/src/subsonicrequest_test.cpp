@@ -0,0 +1,321 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+#include "gtest_include.h"
+
+#include <QMap>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QStandardPaths>
+#include <QSignalSpy>
+
+#include "mock_networkaccessmanager.h"
+#include "includes/scoped_ptr.h"
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/settings.h"
+#include "core/taskmanager.h"
+#include "core/urlhandlers.h"
+#include "core/memorydatabase.h"
+#include "constants/timeconstants.h"
+#include "constants/subsonicsettings.h"
+#include "subsonic/subsonicservice.h"
+#include "subsonic/subsonicurlhandler.h"
+#include "subsonic/subsonicrequest.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_unique;
+using std::make_shared;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+constexpr qint64 kLastSync = 1700000000000;  // Server lastModified of the previous sync, in milliseconds.
+constexpr int kSongDuration = 200;
+
+QByteArray SubsonicResponse(const QString &name, const QJsonObject &json_object) {
+
+  QJsonObject object_response;
+  object_response.insert("status"_L1, u"ok"_s);
+  object_response.insert(name, json_object);
+
+  QJsonObject object_root;
+  object_root.insert("subsonic-response"_L1, object_response);
+
+  return QJsonDocument(object_root).toJson(QJsonDocument::Compact);
+
+}
+
+QByteArray IndexesResponse(const qint64 last_modified) {
+
+  QJsonObject object_indexes;
+  object_indexes.insert("lastModified"_L1, last_modified);
+
+  return SubsonicResponse(u"indexes"_s, object_indexes);
+
+}
+
+QString ISODate(const qint64 msec) {
+  return QDateTime::fromMSecsSinceEpoch(msec).toUTC().toString(Qt::ISODate);
+}
+
+QJsonObject AlbumObject(const QString &album_id, const int song_count, const qint64 changed_msec) {
+
+  QJsonObject object_album;
+  object_album.insert("id"_L1, album_id);
+  object_album.insert("artist"_L1, u"Artist"_s);
+  object_album.insert("name"_L1, u"Album "_s + album_id);
+  object_album.insert("songCount"_L1, song_count);
+  object_album.insert("duration"_L1, song_count * kSongDuration);
+  object_album.insert("created"_L1, ISODate(changed_msec));
+  object_album.insert("changed"_L1, ISODate(changed_msec));
+
+  return object_album;
+
+}
+
+QByteArray AlbumListResponse(const QJsonArray &array_albums) {
+
+  QJsonObject object_albumlist;
+  object_albumlist.insert("album"_L1, array_albums);
+
+  return SubsonicResponse(u"albumList2"_s, object_albumlist);
+
+}
+
+QByteArray AlbumResponse(const QString &album_id, const int song_count, const qint64 created_msec) {
+
+  QJsonArray array_songs;
+  for (int i = 1; i <= song_count; ++i) {
+    QJsonObject object_song;
+    object_song.insert("id"_L1, album_id + u'-' + QString::number(i));
+    object_song.insert("albumId"_L1, album_id);
+    object_song.insert("title"_L1, u"Remote title "_s + QString::number(i));
+    object_song.insert("album"_L1, u"Album "_s + album_id);
+    object_song.insert("artist"_L1, u"Artist"_s);
+    object_song.insert("track"_L1, i);
+    object_song.insert("size"_L1, 1000);
+    object_song.insert("suffix"_L1, u"flac"_s);
+    object_song.insert("duration"_L1, kSongDuration);
+    object_song.insert("type"_L1, u"music"_s);
+    object_song.insert("created"_L1, ISODate(created_msec));
+    array_songs << object_song;
+  }
+
+  QJsonObject object_album = AlbumObject(album_id, song_count, created_msec);
+  object_album.insert("song"_L1, array_songs);
+
+  return SubsonicResponse(u"album"_s, object_album);
+
+}
+
+SongList LocalSongs(const QString &album_id, const int song_count) {
+
+  SongList songs;
+  for (int i = 1; i <= song_count; ++i) {
+    Song song(Song::Source::Subsonic);
+    song.set_song_id(album_id + u'-' + QString::number(i));
+    song.set_album_id(album_id);
+    song.set_title(u"Local title "_s + QString::number(i));
+    song.set_length_nanosec(kSongDuration * kNsecPerSec);
+    song.set_mtime(1000);
+    song.set_valid(true);
+    songs << song;
+  }
+
+  return songs;
+
+}
+
+class SubsonicRequestTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+
+    QStandardPaths::setTestModeEnabled(true);
+
+    Settings s;
+    s.beginGroup(SubsonicSettings::kSettingsGroup);
+    s.setValue(SubsonicSettings::kUrl, QUrl(u"http://subsonic.test/"_s));
+    s.setValue(SubsonicSettings::kUsername, u"user"_s);
+    s.setValue(SubsonicSettings::kPassword, QByteArray("password").toBase64());
+    s.setValue(SubsonicSettings::kAuthMethod, static_cast<int>(SubsonicSettings::AuthMethod::Hex));
+    s.setValue(SubsonicSettings::kDownloadAlbumCovers, false);
+    s.endGroup();
+
+    task_manager_ = make_shared<TaskManager>();
+    database_ = make_shared<MemoryDatabase>(task_manager_);
+    url_handlers_ = make_shared<UrlHandlers>();
+    service_ = make_shared<SubsonicService>(task_manager_, database_, url_handlers_, nullptr);
+    request_ = make_unique<SubsonicRequest>(&*service_, new SubsonicUrlHandler(&*service_));
+    network_ = new MockNetworkAccessManager;
+    request_->SetNetworkAccessManager(network_);
+
+  }
+
+  void TearDown() override {
+
+    request_.reset();
+    service_.reset();
+
+    Settings s;
+    s.remove(QLatin1String(SubsonicSettings::kSettingsGroup));
+
+  }
+
+  // Runs the request until it emits its results.
+  SongMap GetSongs(const SongList &local_songs, const qint64 last_modified, QString *error = nullptr) {
+
+    QSignalSpy spy(&*request_, &SubsonicRequest::Results);
+    request_->GetSongs(local_songs, last_modified);
+    EXPECT_TRUE(spy.count() > 0 || spy.wait(10000));
+    if (spy.isEmpty()) return SongMap();
+    if (error) *error = spy.first().at(1).toString();
+    return spy.first().at(0).value<SongMap>();
+
+  }
+
+  SharedPtr<TaskManager> task_manager_;
+  SharedPtr<MemoryDatabase> database_;
+  SharedPtr<UrlHandlers> url_handlers_;
+  SharedPtr<SubsonicService> service_;
+  ScopedPtr<SubsonicRequest> request_;
+  MockNetworkAccessManager *network_;
+};
+
+TEST_F(SubsonicRequestTest, FullSync) {
+
+  network_->ExpectGetAndFinish(u"getIndexes"_s, QMap<QString, QString>(), 200, IndexesResponse(kLastSync));
+  network_->ExpectGetAndFinish(u"getAlbumList2"_s, QMap<QString, QString>(), 200, AlbumListResponse(QJsonArray() << AlbumObject(u"1"_s, 2, kLastSync) << AlbumObject(u"2"_s, 1, kLastSync)));
+  network_->ExpectGetAndFinish(u"getAlbum.view"_s, QMap<QString, QString>{{u"id"_s, u"1"_s}}, 200, AlbumResponse(u"1"_s, 2, kLastSync));
+  network_->ExpectGetAndFinish(u"getAlbum.view"_s, QMap<QString, QString>{{u"id"_s, u"2"_s}}, 200, AlbumResponse(u"2"_s, 1, kLastSync));
+
+  QString error;
+  const SongMap songs = GetSongs(SongList(), 0, &error);
+
+  EXPECT_TRUE(error.isEmpty()) << error.toStdString();
+  ASSERT_EQ(3, songs.count());
+  EXPECT_TRUE(songs.contains(u"1-1"_s));
+  EXPECT_TRUE(songs.contains(u"1-2"_s));
+  EXPECT_TRUE(songs.contains(u"2-1"_s));
+  // The song keeps its own creation time as mtime.
+  EXPECT_EQ(kLastSync / 1000, songs[u"1-1"_s].mtime());
+  EXPECT_EQ(kLastSync, request_->last_modified());
+
+}
+
+TEST_F(SubsonicRequestTest, NoChangesReusesLocalSongs) {
+
+  network_->ExpectGetAndFinish(u"getIndexes"_s, QMap<QString, QString>{{u"ifModifiedSince"_s, QString::number(kLastSync)}}, 200, IndexesResponse(kLastSync));
+
+  QString error;
+  const SongMap songs = GetSongs(LocalSongs(u"1"_s, 2) + LocalSongs(u"2"_s, 1), kLastSync, &error);
+
+  EXPECT_TRUE(error.isEmpty()) << error.toStdString();
+  ASSERT_EQ(3, songs.count());
+  EXPECT_EQ(u"Local title 1"_s, songs[u"2-1"_s].title());
+  EXPECT_EQ(kLastSync, request_->last_modified());
+
+}
+
+TEST_F(SubsonicRequestTest, OnlyChangedAlbumsAreFetched) {
+
+  constexpr qint64 kLastModified = kLastSync + 3600000;
+
+  // Album 1 is unchanged, album 2 changed after the last sync, album 3 is new and album 4 was removed from the server.
+  network_->ExpectGetAndFinish(u"getIndexes"_s, QMap<QString, QString>{{u"ifModifiedSince"_s, QString::number(kLastSync)}}, 200, IndexesResponse(kLastModified));
+  network_->ExpectGetAndFinish(u"getAlbumList2"_s, QMap<QString, QString>(), 200, AlbumListResponse(QJsonArray() << AlbumObject(u"1"_s, 2, kLastSync - 60000) << AlbumObject(u"2"_s, 1, kLastModified) << AlbumObject(u"3"_s, 1, kLastModified)));
+  network_->ExpectGetAndFinish(u"getAlbum.view"_s, QMap<QString, QString>{{u"id"_s, u"2"_s}}, 200, AlbumResponse(u"2"_s, 1, kLastModified));
+  network_->ExpectGetAndFinish(u"getAlbum.view"_s, QMap<QString, QString>{{u"id"_s, u"3"_s}}, 200, AlbumResponse(u"3"_s, 1, kLastModified));
+
+  QString error;
+  const SongMap songs = GetSongs(LocalSongs(u"1"_s, 2) + LocalSongs(u"2"_s, 1) + LocalSongs(u"4"_s, 1), kLastSync, &error);
+
+  EXPECT_TRUE(error.isEmpty()) << error.toStdString();
+  ASSERT_EQ(4, songs.count());
+  EXPECT_EQ(u"Local title 1"_s, songs[u"1-1"_s].title());
+  EXPECT_EQ(1000, songs[u"1-1"_s].mtime());
+  EXPECT_EQ(u"Remote title 1"_s, songs[u"2-1"_s].title());
+  EXPECT_TRUE(songs.contains(u"3-1"_s));
+  EXPECT_FALSE(songs.contains(u"4-1"_s));
+  EXPECT_EQ(kLastModified, request_->last_modified());
+
+}
+
+TEST_F(SubsonicRequestTest, ChangedSongCountIsFetched) {
+
+  constexpr qint64 kLastModified = kLastSync + 3600000;
+
+  network_->ExpectGetAndFinish(u"getIndexes"_s, QMap<QString, QString>(), 200, IndexesResponse(kLastModified));
+  network_->ExpectGetAndFinish(u"getAlbumList2"_s, QMap<QString, QString>(), 200, AlbumListResponse(QJsonArray() << AlbumObject(u"1"_s, 3, kLastSync - 60000)));
+  network_->ExpectGetAndFinish(u"getAlbum.view"_s, QMap<QString, QString>{{u"id"_s, u"1"_s}}, 200, AlbumResponse(u"1"_s, 3, kLastSync - 60000));
+
+  const SongMap songs = GetSongs(LocalSongs(u"1"_s, 2), kLastSync);
+
+  ASSERT_EQ(3, songs.count());
+  EXPECT_EQ(u"Remote title 1"_s, songs[u"1-1"_s].title());
+
+}
+
+TEST_F(SubsonicRequestTest, AlbumWithoutChangedIsFetched) {
+
+  constexpr qint64 kLastModified = kLastSync + 3600000;
+
+  // Servers without OpenSubsonic only send the created time, which doesn't tell whether the album was changed since.
+  QJsonObject object_album = AlbumObject(u"1"_s, 2, kLastSync - 60000);
+  object_album.remove("changed"_L1);
+
+  network_->ExpectGetAndFinish(u"getIndexes"_s, QMap<QString, QString>(), 200, IndexesResponse(kLastModified));
+  network_->ExpectGetAndFinish(u"getAlbumList2"_s, QMap<QString, QString>(), 200, AlbumListResponse(QJsonArray() << object_album));
+  network_->ExpectGetAndFinish(u"getAlbum.view"_s, QMap<QString, QString>{{u"id"_s, u"1"_s}}, 200, AlbumResponse(u"1"_s, 2, kLastSync - 60000));
+
+  const SongMap songs = GetSongs(LocalSongs(u"1"_s, 2), kLastSync);
+
+  ASSERT_EQ(2, songs.count());
+  EXPECT_EQ(u"Remote title 1"_s, songs[u"1-1"_s].title());
+
+}
+
+TEST_F(SubsonicRequestTest, FailedAlbumIsNotMarkedSynced) {
+
+  constexpr qint64 kLastModified = kLastSync + 3600000;
+
+  network_->ExpectGetAndFinish(u"getIndexes"_s, QMap<QString, QString>(), 200, IndexesResponse(kLastModified));
+  network_->ExpectGetAndFinish(u"getAlbumList2"_s, QMap<QString, QString>(), 200, AlbumListResponse(QJsonArray() << AlbumObject(u"1"_s, 1, kLastModified) << AlbumObject(u"2"_s, 1, kLastModified)));
+  network_->ExpectGetAndFinish(u"getAlbum.view"_s, QMap<QString, QString>{{u"id"_s, u"1"_s}}, 200, AlbumResponse(u"1"_s, 1, kLastModified));
+  network_->ExpectGetAndFinish(u"getAlbum.view"_s, QMap<QString, QString>{{u"id"_s, u"2"_s}}, 500, QByteArray());
+
+  QString error;
+  const SongMap songs = GetSongs(SongList(), kLastSync, &error);
+
+  EXPECT_FALSE(error.isEmpty());
+  EXPECT_EQ(1, songs.count());
+  // The next sync has to list all albums again, or it would miss the album that failed.
+  EXPECT_EQ(0, request_->last_modified());
+
+}
+
+}  // namespace
@@ -0,0 +1,154 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2025, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QCoreApplication>
+#include <QThreadPool>
+#include <QString>
+#include <QStringList>
+#include <QStringListModel>
+#include <QUrl>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "includes/shared_ptr.h"
+#include "includes/scoped_ptr.h"
+#include "core/song.h"
+#include "core/database.h"
+#include "collection/collectionbackend.h"
+#include "collection/collectionlibrary.h"
+#include "playlist/playlist.h"
+#include "playlist/tagcompletionstore.h"
+
+using std::make_shared;
+using namespace Qt::Literals::StringLiterals;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+class TagCompletionStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // The values are loaded from another thread, so the database can't be in memory.
+    database_ = make_shared<Database>(nullptr, nullptr, temp_dir_.filePath(u"strawberry.db"_s));
+    backend_ = make_shared<CollectionBackend>();
+    backend_->Init(database_, nullptr, Song::Source::Collection, QLatin1String(CollectionLibrary::kSongsTable), QLatin1String(CollectionLibrary::kDirsTable), QLatin1String(CollectionLibrary::kSubdirsTable));
+    backend_->AddDirectory(u"/tmp"_s);
+    store_.reset(new TagCompletionStore(backend_));
+  }
+
+  void TearDown() override {
+    WaitForLoads();
+    store_.reset();
+    backend_->Close();
+    database_->Close();
+  }
+
+  Song MakeSong(const QString &filename, const QString &artist) {
+    Song song;
+    song.set_directory_id(1);
+    song.set_url(QUrl::fromLocalFile(temp_dir_.filePath(filename)));
+    song.set_mtime(1);
+    song.set_ctime(1);
+    song.set_filesize(1);
+    song.set_title(filename);
+    song.set_artist(artist);
+    return song;
+  }
+
+  static void WaitForLoads() {
+    QThreadPool::globalInstance()->waitForDone();
+    QCoreApplication::processEvents();
+  }
+
+  QTemporaryDir temp_dir_;
+  SharedPtr<Database> database_;
+  SharedPtr<CollectionBackend> backend_;
+  ScopedPtr<TagCompletionStore> store_;
+};
+
+TEST_F(TagCompletionStoreTest, LoadsSortedValuesAndAddsNewOnes) {
+
+  backend_->AddOrUpdateSongs(SongList() << MakeSong(u"1.flac"_s, u"beta"_s) << MakeSong(u"2.flac"_s, u"Alpha"_s) << MakeSong(u"3.flac"_s, u"beta"_s));
+
+  QStringListModel *model = store_->model(Playlist::Column::Artist);
+  ASSERT_TRUE(QTest::qWaitFor([model]() { return model->rowCount() == 2; }, 5000));
+  EXPECT_EQ(QStringList() << u"Alpha"_s << u"beta"_s, model->stringList());
+
+  backend_->AddOrUpdateSongs(SongList() << MakeSong(u"4.flac"_s, u"Gamma"_s) << MakeSong(u"5.flac"_s, u"alpha"_s));
+  EXPECT_EQ(QStringList() << u"Alpha"_s << u"alpha"_s << u"beta"_s << u"Gamma"_s, model->stringList());
+
+}
+
+TEST_F(TagCompletionStoreTest, DeletedValuesAreRemovedWhenNoOtherSongHasThem) {
+
+  backend_->AddOrUpdateSongs(SongList() << MakeSong(u"1.flac"_s, u"Alpha"_s) << MakeSong(u"2.flac"_s, u"Alpha"_s) << MakeSong(u"3.flac"_s, u"Beta"_s));
+
+  QStringListModel *model = store_->model(Playlist::Column::Artist);
+  ASSERT_TRUE(QTest::qWaitFor([model]() { return model->rowCount() == 2; }, 5000));
+
+  SongList deleted_songs;
+  const SongList songs = backend_->GetAllSongs();
+  for (const Song &song : songs) {
+    if (song.title() != "2.flac"_L1) deleted_songs << song;
+  }
+  ASSERT_EQ(2, deleted_songs.count());
+  backend_->DeleteSongs(deleted_songs);
+
+  ASSERT_TRUE(QTest::qWaitFor([model]() { return model->rowCount() == 1; }, 5000));
+  EXPECT_EQ(QStringList() << u"Alpha"_s, model->stringList());
+
+}
+
+TEST_F(TagCompletionStoreTest, RenamedValuesAreRemovedWhenNoOtherSongHasThem) {
+
+  backend_->AddOrUpdateSongs(SongList() << MakeSong(u"1.flac"_s, u"Alpha"_s) << MakeSong(u"2.flac"_s, u"Alpha"_s) << MakeSong(u"3.flac"_s, u"Beta"_s));
+
+  QStringListModel *model = store_->model(Playlist::Column::Artist);
+  ASSERT_TRUE(QTest::qWaitFor([model]() { return model->rowCount() == 2; }, 5000));
+
+  SongList songs = backend_->GetAllSongs();
+  ASSERT_EQ(3, songs.count());
+  for (Song &song : songs) {
+    song.set_artist(song.title() == "1.flac"_L1 ? u"Gamma"_s : song.title() == "3.flac"_L1 ? u"Delta"_s : song.artist());
+  }
+  backend_->AddOrUpdateSongs(songs);
+
+  // Alpha is still used by the second song, Beta has no songs left.
+  EXPECT_EQ(QStringList() << u"Alpha"_s << u"Delta"_s << u"Gamma"_s, model->stringList());
+
+}
+
+TEST_F(TagCompletionStoreTest, LoadFromBeforeDatabaseResetIsDropped) {
+
+  backend_->AddOrUpdateSongs(SongList() << MakeSong(u"1.flac"_s, u"Alpha"_s));
+
+  // Let the first load read the values, but don't handle its result until the database is reset.
+  QStringListModel *model = store_->model(Playlist::Column::Artist);
+  QThreadPool::globalInstance()->waitForDone();
+  backend_->DeleteAll();
+
+  WaitForLoads();
+  EXPECT_TRUE(model->stringList().isEmpty());
+
+}
+
+}  // namespace